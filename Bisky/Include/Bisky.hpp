@@ -1,16 +1,23 @@
 #pragma once
 
 #include "Core/Application.hpp"
+#include "Core/CpuFeatures.hpp"
+#include "Core/DerivedDataCache.hpp"
 #include "Core/FrameStats.hpp"
 #include "Core/GameTimer.hpp"
+#include "Core/Hash.hpp"
 #include "Core/Input.hpp"
+#include "Core/JobSystem.hpp"
 #include "Core/Logger.hpp"
+#include "Core/MappedFile.hpp"
+#include "Core/ModelCooker.hpp"
 #include "Core/ResourceManager.hpp"
 #include "Core/StringHelpers.hpp"
 
 #include "Editor/Editor.hpp"
 
 #include "Graphics/Allocator.hpp"
+#include "Graphics/BlockCompressor.hpp"
 #include "Graphics/Buffer.hpp"
 #include "Graphics/CommandList.hpp"
 #include "Graphics/CommandQueue.hpp"
@@ -19,15 +26,25 @@
 #include "Graphics/Descriptor.hpp"
 #include "Graphics/DescriptorHeap.hpp"
 #include "Graphics/Device.hpp"
+#include "Graphics/FrameArena.hpp"
 #include "Graphics/FrameResource.hpp"
+#include "Graphics/GeometryPool.hpp"
 #include "Graphics/GraphicsCommandList.hpp"
+#include "Graphics/MemoryAllocator.hpp"
+#include "Graphics/OffsetAllocator.hpp"
 #include "Graphics/PipelineState.hpp"
 #include "Graphics/ResourceUpload.hpp"
 #include "Graphics/Resources.hpp"
 #include "Graphics/RootSignature.hpp"
 #include "Graphics/ShaderCompiler.hpp"
+#include "Graphics/StagingRing.hpp"
+#include "Graphics/StreamingStore.hpp"
 #include "Graphics/Texture.hpp"
+#include "Graphics/TextureProcessor.hpp"
+#include "Graphics/TlsfAllocator.hpp"
 #include "Graphics/Transform.hpp"
+#include "Graphics/TransformStorage.hpp"
+#include "Graphics/UploadManager.hpp"
 #include "Graphics/Utilities.hpp"
 #include "Graphics/Window.hpp"
 
@@ -38,10 +55,18 @@
 
 #include "Scene/ArcballCamera.hpp"
 #include "Scene/Camera.hpp"
+#include "Scene/Components.hpp"
+#include "Scene/EntityRegistry.hpp"
+#include "Scene/FrustumCuller.hpp"
 #include "Scene/Lights.hpp"
+#include "Scene/LodSelector.hpp"
 #include "Scene/Material.hpp"
 #include "Scene/Mesh.hpp"
-#include "Scene/RenderObject.hpp"
+#include "Scene/MeshOptimizer.hpp"
+#include "Scene/MeshSimplifier.hpp"
+#include "Scene/MeshletBuilder.hpp"
+#include "Scene/MeshletCuller.hpp"
 #include "Scene/Scene.hpp"
 #include "Scene/ScreenQuad.hpp"
-#include "Scene/Vertex.hpp"
\ No newline at end of file
+#include "Scene/Vertex.hpp"
+#include "Scene/VertexQuantizer.hpp"
\ No newline at end of file
@@ -0,0 +1,23 @@
+#pragma once
+
+namespace bisky::core
+{
+
+/*
+ * The instruction sets the SIMD kernels can pick at run time.
+ * The build itself only assumes SSE2, wider kernels check here before they run.
+ */
+namespace CpuFeatures
+{
+
+/*
+ * Checks whether AVX instructions can run. The CPU has to support them and the OS has to save the upper
+ * halves of the registers on a context switch. The check runs once, later calls return its result.
+ *
+ * @return True if AVX can be used.
+ */
+bool hasAvx();
+
+} // namespace CpuFeatures
+
+} // namespace bisky::core
\ No newline at end of file
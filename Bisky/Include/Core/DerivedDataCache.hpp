@@ -0,0 +1,132 @@
+#pragma once
+
+#include "Common.hpp"
+#include "Core/MappedFile.hpp"
+
+namespace bisky::core
+{
+
+/*
+ * Counters for the derived data cache since startup.
+ */
+struct CacheStats
+{
+    uint32_t hits;
+    uint32_t misses;
+    uint32_t writes;
+    uint32_t evictions;
+    uint64_t bytesRead;
+    uint64_t bytesWritten;
+    uint64_t size;
+};
+
+/*
+ * A local on-disk cache for the results of expensive processing (cooked meshes, decoded textures...).
+ *
+ * Entries are grouped into buckets and addressed by a 64-bit key. The key should hash
+ * everything the result depends on: the source content, the processor version and its options.
+ * Reading an entry marks it as recently used, and the least recently used entries
+ * are deleted once the cache grows past its maximum size.
+ *
+ * The cache is safe to use from multiple threads.
+ */
+class DerivedDataCache
+{
+  public:
+    /*
+     * Singleton pattern initializer and getter.
+     * Use this to get an instance of the global DerivedDataCache.
+     *
+     * @return A reference to the global DerivedDataCache.
+     */
+    inline static DerivedDataCache &get()
+    {
+        static DerivedDataCache instance;
+        return instance;
+    }
+
+    ~DerivedDataCache()                                           = default;
+    DerivedDataCache(const DerivedDataCache &)                    = delete;
+    const DerivedDataCache &operator=(const DerivedDataCache &)   = delete;
+    DerivedDataCache(const DerivedDataCache &&)                   = delete;
+    const DerivedDataCache &&operator=(const DerivedDataCache &&) = delete;
+
+  public:
+    /*
+     * Sets the directory entries are stored in and trims it to the maximum size.
+     * The cache is disabled until a directory is set.
+     *
+     * @param path The directory to use, created if it doesn't exist.
+     */
+    void setDirectory(const std::filesystem::path &path);
+
+    /*
+     * Sets the maximum size of the cache on disk.
+     *
+     * @param bytes The maximum size in bytes.
+     */
+    void setMaxSize(uint64_t bytes);
+
+    /*
+     * Reads a whole entry into memory.
+     *
+     * @param bucket The kind of data, e.g. "meshes".
+     * @param key The hash of everything the entry depends on.
+     * @param data The vector to fill.
+     * @return True on a cache hit.
+     */
+    bool load(std::string_view bucket, uint64_t key, std::vector<uint8_t> &data);
+
+    /*
+     * Memory maps an entry.
+     *
+     * @param bucket The kind of data.
+     * @param key The hash of everything the entry depends on.
+     * @return The mapped entry, or nullptr on a cache miss.
+     */
+    std::unique_ptr<MappedFile> map(std::string_view bucket, uint64_t key);
+
+    /*
+     * Writes an entry.
+     * The data is written to a temporary file and renamed, so readers never see a partial entry.
+     *
+     * @param bucket The kind of data.
+     * @param key The hash of everything the entry depends on.
+     * @param data The bytes to store.
+     * @return True if the entry was written.
+     */
+    bool store(std::string_view bucket, uint64_t key, std::span<const uint8_t> data);
+
+    /*
+     * Same as above, but the writer creates the temporary file itself.
+     *
+     * @param bucket The kind of data.
+     * @param key The hash of everything the entry depends on.
+     * @param writer Writes the entry to the given path and returns true on success.
+     * @return True if the entry was written.
+     */
+    bool store(
+        std::string_view bucket, uint64_t key, const std::function<bool(const std::filesystem::path &)> &writer
+    );
+
+  public:
+    bool       isEnabled() const;
+    CacheStats getStats() const;
+
+  private:
+    explicit DerivedDataCache() = default;
+
+    std::filesystem::path getEntryPath(std::string_view bucket, uint64_t key) const;
+    std::filesystem::path getTempPath(const std::filesystem::path &path) const;
+    bool                  find(const std::filesystem::path &path);
+    bool                  commit(const std::filesystem::path &tempPath, const std::filesystem::path &path);
+    void                  trim();
+
+  private:
+    mutable std::mutex    m_mutex;
+    std::filesystem::path m_directory;
+    uint64_t              m_maxSize = 2048ull * 1024ull * 1024ull;
+    CacheStats            m_stats{};
+};
+
+} // namespace bisky::core
\ No newline at end of file
@@ -10,6 +10,13 @@ struct FrameStats
     float    frameTime;
     uint32_t triangleCount;
     uint32_t drawCount;
+    uint32_t lodTriangleSavings; // triangles skipped by drawing simplified LODs
+    uint32_t lodObjectCounts[8]; // objects drawn at each LOD, 0 is full detail
+    uint32_t meshletCount;       // meshlets tested against the camera
+    uint32_t meshletsCulled;     // meshlets that were outside of the frustum or facing away
+    uint32_t objectsVisible;     // entities inside of the frustum, drawn
+    uint32_t objectsCulled;      // entities outside of the frustum, skipped before recording
+    uint32_t objectBytes;        // per-object data uploaded for the frame
     float    sceneUpdateTime;
     float    meshDrawTime;
     float    finalRenderDrawTime;
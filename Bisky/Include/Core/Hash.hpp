@@ -0,0 +1,63 @@
+#pragma once
+
+#include "Common.hpp"
+
+namespace bisky::core
+{
+
+/*
+ * Incrementally builds a 64-bit FNV-1a hash.
+ * Used to build cache keys, so the result must be stable between runs and machines.
+ */
+class Hasher
+{
+  public:
+    /*
+     * Adds raw bytes to the hash.
+     *
+     * @param data The bytes to add.
+     * @param size The number of bytes.
+     */
+    void update(const void *data, size_t size);
+
+    /*
+     * Adds a string and its length to the hash.
+     *
+     * @param string The string to add.
+     */
+    void update(std::string_view string);
+
+    /*
+     * Adds the bytes of a trivially copyable value to the hash.
+     *
+     * @param value The value to add.
+     */
+    template <typename T> void updateValue(const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        update(&value, sizeof(T));
+    }
+
+    /*
+     * Adds the contents of a file to the hash.
+     *
+     * @param path The file to read.
+     * @return True if the file could be read.
+     */
+    bool updateFile(const std::filesystem::path &path);
+
+    uint64_t finish() const;
+
+  private:
+    uint64_t m_hash = 14695981039346656037ull;
+};
+
+/*
+ * Formats a hash as a fixed width hexadecimal string.
+ *
+ * @param hash The hash to format.
+ * @return The 16 character string.
+ */
+std::string toHexString(uint64_t hash);
+
+} // namespace bisky::core
\ No newline at end of file
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace bisky::core
+{
+
+/*
+ * Tracks a group of jobs.
+ * The value is incremented for every job submitted with this counter
+ * and decremented once that job has finished running.
+ */
+struct JobCounter
+{
+    std::atomic<uint32_t> value = 0u;
+};
+
+/*
+ * A single unit of work and the counter it reports to.
+ */
+struct Job
+{
+    std::function<void()> function;
+    JobCounter           *counter = nullptr;
+};
+
+/*
+ * A work-stealing job system.
+ *
+ * Every worker owns a deque of jobs. Workers pop from the back of their
+ * own deque and steal from the front of the other deques when they run dry.
+ * Threads that are not workers (e.g. the main thread) push to a shared
+ * queue and help execute jobs while they wait on a counter.
+ *
+ * A job system with zero workers runs everything on the waiting thread.
+ */
+class JobSystem
+{
+  public:
+    /*
+     * Gets the engine-wide job system.
+     * It uses one worker for every hardware thread except the calling one.
+     *
+     * @return A reference to the global JobSystem.
+     */
+    static JobSystem &get();
+
+    /*
+     * Starts the worker threads.
+     *
+     * @param numWorkers The number of worker threads to create.
+     */
+    explicit JobSystem(uint32_t numWorkers);
+
+    /*
+     * Stops and joins all worker threads.
+     * Jobs that have not been started are discarded.
+     */
+    ~JobSystem();
+
+    JobSystem(const JobSystem &)                    = delete;
+    const JobSystem &operator=(const JobSystem &)   = delete;
+    JobSystem(const JobSystem &&)                   = delete;
+    const JobSystem &&operator=(const JobSystem &&) = delete;
+
+  public:
+    /*
+     * Submits a job to the calling thread's queue.
+     *
+     * @param function The work to run.
+     * @param counter Optional counter that is incremented now and decremented once the job finishes.
+     */
+    void submit(std::function<void()> function, JobCounter *counter = nullptr);
+
+    /*
+     * Splits [0, count) into batches of grainSize and submits one job per batch.
+     * The function is called with the [begin, end) range of its batch.
+     *
+     * @param count The number of items to process.
+     * @param grainSize The number of items per job.
+     * @param function The work to run on each batch.
+     * @param counter The counter to wait on.
+     */
+    void parallelFor(
+        uint32_t count, uint32_t grainSize, std::function<void(uint32_t, uint32_t)> function, JobCounter *counter
+    );
+
+    /*
+     * Same as above, but blocks until every batch has finished.
+     */
+    void parallelFor(uint32_t count, uint32_t grainSize, std::function<void(uint32_t, uint32_t)> function);
+
+    /*
+     * Blocks until the counter reaches zero.
+     * The calling thread executes pending jobs instead of sleeping.
+     *
+     * @param counter The counter to wait on.
+     */
+    void wait(JobCounter *const counter);
+
+  public:
+    /*
+     * Gets the number of worker threads (not including the calling thread).
+     *
+     * @return The number of worker threads.
+     */
+    uint32_t getWorkerCount() const;
+
+  private:
+    struct WorkerQueue
+    {
+        std::mutex      mutex;
+        std::deque<Job> jobs;
+    };
+
+    void workerLoop(uint32_t index);
+    bool tryGetJob(uint32_t index, Job &job);
+    void execute(Job &job);
+    void push(uint32_t index, Job &&job);
+    uint32_t currentQueueIndex() const;
+
+  private:
+    std::vector<std::thread>                  m_workers;
+    std::vector<std::unique_ptr<WorkerQueue>> m_queues; // one per worker, the last is shared by other threads
+    std::atomic<uint32_t>                     m_pendingJobs = 0u;
+    std::atomic<bool>                         m_running     = true;
+    std::mutex                                m_sleepMutex;
+    std::condition_variable                   m_wakeCondition;
+};
+
+} // namespace bisky::core
\ No newline at end of file
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace bisky::core
+{
+
+/*
+ * A read-only memory mapping of a whole file.
+ * The view stays valid for the lifetime of the object.
+ *
+ * Only the view is kept, the file and mapping handles are closed as soon as it is mapped.
+ * Maps with MapViewOfFile on Windows and mmap everywhere else.
+ */
+class MappedFile
+{
+  public:
+    /*
+     * Opens and maps the given file.
+     * Check isValid() to see if it succeeded.
+     *
+     * @param path The file to map.
+     */
+    explicit MappedFile(const std::filesystem::path &path);
+
+    /*
+     * Unmaps the view.
+     */
+    ~MappedFile();
+
+    MappedFile(const MappedFile &)                    = delete;
+    const MappedFile &operator=(const MappedFile &)   = delete;
+    MappedFile(const MappedFile &&)                   = delete;
+    const MappedFile &&operator=(const MappedFile &&) = delete;
+
+  public:
+    bool           isValid() const;
+    const uint8_t *data() const;
+    size_t         size() const;
+
+  private:
+    const uint8_t *m_data = nullptr;
+    size_t         m_size = 0u;
+};
+
+} // namespace bisky::core
\ No newline at end of file
@@ -0,0 +1,220 @@
+#pragma once
+
+#include "Core/MappedFile.hpp"
+#include "Scene/FrustumCuller.hpp"
+#include "Scene/MeshletBuilder.hpp"
+#include "Scene/Vertex.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace bisky::core
+{
+
+/*
+ * A draw range inside of a MeshData.
+ */
+struct SubmeshData
+{
+    uint32_t baseVertexLocation = 0u;
+    uint32_t startIndexLocation = 0u;
+    uint32_t indexCount         = 0u;
+    int32_t  materialIndex      = -1;
+    uint32_t firstMeshlet       = 0u; // into MeshData::meshlets
+    uint32_t meshletCount       = 0u;
+};
+
+/*
+ * A simplified version of every submesh of a MeshData.
+ * The submeshes draw from the same vertices as the full detail ones, only their index ranges differ.
+ */
+struct LodData
+{
+    float                    error = 0.0f; // geometric error in object space units
+    std::vector<SubmeshData> submeshes;
+};
+
+/*
+ * CPU-side mesh data that is ready to be uploaded.
+ * The spans point either into ModelData's own storage or into a mapped cooked file.
+ */
+struct MeshData
+{
+    std::string                     name;
+    std::span<const scene::Vertex>  vertices;
+    std::span<const uint32_t>       indices;
+    std::span<const scene::Meshlet> meshlets;
+    std::vector<SubmeshData>        submeshes;
+    std::vector<LodData>            lods;   // from the most to the least detailed, not including submeshes
+    scene::MeshBounds               bounds; // of every vertex, in object space
+};
+
+/*
+ * Material parameters with indices into ModelData::images.
+ * -1 means the material doesn't use that texture.
+ */
+struct MaterialData
+{
+    std::string  name;
+    dx::XMFLOAT3 diffuse                = {1.0f, 1.0f, 1.0f};
+    int32_t      diffuseImage           = -1;
+    int32_t      metallicRoughnessImage = -1;
+    int32_t      normalImage            = -1;
+};
+
+/*
+ * A node of a model's scene graph.
+ * Nodes are stored parents first, so a node's parent always comes before it.
+ */
+struct NodeData
+{
+    std::string  name;
+    int32_t      mesh        = -1; // into ModelData::meshes, -1 for nodes that only group their children
+    int32_t      parent      = -1; // into ModelData::nodes, -1 for root nodes
+    dx::XMFLOAT3 scale       = {1.0f, 1.0f, 1.0f};
+    dx::XMFLOAT3 rotation    = {0.0f, 0.0f, 0.0f}; // in degrees, pitch, yaw and roll
+    dx::XMFLOAT3 translation = {0.0f, 0.0f, 0.0f};
+};
+
+/*
+ * An image still in its source encoding (png, jpg...).
+ * Empty bytes means the image source isn't supported.
+ */
+struct EncodedImage
+{
+    std::string              name;
+    std::span<const uint8_t> bytes;
+};
+
+/*
+ * Everything needed to create the GPU resources for a model file.
+ */
+struct ModelData
+{
+    std::vector<MeshData>     meshes;
+    std::vector<MaterialData> materials;
+    std::vector<EncodedImage> images;
+    std::vector<NodeData>     nodes;
+
+    // backing storage when imported from glTF
+    std::vector<std::vector<scene::Vertex>>  vertexStorage;
+    std::vector<std::vector<uint32_t>>       indexStorage;
+    std::vector<std::vector<scene::Meshlet>> meshletStorage;
+    std::vector<std::vector<uint8_t>>        imageStorage;
+
+    // backing storage when loaded from a cooked file
+    std::unique_ptr<MappedFile> mappedFile;
+};
+
+/*
+ * Converts source models into a binary container that can be memory mapped.
+ *
+ * The cooked container is a header followed by page-aligned sections:
+ * meshes, lods, submeshes, meshlets, materials, images, nodes, strings, vertices, indices and image bytes.
+ * Vertices and indices are stored exactly as they are uploaded, so loading
+ * a cooked file only maps it and points the ModelData spans into the view.
+ *
+ * Writing and reading the container is built without the precompiled header (CookedModel.cpp),
+ * so it runs headless wherever MappedFile does. Importing glTF lives in ModelCooker.cpp.
+ */
+namespace ModelCooker
+{
+
+constexpr uint32_t Magic       = 0x4D4B5342u; // "BSKM"
+constexpr uint32_t Version     = 7u;
+constexpr uint64_t Alignment   = 4096u;
+constexpr uint32_t MaxLodCount = 5u; // including the full detail mesh
+
+/*
+ * How source models are processed on import.
+ */
+struct ImportOptions
+{
+    bool parallel       = true; // decode and optimize primitives on the job system
+    bool optimizeMeshes = true; // weld and reorder vertices and indices with the MeshOptimizer
+    bool generateLods   = true; // build a simplified LOD chain with the MeshSimplifier
+    bool buildMeshlets  = true; // split every submesh into meshlets for cluster culling
+};
+
+/*
+ * What a cooked file was cooked from.
+ * A cooked file is stale once its stamp differs from the one of its source, even if it is newer.
+ */
+struct SourceStamp
+{
+    uint64_t optionsHash = 0u; // the import options that change the result
+    uint64_t sourcesHash = 0u; // the names, sizes and write times of the source and the files it can reference
+};
+
+/*
+ * Parses, validates and decodes a .gltf or .glb file.
+ * Each primitive is optimized, simplified and split into meshlets separately,
+ * so submeshes keep their own vertex ranges.
+ *
+ * The nodes of the default scene are imported as well, and every instance of EXT_mesh_gpu_instancing
+ * becomes a child of the node it belongs to. Meshes that are made of the same primitives are only
+ * decoded once, nodes referencing any of them reference that one.
+ *
+ * @param path The file to import.
+ * @param model The model to fill.
+ * @param options How to process the primitives.
+ * @return True if successfully imported.
+ */
+bool importGltf(const std::filesystem::path &path, ModelData &model, const ImportOptions &options = {});
+
+/*
+ * Writes the model into a cooked container.
+ * The file is written to a temporary path first and renamed once complete.
+ *
+ * @param path The file to write.
+ * @param model The model to write.
+ * @param stamp What the model was imported from, see getSourceStamp.
+ * @return True if successfully written.
+ */
+bool write(const std::filesystem::path &path, const ModelData &model, const SourceStamp &stamp = {});
+
+/*
+ * Maps a cooked container and points the model at its sections.
+ *
+ * @param path The file to read.
+ * @param model The model to fill.
+ * @param stamp If given, the file is only read if it was written with the same stamp.
+ * @return True if the file exists and has the expected version and stamp.
+ */
+bool read(const std::filesystem::path &path, ModelData &model, const SourceStamp *stamp = nullptr);
+
+/*
+ * Same as above, but reads an already mapped cooked container.
+ *
+ * @param file The mapped file, owned by the model on success.
+ * @param model The model to fill.
+ * @param stamp If given, the file is only read if it was written with the same stamp.
+ * @return True if the file has the expected version and stamp.
+ */
+bool read(std::unique_ptr<MappedFile> file, ModelData &model, const SourceStamp *stamp = nullptr);
+
+/*
+ * Stamps a source model without reading it.
+ * A .gltf file can reference any file next to it, so every file in its directory is stamped too.
+ *
+ * @param path The source model.
+ * @param options The options the model is imported with.
+ * @return The stamp to write with the cooked file and to check it against.
+ */
+SourceStamp getSourceStamp(const std::filesystem::path &path, const ImportOptions &options);
+
+/*
+ * Gets the cooked file path for a source model.
+ *
+ * @param path The source model path.
+ * @return The source path with the .bmesh extension.
+ */
+std::filesystem::path getCookedPath(const std::filesystem::path &path);
+
+} // namespace ModelCooker
+
+} // namespace bisky::core
\ No newline at end of file
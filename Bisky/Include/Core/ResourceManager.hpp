@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Core/ModelCooker.hpp"
 #include "Graphics/Texture.hpp"
 #include "Scene/Material.hpp"
 #include "Scene/Mesh.hpp"
@@ -28,6 +29,19 @@ namespace bisky::core
  */
 void _setWorkingDirectory(const std::filesystem::path &filepath);
 
+/*
+ * A node of a loaded model's scene graph, with its mesh already looked up.
+ */
+struct ModelNode
+{
+    std::string  name;
+    scene::Mesh *mesh        = nullptr; // shared by every node drawing it, null for nodes that only group others
+    int32_t      parent      = -1;      // index of the parent node, which always comes first, -1 for roots
+    dx::XMFLOAT3 scale       = {1.0f, 1.0f, 1.0f};
+    dx::XMFLOAT3 rotation    = {0.0f, 0.0f, 0.0f}; // in degrees, pitch, yaw and roll
+    dx::XMFLOAT3 translation = {0.0f, 0.0f, 0.0f};
+};
+
 /*
  * A basic resource manager class.
  *
@@ -92,15 +106,30 @@ class ResourceManager
      */
     void setTextureDirectory(const std::filesystem::path &path);
 
+    /*
+     * Sets how source models are imported.
+     * Each import logs its decode and optimization times, so the options can be compared.
+     *
+     * @param options The options used by the following loadMesh calls.
+     */
+    void setImportOptions(const ModelCooker::ImportOptions &options);
+
     /*
      * Loads a mesh from a given filename.
      * Assumes the file is in the ShaderDirectory.
+     * Meshes whose indices fit in 16 bits always get a 16-bit index buffer.
+     * Every mesh is uploaded once, no matter how many nodes draw it.
      *
      * @param device The device to create buffers with.
      * @param filename The file to load.
+     * @param vertexFormat The vertex buffer layout, Packed only works with shaders that decode it.
+     * @param nodes Filled with the nodes of the model's scene graph if not null.
      * @return True if successfully loaded.
      */
-    bool loadMesh(gfx::Device *const device, const std::filesystem::path &filename);
+    bool loadMesh(
+        gfx::Device *const device, const std::filesystem::path &filename,
+        scene::VertexFormat vertexFormat = scene::VertexFormat::Packed, std::vector<ModelNode> *nodes = nullptr
+    );
 
     bool loadDDS(gfx::Device *const device, const std::filesystem::path &filename, bool *isCubemap);
 
@@ -133,6 +162,8 @@ class ResourceManager
     std::filesystem::path m_shaderDirectory;
     std::filesystem::path m_modelDirectory;
     std::filesystem::path m_textureDirectory;
+
+    ModelCooker::ImportOptions m_importOptions;
 };
 
 } // namespace bisky::core
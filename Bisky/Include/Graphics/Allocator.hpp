@@ -2,6 +2,8 @@
 
 #include "Common.hpp"
 #include "Graphics/Buffer.hpp"
+#include "Graphics/FrameArena.hpp"
+#include "Graphics/StreamingStore.hpp"
 
 namespace bisky::gfx
 {
@@ -9,27 +11,60 @@ namespace bisky::gfx
 class Device;
 
 /*
- * An allocation that is returned by the allocator
+ * An allocation that is returned by the allocator.
+ *
+ * The mapped memory is write-combined, so it can only be written through write(), which streams
+ * data built in regular memory. There's no pointer to it to read from by accident.
  */
 struct Allocation
 {
     ID3D12Resource *const     resource; // pointer to the actual resource
-    void                     *cpuBase;  // mapped data (for updating)
     D3D12_GPU_VIRTUAL_ADDRESS gpuBase;  // gpu address
     uint32_t                  offset;   // offset
     uint32_t                  size;     // size of the allocation
+
+    /*
+     * Streams a value into the allocation.
+     * StreamingStore::fence must run before the GPU reads it, Application does so once a frame.
+     *
+     * @param value The value, built in regular memory.
+     * @param index Where to write it, in multiples of the value's size, which must keep it 16-byte aligned.
+     */
+    template <typename T> void write(const T &value, size_t index = 0u) const
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        StreamingStore::copy(m_cpuBase + index * sizeof(T), &value, sizeof(T));
+    }
+
+  private:
+    friend struct Allocator;
+
+    Allocation(
+        ID3D12Resource *resource, uint8_t *cpuBase, D3D12_GPU_VIRTUAL_ADDRESS gpuBase, uint32_t offset, uint32_t size
+    );
+
+    uint8_t *m_cpuBase; // mapped data, write-combined
 };
 
 /*
- * An arena allocator mainly meant for upload buffers
+ * An arena allocator mainly meant for upload buffers.
+ * Chains extra upload buffers when a frame runs out of room, see FrameArena.
  */
 struct Allocator
 {
-    std::unique_ptr<Buffer>   buffer;   // the buffer to allocate to
-    char                     *cpuBase;  // pointer to the start of the mapped data
-    D3D12_GPU_VIRTUAL_ADDRESS gpuBase;  // pointer to the start of gpu address
-    uint32_t                  at;       // current offset in the memory
-    uint32_t                  capacity; // total memory allocated
+    /*
+     * A mapped upload buffer backing one page of the arena.
+     */
+    struct Page
+    {
+        std::unique_ptr<Buffer>   buffer;  // the buffer to allocate to
+        uint8_t                  *cpuBase; // pointer to the start of the mapped data
+        D3D12_GPU_VIRTUAL_ADDRESS gpuBase; // pointer to the start of gpu address
+    };
+
+    Device           *device; // the device to create pages with
+    FrameArena        arena;  // decides where allocations go and how big the pages are
+    std::vector<Page> pages;  // one for every page of the arena
 
     Allocator(Device *const device, uint32_t size);
     ~Allocator();
@@ -40,16 +75,21 @@ struct Allocator
     const Allocator &&operator=(const Allocator &&) = delete;
 
     /*
-     * Allocates the size aligned by align if possible.
+     * Allocates the size aligned by align, on a new page if the current one is full.
      * Returns an Allocation struct with the necessary information.
      */
     Allocation allocate(uint32_t size, uint32_t align = D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
 
     /*
-     * Resets all allocations made by setting 'at' to 0u.
-     * This should be called at the end of each frame.
+     * Resets all allocations made and resizes the pages to fit recent frames.
+     * This should be called once the GPU is done with the frame.
      */
     void reset();
+
+    /*
+     * Creates, recreates or releases pages until they match the arena's page sizes.
+     */
+    void syncPages();
 };
 
 } // namespace bisky::gfx
\ No newline at end of file
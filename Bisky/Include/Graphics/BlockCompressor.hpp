@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstdint>
+
+namespace bisky::gfx
+{
+
+/*
+ * Encoders for single 4x4 blocks of the BC formats.
+ *
+ * Every encoder takes the 16 pixels of a block as RGBA8, row by row, and writes one block.
+ * Endpoints start on the principal axis of the pixels and are refined once with a least squares
+ * fit to the chosen indices, which is most of the quality of an exhaustive search at a fraction
+ * of the cost.
+ */
+namespace BlockCompressor
+{
+
+// the size of one encoded block
+constexpr uint32_t Bc1BlockSize = 8u;
+constexpr uint32_t Bc3BlockSize = 16u;
+constexpr uint32_t Bc4BlockSize = 8u;
+constexpr uint32_t Bc5BlockSize = 16u;
+constexpr uint32_t Bc7BlockSize = 16u;
+
+/*
+ * Encodes the RGB of a block as BC1, alpha is ignored.
+ *
+ * @param pixels The 16 RGBA8 pixels of the block.
+ * @param block The 8 byte block to write.
+ */
+void encodeBc1(const uint8_t *pixels, uint8_t *block);
+
+/*
+ * Encodes a block as BC3, BC4 alpha followed by BC1 color.
+ *
+ * @param pixels The 16 RGBA8 pixels of the block.
+ * @param block The 16 byte block to write.
+ */
+void encodeBc3(const uint8_t *pixels, uint8_t *block);
+
+/*
+ * Encodes one channel of a block as BC4.
+ *
+ * @param pixels The 16 RGBA8 pixels of the block.
+ * @param channel The channel to encode, 0 to 3.
+ * @param block The 8 byte block to write.
+ */
+void encodeBc4(const uint8_t *pixels, uint32_t channel, uint8_t *block);
+
+/*
+ * Encodes the red and green channels of a block as BC5.
+ *
+ * @param pixels The 16 RGBA8 pixels of the block.
+ * @param block The 16 byte block to write.
+ */
+void encodeBc5(const uint8_t *pixels, uint8_t *block);
+
+/*
+ * Encodes a block as BC7 using mode 6, a single RGBA line with 16 interpolated colors.
+ * The other modes trade precision for partitions, which only pays off on blocks with sharp edges.
+ *
+ * @param pixels The 16 RGBA8 pixels of the block.
+ * @param block The 16 byte block to write.
+ */
+void encodeBc7(const uint8_t *pixels, uint8_t *block);
+
+} // namespace BlockCompressor
+
+} // namespace bisky::gfx
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Graphics/Descriptor.hpp"
+#include "Graphics/MemoryAllocator.hpp"
 
 namespace bisky::gfx
 {
@@ -38,12 +39,18 @@ struct Buffer
     static int GetCbvIndex(const Buffer *const buffer);
 
     explicit Buffer();
+
+    /*
+     * Hands the resource and the memory it was placed in to the memory allocator, which releases them
+     * once the GPU is done with them.
+     */
     ~Buffer();
 
     wrl::ComPtr<ID3D12Resource> resource      = nullptr;
     gfx::Descriptor             srvDescriptor = {};
     gfx::Descriptor             uavDescriptor = {};
     gfx::Descriptor             cbvDescriptor = {};
+    gfx::MemoryAllocation       memory        = {};
 
     /*
      * Rule of 5 deletors.
@@ -55,6 +55,15 @@ class CommandQueue
      */
     uint64_t getCompletedValue() const;
 
+    /*
+     * Gets the value the next signal will set the fence to.
+     * Everything submitted before that signal is done once the fence reaches it, so work that
+     * only has to wait for what's already submitted can use it without signaling on its own.
+     *
+     * @return The next fence value.
+     */
+    uint64_t getNextValue() const;
+
   public: // Public methods
     /*
      * Closes and executes the given command lists.
@@ -85,7 +94,7 @@ class CommandQueue
   private: // Private variables
     wrl::ComPtr<ID3D12CommandQueue> m_commandQueue;
     wrl::ComPtr<ID3D12Fence>        m_fence;
-    uint64_t                        m_fenceValue = 0u;
+    std::atomic<uint64_t>           m_fenceValue = 0u; // read by getNextValue from any thread
 };
 
 } // namespace bisky::gfx
\ No newline at end of file
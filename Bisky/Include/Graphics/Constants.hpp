@@ -24,12 +24,16 @@ struct SceneBuffer
 
 /*
  * This holds values that change per object.
+ * Every object drawn in a frame is packed into one structured buffer, indexed by RenderResource::objectIndex.
  */
 struct ObjectBuffer
 {
     dx::XMFLOAT4X4 world;
-    dx::XMFLOAT4X4 inverseWorld;
     dx::XMFLOAT4X4 transposeInverseWorld;
+    dx::XMFLOAT3   positionMin;  // packed positions decode to positionMin + position * positionScale
+    uint32_t       vertexFormat; // a scene::VertexFormat
+    dx::XMFLOAT3   positionScale;
+    float          padding;
 };
 
 struct LightBuffer
@@ -52,11 +56,12 @@ struct MaterialInfo
  */
 struct RenderResource
 {
-    int32_t vertexBufferIndex             = -1;
-    int32_t sceneBufferIndex              = -1;
-    int32_t diffuseTextureIndex           = -1;
-    int32_t metallicRoughnessTextureIndex = -1;
-    int32_t normalTextureIndex            = -1;
+    int32_t  vertexBufferIndex             = -1;
+    int32_t  sceneBufferIndex              = -1;
+    int32_t  diffuseTextureIndex           = -1;
+    int32_t  metallicRoughnessTextureIndex = -1;
+    int32_t  normalTextureIndex            = -1;
+    uint32_t objectIndex                   = 0u; // element of the frame's ObjectBuffer array
 };
 
 } // namespace bisky::gfx
\ No newline at end of file
@@ -3,14 +3,18 @@
 #include "Graphics/CommandQueue.hpp"
 #include "Graphics/DescriptorHeap.hpp"
 #include "Graphics/FrameResource.hpp"
+#include "Graphics/GeometryPool.hpp"
+#include "Graphics/MemoryAllocator.hpp"
 #include "Graphics/PipelineState.hpp"
 #include "Graphics/Resources.hpp"
 #include "Graphics/RootSignature.hpp"
 #include "Graphics/Texture.hpp"
+#include "Graphics/UploadManager.hpp"
 
 namespace bisky::gfx
 {
 
+class ResourceUpload;
 class Window;
 
 /*
@@ -45,6 +49,11 @@ class Device
     constexpr static uint32_t FramesInFlight = 3u;
 
   public: // Public methods
+    /*
+     * Transitions the render targets for drawing and frees the uploads and geometry the GPU is done with.
+     *
+     * @param cmdList The command list for the frame.
+     */
     void beginFrame(GraphicsCommandList *const cmdList);
 
     void endFrame(GraphicsCommandList *const cmdList);
@@ -81,6 +90,29 @@ class Device
      */
     void addGraphicsPipelineState(std::string_view name, const GraphicsPipelineStateDesc &gfxDesc);
 
+    /*
+     * Adds a list of graphics pipeline states.
+     * Every shader stage is compiled concurrently on the job system before the pipeline states are created.
+     *
+     * @param names The names to set, one per description.
+     * @param gfxDescs The pipeline state descriptions.
+     */
+    void addGraphicsPipelineStates(
+        std::span<const std::string_view> names, std::span<const GraphicsPipelineStateDesc> gfxDescs
+    );
+
+    /*
+     * Starts collecting pipeline states.
+     * Until endPipelineStateBatch() is called, addGraphicsPipelineState() copies the description
+     * instead of creating the pipeline state immediately.
+     */
+    void beginPipelineStateBatch();
+
+    /*
+     * Creates every pipeline state collected since beginPipelineStateBatch() in one batch.
+     */
+    void endPipelineStateBatch();
+
     /*
      * Adds a new root signature from the given root parameters.
      *
@@ -100,7 +132,17 @@ class Device
      * @param dataSize Optional size of the initial data.
      * @return An allocated upload buffer.
      */
-    std::unique_ptr<Buffer> createUploadBuffer(uint32_t size, void *data = nullptr, uint32_t dataSize = 0u);
+    std::unique_ptr<Buffer> createUploadBuffer(uint32_t size, const void *data = nullptr, uint32_t dataSize = 0u);
+
+    /*
+     * Creates a buffer in the default heap, which only the GPU can access.
+     * It starts in the common state.
+     *
+     * @param size Size of the buffer to allocate.
+     * @param flags The flags for the buffer.
+     * @return An allocated buffer.
+     */
+    std::unique_ptr<Buffer> createBuffer(uint32_t size, D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE);
 
     /*
      * Creates an allocated texture2D with the given parameters.
@@ -109,15 +151,54 @@ class Device
      * @param height The height of the texture.
      * @param format The format of the texture.
      * @param flags The flags for the texture.
+     * @param mipLevels The number of mip levels.
      * @return An allocated texture.
      */
     std::unique_ptr<Texture> createTexture2D(
-        uint32_t width, uint32_t height, DXGI_FORMAT format, D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE
+        uint32_t width, uint32_t height, DXGI_FORMAT format, D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE,
+        uint32_t mipLevels = 1u
+    );
+
+    /*
+     * Uploads every mip level of a texture and waits for the copy to finish.
+     *
+     * @param data The mip levels from the largest down, each with tightly packed rows.
+     * @param imageData The dimensions and format of the data.
+     * @param texture The texture to copy to.
+     */
+    void copyToTexture(const unsigned char *data, const ImageData &imageData, Texture *const texture);
+
+    /*
+     * Records the upload of every mip level of a texture into an upload block.
+     * The mip levels are staged in the upload block's staging memory.
+     *
+     * @param data The mip levels from the largest down, each with tightly packed rows.
+     * @param imageData The dimensions and format of the data.
+     * @param texture The texture to copy to.
+     * @param upload The upload block to record into.
+     */
+    void copyToTexture(
+        const unsigned char *data, const ImageData &imageData, Texture *const texture, ResourceUpload &upload
     );
 
-    void copyToTexture(unsigned char *data, const ImageData &imageData, Texture *const texture);
+    std::shared_ptr<Texture> createImageFromMemory(const unsigned char *data, size_t dataSize);
 
-    std::shared_ptr<Texture> createImageFromMemory(unsigned char *data, size_t dataSize);
+    /*
+     * Creates a texture from already decoded pixels or blocks.
+     *
+     * @param pixels Every mip level from the largest down, each with tightly packed rows.
+     * @param imageData The dimensions, format and mip levels of the pixels.
+     * @return The texture with a shader resource view.
+     */
+    std::shared_ptr<Texture> createImageFromPixels(const unsigned char *pixels, const ImageData &imageData);
+
+    /*
+     * Same as above, but records the copy into an upload block instead of waiting on its own.
+     * The texture can't be sampled until the upload block has finished.
+     */
+    std::shared_ptr<Texture> createImageFromPixels(
+        const unsigned char *pixels, const ImageData &imageData, ResourceUpload &upload
+    );
 
     /*
      * Creates a shader resource view with the given buffer and description.
@@ -155,6 +236,27 @@ class Device
      */
     CommandQueue *const getDirectCommandQueue() const;
 
+    /*
+     * Gets the upload manager that owns the staging ring.
+     *
+     * @return An unmodifiable pointer to the upload manager.
+     */
+    UploadManager *const getUploadManager() const;
+
+    /*
+     * Gets the geometry pool every static mesh is sub-allocated from.
+     *
+     * @return An unmodifiable pointer to the geometry pool.
+     */
+    GeometryPool *const getGeometryPool() const;
+
+    /*
+     * Gets the allocator every buffer and texture is placed with.
+     *
+     * @return An unmodifiable pointer to the memory allocator.
+     */
+    MemoryAllocator *const getMemoryAllocator() const;
+
     /*
      * Gets the swap chain.
      *
@@ -268,23 +370,35 @@ class Device
 
   private: // Private methods
     void initDevice();
+    void initMemoryAllocator();
     void initDescriptorHeaps();
     void initFactory();
     void initCommandQueue();
     void initSwapChain(Window *window);
     void initFrameResources();
+    void initUploadManager();
+    void initGeometryPool();
 
   private: // Private variables
     wrl::ComPtr<ID3D12Device10>  m_device;
     wrl::ComPtr<IDXGIFactory7>   m_factory;
     wrl::ComPtr<IDXGISwapChain4> m_swapChain;
 
+    // heaps every buffer and texture is placed in
+    std::unique_ptr<MemoryAllocator> m_memoryAllocator;
+
     D3D12_VIEWPORT m_viewport;
     D3D12_RECT     m_scissor;
 
     // command queues
     std::unique_ptr<CommandQueue> m_directCommandQueue;
 
+    // staging memory for uploads
+    std::unique_ptr<UploadManager> m_uploadManager;
+
+    // vertex and index buffers shared by every static mesh
+    std::unique_ptr<GeometryPool> m_geometryPool;
+
     // heaps
     std::unique_ptr<DescriptorHeap> m_rtvHeap;
     std::unique_ptr<DescriptorHeap> m_dsvHeap;
@@ -313,6 +427,17 @@ class Device
 
     std::unordered_map<std::string_view, std::unique_ptr<RootSignature>> m_rootSignatures;
     std::unordered_map<std::string_view, std::unique_ptr<PipelineState>> m_pipelineStates;
+
+    // pipeline states waiting for endPipelineStateBatch()
+    struct PendingPipelineState
+    {
+        std::string_view          name;
+        GraphicsPipelineStateDesc desc;
+        std::vector<DXGI_FORMAT>  rtvFormats;
+    };
+
+    std::vector<PendingPipelineState> m_pendingPipelineStates;
+    bool                              m_batchingPipelineStates = false;
 };
 
 } // namespace bisky::gfx
\ No newline at end of file
@@ -0,0 +1,113 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace bisky::gfx
+{
+
+/*
+ * A piece of a page handed out by FrameArena::allocate.
+ */
+struct ArenaRegion
+{
+    uint32_t page;   // index of the page the region is in
+    uint64_t offset; // offset of the region from the start of the page
+};
+
+/*
+ * How one frame used the arena.
+ */
+struct ArenaFrameStats
+{
+    uint64_t usedBytes;   // bytes asked for
+    uint64_t wastedBytes; // padding for alignment and space skipped at the end of pages
+    uint32_t pageCount;   // pages the frame touched
+};
+
+/*
+ * The bookkeeping of a per-frame linear arena made of pages, without the memory itself.
+ *
+ * Allocations bump through the base page and chain onto overflow pages once it runs out, so a busy
+ * frame never runs off the end of its memory. Each overflow page is twice the size of the last.
+ * Every reset records how much the frame went through. If a recent frame needed more than the
+ * base page, the base page grows to fit it with a quarter to spare and the overflow pages are
+ * dropped. If every frame of a full history used less than a quarter of it, the base page
+ * shrinks to twice what they used.
+ *
+ * Nothing here touches D3D12, the owner creates a buffer for every page and recreates them when
+ * their sizes change, so the paging can be driven without a device.
+ */
+class FrameArena
+{
+  public:
+    /*
+     * @param baseSize The starting size of the base page in bytes.
+     * @param minimumSize The base page never shrinks below this.
+     */
+    explicit FrameArena(uint64_t baseSize, uint64_t minimumSize = PageGranularity);
+
+  public: // Static variables
+    constexpr static uint64_t PageGranularity = 64ull * 1024ull;
+    constexpr static uint32_t HistoryLength   = 64u;
+
+  public: // Public methods
+    /*
+     * Allocates a region, moving on to the next page if it doesn't fit in the current one.
+     * Adds a page if there is no next page, the owner must create its memory before using the region.
+     *
+     * @param size The size in bytes, rounded up to the alignment.
+     * @param alignment The alignment of the offset, a power of two no bigger than PageGranularity.
+     * @return The region.
+     */
+    ArenaRegion allocate(uint64_t size, uint64_t alignment);
+
+    /*
+     * Records the frame and frees every allocation.
+     * May resize the base page and drop the overflow pages, the owner must match its memory to the
+     * page sizes afterwards.
+     */
+    void reset();
+
+  public: // Getter methods
+    uint32_t getPageCount() const;
+    uint64_t getPageSize(uint32_t page) const;
+    uint64_t getBaseSize() const;
+
+    /*
+     * Gets the most any frame in the history went through.
+     *
+     * @return The used and wasted bytes of the busiest recent frame.
+     */
+    uint64_t getHighWater() const;
+
+    /*
+     * Gets how the frame since the last reset used the arena so far.
+     *
+     * @return The stats.
+     */
+    const ArenaFrameStats &getFrameStats() const;
+
+    /*
+     * Gets how the frame before the last reset used the arena.
+     *
+     * @return The stats.
+     */
+    const ArenaFrameStats &getLastFrameStats() const;
+
+  private: // Private variables
+    std::vector<uint64_t> m_pageSizes;
+    uint64_t              m_minimumSize;
+    uint32_t              m_page = 0u; // page allocations are bumping through
+    uint64_t              m_at   = 0u; // offset of the next allocation in that page
+
+    ArenaFrameStats m_frame     = {};
+    ArenaFrameStats m_lastFrame = {};
+
+    std::array<uint64_t, HistoryLength> m_history      = {}; // bytes each recent frame went through
+    uint32_t                            m_historyIndex = 0u;
+    uint32_t                            m_historyCount = 0u;
+};
+
+} // namespace bisky::gfx
\ No newline at end of file
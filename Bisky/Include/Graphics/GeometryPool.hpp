@@ -0,0 +1,157 @@
+#pragma once
+
+#include "Common.hpp"
+#include "Graphics/OffsetAllocator.hpp"
+#include "Graphics/Resources.hpp"
+
+namespace bisky::gfx
+{
+
+class CommandQueue;
+class Device;
+class ResourceUpload;
+struct Buffer;
+
+/*
+ * Where a mesh's vertices or indices live in the geometry pool.
+ */
+struct GeometryRange
+{
+    Buffer  *buffer = nullptr; // the pool buffer
+    uint64_t offset = 0u;      // in bytes
+    uint64_t size   = 0u;      // in bytes
+};
+
+/*
+ * How full and how fragmented each pool buffer is.
+ */
+struct GeometryPoolStats
+{
+    OffsetAllocatorStats vertices;
+    OffsetAllocatorStats indices16;
+    OffsetAllocatorStats indices32;
+};
+
+/*
+ * Sub-allocates the geometry of every static mesh from a few large default heap buffers.
+ *
+ * Vertices of every stride share one buffer, each mesh starts on a multiple of its stride so a
+ * structured buffer view can start there. Indices go in one buffer per index format, so a single
+ * index buffer view serves every mesh and draws only carry the offset of their first index.
+ */
+class GeometryPool
+{
+  public:
+    /*
+     * Creates the pool buffers.
+     *
+     * @param device The device to create the buffers with.
+     * @param vertexCapacity The size of the vertex buffer in bytes.
+     * @param indexCapacity The size of each index buffer in bytes.
+     */
+    GeometryPool(
+        Device *const device, uint32_t vertexCapacity = DefaultVertexCapacity,
+        uint32_t indexCapacity = DefaultIndexCapacity
+    );
+    ~GeometryPool();
+
+    GeometryPool(const GeometryPool &)                    = delete;
+    const GeometryPool &operator=(const GeometryPool &)   = delete;
+    GeometryPool(const GeometryPool &&)                   = delete;
+    const GeometryPool &&operator=(const GeometryPool &&) = delete;
+
+  public: // Static variables
+    constexpr static uint32_t DefaultVertexCapacity = 128u << 20;
+    constexpr static uint32_t DefaultIndexCapacity  = 32u << 20;
+
+  public: // Public methods
+    /*
+     * Allocates room for vertices and records the copy of them.
+     *
+     * @param data The vertices.
+     * @param count The number of vertices.
+     * @param stride The size of one vertex.
+     * @param upload The upload block to record into.
+     * @param range Filled with where the vertices live.
+     * @return False if the pool is full.
+     */
+    bool addVertices(const void *data, uint32_t count, uint32_t stride, ResourceUpload &upload, GeometryRange &range);
+
+    /*
+     * Allocates room for indices and records the copy of them.
+     *
+     * @param data The indices.
+     * @param count The number of indices.
+     * @param format Either DXGI_FORMAT_R16_UINT or DXGI_FORMAT_R32_UINT.
+     * @param upload The upload block to record into.
+     * @param range Filled with where the indices live.
+     * @return False if the pool is full.
+     */
+    bool addIndices(const void *data, uint32_t count, DXGI_FORMAT format, ResourceUpload &upload, GeometryRange &range);
+
+    /*
+     * Frees a range once the GPU has finished everything submitted so far.
+     * The range waits for the next fence signal, it doesn't signal on its own.
+     *
+     * @param range The range to free.
+     */
+    void free(const GeometryRange &range);
+
+    /*
+     * Frees the ranges the GPU is done with.
+     * This should be called once at the start of each frame.
+     */
+    void retire();
+
+  public: // Getter methods
+    /*
+     * Gets the view of the whole index buffer for a format.
+     *
+     * @param format Either DXGI_FORMAT_R16_UINT or DXGI_FORMAT_R32_UINT.
+     * @return The index buffer view.
+     */
+    IndexBufferView getIndexBufferView(DXGI_FORMAT format) const;
+
+    Buffer *const getVertexBuffer() const;
+
+    /*
+     * Gets how full and how fragmented the pool buffers are.
+     *
+     * @return The stats of every pool buffer.
+     */
+    GeometryPoolStats getStats() const;
+
+  private: // Private types
+    struct Pool
+    {
+        std::unique_ptr<Buffer> buffer;
+        OffsetAllocator         allocator;
+    };
+
+  private: // Private methods
+    /*
+     * Allocates from a pool, stages the data and records the copy.
+     */
+    bool add(
+        Pool &pool, const void *data, uint64_t size, uint64_t alignment, ResourceUpload &upload, GeometryRange &range
+    );
+
+    Pool &getPool(const Buffer *const buffer);
+
+  private: // Private variables
+    CommandQueue *m_queue;
+    Pool          m_vertices;
+    Pool          m_indices16;
+    Pool          m_indices32;
+
+    // ranges waiting for the GPU before they can be reused
+    struct PendingFree
+    {
+        uint64_t      fenceValue;
+        GeometryRange range;
+    };
+
+    std::deque<PendingFree> m_pendingFrees;
+};
+
+} // namespace bisky::gfx
\ No newline at end of file
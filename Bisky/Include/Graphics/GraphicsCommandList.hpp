@@ -88,7 +88,28 @@ class GraphicsCommandList : public CommandList
      */
     void copyBufferRegion(Buffer *const src, Buffer *const dst, size_t bufferSize);
 
-    void copyTextureRegion(Buffer *const src, Texture *const dst, const ImageData &imageData);
+    /*
+     * Copies a region of src starting at srcOffset to dst starting at dstOffset.
+     *
+     * @param src The source buffer to copy
+     * @param srcOffset The offset of the data in src
+     * @param dst The buffer to copy into
+     * @param dstOffset The offset to copy to in dst
+     * @param size The size of the data to copy
+     */
+    void copyBufferRegion(Buffer *const src, uint64_t srcOffset, Buffer *const dst, uint64_t dstOffset, size_t size);
+
+    /*
+     * Copies one subresource of a texture from a buffer.
+     *
+     * @param src The buffer to copy from.
+     * @param dst The texture to copy into.
+     * @param footprint Where the subresource is in src and how its rows are laid out.
+     * @param subresource The index of the subresource in dst.
+     */
+    void copyTextureRegion(
+        Buffer *const src, Texture *const dst, const D3D12_PLACED_SUBRESOURCE_FOOTPRINT &footprint, uint32_t subresource
+    );
 
     /*
      * Sets the descriptor heaps.
@@ -151,6 +172,14 @@ class GraphicsCommandList : public CommandList
      */
     void setConstantBufferView(uint32_t index, D3D12_GPU_VIRTUAL_ADDRESS handle);
 
+    /*
+     * Passes a buffer to the shader as a root shader resource view.
+     *
+     * @param index The index of the root parameter.
+     * @param handle The GPU address of the start of the buffer.
+     */
+    void setShaderResourceView(uint32_t index, D3D12_GPU_VIRTUAL_ADDRESS handle);
+
     /*
      * Passes 32-bit constants to the shader.
      *
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "Common.hpp"
+#include "Graphics/TlsfAllocator.hpp"
+
+namespace bisky::gfx
+{
+
+class CommandQueue;
+class MemoryAllocator;
+
+/*
+ * Where a placed resource lives, handed out by MemoryAllocator::createResource.
+ */
+struct MemoryAllocation
+{
+    MemoryAllocator *allocator = nullptr; // null if the resource doesn't own its memory
+    uint32_t         pool      = 0u;
+    uint32_t         heap      = 0u;
+    TlsfAllocation   block     = {};
+};
+
+/*
+ * The memory of every heap of one heap type.
+ */
+struct MemoryStats
+{
+    uint64_t reservedBytes    = 0u; // size of every heap created
+    uint64_t usedBytes        = 0u; // bytes handed out to resources, including alignment padding
+    uint64_t largestFreeBlock = 0u;
+    uint32_t heapCount        = 0u;
+    uint32_t allocationCount  = 0u;
+};
+
+/*
+ * Places resources in a few big heaps instead of giving every resource a heap of its own.
+ *
+ * Resources are sorted into pools of buffers, textures and render targets, since resource heap
+ * tier 1 hardware can't mix them in one heap. Each pool reserves heaps of the same size and
+ * hands out blocks of them with a TlsfAllocator. Small textures take the 4 KB alignment when the
+ * driver allows it, everything else takes the 64 KB default, or 4 MB for multisampled targets.
+ * Resources bigger than half a heap get a heap of their own, which is released with them.
+ *
+ * Frames in flight may still use a resource after it's destroyed, so freeing it holds on to the
+ * resource and its memory until the direct queue's fence passes everything submitted so far.
+ */
+class MemoryAllocator
+{
+  public:
+    /*
+     * @param device The device to create heaps with.
+     * @param queue The queue whose fence frees wait for.
+     * @param heapSize The size of the heaps resources are placed in.
+     */
+    MemoryAllocator(ID3D12Device10 *device, CommandQueue *queue, uint64_t heapSize = DefaultHeapSize);
+
+    MemoryAllocator(const MemoryAllocator &)                    = delete;
+    const MemoryAllocator &operator=(const MemoryAllocator &)   = delete;
+    MemoryAllocator(const MemoryAllocator &&)                   = delete;
+    const MemoryAllocator &&operator=(const MemoryAllocator &&) = delete;
+
+  public: // Static variables
+    constexpr static uint64_t DefaultHeapSize = 64ull * 1024ull * 1024ull;
+    constexpr static uint32_t InvalidHeap     = ~0u;
+
+  public: // Public methods
+    /*
+     * Creates a placed resource.
+     *
+     * @param heapType The heap type to place the resource in, default or upload.
+     * @param desc The description of the resource, the alignment is picked here.
+     * @param state The initial state of the resource.
+     * @param clearValue The optimized clear value of render targets and depth buffers, or null.
+     * @param allocation Filled with where the resource was placed, free it together with the resource.
+     * @param resource Filled with the resource.
+     * @return False if the memory or the resource couldn't be created.
+     */
+    bool createResource(
+        D3D12_HEAP_TYPE heapType, const D3D12_RESOURCE_DESC &desc, D3D12_RESOURCE_STATES state,
+        const D3D12_CLEAR_VALUE *clearValue, MemoryAllocation &allocation, wrl::ComPtr<ID3D12Resource> &resource
+    );
+
+    /*
+     * Releases a resource and frees its memory once the GPU has finished everything submitted so far.
+     * The memory waits for the next fence signal, it doesn't signal on its own.
+     *
+     * @param allocation The memory to free, reset so it isn't freed twice.
+     * @param resource The resource placed in the memory, kept alive until then.
+     */
+    void free(MemoryAllocation &allocation, wrl::ComPtr<ID3D12Resource> resource);
+
+    /*
+     * Frees the memory the GPU is done with.
+     * This should be called once at the start of each frame.
+     */
+    void retire();
+
+  public: // Getter methods
+    /*
+     * Gets the memory of every heap of one heap type.
+     *
+     * @param heapType The heap type, default or upload.
+     * @return The stats.
+     */
+    MemoryStats getStats(D3D12_HEAP_TYPE heapType) const;
+
+  private: // Private types
+    enum PoolType : uint32_t
+    {
+        UploadBuffers,
+        Buffers,
+        Textures,
+        RenderTargets,
+        PoolCount,
+    };
+
+    struct Heap
+    {
+        wrl::ComPtr<ID3D12Heap> heap;
+        TlsfAllocator           allocator;
+        bool                    dedicated;
+    };
+
+    struct Pool
+    {
+        D3D12_HEAP_TYPE   type;
+        D3D12_HEAP_FLAGS  flags;
+        uint64_t          alignment;
+        std::vector<Heap> heaps;
+    };
+
+  private: // Private methods
+    /*
+     * Picks the pool a resource is placed in.
+     */
+    PoolType getPoolType(D3D12_HEAP_TYPE heapType, const D3D12_RESOURCE_DESC &desc) const;
+
+    /*
+     * Creates a heap in a pool, reusing the slot of a released dedicated heap if there is one.
+     *
+     * @return The index of the heap in the pool, or InvalidHeap if it couldn't be created.
+     */
+    uint32_t createHeap(Pool &pool, uint64_t size, bool dedicated);
+
+    /*
+     * Frees the memory of every pending free the fence has passed, the mutex must be locked.
+     */
+    void freeCompleted();
+
+  private: // Private variables
+    ID3D12Device10             *m_device;
+    CommandQueue               *m_queue;
+    std::array<Pool, PoolCount> m_pools;
+    uint64_t                    m_heapSize;
+    mutable std::mutex          m_mutex;
+
+    // resources and their memory waiting for the GPU, in the order they were freed
+    struct PendingFree
+    {
+        uint64_t                    fenceValue;
+        MemoryAllocation            allocation;
+        wrl::ComPtr<ID3D12Resource> resource;
+    };
+
+    std::deque<PendingFree> m_pendingFrees;
+};
+
+} // namespace bisky::gfx
\ No newline at end of file
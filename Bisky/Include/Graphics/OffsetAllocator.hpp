@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+
+namespace bisky::gfx
+{
+
+/*
+ * A range handed out by OffsetAllocator::allocate.
+ */
+struct OffsetAllocation
+{
+    uint64_t offset; // aligned start of the range
+    uint64_t size;   // size of the range, give both back to free it
+};
+
+/*
+ * How fragmented the free space of an OffsetAllocator is.
+ */
+struct OffsetAllocatorStats
+{
+    uint64_t capacity;
+    uint64_t freeBytes;
+    uint64_t largestFreeRange;
+    uint32_t freeRangeCount;
+    uint32_t allocationCount;
+
+    /*
+     * Gets how much of the free space can't be used by one allocation.
+     * 0 means every free byte is in one range, close to 1 means it's split into many small ones.
+     *
+     * @return The fragmentation from 0 to 1.
+     */
+    float getFragmentation() const;
+};
+
+/*
+ * Hands out ranges of a fixed size space, like a big buffer, by offset.
+ *
+ * Free ranges are kept by offset, to merge a freed range with its neighbours, and by size, to
+ * find the smallest range an allocation fits in. Best fit keeps the big ranges intact for big
+ * meshes. Both lookups are logarithmic in the number of free ranges.
+ *
+ * The allocator only does the bookkeeping, so it can be used and tested without a device.
+ */
+class OffsetAllocator
+{
+  public:
+    /*
+     * @param capacity The size of the space to hand out.
+     */
+    explicit OffsetAllocator(uint64_t capacity);
+
+  public:
+    /*
+     * Allocates a range.
+     * Space skipped to align the range stays free.
+     *
+     * @param size The size of the range.
+     * @param alignment The alignment of the offset, doesn't have to be a power of two.
+     * @param allocation Filled with the range on success.
+     * @return False if no free range fits.
+     */
+    bool allocate(uint64_t size, uint64_t alignment, OffsetAllocation &allocation);
+
+    /*
+     * Frees a range and merges it with the free ranges on either side.
+     *
+     * @param allocation The range to free.
+     */
+    void free(const OffsetAllocation &allocation);
+
+  public:
+    /*
+     * Gets the free space and how it is split up.
+     *
+     * @return The stats.
+     */
+    OffsetAllocatorStats getStats() const;
+
+  private:
+    /*
+     * Adds a free range to both lookups.
+     */
+    void insertFreeRange(uint64_t offset, uint64_t size);
+
+    /*
+     * Removes a free range from both lookups.
+     */
+    void eraseFreeRange(std::map<uint64_t, uint64_t>::iterator range);
+
+  private:
+    std::map<uint64_t, uint64_t>      m_freeByOffset; // offset -> size
+    std::multimap<uint64_t, uint64_t> m_freeBySize;   // size -> offset
+    uint64_t                          m_capacity;
+    uint64_t                          m_freeBytes;
+    uint32_t                          m_allocationCount = 0u;
+};
+
+} // namespace bisky::gfx
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "Common.hpp"
+#include "Graphics/Buffer.hpp"
+#include "Graphics/StreamingStore.hpp"
+
+namespace bisky::gfx
+{
+
+class Device;
+
+/*
+ * An upload buffer that stays mapped for as long as it lives, for data the CPU rewrites in place
+ * from frame to frame instead of allocating it again every frame.
+ *
+ * Like Allocation, the mapped memory is write-combined, so it can only be written through write(),
+ * which streams data built in regular memory. There's no pointer to it to read from by accident.
+ */
+class PersistentBuffer
+{
+  public:
+    /*
+     * Creates the buffer and maps it.
+     *
+     * @param device The device to create the buffer with.
+     * @param size The size of the buffer in bytes.
+     */
+    PersistentBuffer(Device *const device, uint32_t size);
+
+    /*
+     * Unmaps the buffer, the buffer itself is released once the GPU is done with it.
+     */
+    ~PersistentBuffer();
+
+    PersistentBuffer(const PersistentBuffer &)                    = delete;
+    const PersistentBuffer &operator=(const PersistentBuffer &)   = delete;
+    PersistentBuffer(const PersistentBuffer &&)                   = delete;
+    const PersistentBuffer &&operator=(const PersistentBuffer &&) = delete;
+
+  public: // Public methods
+    /*
+     * Streams a value into the buffer.
+     * StreamingStore::fence must run before the GPU reads it, Application does so once a frame.
+     *
+     * @param index Where to write it, in multiples of the value's size, which must keep it 16-byte aligned.
+     * @param value The value, built in regular memory.
+     */
+    template <typename T> void write(size_t index, const T &value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+        assert((index + 1u) * sizeof(T) <= m_size);
+        StreamingStore::copy(m_cpuBase + index * sizeof(T), &value, sizeof(T));
+    }
+
+  public: // Getter methods
+    D3D12_GPU_VIRTUAL_ADDRESS getGpuAddress() const;
+    uint32_t                  getSize() const;
+
+  private: // Private variables
+    std::unique_ptr<Buffer> m_buffer;
+    uint8_t                *m_cpuBase; // mapped data, write-combined
+    uint32_t                m_size;
+};
+
+} // namespace bisky::gfx
\ No newline at end of file
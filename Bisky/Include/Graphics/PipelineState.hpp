@@ -13,7 +13,26 @@ namespace bisky::gfx
 class PipelineState
 {
   public:
+    /*
+     * Compiles the shaders in the description and creates the pipeline state.
+     *
+     * @param device The device to create the pipeline state with.
+     * @param gfxD The pipeline state description.
+     */
     explicit PipelineState(ID3D12Device10 *const device, const GraphicsPipelineStateDesc &gfxD);
+
+    /*
+     * Creates the pipeline state from already compiled shaders.
+     *
+     * @param device The device to create the pipeline state with.
+     * @param gfxD The pipeline state description, the shader modules are ignored.
+     * @param vs The compiled vertex shader.
+     * @param ps The compiled pixel shader.
+     */
+    explicit PipelineState(
+        ID3D12Device10 *const device, const GraphicsPipelineStateDesc &gfxD, IDxcBlob *const vs, IDxcBlob *const ps
+    );
+
     ~PipelineState();
 
     PipelineState(const PipelineState &)                    = delete;
@@ -27,6 +46,10 @@ class PipelineState
   private:
     explicit PipelineState() = default;
 
+    void init(
+        ID3D12Device10 *const device, const GraphicsPipelineStateDesc &gfxD, IDxcBlob *const vs, IDxcBlob *const ps
+    );
+
     wrl::ComPtr<ID3D12PipelineState> m_pipelineState;
 };
 
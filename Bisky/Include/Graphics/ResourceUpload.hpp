@@ -1,20 +1,49 @@
 #pragma once
 
 #include <d3d12.h>
-#include <future>
+#include <memory>
+#include <vector>
 
 namespace bisky::gfx
 {
 
+class CommandQueue;
 class Device;
 class GraphicsCommandList;
+struct Buffer;
+
+/*
+ * A handle to the copies submitted by ResourceUpload::Finish.
+ * Work submitted to the same queue afterwards sees the copies, wait on it to use them anywhere else.
+ */
+struct UploadTicket
+{
+    CommandQueue *queue      = nullptr;
+    uint64_t      fenceValue = 0u;
+
+    /*
+     * Blocks until the GPU has finished the copies.
+     */
+    void wait() const;
+};
+
+/*
+ * Staging memory to write upload data to.
+ */
+struct StagingAllocation
+{
+    Buffer   *buffer;    // the upload buffer the memory lives in
+    uint8_t *cpuAddress; // mapped memory to write to
+    uint64_t offset;     // offset of the memory in the buffer
+    uint64_t sequence;   // the region of the staging ring, unused for a buffer of its own
+};
 
 /*
  * A wrapper over a command list that is immediately submitted.
  *
  * User should create and call Begin to start an upload pass.
  * Once they are done with all the commands they want to submit,
- * call Finish, which returns an std::future<void> that the user
+ * call Finish, which returns an UploadTicket that the user
  * can wait on.
  */
 class ResourceUpload
@@ -29,8 +58,33 @@ class ResourceUpload
     const ResourceUpload &&operator=(const ResourceUpload &&) = delete;
 
   public:
-    void              Begin();
-    std::future<void> Finish();
+    void Begin();
+
+    /*
+     * Submits the recorded commands without waiting for them.
+     * The staging memory and the command list are handed to the device's upload manager, which
+     * frees them once the GPU is done, so the upload block can be destroyed or begun again right away.
+     *
+     * @return A ticket for the submitted copies.
+     */
+    UploadTicket Finish();
+
+    /*
+     * Allocates staging memory from the device's staging ring.
+     * Uploads too big for the ring get an upload buffer of their own.
+     *
+     * @param size The size in bytes.
+     * @param alignment The alignment of the offset, a power of two.
+     * @return The staging memory, valid until Finish.
+     */
+    StagingAllocation allocate(uint64_t size, uint64_t alignment = D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT);
+
+    /*
+     * Keeps a staging buffer alive until the upload has finished.
+     *
+     * @param buffer The buffer the recorded copies read from.
+     */
+    void addUploadBuffer(std::unique_ptr<Buffer> buffer);
 
   public:
     GraphicsCommandList *const getCommandList() const;
@@ -38,6 +92,8 @@ class ResourceUpload
   private:
     Device                              &m_device;
     std::unique_ptr<GraphicsCommandList> m_graphicsCommandList;
+    std::vector<std::unique_ptr<Buffer>> m_uploadBuffers;
+    std::vector<uint64_t>                m_regions; // staging ring regions the recorded copies read from
 };
 
 } // namespace bisky::gfx
\ No newline at end of file
@@ -2,6 +2,11 @@
 
 #include "Common.hpp"
 
+namespace bisky::core
+{
+class JobSystem;
+}
+
 namespace bisky::gfx
 {
 
@@ -14,12 +19,47 @@ enum class ShaderType
     Geometry,
 };
 
+/*
+ * A single shader stage to compile as part of a batch.
+ */
+struct ShaderCompileJob
+{
+    ShaderType            shaderType;
+    std::filesystem::path filename;
+    std::wstring          entryPoint;
+    wrl::ComPtr<IDxcBlob> resultBlob;
+    wrl::ComPtr<IDxcBlob> errorBlob;
+    bool                  succeeded = false;
+};
+
 namespace ShaderCompiler
 {
 
+/*
+ * Compiles a shader stage, or loads it from the derived data cache.
+ * Every thread uses its own DXC instances, so this can be called concurrently.
+ */
 bool compile(const ShaderType &shaderType, const std::filesystem::path &filename, const std::wstring_view entryPoint,
              wrl::ComPtr<IDxcBlob> &resultBlob, wrl::ComPtr<IDxcBlob> &errorBlob);
 
-}
+/*
+ * Compiles every job on the given job system and waits for them to finish.
+ * Errors are logged for the jobs that fail.
+ *
+ * @param jobs The shader stages to compile.
+ * @param jobSystem The job system to run on, the calling thread helps while it waits.
+ * @return True if every job compiled successfully.
+ */
+bool compileBatch(std::span<ShaderCompileJob> jobs, core::JobSystem &jobSystem);
+
+/*
+ * Sets whether compiled shaders are read from and written to the derived data cache.
+ * Disabling it is mostly useful for measuring compile times.
+ *
+ * @param enabled True to use the cache.
+ */
+void setCacheEnabled(bool enabled);
+
+} // namespace ShaderCompiler
 
 } // namespace bisky::gfx
\ No newline at end of file
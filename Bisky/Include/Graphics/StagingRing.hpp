@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+
+namespace bisky::gfx
+{
+
+/*
+ * A piece of the ring handed out by StagingRing::allocate.
+ */
+struct StagingRegion
+{
+    uint64_t offset;   // offset of the region from the start of the ring
+    uint64_t sequence; // identifies the region when submitting or cancelling it
+};
+
+/*
+ * The bookkeeping of a ring of staging memory, without the memory itself.
+ *
+ * Regions are handed out one after another and wrap back to the start once they reach the end.
+ * Every region is tagged with the fence value of the submission that reads it, and is retired
+ * once the fence has passed that value. Regions retire in the order they were allocated, so a
+ * region that hasn't been submitted yet holds back everything after it.
+ *
+ * Nothing here touches D3D12, the owner passes in fence values, so the logic can be driven by a
+ * plain counter standing in for a fence.
+ */
+class StagingRing
+{
+  public:
+    /*
+     * @param capacity The size of the ring in bytes.
+     */
+    explicit StagingRing(uint64_t capacity);
+
+  public:
+    /*
+     * Allocates a region.
+     * A region never straddles the end of the ring, the space left at the end is skipped instead.
+     *
+     * @param size The size of the region in bytes.
+     * @param alignment The alignment of the region's offset, a power of two.
+     * @param region Filled with the region on success.
+     * @return False if the ring doesn't have room until more regions are retired.
+     */
+    bool allocate(uint64_t size, uint64_t alignment, StagingRegion &region);
+
+    /*
+     * Tags a region with the fence value of the submission that reads it.
+     *
+     * @param sequence The region to tag.
+     * @param fenceValue The value the fence reaches once the region has been read.
+     */
+    void submit(uint64_t sequence, uint64_t fenceValue);
+
+    /*
+     * Marks a region that will never be read, so it retires without waiting on a fence.
+     *
+     * @param sequence The region to cancel.
+     */
+    void cancel(uint64_t sequence);
+
+    /*
+     * Frees every region, from the oldest, whose fence value the fence has passed.
+     *
+     * @param completedFenceValue The last value the fence completed.
+     */
+    void retire(uint64_t completedFenceValue);
+
+  public:
+    /*
+     * Gets the fence value to wait for to retire the oldest region.
+     *
+     * @return The fence value, or 0 if the oldest region hasn't been submitted or there are no regions.
+     */
+    uint64_t getOldestFenceValue() const;
+
+    /*
+     * Gets the number of bytes in use, including padding and space skipped at the end of the ring.
+     *
+     * @return The used bytes.
+     */
+    uint64_t getUsedBytes() const;
+
+    uint64_t getCapacity() const;
+
+    /*
+     * Gets the number of regions that haven't been retired yet.
+     *
+     * @return The number of regions.
+     */
+    uint32_t getRegionCount() const;
+
+  private:
+    struct Region
+    {
+        uint64_t end;        // position in the ring just after the region
+        uint64_t fenceValue; // fence value to wait for, if submitted
+        bool     submitted;
+    };
+
+    std::deque<Region> m_regions;
+    uint64_t           m_capacity;
+    uint64_t           m_head          = 0u; // position of the next allocation, only ever grows
+    uint64_t           m_tail          = 0u; // position of the oldest region, only ever grows
+    uint64_t           m_firstSequence = 0u; // sequence of m_regions.front()
+};
+
+} // namespace bisky::gfx
\ No newline at end of file
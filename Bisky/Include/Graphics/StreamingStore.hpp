@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Common.hpp"
+
+namespace bisky::gfx
+{
+
+/*
+ * Writes to write-combined memory, like the mapped pages of upload heaps.
+ *
+ * Write-combined memory isn't cached, so every read of it goes all the way to memory and writes
+ * only go out at full speed when they fill whole 64-byte lines. Data should be built in regular
+ * memory and copied out with these, which write 16 bytes at a time with non-temporal stores and
+ * never read the destination.
+ */
+namespace StreamingStore
+{
+
+/*
+ * Copies to write-combined memory with SSE2 non-temporal stores.
+ *
+ * @param destination Where to copy to, 16-byte aligned.
+ * @param source Where to copy from, in regular memory and aligned or not.
+ * @param size The number of bytes, anything past the last 16 is written with regular stores.
+ */
+void copy(void *destination, const void *source, size_t size);
+
+/*
+ * Makes every streaming store so far visible before anything written after.
+ * Non-temporal stores are weakly ordered, so this has to run before the GPU is told to read them.
+ */
+void fence();
+
+} // namespace StreamingStore
+
+} // namespace bisky::gfx
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include "Common.hpp"
 #include "Graphics/Descriptor.hpp"
+#include "Graphics/MemoryAllocator.hpp"
 
 namespace bisky::gfx
 {
@@ -23,7 +24,8 @@ struct ImageData
     int         width;
     int         height;
     int         channelCount;
-    DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    DXGI_FORMAT format    = DXGI_FORMAT_R8G8B8A8_UNORM;
+    uint32_t    mipLevels = 1u;
 };
 
 /*
@@ -33,11 +35,19 @@ struct Texture
 {
     static int32_t GetSrvIndex(const Texture *const texture);
 
+    /*
+     * Hands the resource and the memory it was placed in to the memory allocator, which releases them
+     * once the GPU is done with them.
+     * Swap chain buffers own no memory of their own.
+     */
+    ~Texture();
+
     wrl::ComPtr<ID3D12Resource> resource;
     gfx::Descriptor             srvDescriptor = {};
     gfx::Descriptor             uavDescriptor = {};
     gfx::Descriptor             rtvDescriptor = {};
     gfx::Descriptor             dsvDescriptor = {};
+    gfx::MemoryAllocation       memory        = {};
 };
 
 } // namespace bisky::gfx
\ No newline at end of file
@@ -0,0 +1,160 @@
+#pragma once
+
+#include <directx/dxgiformat.h>
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace bisky::gfx
+{
+
+/*
+ * What a material samples a texture for, which decides how it's filtered and compressed.
+ */
+enum class TextureRole
+{
+    Diffuse,
+    Normal,
+    MetallicRoughness,
+};
+
+/*
+ * How much time to spend on compression.
+ * Fast picks BC1 or BC3 for diffuse textures, High picks BC7 at twice the size of BC1.
+ */
+enum class TextureQuality
+{
+    Fast,
+    High,
+};
+
+/*
+ * The size of one mip level once encoded, in rows of pixels or rows of 4x4 blocks.
+ */
+struct SurfaceInfo
+{
+    uint32_t rowBytes;
+    uint32_t rowCount;
+};
+
+/*
+ * A texture ready to be uploaded, with every mip level tightly packed from the largest down.
+ */
+struct ProcessedTexture
+{
+    uint32_t             width;
+    uint32_t             height;
+    uint32_t             mipLevels;
+    DXGI_FORMAT          format;
+    std::vector<uint8_t> data;
+};
+
+/*
+ * Turns decoded RGBA8 images into mipmapped, block compressed textures.
+ *
+ * Mips are box filtered four channels at a time with SSE2. Diffuse textures are filtered in linear
+ * space so dark and bright texels are averaged the way light adds up, and normal maps are
+ * renormalized after every level so they don't flatten out in the distance.
+ */
+namespace TextureProcessor
+{
+
+/*
+ * Picks the format for a texture.
+ * Diffuse textures hold sRGB values but use the UNORM formats, since the renderer lights the
+ * values as they are and writes them to a UNORM back buffer.
+ *
+ * @param role What the texture is sampled for.
+ * @param quality How much time to spend on compression.
+ * @param hasAlpha Whether any texel is not fully opaque.
+ * @return The block compressed format.
+ */
+DXGI_FORMAT getFormat(TextureRole role, TextureQuality quality, bool hasAlpha);
+
+/*
+ * Gets a short name for the formats the processor produces, for logging.
+ *
+ * @param format The format of a processed texture.
+ * @return The name of the format.
+ */
+std::string_view getFormatName(DXGI_FORMAT format);
+
+/*
+ * Gets the number of levels in a full mip chain, down to 1x1.
+ *
+ * @param width The width of the largest level.
+ * @param height The height of the largest level.
+ * @return The number of mip levels.
+ */
+uint32_t getMipCount(uint32_t width, uint32_t height);
+
+/*
+ * Gets the layout of one level of a texture.
+ * Only RGBA8 and the BC formats are supported.
+ *
+ * @param format The format of the texture.
+ * @param width The width of the level.
+ * @param height The height of the level.
+ * @return The size of a row and the number of rows.
+ */
+SurfaceInfo getSurfaceInfo(DXGI_FORMAT format, uint32_t width, uint32_t height);
+
+/*
+ * Gets the size of a whole mip chain.
+ *
+ * @param format The format of the texture.
+ * @param width The width of the largest level.
+ * @param height The height of the largest level.
+ * @param mipLevels The number of levels.
+ * @return The size in bytes with every level tightly packed.
+ */
+size_t getTextureSize(DXGI_FORMAT format, uint32_t width, uint32_t height, uint32_t mipLevels);
+
+/*
+ * Generates a full mip chain from RGBA8 pixels.
+ *
+ * @param pixels The pixels of the largest level.
+ * @param width The width of the largest level.
+ * @param height The height of the largest level.
+ * @param role Decides whether to filter in linear space or to renormalize.
+ * @param mips Filled with every level, including a copy of the largest.
+ */
+void generateMips(const uint8_t *pixels, uint32_t width, uint32_t height, TextureRole role, std::vector<uint8_t> &mips);
+
+/*
+ * Block compresses one level of RGBA8 pixels.
+ * Levels smaller than a block are padded by repeating their edge pixels.
+ *
+ * @param pixels The RGBA8 pixels of the level.
+ * @param width The width of the level.
+ * @param height The height of the level.
+ * @param format The BC format to encode to.
+ * @param blocks The level's blocks, getSurfaceInfo decides the size.
+ * @param parallel Encode rows of blocks on the job system.
+ */
+void compress(
+    const uint8_t *pixels, uint32_t width, uint32_t height, DXGI_FORMAT format, uint8_t *blocks, bool parallel = true
+);
+
+/*
+ * Generates mips for an image and compresses every level.
+ * Images that aren't a multiple of 4 texels wide and high can't be block compressed and
+ * keep their mips as RGBA8.
+ *
+ * @param pixels The RGBA8 pixels of the image.
+ * @param width The width of the image.
+ * @param height The height of the image.
+ * @param role What the texture is sampled for.
+ * @param quality How much time to spend on compression.
+ * @param texture The processed texture.
+ * @param parallel Encode on the job system.
+ */
+void process(
+    const uint8_t *pixels, uint32_t width, uint32_t height, TextureRole role, TextureQuality quality,
+    ProcessedTexture &texture, bool parallel = true
+);
+
+} // namespace TextureProcessor
+
+} // namespace bisky::gfx
\ No newline at end of file
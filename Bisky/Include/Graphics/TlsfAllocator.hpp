@@ -0,0 +1,155 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace bisky::gfx
+{
+
+/*
+ * A block handed out by TlsfAllocator::allocate.
+ */
+struct TlsfAllocation
+{
+    uint64_t offset; // aligned start of the block
+    uint64_t size;   // size of the block, may be a little bigger than asked for
+    uint32_t block;  // identifies the block when freeing it
+};
+
+/*
+ * The state of a TlsfAllocator.
+ */
+struct TlsfStats
+{
+    uint64_t capacity;
+    uint64_t usedBytes;
+    uint64_t largestFreeBlock;
+    uint32_t allocationCount;
+    uint32_t freeBlockCount;
+};
+
+/*
+ * A two-level segregated fit allocator for a fixed size space, like a heap.
+ *
+ * Free blocks are sorted into bins by size. The first level splits sizes by powers of two, the
+ * second level splits every power of two into 16 linear steps. A bitmap per level records
+ * which bins have blocks, so finding a block that fits and freeing one are both a handful of bit
+ * scans, no matter how many blocks there are. Freed blocks merge with free neighbours right away.
+ *
+ * Every size and offset is a multiple of the granularity, which keeps blocks too small to ever be
+ * used from piling up between allocations.
+ *
+ * The allocator only does the bookkeeping, so it can be used and tested without a device.
+ */
+class TlsfAllocator
+{
+  public:
+    /*
+     * @param capacity The size of the space to hand out, a multiple of the granularity.
+     * @param granularity The smallest size and alignment of a block, a power of two.
+     */
+    TlsfAllocator(uint64_t capacity, uint64_t granularity);
+
+  public: // Static variables
+    constexpr static uint32_t InvalidBlock     = ~0u;
+    constexpr static uint32_t SecondLevelBits  = 4u;
+    constexpr static uint32_t SecondLevelCount = 1u << SecondLevelBits;
+    constexpr static uint32_t FirstLevelCount  = 64u - SecondLevelBits + 1u;
+
+  public: // Public methods
+    /*
+     * Allocates a block.
+     *
+     * @param size The size of the block, rounded up to the granularity.
+     * @param alignment The alignment of the offset, a power of two.
+     * @param allocation Filled with the block on success.
+     * @return False if no free block fits.
+     */
+    bool allocate(uint64_t size, uint64_t alignment, TlsfAllocation &allocation);
+
+    /*
+     * Frees a block and merges it with the free blocks on either side.
+     *
+     * @param allocation The block to free.
+     */
+    void free(const TlsfAllocation &allocation);
+
+    /*
+     * Checks whether nothing is allocated.
+     *
+     * @return True if the whole space is free.
+     */
+    bool isEmpty() const;
+
+  public: // Getter methods
+    /*
+     * Gets how much is used and how the free space is split up.
+     * Finding the largest free block walks one bin, the rest is kept up to date as blocks change.
+     *
+     * @return The stats.
+     */
+    TlsfStats getStats() const;
+
+  private: // Private types
+    struct Block
+    {
+        uint64_t offset;
+        uint64_t size;
+        uint32_t previousPhysical; // neighbour in the space
+        uint32_t nextPhysical;
+        uint32_t previousFree; // neighbour in the bin's free list
+        uint32_t nextFree;
+        bool     free;
+    };
+
+  private: // Private methods
+    /*
+     * Gets the bin a block is stored in.
+     *
+     * @param units The size of the block in multiples of the granularity.
+     */
+    void getBin(uint64_t units, uint32_t &firstLevel, uint32_t &secondLevel) const;
+
+    /*
+     * Finds a free block of at least the given size.
+     *
+     * @return The block, or InvalidBlock if none is big enough.
+     */
+    uint32_t findFreeBlock(uint64_t size) const;
+
+    void insertFreeBlock(uint32_t block);
+    void removeFreeBlock(uint32_t block);
+
+    /*
+     * Creates a block, reusing the slot of a block that was merged away if there is one.
+     */
+    uint32_t createBlock(uint64_t offset, uint64_t size);
+    void     destroyBlock(uint32_t block);
+
+    /*
+     * Splits the end of a block off into a new free block.
+     */
+    void splitBlock(uint32_t block, uint64_t size);
+
+    /*
+     * Merges a block into the block before it, both must be free.
+     */
+    void mergeBlocks(uint32_t previous, uint32_t block);
+
+  private: // Private variables
+    std::vector<Block>    m_blocks;
+    std::vector<uint32_t> m_unusedBlocks;
+
+    std::array<std::array<uint32_t, SecondLevelCount>, FirstLevelCount> m_freeLists;
+    std::array<uint32_t, FirstLevelCount>                                m_secondLevelBitmaps = {};
+    uint64_t                                                             m_firstLevelBitmap   = 0u;
+
+    uint64_t m_capacity;
+    uint64_t m_granularity;
+    uint64_t m_usedBytes       = 0u;
+    uint32_t m_allocationCount = 0u;
+    uint32_t m_freeBlockCount  = 0u;
+};
+
+} // namespace bisky::gfx
\ No newline at end of file
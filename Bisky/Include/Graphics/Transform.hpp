@@ -5,21 +5,20 @@
 namespace bisky::gfx
 {
 
+class TransformStorage;
+
 /*
  * A basic set of transforms (scaling, rotation, translation).
  *
+ * A handle to one transform in a TransformStorage, which keeps the values and the cached local to
+ * world matrix and its inverse. Copies refer to the same transform.
+ *
  * FIXME: Currently suffers from gimbal lock since using euler angles.
  */
 class Transform
 {
   public:
-    explicit Transform();
-    ~Transform() = default;
-
-    Transform(const Transform &)                    = delete;
-    const Transform &operator=(const Transform &)   = delete;
-    Transform(const Transform &&)                   = delete;
-    const Transform &&operator=(const Transform &&) = delete;
+    explicit Transform(TransformStorage *storage, uint32_t index);
 
   public:
     void setScale(float x, float y, float z);
@@ -27,8 +26,31 @@ class Transform
     void addTranslation(float x, float y, float z);
     void setRotation(float x, float y, float z);
 
+    /*
+     * Checks whether a setter changed the transform since the last call, and forgets it.
+     * The scene uses this to tell the renderer which objects' constants to upload again.
+     *
+     * @return True if the transform changed.
+     */
+    bool takeChanged();
+
   public:
+    /*
+     * Gets the local to world matrix, including every parent, as of the storage's last update.
+     */
     dx::XMMATRIX getLocalToWorld() const;
+
+    /*
+     * Gets the inverse of the local to world matrix.
+     * Built from the inverse scale, transposed rotation and negated translation, so the scale must not be 0.
+     */
+    dx::XMMATRIX getWorldToLocal() const;
+
+    /*
+     * Gets the matrix that takes normals to world space, the transpose of the inverse.
+     */
+    dx::XMMATRIX getNormalMatrix() const;
+
     dx::XMVECTOR getScale() const;
     dx::XMFLOAT3 getScale3f() const;
     dx::XMMATRIX getScaleMatrix() const;
@@ -38,11 +60,12 @@ class Transform
     dx::XMVECTOR getTranslation() const;
     dx::XMFLOAT3 getTranslation3f() const;
     dx::XMMATRIX getTranslationMatrix() const;
+    uint32_t     getIndex() const;
+    uint32_t     getParentIndex() const; // TransformStorage::NoParent for a root
 
   private:
-    dx::XMFLOAT3 m_scale;
-    dx::XMFLOAT3 m_rotation;
-    dx::XMFLOAT3 m_translation;
+    TransformStorage *m_storage;
+    uint32_t          m_index;
 };
 
 } // namespace bisky::gfx
\ No newline at end of file
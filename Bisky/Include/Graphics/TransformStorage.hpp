@@ -0,0 +1,205 @@
+#pragma once
+
+#include "Graphics/Transform.hpp"
+
+namespace bisky::gfx
+{
+
+/*
+ * The kernels TransformStorage can build matrices with.
+ */
+enum class TransformKernel
+{
+    Sse, // 4 transforms at a time with SSE2, always available
+    Avx, // 8 transforms at a time, if both the CPU and the OS support AVX
+};
+
+/*
+ * Keeps every transform of a scene in structure of arrays form and builds their matrices in batches.
+ *
+ * Each component of scale, rotation and translation has an array of its own, so a kernel loads
+ * 4 or 8 transforms with one instruction per component and builds all of their local matrices at
+ * once, sines and cosines included. Only the blocks of 8 transforms where something changed are
+ * rebuilt.
+ *
+ * A transform may have a parent, its world matrix is then its local matrix times its parent's.
+ * The parent links are kept in a flat array sorted by depth, so one linear pass over it always
+ * reaches a parent before its children. A node is only multiplied out again when its own local
+ * matrix or its parent's world matrix was rebuilt by the same update, so untouched subtrees cost
+ * a compare per node. Every level only depends on the one above it, and wide levels are split
+ * across the job system. A transform without a parent uses its local matrix as its world matrix.
+ *
+ * Transforms are never removed, so a Transform handle stays valid for as long as the storage.
+ */
+class TransformStorage
+{
+  public:
+    explicit TransformStorage();
+    ~TransformStorage() = default;
+
+    TransformStorage(const TransformStorage &)                    = delete;
+    const TransformStorage &operator=(const TransformStorage &)   = delete;
+    TransformStorage(const TransformStorage &&)                   = delete;
+    const TransformStorage &&operator=(const TransformStorage &&) = delete;
+
+  public: // Public methods
+    /*
+     * Adds an identity transform.
+     *
+     * @param parent The index of the parent transform, or NoParent.
+     * @return A handle to the new transform.
+     */
+    Transform create(uint32_t parent = NoParent);
+
+    void setScale(uint32_t index, float x, float y, float z);
+    void setRotation(uint32_t index, float x, float y, float z);
+    void setTranslation(uint32_t index, float x, float y, float z);
+    void addTranslation(uint32_t index, float x, float y, float z);
+
+    /*
+     * Checks whether a transform's world matrix changed since the last call, and forgets it.
+     * A transform also changes when update() moved it along with one of its ancestors.
+     *
+     * @param index The transform.
+     * @return True if the transform changed.
+     */
+    bool takeChanged(uint32_t index);
+
+    /*
+     * Marks every transform as changed, so the next update rebuilds all of them.
+     */
+    void invalidate();
+
+    /*
+     * Rebuilds the local matrices of every block where something changed, then the world
+     * matrices of the changed transforms and everything below them.
+     */
+    void update();
+
+    /*
+     * Rebuilds the local matrices of a range of transforms, changed or not.
+     * Whole blocks are built, so the transforms around the range may be rebuilt as well.
+     * Their children aren't touched until the next update.
+     *
+     * @param first The first transform of the range.
+     * @param count The number of transforms.
+     */
+    void computeLocals(uint32_t first, uint32_t count);
+
+    /*
+     * Picks the kernel to build matrices with, it must be supported.
+     *
+     * @param kernel The kernel.
+     */
+    void setKernel(TransformKernel kernel);
+
+  public: // Getter methods
+    dx::XMFLOAT3 getScale(uint32_t index) const;
+    dx::XMFLOAT3 getRotation(uint32_t index) const;
+    dx::XMFLOAT3 getTranslation(uint32_t index) const;
+
+    /*
+     * Gets a transform's local to world matrix as of the last update.
+     *
+     * @param index The transform.
+     * @return scale * rotation * translation, times the parent's local to world matrix.
+     */
+    dx::XMMATRIX getLocalToWorld(uint32_t index) const;
+
+    /*
+     * Gets the inverse of a transform's local to world matrix as of the last update.
+     * The scale of the transform and of its ancestors must not be 0.
+     *
+     * @param index The transform.
+     * @return The world to local matrix.
+     */
+    dx::XMMATRIX getWorldToLocal(uint32_t index) const;
+
+    uint32_t        getParent(uint32_t index) const;
+    uint32_t        getDepth(uint32_t index) const;
+    TransformKernel getKernel() const;
+    uint32_t        getCount() const;
+
+  public: // Static methods
+    /*
+     * Checks whether a kernel can run on this machine.
+     *
+     * @param kernel The kernel.
+     * @return True if the CPU and the OS support its instructions.
+     */
+    static bool IsSupported(TransformKernel kernel);
+
+  public: // Static variables
+    constexpr static uint32_t BlockSize         = 8u;         // transforms rebuilt together, the widest kernel's width
+    constexpr static uint32_t NoParent          = UINT32_MAX; // the parent of a root transform
+    constexpr static uint32_t ParallelThreshold = 8192u;      // levels with fewer nodes are propagated serially
+    constexpr static uint32_t ParallelGrainSize = 2048u;      // nodes per job when a level is split
+
+  private: // Private types
+    struct Components
+    {
+        std::vector<float> x;
+        std::vector<float> y;
+        std::vector<float> z;
+    };
+
+    /*
+     * One parent link in the depth sorted array.
+     */
+    struct Node
+    {
+        uint32_t index;
+        uint32_t parent;
+    };
+
+  private: // Private methods
+    /*
+     * Builds the local matrices of one block.
+     *
+     * @param first The first transform of the block, a multiple of BlockSize.
+     */
+    void buildBlock(uint32_t first);
+
+    /*
+     * Multiplies out the world matrices of a range of the depth sorted nodes, all on the same level.
+     *
+     * @param begin The first node.
+     * @param end One past the last node.
+     */
+    void propagate(uint32_t begin, uint32_t end);
+
+    /*
+     * Rebuilds the depth sorted nodes with a counting sort on depth.
+     */
+    void sortByDepth();
+
+    void markDirty(uint32_t index);
+
+  private:
+    Components m_scale;
+    Components m_rotation; // in degrees, pitch, yaw and roll
+    Components m_translation;
+
+    std::vector<uint32_t> m_parents;
+    std::vector<uint32_t> m_depths;
+    std::vector<uint8_t>  m_changed; // 1 for transforms changed since takeChanged
+    std::vector<uint8_t>  m_dirty;   // 1 for transforms whose local matrix is out of date
+    std::vector<uint32_t> m_stamps;  // the update that last rebuilt a transform's matrices
+    uint32_t              m_count       = 0u;
+    uint32_t              m_dirtyCount  = 0u;
+    uint32_t              m_updateIndex = 0u;
+    TransformKernel       m_kernel      = TransformKernel::Sse;
+
+    // the depth sorted parent links, roots first, and where each level starts
+    std::vector<Node>     m_nodes;
+    std::vector<uint32_t> m_levels;
+    bool                  m_sorted = true;
+
+    // local matrices, and world matrices for transforms with a parent
+    std::vector<dx::XMFLOAT4X4> m_local;
+    std::vector<dx::XMFLOAT4X4> m_localInverse;
+    std::vector<dx::XMFLOAT4X4> m_world;
+    std::vector<dx::XMFLOAT4X4> m_worldInverse;
+};
+
+} // namespace bisky::gfx
\ No newline at end of file
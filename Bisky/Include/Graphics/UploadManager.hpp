@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Common.hpp"
+#include "Graphics/StagingRing.hpp"
+
+namespace bisky::gfx
+{
+
+class CommandQueue;
+class Device;
+class GraphicsCommandList;
+struct Buffer;
+
+/*
+ * Owns the staging memory for uploads and everything the GPU still reads from.
+ *
+ * Staging memory comes from one persistently mapped upload buffer, sub-allocated by a
+ * StagingRing and tagged with the fence value of the submission that reads it. Command lists
+ * and upload buffers of finished upload blocks are kept alive the same way. Nothing is waited
+ * on unless the ring runs out of room, everything the GPU is done with is freed once a frame.
+ */
+class UploadManager
+{
+  public:
+    /*
+     * Creates and maps the staging ring.
+     *
+     * @param device The device to create the ring with.
+     * @param capacity The size of the staging ring in bytes.
+     */
+    UploadManager(Device *const device, uint64_t capacity = DefaultCapacity);
+
+    /*
+     * Waits for the GPU to finish with the staging ring.
+     */
+    ~UploadManager();
+
+    UploadManager(const UploadManager &)                    = delete;
+    const UploadManager &operator=(const UploadManager &)   = delete;
+    UploadManager(const UploadManager &&)                   = delete;
+    const UploadManager &&operator=(const UploadManager &&) = delete;
+
+  public: // Static variables
+    constexpr static uint64_t DefaultCapacity = 64ull << 20;
+
+  public: // Public methods
+    /*
+     * Allocates staging memory from the ring.
+     * If the ring is full, waits for the oldest submitted regions to retire until there is room.
+     * The size counts towards this frame's bytes whether or not the ring can fit it.
+     *
+     * @param size The size in bytes.
+     * @param alignment The alignment of the offset, a power of two.
+     * @param allocation Filled with the staging memory on success.
+     * @return False if the ring can't fit the size, even after waiting.
+     */
+    bool allocate(uint64_t size, uint64_t alignment, StagingAllocation &allocation);
+
+    /*
+     * Tags regions with the fence value of the submission that reads them.
+     *
+     * @param sequences The regions to tag.
+     * @param fenceValue The value the direct queue's fence reaches once the regions have been read.
+     */
+    void submit(std::span<const uint64_t> sequences, uint64_t fenceValue);
+
+    /*
+     * Frees regions that were never submitted.
+     *
+     * @param sequences The regions to cancel.
+     */
+    void cancel(std::span<const uint64_t> sequences);
+
+    /*
+     * Keeps an upload buffer alive until the GPU is done with it.
+     *
+     * @param buffer The buffer to release.
+     * @param fenceValue The fence value of the last submission that reads the buffer.
+     */
+    void release(std::unique_ptr<Buffer> buffer, uint64_t fenceValue);
+
+    /*
+     * Keeps a command list alive until the GPU is done with it.
+     *
+     * @param commandList The command list to release.
+     * @param fenceValue The fence value of the submission of the command list.
+     */
+    void release(std::unique_ptr<GraphicsCommandList> commandList, uint64_t fenceValue);
+
+    /*
+     * Frees everything the GPU is done with and starts counting the frame's bytes again.
+     * This should be called once at the start of each frame.
+     */
+    void beginFrame();
+
+  public: // Getter methods
+    uint64_t getUsedBytes() const;
+
+    uint64_t getCapacity() const;
+
+    /*
+     * Gets the number of bytes allocated since the start of the frame.
+     *
+     * @return The bytes uploaded this frame.
+     */
+    uint64_t getFrameBytes() const;
+
+  private: // Private methods
+    /*
+     * Retires regions and releases everything the direct queue's fence has passed.
+     */
+    void retire();
+
+  private: // Private variables
+    CommandQueue           *m_queue;
+    std::unique_ptr<Buffer> m_buffer;
+    uint8_t                *m_cpuBase = nullptr;
+    StagingRing             m_ring;
+
+    // command lists and buffers waiting on the fence, in submission order
+    struct PendingRelease
+    {
+        uint64_t                             fenceValue;
+        std::unique_ptr<Buffer>              buffer;
+        std::unique_ptr<GraphicsCommandList> commandList;
+    };
+
+    std::deque<PendingRelease> m_pendingReleases;
+
+    uint64_t m_frameBytes = 0u;
+};
+
+} // namespace bisky::gfx
\ No newline at end of file
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Scene/RenderObject.hpp"
+#include "Scene/Components.hpp"
 
 namespace bisky::core
 {
@@ -42,7 +42,7 @@ class FinalRenderPass
     void initPipelineState();
 
     gfx::Device *const                   m_device;
-    std::unique_ptr<scene::RenderObject> m_screenQuad;
+    std::unique_ptr<scene::MeshInstance> m_screenQuad;
 };
 
 } // namespace bisky::renderer
\ No newline at end of file
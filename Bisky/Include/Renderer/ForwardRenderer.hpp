@@ -1,6 +1,9 @@
 #pragma once
 
+#include "Graphics/Device.hpp"
+#include "Graphics/PersistentBuffer.hpp"
 #include "Renderer/RenderLayer.hpp"
+#include "Scene/FrustumCuller.hpp"
 
 namespace bisky::core
 {
@@ -9,7 +12,6 @@ struct FrameStats;
 
 namespace bisky::gfx
 {
-class Device;
 class Window;
 struct FrameResource;
 } // namespace bisky::gfx
@@ -40,12 +42,48 @@ class ForwardRenderer
     );
 
   public:
+    void  setLodErrorThreshold(float threshold);
+    float getLodErrorThreshold() const;
+    void  setMeshletCulling(bool enabled);
+    bool  getMeshletCulling() const;
+    void  setFrustumCulling(bool enabled);
+    bool  getFrustumCulling() const;
+
+  private: // Private types
+    /*
+     * A persistent upload buffer holding every entity's constants, one per frame in flight.
+     * An entity keeps its slot, its position in the query, for as long as the registry's version doesn't change,
+     * so only entities that moved are written again.
+     */
+    struct ObjectConstants
+    {
+        std::unique_ptr<gfx::PersistentBuffer> buffer   = nullptr;
+        uint32_t                               capacity = 0u;         // number of objects that fit
+        uint64_t                               version  = UINT64_MAX; // the registry's version when slots were assigned
+    };
+
   private:
     void initRootSignatures();
     void initPipelineStateObjects();
 
+    /*
+     * Grows a frame resource's object constants to fit every object.
+     *
+     * @param constants The object constants of one frame resource.
+     * @param objectCount The number of objects in the scene.
+     * @return True if the buffer was recreated and every object has to be written again.
+     */
+    bool reserveObjectConstants(ObjectConstants &constants, uint32_t objectCount);
+
   private:
-    gfx::Device *const m_backend;
+    gfx::Device *const   m_backend;
+    float                m_lodErrorThreshold; // largest LOD error allowed on screen, in pixels
+    bool                 m_meshletCulling;    // draw only the meshlets that pass the CPU culler
+    bool                 m_frustumCulling;    // draw only the entities whose bounds touch the view frustum
+    scene::CullKernel    m_cullKernel;        // the widest kernel the CPU supports
+    std::vector<uint8_t> m_visibility;        // the culling results of the chunk being recorded
+
+    std::array<ObjectConstants, gfx::Device::FramesInFlight> m_objectConstants; // indexed by frame resource
 };
 
 } // namespace bisky::renderer
\ No newline at end of file
@@ -1,6 +1,6 @@
 #pragma once
 
-#include "Scene/RenderObject.hpp"
+#include "Scene/Components.hpp"
 
 namespace bisky::core
 {
@@ -47,7 +47,7 @@ class SkyboxRenderPass
 
   private:
     gfx::Device *const                   m_device;
-    std::unique_ptr<scene::RenderObject> m_cube;
+    std::unique_ptr<scene::MeshInstance> m_cube;
 };
 
 } // namespace bisky::renderer
\ No newline at end of file
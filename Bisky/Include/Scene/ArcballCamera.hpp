@@ -41,6 +41,8 @@ class ArcballCamera
     XMVECTOR getUp() const;
     XMVECTOR getForward() const;
     XMVECTOR getPosition() const;
+    float    getFovY() const;
+    uint32_t getHeight() const;
 
   private:
     XMFLOAT3   m_cameraFocus;
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "Graphics/Device.hpp"
+#include "Graphics/Transform.hpp"
+#include "Scene/FrustumCuller.hpp"
+
+namespace bisky::scene
+{
+
+struct Mesh;
+
+/*
+ * The components a scene's entities are made of.
+ * An entity that is drawn has a gfx::Transform, a MeshInstance, Bounds and RenderFlags, the transform
+ * being a handle into the scene's TransformStorage. Bounds is declared with FrustumCuller, which culls it.
+ * They're kept in an EntityRegistry, so they have to stay trivially copyable.
+ */
+
+/*
+ * The mesh an entity draws, shared with every other entity drawing it.
+ */
+struct MeshInstance
+{
+    Mesh                    *mesh              = nullptr;                             // the mesh to draw
+    D3D12_PRIMITIVE_TOPOLOGY primitiveTopology = D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST; // the topology type
+};
+
+/*
+ * How an entity is drawn.
+ */
+struct RenderFlags
+{
+    uint32_t numFramesDirty = gfx::Device::FramesInFlight; // number of frames whose constants are out of date
+    bool     visible        = true;                        // hidden entities keep their constants but aren't drawn
+};
+
+} // namespace bisky::scene
\ No newline at end of file
@@ -0,0 +1,346 @@
+#pragma once
+
+#include "Core/JobSystem.hpp"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace bisky::scene
+{
+
+/*
+ * A handle to an entity of an EntityRegistry.
+ * The generation of an index changes every time it is reused, so handles to destroyed entities stay invalid.
+ */
+struct Entity
+{
+    uint32_t index      = 0u;
+    uint32_t generation = 0u; // never 0 for an entity that exists
+
+    bool operator==(const Entity &) const = default;
+};
+
+/*
+ * One bit for every component type.
+ */
+using ComponentMask = uint64_t;
+
+/*
+ * Stores entities grouped by the set of components they have, their archetype.
+ *
+ * Every archetype keeps its entities in fixed size chunks, and a chunk keeps one packed array per
+ * component, so a query walks plain arrays of exactly the components it asks for. Entities are
+ * kept dense, destroying one moves the archetype's last entity into its place, and adding or
+ * removing a component moves the entity to another archetype. A handle finds its entity through
+ * a slot with the entity's current chunk and row.
+ *
+ * Components are moved around with memcpy, so they have to be trivially copyable.
+ * Entities can't be created or destroyed, nor components added or removed, during a query.
+ */
+class EntityRegistry
+{
+  public:
+    explicit EntityRegistry();
+    ~EntityRegistry() = default;
+
+    EntityRegistry(const EntityRegistry &)                    = delete;
+    const EntityRegistry &operator=(const EntityRegistry &)   = delete;
+    EntityRegistry(const EntityRegistry &&)                   = delete;
+    const EntityRegistry &&operator=(const EntityRegistry &&) = delete;
+
+  public: // Public methods
+    /*
+     * Creates an entity with the given components.
+     *
+     * @param components The values of the entity's components, one of each type.
+     * @return A handle to the new entity.
+     */
+    template <typename... Ts> Entity create(const Ts &...components)
+    {
+        const Entity entity = allocate(GetMask<Ts...>());
+        ((*get<Ts>(entity) = components), ...);
+        return entity;
+    }
+
+    /*
+     * Destroys an entity, its handle and every copy of it become invalid.
+     *
+     * @param entity The entity, nothing happens if it doesn't exist.
+     */
+    void destroy(Entity entity);
+
+    /*
+     * Adds a component to an entity, or overwrites it if the entity already has one.
+     * The entity moves to the archetype with the component.
+     *
+     * @param entity The entity.
+     * @param component The value of the component.
+     */
+    template <typename T> void add(Entity entity, const T &component)
+    {
+        if (!isAlive(entity))
+        {
+            return;
+        }
+
+        setMask(entity, getMask(entity) | GetBit<T>());
+        *get<T>(entity) = component;
+    }
+
+    /*
+     * Removes a component from an entity, the entity moves to the archetype without it.
+     *
+     * @param entity The entity.
+     */
+    template <typename T> void remove(Entity entity)
+    {
+        if (isAlive(entity))
+        {
+            setMask(entity, getMask(entity) & ~GetBit<T>());
+        }
+    }
+
+    /*
+     * Calls a function with the packed arrays of every chunk whose entities have all of the given components,
+     * as function(const Entity *entities, uint32_t count, Ts *...components).
+     * Components that are only read can be asked for as const.
+     */
+    template <typename... Ts, typename Function> void forEach(Function &&function)
+    {
+        const ComponentMask mask = GetMask<Ts...>();
+        for (auto &archetype : m_archetypes)
+        {
+            if ((archetype->mask & mask) != mask)
+            {
+                continue;
+            }
+
+            for (auto &chunk : archetype->chunks)
+            {
+                function(getEntities(chunk), chunk.count, getArray<Ts>(*archetype, chunk)...);
+            }
+        }
+    }
+
+    /*
+     * Same as above, but splits the chunks across the job system and blocks until every chunk is done.
+     * The function is called from several threads at once, each time with a different chunk.
+     */
+    template <typename... Ts, typename Function> void parallelForEach(Function &&function)
+    {
+        // -------------- gather the matching chunks first, so they can be handed out by index --------------
+        const ComponentMask mask = GetMask<Ts...>();
+        m_chunkRefs.clear();
+        for (auto &archetype : m_archetypes)
+        {
+            if ((archetype->mask & mask) != mask)
+            {
+                continue;
+            }
+
+            for (auto &chunk : archetype->chunks)
+            {
+                m_chunkRefs.push_back({archetype.get(), &chunk});
+            }
+        }
+
+        const uint32_t chunkCount = static_cast<uint32_t>(m_chunkRefs.size());
+        core::JobSystem::get().parallelFor(chunkCount, ParallelGrainSize, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; i++)
+            {
+                auto [archetype, chunk] = m_chunkRefs[i];
+                function(getEntities(*chunk), chunk->count, getArray<Ts>(*archetype, *chunk)...);
+            }
+        });
+    }
+
+  public: // Getter methods
+    /*
+     * Gets one of an entity's components.
+     *
+     * @param entity The entity.
+     * @return The component, or nullptr if the entity doesn't exist or doesn't have one.
+     *         Only valid until the next entity is created or destroyed, or a component is added or removed.
+     */
+    template <typename T> T *get(Entity entity)
+    {
+        return static_cast<T *>(getComponent(entity, GetComponentId<T>()));
+    }
+
+    /*
+     * Counts the entities that have all of the given components.
+     *
+     * @return The number of entities a query over the components visits.
+     */
+    template <typename... Ts> uint32_t count() const
+    {
+        const ComponentMask mask  = GetMask<Ts...>();
+        uint32_t            total = 0u;
+        for (auto &archetype : m_archetypes)
+        {
+            if ((archetype->mask & mask) == mask)
+                total += archetype->count;
+        }
+        return total;
+    }
+
+    bool isAlive(Entity entity) const;
+
+    /*
+     * Gets a number that changes whenever entities are created, destroyed or moved between archetypes.
+     * A query visits the same entities in the same order for as long as it doesn't change.
+     *
+     * @return The structural version.
+     */
+    uint64_t getVersion() const;
+
+    uint32_t getCount() const;
+    uint32_t getArchetypeCount() const;
+    uint32_t getChunkCount() const;
+
+  public: // Static methods
+    /*
+     * Gets the index of a component type, the first call for a type assigns it.
+     *
+     * @return The index of the type's bit in a ComponentMask.
+     */
+    template <typename T> static uint32_t GetComponentId()
+    {
+        return ComponentIdOf<std::remove_cv_t<T>>();
+    }
+
+    template <typename T> static ComponentMask GetBit()
+    {
+        return ComponentMask(1u) << GetComponentId<T>();
+    }
+
+    template <typename... Ts> static ComponentMask GetMask()
+    {
+        return (ComponentMask(0u) | ... | GetBit<Ts>());
+    }
+
+  public: // Static variables
+    constexpr static uint32_t MaxComponents     = 64u;    // one per bit of ComponentMask
+    constexpr static uint32_t MaxComponentSize  = 1024u;  // so every chunk holds a useful number of entities
+    constexpr static uint32_t ChunkSize         = 16384u; // bytes per chunk, entities and components included
+    constexpr static uint32_t ArrayAlignment    = 64u;    // every array of a chunk starts on a cache line
+    constexpr static uint32_t ParallelGrainSize = 8u;     // chunks per job in parallelForEach
+
+  private: // Private types
+    struct Chunk
+    {
+        std::unique_ptr<uint8_t[]> memory;
+        uint8_t                   *data  = nullptr; // memory aligned to ArrayAlignment
+        uint32_t                   count = 0u;
+    };
+
+    struct Archetype
+    {
+        ComponentMask                       mask     = 0u;
+        uint32_t                            capacity = 0u; // entities per chunk
+        uint32_t                            count    = 0u; // entities in every chunk
+        std::array<uint32_t, MaxComponents> offsets  = {}; // where each component's array starts in a chunk
+        std::vector<Chunk>                  chunks;        // every chunk but the last one is full
+    };
+
+    /*
+     * Where an entity lives, indexed by the entity's index.
+     */
+    struct Slot
+    {
+        uint32_t generation = 1u;
+        uint32_t archetype  = 0u;
+        uint32_t chunk      = 0u;
+        uint32_t row        = 0u;
+    };
+
+    struct ChunkRef
+    {
+        Archetype *archetype;
+        Chunk     *chunk;
+    };
+
+  private: // Private methods
+    /*
+     * Creates an entity in the archetype with the given components, all zeroed.
+     *
+     * @param mask The entity's components.
+     * @return A handle to the new entity.
+     */
+    Entity allocate(ComponentMask mask);
+
+    /*
+     * Moves an entity to the archetype with the given components.
+     * Components in both archetypes keep their values, new ones are zeroed.
+     *
+     * @param entity The entity, it must exist.
+     * @param mask The entity's new components.
+     */
+    void setMask(Entity entity, ComponentMask mask);
+
+    /*
+     * Finds the archetype with exactly the given components, or creates it.
+     *
+     * @param mask The components.
+     * @return The index of the archetype.
+     */
+    uint32_t findArchetype(ComponentMask mask);
+
+    /*
+     * Appends a zeroed row to an archetype, with a new chunk if its last one is full.
+     *
+     * @param archetypeIndex The archetype.
+     * @param entity The entity the row belongs to.
+     * @param slot Filled with the chunk and row.
+     */
+    void pushRow(uint32_t archetypeIndex, Entity entity, Slot &slot);
+
+    /*
+     * Removes a row by moving the archetype's last row into it.
+     *
+     * @param slot The archetype, chunk and row to remove.
+     */
+    void removeRow(const Slot &slot);
+
+    ComponentMask getMask(Entity entity) const;
+    void         *getComponent(Entity entity, uint32_t id);
+
+    static Entity *getEntities(const Chunk &chunk);
+
+    template <typename T> static T *getArray(const Archetype &archetype, const Chunk &chunk)
+    {
+        return reinterpret_cast<T *>(chunk.data + archetype.offsets[GetComponentId<T>()]);
+    }
+
+    template <typename T> static uint32_t ComponentIdOf()
+    {
+        static_assert(std::is_trivially_copyable_v<T>, "components are moved between chunks with memcpy");
+        static_assert(sizeof(T) <= MaxComponentSize && alignof(T) <= ArrayAlignment);
+
+        static const uint32_t id = RegisterComponent(sizeof(T));
+        return id;
+    }
+
+    /*
+     * Assigns the next component index.
+     *
+     * @param size The size of the component.
+     * @return The index.
+     */
+    static uint32_t RegisterComponent(uint32_t size);
+
+  private:
+    std::vector<std::unique_ptr<Archetype>>     m_archetypes;
+    std::unordered_map<ComponentMask, uint32_t> m_archetypeIndices;
+    std::vector<Slot>                           m_slots;
+    std::vector<uint32_t>                       m_freeSlots;
+    std::vector<ChunkRef>                       m_chunkRefs; // the chunks of the current parallelForEach
+    uint32_t                                    m_count   = 0u;
+    uint64_t                                    m_version = 0u;
+};
+
+} // namespace bisky::scene
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Scene/MeshletCuller.hpp"
+#include "Scene/Vertex.hpp"
+
+#include <cstdint>
+#include <span>
+
+namespace bisky::scene
+{
+
+/*
+ * The sphere around a mesh's vertices, in object space.
+ * It is centered on the box around them, its radius reaches the farthest vertex.
+ */
+struct MeshBounds
+{
+    dx::XMFLOAT3 center = {0.0f, 0.0f, 0.0f};
+    float        radius = 0.0f;
+};
+
+/*
+ * A sphere around an entity's mesh in world space, what the renderer culls the entity with.
+ * The scene updates it from the mesh's bounds whenever the entity's transform changes.
+ * It is one of the components in Components.hpp, declared here so the culler builds without the device.
+ */
+struct Bounds
+{
+    dx::XMFLOAT3 center = {0.0f, 0.0f, 0.0f};
+    float        radius = 0.0f;
+};
+
+/*
+ * The kernels FrustumCuller can test spheres with.
+ */
+enum class CullKernel
+{
+    Scalar, // one sphere at a time, the reference
+    Sse,    // 4 spheres at a time with SSE2, always available
+    Avx,    // 8 spheres at a time, if both the CPU and the OS support AVX
+};
+
+/*
+ * Culls whole objects against the view frustum before they are recorded.
+ *
+ * The world space spheres of a chunk of entities are loaded 4 or 8 at a time and transposed,
+ * so each plane is tested against every lane with one multiply and add per axis.
+ */
+namespace FrustumCuller
+{
+
+/*
+ * Computes the bounding sphere of a mesh's vertices.
+ *
+ * @param vertices The vertices of one mesh.
+ * @return The bounds, all zero without vertices.
+ */
+MeshBounds computeBounds(std::span<const Vertex> vertices);
+
+/*
+ * Tests spheres against a frustum, a sphere is visible unless it is entirely behind one of the planes.
+ * Every kernel gives the same result.
+ *
+ * @param frustum The world space frustum.
+ * @param spheres The world space spheres.
+ * @param count The number of spheres.
+ * @param visible One byte per sphere, set to 1 if it is visible and 0 if it isn't.
+ * @param kernel The kernel to test with, it must be supported.
+ * @return The number of visible spheres.
+ */
+uint32_t cull(const Frustum &frustum, const Bounds *spheres, uint32_t count, uint8_t *visible, CullKernel kernel);
+
+/*
+ * Checks whether a kernel can run on this CPU.
+ *
+ * @param kernel The kernel.
+ * @return True if the kernel can be used.
+ */
+bool isSupported(CullKernel kernel);
+
+} // namespace FrustumCuller
+
+} // namespace bisky::scene
\ No newline at end of file
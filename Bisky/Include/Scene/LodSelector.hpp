@@ -0,0 +1,53 @@
+#pragma once
+
+#include "Common.hpp"
+#include "Scene/Mesh.hpp"
+
+namespace bisky::scene
+{
+
+/*
+ * Picks a mesh LOD by projecting its geometric error onto the screen.
+ *
+ * The error of a level is scaled by the object's largest axis scale and divided by the distance
+ * from the camera to the closest point of the mesh's bounding sphere, so the estimate never
+ * underestimates how large the error looks.
+ */
+namespace LodSelector
+{
+
+/*
+ * Gets the factor that turns an error over a distance into pixels.
+ *
+ * @param fovY The vertical field of view in radians.
+ * @param height The height of the viewport in pixels.
+ * @return The viewport height over the height of the view frustum at a distance of one.
+ */
+float getProjectionScale(float fovY, uint32_t height);
+
+/*
+ * Chooses the least detailed LOD whose projected error is within the threshold.
+ *
+ * @param mesh The mesh to draw.
+ * @param world The object's local to world matrix.
+ * @param cameraPosition The camera position in world space.
+ * @param projectionScale The result of getProjectionScale.
+ * @param threshold The largest error allowed on screen, in pixels.
+ * @return 0 for the full detail submeshes, otherwise one past the index into Mesh::lods.
+ */
+uint32_t select(
+    const Mesh &mesh, dx::FXMMATRIX world, dx::FXMVECTOR cameraPosition, float projectionScale, float threshold
+);
+
+/*
+ * Gets the submeshes to draw for a LOD.
+ *
+ * @param mesh The mesh to draw.
+ * @param lod The result of select.
+ * @return The submeshes of that level.
+ */
+const std::vector<Submesh> &getSubmeshes(const Mesh &mesh, uint32_t lod);
+
+} // namespace LodSelector
+
+} // namespace bisky::scene
\ No newline at end of file
@@ -1,7 +1,16 @@
 #pragma once
 
-#include "Graphics/Buffer.hpp"
 #include "Graphics/Descriptor.hpp"
+#include "Graphics/GeometryPool.hpp"
+#include "Scene/FrustumCuller.hpp"
+#include "Scene/MeshletBuilder.hpp"
+#include "Scene/VertexQuantizer.hpp"
+
+namespace bisky::gfx
+{
+class Device;
+class ResourceUpload;
+} // namespace bisky::gfx
 
 namespace bisky::scene
 {
@@ -18,21 +27,67 @@ struct Submesh
     uint32_t  startIndexLocation;
     uint32_t  indexCount;
     Material *material;
+    uint32_t  firstMeshlet; // into Mesh::meshlets
+    uint32_t  meshletCount;
+};
+
+/*
+ * A simplified level of detail of a mesh, drawn from the same vertex and index buffers.
+ * The error is how far the simplified surface is from the original, in object space units.
+ */
+struct MeshLod
+{
+    float                error;
+    std::vector<Submesh> submeshes;
 };
 
 /*
  * Represents a Mesh.
+ * The submeshes are the full detail mesh, lods holds the simplified versions from the most to the least detailed.
+ *
+ * The vertices and indices live in the geometry pool. The submeshes' start index locations already include where
+ * the indices start in the pool's index buffer, the vertex view starts at the mesh's first vertex.
  */
 struct Mesh
 {
-    std::string                  name;
-    uint32_t                     vertexBufferByteSize;
-    uint32_t                     vertexByteStride;
-    uint32_t                     indexBufferByteSize;
-    DXGI_FORMAT                  indexFormat;
-    std::unique_ptr<gfx::Buffer> vertexBuffer;
-    std::unique_ptr<gfx::Buffer> indexBuffer;
-    std::vector<Submesh>         submeshes;
+    /*
+     * Returns the vertices and indices to the geometry pool.
+     */
+    ~Mesh();
+
+    /*
+     * Copies the vertices and indices into the geometry pool and creates the vertex view.
+     * The vertex stride, index format and submeshes have to be set first, the submeshes and levels of detail are
+     * moved to where the indices land in the pool.
+     *
+     * @param device The device that owns the geometry pool.
+     * @param vertexData The vertices.
+     * @param vertexCount The number of vertices.
+     * @param indexData The indices.
+     * @param indexCount The number of indices.
+     * @param upload The upload block to record the copies into.
+     * @return False if the pool is full.
+     */
+    bool createGeometry(
+        gfx::Device *const device, const void *vertexData, uint32_t vertexCount, const void *indexData,
+        uint32_t indexCount, gfx::ResourceUpload &upload
+    );
+
+    std::string          name;
+    uint32_t             vertexBufferByteSize;
+    uint32_t             vertexByteStride;
+    uint32_t             indexBufferByteSize;
+    DXGI_FORMAT          indexFormat;
+    VertexFormat         vertexFormat = VertexFormat::Full;
+    QuantizationBounds   quantization = {};
+    MeshBounds           bounds       = {}; // object space, computed when the model is imported
+    gfx::GeometryPool   *geometryPool = nullptr;
+    gfx::GeometryRange   vertices;
+    gfx::GeometryRange   indices;
+    gfx::Descriptor      vertexSrv; // structured buffer view of just this mesh's vertices
+    std::vector<Submesh> submeshes;
+    std::vector<MeshLod> lods;
+    std::vector<Meshlet> meshlets;
 };
 
 } // namespace bisky::scene
\ No newline at end of file
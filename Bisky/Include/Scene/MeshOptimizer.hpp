@@ -0,0 +1,103 @@
+#pragma once
+
+#include "Scene/Vertex.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace bisky::scene
+{
+
+/*
+ * Post-transform vertex cache efficiency of an index buffer.
+ * ACMR is the average cache misses per triangle (0.5 is ideal for large grids, 3 is the worst).
+ * ATVR is the average transforms per vertex (1 is ideal).
+ */
+struct VertexCacheStats
+{
+    float acmr;
+    float atvr;
+};
+
+/*
+ * What the optimizer did to a single vertex/index buffer pair.
+ */
+struct MeshOptimizationStats
+{
+    uint32_t         verticesBefore;
+    uint32_t         verticesAfter;
+    VertexCacheStats before;
+    VertexCacheStats after;
+};
+
+/*
+ * CPU-only passes that reorder a vertex/index buffer pair for faster rendering.
+ * Every pass keeps the triangles themselves (and their winding) intact.
+ */
+namespace MeshOptimizer
+{
+
+// the FIFO cache size used for analysis and overdraw clustering
+constexpr uint32_t CacheSize = 16u;
+
+/*
+ * Merges vertices that are bitwise identical and remaps the indices.
+ *
+ * @param vertices The vertices, shrunk to the unique vertices.
+ * @param indices The indices to remap.
+ * @return The number of unique vertices.
+ */
+uint32_t weldVertices(std::vector<Vertex> &vertices, std::span<uint32_t> indices);
+
+/*
+ * Reorders triangles for post-transform vertex cache locality (Forsyth's linear-speed algorithm).
+ *
+ * @param indices The triangle list to reorder in place.
+ * @param vertexCount The number of vertices the indices refer to.
+ */
+void optimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount);
+
+/*
+ * Reorders clusters of triangles so that outward facing clusters draw first, reducing overdraw.
+ * Clusters are split where it costs little vertex cache efficiency, so run optimizeVertexCache first.
+ *
+ * @param indices The triangle list to reorder in place.
+ * @param vertices The vertices the indices refer to.
+ * @param threshold How much worse the ACMR is allowed to get, e.g. 1.05 allows 5%.
+ */
+void optimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices, float threshold = 1.05f);
+
+/*
+ * Reorders vertices in the order they're first referenced and drops unreferenced vertices.
+ *
+ * @param vertices The vertices to reorder.
+ * @param indices The indices to remap.
+ * @return The number of vertices left.
+ */
+uint32_t optimizeVertexFetch(std::vector<Vertex> &vertices, std::span<uint32_t> indices);
+
+/*
+ * Simulates a FIFO post-transform cache over a triangle list.
+ *
+ * @param indices The triangle list.
+ * @param vertexCount The number of vertices the indices refer to.
+ * @param cacheSize The number of entries in the simulated cache.
+ * @return The ACMR and ATVR of the triangle list.
+ */
+VertexCacheStats analyzeVertexCache(
+    std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = CacheSize
+);
+
+/*
+ * Runs every pass: welding, vertex cache, overdraw and vertex fetch ordering.
+ *
+ * @param vertices The vertices to optimize.
+ * @param indices The triangle list to optimize.
+ * @return The vertex counts and cache statistics before and after.
+ */
+MeshOptimizationStats optimize(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices);
+
+} // namespace MeshOptimizer
+
+} // namespace bisky::scene
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "Common.hpp"
+#include "Scene/Vertex.hpp"
+
+namespace bisky::scene
+{
+
+/*
+ * Quadric error edge collapse simplification (Garland and Heckbert 1997).
+ *
+ * Edges collapse onto one of their existing vertices, so the simplified index buffer
+ * draws from the same vertex buffer as the original. Vertices that share a position
+ * (UV or normal seams) collapse together, and open borders only collapse along themselves.
+ */
+namespace MeshSimplifier
+{
+
+/*
+ * Simplifies a triangle list until it reaches the target size or the error limit.
+ *
+ * @param vertices The vertices the indices refer to.
+ * @param indices The triangle list to simplify.
+ * @param targetIndexCount The number of indices to stop at.
+ * @param maxError The largest geometric error allowed, in the same units as the positions.
+ * @param result The simplified triangle list.
+ * @return The geometric error of the result, the RMS distance to the original surface around each collapse.
+ */
+float simplify(
+    std::span<const Vertex> vertices, std::span<const uint32_t> indices, uint32_t targetIndexCount, float maxError,
+    std::vector<uint32_t> &result
+);
+
+} // namespace MeshSimplifier
+
+} // namespace bisky::scene
\ No newline at end of file
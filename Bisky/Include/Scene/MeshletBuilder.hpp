@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Scene/Vertex.hpp"
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace bisky::scene
+{
+
+/*
+ * A small cluster of a submesh's triangles with the bounds used to cull it.
+ * The triangles are a contiguous range of the submesh's indices, so a meshlet can be drawn
+ * with the regular index buffer by offsetting the submesh's draw.
+ *
+ * The cone holds the normals of every triangle, every triangle faces away from a camera where
+ * dot(center - camera, coneAxis) >= coneCutoff * length(center - camera) + radius.
+ * A cutoff of 1 never culls.
+ */
+struct Meshlet
+{
+    uint32_t     startIndexLocation; // relative to the submesh's startIndexLocation
+    uint32_t     indexCount;
+    uint32_t     vertexCount;
+    float        radius;
+    dx::XMFLOAT3 center;
+    float        coneCutoff;
+    dx::XMFLOAT3 coneAxis;
+    float        padding;
+};
+
+/*
+ * Splits triangle lists into meshlets.
+ *
+ * Meshlets are grown greedily from a seed triangle, always adding the neighbouring triangle that
+ * needs the fewest new vertices and then the one closest to the meshlet, which keeps the bounding
+ * spheres tight and the normal cones narrow.
+ */
+namespace MeshletBuilder
+{
+
+// the limits recommended for mesh shaders, 124 triangles keeps the primitive indices in 4 bytes each
+constexpr uint32_t MaxVertices  = 64u;
+constexpr uint32_t MaxTriangles = 124u;
+
+/*
+ * Reorders the triangles of a triangle list so each meshlet's triangles are contiguous.
+ *
+ * @param vertices The vertices the indices refer to.
+ * @param indices The triangle list to split, reordered in place.
+ * @param meshlets The meshlets to append to, their index ranges are relative to indices.
+ * @return The number of meshlets appended.
+ */
+uint32_t build(std::span<const Vertex> vertices, std::span<uint32_t> indices, std::vector<Meshlet> &meshlets);
+
+/*
+ * Computes the bounding sphere and normal cone of a range of triangles.
+ *
+ * @param vertices The vertices the indices refer to.
+ * @param indices The triangles of one meshlet.
+ * @return A meshlet with its bounds and vertex count filled in.
+ */
+Meshlet computeBounds(std::span<const Vertex> vertices, std::span<const uint32_t> indices);
+
+} // namespace MeshletBuilder
+
+} // namespace bisky::scene
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Scene/MeshletBuilder.hpp"
+
+#include <DirectXMath.h>
+
+namespace bisky::scene
+{
+
+/*
+ * The six planes of a view frustum, normals point inside.
+ * The planes are normalized, so dot(plane, point) is a signed distance.
+ */
+struct Frustum
+{
+    dx::XMFLOAT4 planes[6];
+};
+
+/*
+ * A frustum and camera moved into one object's local space, so meshlets can be tested
+ * without transforming their bounds.
+ */
+struct MeshletCullData
+{
+    dx::XMFLOAT4 planes[6]; // not normalized, dot(plane, point) is the distance in world units
+    dx::XMFLOAT3 cameraPosition;
+    float        scale;       // the largest axis scale of the object
+    bool         coneCulling; // normal cones are only valid when the object is scaled uniformly
+};
+
+/*
+ * CPU reference culling for meshlets, against the view frustum and their normal cones.
+ */
+namespace MeshletCuller
+{
+
+/*
+ * Extracts the frustum planes of a view projection matrix (Gribb and Hartmann 2001).
+ * Expects a Direct3D projection where depth goes from 0 to 1.
+ *
+ * @param viewProjection The camera's view projection matrix.
+ * @return The world space frustum.
+ */
+Frustum getFrustum(dx::FXMMATRIX viewProjection);
+
+/*
+ * Moves a world space frustum and camera into an object's local space.
+ *
+ * @param frustum The world space frustum.
+ * @param world The object's local to world matrix.
+ * @param worldToLocal The inverse of world, the transform already caches it.
+ * @param cameraPosition The camera position in world space.
+ * @return What isVisible needs to test that object's meshlets.
+ */
+MeshletCullData prepare(
+    const Frustum &frustum, dx::FXMMATRIX world, dx::CXMMATRIX worldToLocal, dx::FXMVECTOR cameraPosition
+);
+
+/*
+ * Tests a meshlet against the frustum and its normal cone.
+ *
+ * @param meshlet The meshlet to test.
+ * @param data The object's result of prepare.
+ * @return False if none of the meshlet's triangles can be seen.
+ */
+bool isVisible(const Meshlet &meshlet, const MeshletCullData &data);
+
+} // namespace MeshletCuller
+
+} // namespace bisky::scene
\ No newline at end of file
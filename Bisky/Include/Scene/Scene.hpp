@@ -3,10 +3,12 @@
 #include "Graphics/Constants.hpp"
 #include "Graphics/Device.hpp"
 #include "Graphics/Texture.hpp"
+#include "Graphics/TransformStorage.hpp"
 #include "Scene/ArcballCamera.hpp"
 #include "Scene/Camera.hpp"
+#include "Scene/Components.hpp"
+#include "Scene/EntityRegistry.hpp"
 #include "Scene/Lights.hpp"
-#include "Scene/RenderObject.hpp"
 #include "Scene/Skybox.hpp"
 
 namespace bisky::core
@@ -42,25 +44,44 @@ class Scene
   public: // Public functions
     void update(const core::GameTimer *const timer);
 
+    /*
+     * Loads a model and adds an entity for every node of its scene graph that draws a mesh.
+     * Every node gets a transform parented the same way as in the file, and nodes drawing the same
+     * mesh share its geometry.
+     *
+     * @param filename The file to load, in the model directory.
+     * @param parent The transform to place the model's root nodes under, or TransformStorage::NoParent.
+     * @return True if successfully loaded.
+     */
+    bool loadModel(const std::filesystem::path &filename, uint32_t parent = gfx::TransformStorage::NoParent);
+
   public: // Getter functions
-    const std::vector<std::shared_ptr<RenderObject>> &getRenderObjects() const;
-    Camera *const                                     getCamera() const;
-    ArcballCamera *const                              getArcballCamera() const;
-    const std::vector<PointLight>                    &getLights() const;
-    Skybox *const                                     getSkybox() const;
+    /*
+     * Gets the entities of the scene.
+     * Every drawn entity has a gfx::Transform, a MeshInstance, Bounds and RenderFlags.
+     */
+    EntityRegistry *const          getEntities() const;
+    std::string_view               getName(Entity entity) const;
+    gfx::TransformStorage *const   getTransforms() const;
+    Camera *const                  getCamera() const;
+    ArcballCamera *const           getArcballCamera() const;
+    const std::vector<PointLight> &getLights() const;
+    Skybox *const                  getSkybox() const;
 
   private: // Private functions
     void initDefaultScene();
 
   private:
-    gfx::Window *const                         m_window;
-    gfx::Device *const                         m_device;
-    std::string_view                           m_name;
-    std::vector<std::shared_ptr<RenderObject>> m_renderObjects;
-    std::unique_ptr<Skybox>                    m_skybox;
-    std::unique_ptr<Camera>                    m_camera; // every scene has a camera - later hold more cameras
-    std::unique_ptr<ArcballCamera>             m_arcballCamera;
-    std::vector<PointLight>                    m_lights;
+    gfx::Window *const                     m_window;
+    gfx::Device *const                     m_device;
+    std::string_view                       m_name;
+    std::unique_ptr<gfx::TransformStorage> m_transforms; // every entity's transform
+    std::unique_ptr<EntityRegistry>        m_entities;
+    std::vector<std::string>               m_names; // by entity index, only the editor reads them
+    std::unique_ptr<Skybox>                m_skybox;
+    std::unique_ptr<Camera>                m_camera; // every scene has a camera - later hold more cameras
+    std::unique_ptr<ArcballCamera>         m_arcballCamera;
+    std::vector<PointLight>                m_lights;
 };
 
 } // namespace bisky::scene
\ No newline at end of file
@@ -1,6 +1,11 @@
 #pragma once
 
-#include "Common.hpp"
+#include <DirectXMath.h>
+
+#include <cstdint>
+
+// the same alias Common.hpp declares, so the vertex types stay usable without it
+namespace dx = DirectX;
 
 namespace bisky::scene
 {
@@ -13,4 +18,29 @@ struct Vertex
     dx::XMFLOAT4 tangent;
 };
 
+/*
+ * A compact Vertex, decoded in the vertex shader.
+ * Positions are unorm16 relative to the mesh bounds, normals and tangents are
+ * octahedral snorm16 and texture coordinates are half floats.
+ */
+struct PackedVertex
+{
+    uint16_t position[3];
+    uint16_t tangentSign; // 1 if the tangent's w is negative
+    int16_t  normal[2];
+    int16_t  tangent[2];
+    uint16_t texCoord[2];
+};
+
+static_assert(sizeof(PackedVertex) == 20u);
+
+/*
+ * The layout of a mesh's vertex buffer, matches VERTEX_FORMAT_* in Geometry/Shader.hlsl.
+ */
+enum class VertexFormat : uint32_t
+{
+    Full   = 0u,
+    Packed = 1u,
+};
+
 } // namespace bisky::scene
\ No newline at end of file
@@ -0,0 +1,107 @@
+#pragma once
+
+#include "Scene/Vertex.hpp"
+
+#include <cstdint>
+#include <span>
+
+namespace bisky::scene
+{
+
+/*
+ * How packed positions map back to object space: position = min + quantized * scale.
+ */
+struct QuantizationBounds
+{
+    dx::XMFLOAT3 min;
+    dx::XMFLOAT3 scale;
+};
+
+/*
+ * The largest error the packing introduced into a mesh, and what it saved.
+ * Normal and tangent errors are angles in degrees.
+ */
+struct QuantizationReport
+{
+    float    maxPositionError;
+    float    maxNormalError;
+    float    maxTangentError;
+    float    maxTexCoordError;
+    uint64_t fullBytes;
+    uint64_t packedBytes;
+};
+
+/*
+ * Converts between Vertex and PackedVertex, and narrows index buffers.
+ * encode is the scalar reference, encodeSimd produces the exact same bytes using SSE2.
+ */
+namespace VertexQuantizer
+{
+
+/*
+ * Gets the bounds that positions are quantized against.
+ *
+ * @param vertices The vertices of one mesh.
+ * @return The bounds, with a zero scale on flat axes.
+ */
+QuantizationBounds computeBounds(std::span<const Vertex> vertices);
+
+/*
+ * Packs vertices one at a time.
+ *
+ * @param vertices The vertices to pack.
+ * @param bounds The bounds from computeBounds.
+ * @param packed The output, the same size as vertices.
+ */
+void encode(std::span<const Vertex> vertices, const QuantizationBounds &bounds, std::span<PackedVertex> packed);
+
+/*
+ * Packs four vertices at a time with SSE2.
+ *
+ * @param vertices The vertices to pack.
+ * @param bounds The bounds from computeBounds.
+ * @param packed The output, the same size as vertices.
+ */
+void encodeSimd(std::span<const Vertex> vertices, const QuantizationBounds &bounds, std::span<PackedVertex> packed);
+
+/*
+ * Unpacks a vertex the same way Geometry/Shader.hlsl does.
+ *
+ * @param packed The vertex to unpack.
+ * @param bounds The bounds the vertex was packed with.
+ * @return The decoded vertex.
+ */
+Vertex decode(const PackedVertex &packed, const QuantizationBounds &bounds);
+
+/*
+ * Decodes every vertex and compares it to the source.
+ *
+ * @param vertices The source vertices.
+ * @param packed The packed vertices.
+ * @param bounds The bounds the vertices were packed with.
+ * @return The largest errors and the vertex buffer sizes.
+ */
+QuantizationReport measure(
+    std::span<const Vertex> vertices, std::span<const PackedVertex> packed, const QuantizationBounds &bounds
+);
+
+/*
+ * Checks whether every index fits in DXGI_FORMAT_R16_UINT.
+ * 0xFFFF is left out since it is the strip cut value.
+ *
+ * @param indices The indices to check.
+ * @return True if 16-bit indices can be used.
+ */
+bool fitsIn16Bits(std::span<const uint32_t> indices);
+
+/*
+ * Copies indices into a 16-bit index buffer, check fitsIn16Bits first.
+ *
+ * @param indices The indices to narrow.
+ * @param narrowed The output, the same size as indices.
+ */
+void narrowIndices(std::span<const uint32_t> indices, std::span<uint16_t> narrowed);
+
+} // namespace VertexQuantizer
+
+} // namespace bisky::scene
\ No newline at end of file
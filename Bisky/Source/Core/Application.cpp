@@ -1,6 +1,7 @@
 #include "Common.hpp"
 
 #include "Core/Application.hpp"
+#include "Core/DerivedDataCache.hpp"
 #include "Core/ResourceManager.hpp"
 
 namespace bisky::core
@@ -17,10 +18,13 @@ Application::Application(uint32_t width, uint32_t height, const std::string &tit
     m_timer = std::make_unique<core::GameTimer>();
 
     // -------------- initialize our renderer and scene --------------
+    // the render passes' pipeline states are compiled together once they've all been added
+    m_backend->beginPipelineStateBatch();
     m_renderer         = std::make_unique<renderer::ForwardRenderer>(m_window.get(), m_backend.get());
     m_finalRenderPass  = std::make_unique<renderer::FinalRenderPass>(m_backend.get());
     m_skyboxRenderPass = std::make_unique<renderer::SkyboxRenderPass>(m_backend.get());
-    m_scene            = std::make_unique<scene::Scene>(m_window.get(), m_backend.get(), "test");
+    m_backend->endPipelineStateBatch();
+    m_scene = std::make_unique<scene::Scene>(m_window.get(), m_backend.get(), "test");
 
     // -------------- initialize the editor --------------
     m_editor     = std::make_unique<editor::Editor>(m_window.get(), m_backend.get());
@@ -99,10 +103,99 @@ void Application::run()
         ImGui::Begin("Debug");
         ImGui::Text("Triangle Count: %i", m_frameStats->triangleCount);
         ImGui::Text("Draw Count: %i", m_frameStats->drawCount);
+        ImGui::Text("Object Data: %.1f KB", m_frameStats->objectBytes / 1024.0f);
         ImGui::Text("Frame Time: %f", m_frameStats->frameTime);
         ImGui::Text("Scene Update Time: %f", m_frameStats->sceneUpdateTime);
         ImGui::Text("Mesh Draw Time: %f", m_frameStats->meshDrawTime);
         ImGui::Text("Final Render Draw Time: %f", m_frameStats->finalRenderDrawTime);
+
+        ImGui::SeparatorText("Level of Detail");
+        float lodErrorThreshold = m_renderer->getLodErrorThreshold();
+        if (ImGui::SliderFloat("Error Threshold (px)", &lodErrorThreshold, 0.0f, 16.0f))
+        {
+            m_renderer->setLodErrorThreshold(lodErrorThreshold);
+        }
+
+        ImGui::Text("Triangles Saved: %u", m_frameStats->lodTriangleSavings);
+        for (uint32_t lod = 0; lod < ModelCooker::MaxLodCount; lod++)
+        {
+            ImGui::Text("LOD %u: %u objects", lod, m_frameStats->lodObjectCounts[lod]);
+        }
+
+        ImGui::SeparatorText("Frustum Culling");
+        bool frustumCulling = m_renderer->getFrustumCulling();
+        if (ImGui::Checkbox("Frustum Culling", &frustumCulling))
+        {
+            m_renderer->setFrustumCulling(frustumCulling);
+        }
+
+        ImGui::Text("Visible: %u Culled: %u", m_frameStats->objectsVisible, m_frameStats->objectsCulled);
+
+        ImGui::SeparatorText("Meshlets");
+        bool meshletCulling = m_renderer->getMeshletCulling();
+        if (ImGui::Checkbox("Meshlet Culling", &meshletCulling))
+        {
+            m_renderer->setMeshletCulling(meshletCulling);
+        }
+
+        ImGui::Text(
+            "Culled: %u / %u (%.1f%%)", m_frameStats->meshletsCulled, m_frameStats->meshletCount,
+            100.0f * m_frameStats->meshletsCulled / std::max(m_frameStats->meshletCount, 1u)
+        );
+
+        CacheStats cacheStats = DerivedDataCache::get().getStats();
+        ImGui::SeparatorText("Derived Data Cache");
+        ImGui::Text("Hits: %u Misses: %u", cacheStats.hits, cacheStats.misses);
+        ImGui::Text("Writes: %u Evictions: %u", cacheStats.writes, cacheStats.evictions);
+        ImGui::Text("Size: %.2f MB", cacheStats.size / (1024.0f * 1024.0f));
+
+        const gfx::FrameArena      &arena      = frameResource->resourceAllocator->arena;
+        const gfx::ArenaFrameStats &arenaStats = arena.getFrameStats();
+        ImGui::SeparatorText("Frame Arena");
+        ImGui::Text(
+            "Used: %.1f KB Wasted: %.1f KB Pages: %u", arenaStats.usedBytes / 1024.0f,
+            arenaStats.wastedBytes / 1024.0f, arenaStats.pageCount
+        );
+        ImGui::Text("High Water: %.1f KB Base: %.1f KB", arena.getHighWater() / 1024.0f, arena.getBaseSize() / 1024.0f);
+
+        const gfx::UploadManager *uploadManager = m_backend->getUploadManager();
+        ImGui::SeparatorText("Uploads");
+        ImGui::Text(
+            "Staging Ring: %.2f / %.2f MB", uploadManager->getUsedBytes() / (1024.0f * 1024.0f),
+            uploadManager->getCapacity() / (1024.0f * 1024.0f)
+        );
+        ImGui::Text("This Frame: %.2f MB", uploadManager->getFrameBytes() / (1024.0f * 1024.0f));
+
+        ImGui::SeparatorText("Heaps");
+        const std::pair<const char *, D3D12_HEAP_TYPE> heapTypes[] = {
+            {"Default", D3D12_HEAP_TYPE_DEFAULT},
+            {"Upload", D3D12_HEAP_TYPE_UPLOAD},
+        };
+        for (auto &[name, heapType] : heapTypes)
+        {
+            const gfx::MemoryStats stats = m_backend->getMemoryAllocator()->getStats(heapType);
+            ImGui::Text(
+                "%s: %.2f / %.2f MB in %u heaps, %u resources, largest free %.2f MB", name,
+                stats.usedBytes / (1024.0f * 1024.0f), stats.reservedBytes / (1024.0f * 1024.0f), stats.heapCount,
+                stats.allocationCount, stats.largestFreeBlock / (1024.0f * 1024.0f)
+            );
+        }
+
+        const gfx::GeometryPoolStats poolStats = m_backend->getGeometryPool()->getStats();
+        ImGui::SeparatorText("Geometry Pool");
+        const std::pair<const char *, gfx::OffsetAllocatorStats> pools[] = {
+            {"Vertices", poolStats.vertices},
+            {"16-bit Indices", poolStats.indices16},
+            {"32-bit Indices", poolStats.indices32},
+        };
+        for (auto &[name, stats] : pools)
+        {
+            ImGui::Text(
+                "%s: %.2f / %.2f MB, %u free ranges, %.1f%% fragmented", name,
+                (stats.capacity - stats.freeBytes) / (1024.0f * 1024.0f), stats.capacity / (1024.0f * 1024.0f),
+                stats.freeRangeCount, stats.getFragmentation() * 100.0f
+            );
+        }
         ImGui::End();
         m_editor->render(m_scene.get());
         m_editor->endFrame(cmdList, m_backend.get());
@@ -110,7 +203,8 @@ void Application::run()
         // -------------- transition resource to present --------------
         m_backend->endFrame(cmdList);
 
-        // -------------- execute command list --------------
+        // -------------- execute command list once the frame's constants have landed --------------
+        gfx::StreamingStore::fence();
         std::array<const bisky::gfx::CommandList *const, 1> commandLists = {cmdList};
         m_backend->getDirectCommandQueue()->executeCommandLists(commandLists);
 
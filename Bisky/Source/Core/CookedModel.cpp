@@ -0,0 +1,505 @@
+#include "Core/Logger.hpp"
+#include "Core/ModelCooker.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace bisky::core::ModelCooker
+{
+
+namespace
+{
+
+/*
+ * The layout of a cooked file.
+ * Every offset is from the start of the file, every section starts on an Alignment boundary.
+ */
+struct FileHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t vertexStride;
+    uint32_t indexStride;
+    uint32_t meshCount;
+    uint32_t lodCount;
+    uint32_t submeshCount;
+    uint32_t meshletCount;
+    uint32_t materialCount;
+    uint32_t imageCount;
+    uint32_t nodeCount;
+    uint64_t meshOffset;
+    uint64_t lodOffset;
+    uint64_t submeshOffset;
+    uint64_t meshletOffset;
+    uint64_t materialOffset;
+    uint64_t imageOffset;
+    uint64_t nodeOffset;
+    uint64_t stringOffset;
+    uint64_t stringSize;
+    uint64_t vertexOffset;
+    uint64_t vertexCount;
+    uint64_t indexOffset;
+    uint64_t indexCount;
+    uint64_t imageDataOffset;
+    uint64_t imageDataSize;
+    uint64_t fileSize;
+    uint64_t optionsHash;
+    uint64_t sourcesHash;
+};
+
+struct CookedString
+{
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct CookedMesh
+{
+    CookedString      name;
+    uint64_t          firstVertex;
+    uint64_t          vertexCount;
+    uint64_t          firstIndex;
+    uint64_t          indexCount;
+    uint32_t          firstSubmesh;
+    uint32_t          submeshCount;
+    uint32_t          firstLod;
+    uint32_t          lodCount;
+    uint32_t          firstMeshlet;
+    uint32_t          meshletCount;
+    scene::MeshBounds bounds;
+};
+
+struct CookedLod
+{
+    float    error;
+    uint32_t firstSubmesh;
+};
+
+struct CookedMaterial
+{
+    CookedString name;
+    dx::XMFLOAT3 diffuse;
+    int32_t      diffuseImage;
+    int32_t      metallicRoughnessImage;
+    int32_t      normalImage;
+};
+
+struct CookedImage
+{
+    CookedString name;
+    uint64_t     offset;
+    uint64_t     size;
+};
+
+struct CookedNode
+{
+    CookedString name;
+    int32_t      mesh;
+    int32_t      parent;
+    dx::XMFLOAT3 scale;
+    dx::XMFLOAT3 rotation;
+    dx::XMFLOAT3 translation;
+};
+
+static_assert(std::is_trivially_copyable_v<SubmeshData>);
+static_assert(std::is_trivially_copyable_v<scene::Vertex>);
+static_assert(std::is_trivially_copyable_v<scene::Meshlet>);
+
+uint64_t alignUp(uint64_t value)
+{
+    return (value + Alignment - 1u) & ~(Alignment - 1u);
+}
+
+template <typename T> const T *getSection(const MappedFile &file, uint64_t offset, uint64_t count)
+{
+    if (offset > file.size() || count > (file.size() - offset) / sizeof(T))
+    {
+        return nullptr;
+    }
+
+    return reinterpret_cast<const T *>(file.data() + offset);
+}
+
+} // namespace
+
+bool write(const std::filesystem::path &path, const ModelData &model, const SourceStamp &stamp)
+{
+    // -------------- build the tables --------------
+    std::string                 strings;
+    std::vector<CookedMesh>     meshes;
+    std::vector<CookedLod>      lods;
+    std::vector<SubmeshData>    submeshes;
+    std::vector<scene::Meshlet> meshlets;
+    std::vector<CookedMaterial> materials;
+    std::vector<CookedImage>    images;
+    std::vector<CookedNode>     nodes;
+    uint64_t                    vertexCount   = 0u;
+    uint64_t                    indexCount    = 0u;
+    uint64_t                    imageDataSize = 0u;
+
+    auto addString = [&](std::string_view string) {
+        CookedString cooked = {static_cast<uint32_t>(strings.size()), static_cast<uint32_t>(string.size())};
+        strings.append(string);
+        return cooked;
+    };
+
+    for (auto &mesh : model.meshes)
+    {
+        meshes.push_back({
+            .name         = addString(mesh.name),
+            .firstVertex  = vertexCount,
+            .vertexCount  = mesh.vertices.size(),
+            .firstIndex   = indexCount,
+            .indexCount   = mesh.indices.size(),
+            .firstSubmesh = static_cast<uint32_t>(submeshes.size()),
+            .submeshCount = static_cast<uint32_t>(mesh.submeshes.size()),
+            .firstLod     = static_cast<uint32_t>(lods.size()),
+            .lodCount     = static_cast<uint32_t>(mesh.lods.size()),
+            .firstMeshlet = static_cast<uint32_t>(meshlets.size()),
+            .meshletCount = static_cast<uint32_t>(mesh.meshlets.size()),
+            .bounds       = mesh.bounds,
+        });
+        meshlets.insert(meshlets.end(), mesh.meshlets.begin(), mesh.meshlets.end());
+        submeshes.insert(submeshes.end(), mesh.submeshes.begin(), mesh.submeshes.end());
+
+        // every level has one submesh per full detail submesh, stored right after them
+        for (auto &lod : mesh.lods)
+        {
+            lods.push_back({.error = lod.error, .firstSubmesh = static_cast<uint32_t>(submeshes.size())});
+            submeshes.insert(submeshes.end(), lod.submeshes.begin(), lod.submeshes.end());
+        }
+
+        vertexCount += mesh.vertices.size();
+        indexCount += mesh.indices.size();
+    }
+
+    for (auto &material : model.materials)
+    {
+        materials.push_back({
+            .name                   = addString(material.name),
+            .diffuse                = material.diffuse,
+            .diffuseImage           = material.diffuseImage,
+            .metallicRoughnessImage = material.metallicRoughnessImage,
+            .normalImage            = material.normalImage,
+        });
+    }
+
+    for (auto &image : model.images)
+    {
+        images.push_back({.name = addString(image.name), .offset = imageDataSize, .size = image.bytes.size()});
+        imageDataSize += image.bytes.size();
+    }
+
+    for (auto &node : model.nodes)
+    {
+        nodes.push_back({
+            .name        = addString(node.name),
+            .mesh        = node.mesh,
+            .parent      = node.parent,
+            .scale       = node.scale,
+            .rotation    = node.rotation,
+            .translation = node.translation,
+        });
+    }
+
+    // -------------- lay out the sections --------------
+    FileHeader header = {
+        .magic         = Magic,
+        .version       = Version,
+        .vertexStride  = sizeof(scene::Vertex),
+        .indexStride   = sizeof(uint32_t),
+        .meshCount     = static_cast<uint32_t>(meshes.size()),
+        .lodCount      = static_cast<uint32_t>(lods.size()),
+        .submeshCount  = static_cast<uint32_t>(submeshes.size()),
+        .meshletCount  = static_cast<uint32_t>(meshlets.size()),
+        .materialCount = static_cast<uint32_t>(materials.size()),
+        .imageCount    = static_cast<uint32_t>(images.size()),
+        .nodeCount     = static_cast<uint32_t>(nodes.size()),
+        .stringSize    = strings.size(),
+        .vertexCount   = vertexCount,
+        .indexCount    = indexCount,
+        .imageDataSize = imageDataSize,
+        .optionsHash   = stamp.optionsHash,
+        .sourcesHash   = stamp.sourcesHash,
+    };
+
+    uint64_t offset  = alignUp(sizeof(FileHeader));
+    auto     reserve = [&](uint64_t size) {
+        uint64_t start = offset;
+        offset         = alignUp(offset + size);
+        return start;
+    };
+
+    header.meshOffset      = reserve(meshes.size() * sizeof(CookedMesh));
+    header.lodOffset       = reserve(lods.size() * sizeof(CookedLod));
+    header.submeshOffset   = reserve(submeshes.size() * sizeof(SubmeshData));
+    header.meshletOffset   = reserve(meshlets.size() * sizeof(scene::Meshlet));
+    header.materialOffset  = reserve(materials.size() * sizeof(CookedMaterial));
+    header.imageOffset     = reserve(images.size() * sizeof(CookedImage));
+    header.nodeOffset      = reserve(nodes.size() * sizeof(CookedNode));
+    header.stringOffset    = reserve(strings.size());
+    header.vertexOffset    = reserve(vertexCount * sizeof(scene::Vertex));
+    header.indexOffset     = reserve(indexCount * sizeof(uint32_t));
+    header.imageDataOffset = reserve(imageDataSize);
+    header.fileSize        = offset;
+
+    // -------------- write to a temporary file --------------
+    std::filesystem::path tempPath = path;
+    tempPath += ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            LOG_WARNING("Failed to open " + tempPath.string());
+            return false;
+        }
+
+        auto writeAt = [&](uint64_t at, const void *data, uint64_t size) {
+            file.seekp(static_cast<std::streamoff>(at));
+            file.write(static_cast<const char *>(data), static_cast<std::streamsize>(size));
+        };
+
+        writeAt(0u, &header, sizeof(FileHeader));
+        writeAt(header.meshOffset, meshes.data(), meshes.size() * sizeof(CookedMesh));
+        writeAt(header.lodOffset, lods.data(), lods.size() * sizeof(CookedLod));
+        writeAt(header.submeshOffset, submeshes.data(), submeshes.size() * sizeof(SubmeshData));
+        writeAt(header.meshletOffset, meshlets.data(), meshlets.size() * sizeof(scene::Meshlet));
+        writeAt(header.materialOffset, materials.data(), materials.size() * sizeof(CookedMaterial));
+        writeAt(header.imageOffset, images.data(), images.size() * sizeof(CookedImage));
+        writeAt(header.nodeOffset, nodes.data(), nodes.size() * sizeof(CookedNode));
+        writeAt(header.stringOffset, strings.data(), strings.size());
+
+        for (size_t i = 0; i < model.meshes.size(); i++)
+        {
+            auto &mesh = model.meshes[i];
+            writeAt(
+                header.vertexOffset + meshes[i].firstVertex * sizeof(scene::Vertex), mesh.vertices.data(),
+                mesh.vertices.size_bytes()
+            );
+            writeAt(
+                header.indexOffset + meshes[i].firstIndex * sizeof(uint32_t), mesh.indices.data(),
+                mesh.indices.size_bytes()
+            );
+        }
+
+        for (size_t i = 0; i < model.images.size(); i++)
+        {
+            writeAt(header.imageDataOffset + images[i].offset, model.images[i].bytes.data(), images[i].size);
+        }
+
+        // -------------- pad the last section to the page boundary --------------
+        if (header.fileSize > 0u)
+        {
+            char zero = 0;
+            writeAt(header.fileSize - 1u, &zero, 1u);
+        }
+
+        if (!file)
+        {
+            LOG_WARNING("Failed to write " + tempPath.string());
+            return false;
+        }
+    }
+
+    // -------------- replace the old cooked file --------------
+    std::error_code ec;
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec)
+    {
+        LOG_WARNING("Failed to rename " + tempPath.string() + ": " + ec.message());
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+    LOG_INFO(fmt::format("Cooked {} ({:.2f} MB)", path.string(), header.fileSize / (1024.0f * 1024.0f)));
+    return true;
+}
+
+bool read(const std::filesystem::path &path, ModelData &model, const SourceStamp *stamp)
+{
+    auto file = std::make_unique<MappedFile>(path);
+    if (!file->isValid())
+    {
+        return false;
+    }
+
+    if (!read(std::move(file), model, stamp))
+    {
+        LOG_WARNING("Failed to read cooked file " + path.string());
+        return false;
+    }
+
+    return true;
+}
+
+bool read(std::unique_ptr<MappedFile> file, ModelData &model, const SourceStamp *stamp)
+{
+    if (!file || !file->isValid() || file->size() < sizeof(FileHeader))
+    {
+        return false;
+    }
+
+    // -------------- check the header --------------
+    auto &header = *reinterpret_cast<const FileHeader *>(file->data());
+    if (header.magic != Magic || header.version != Version || header.vertexStride != sizeof(scene::Vertex) ||
+        header.indexStride != sizeof(uint32_t) || header.fileSize != file->size())
+    {
+        LOG_WARNING("Cooked model is out of date");
+        return false;
+    }
+
+    if (stamp && (header.optionsHash != stamp->optionsHash || header.sourcesHash != stamp->sourcesHash))
+    {
+        LOG_WARNING("Cooked model was cooked from other sources or with other import options");
+        return false;
+    }
+
+    // -------------- find the sections --------------
+    auto meshes    = getSection<CookedMesh>(*file, header.meshOffset, header.meshCount);
+    auto lods      = getSection<CookedLod>(*file, header.lodOffset, header.lodCount);
+    auto submeshes = getSection<SubmeshData>(*file, header.submeshOffset, header.submeshCount);
+    auto meshlets  = getSection<scene::Meshlet>(*file, header.meshletOffset, header.meshletCount);
+    auto materials = getSection<CookedMaterial>(*file, header.materialOffset, header.materialCount);
+    auto images    = getSection<CookedImage>(*file, header.imageOffset, header.imageCount);
+    auto nodes     = getSection<CookedNode>(*file, header.nodeOffset, header.nodeCount);
+    auto strings   = getSection<char>(*file, header.stringOffset, header.stringSize);
+    auto vertices  = getSection<scene::Vertex>(*file, header.vertexOffset, header.vertexCount);
+    auto indices   = getSection<uint32_t>(*file, header.indexOffset, header.indexCount);
+    auto imageData = getSection<uint8_t>(*file, header.imageDataOffset, header.imageDataSize);
+    if (!meshes || !lods || !submeshes || !meshlets || !materials || !images || !nodes || !strings || !vertices ||
+        !indices || !imageData)
+    {
+        LOG_WARNING("Cooked model is truncated");
+        return false;
+    }
+
+    auto getString = [&](const CookedString &string) {
+        if (string.offset + static_cast<uint64_t>(string.length) > header.stringSize)
+            return std::string();
+        return std::string(strings + string.offset, string.length);
+    };
+
+    // -------------- point the model at the mapped sections --------------
+    for (uint32_t i = 0; i < header.meshCount; i++)
+    {
+        auto &mesh = meshes[i];
+        if (mesh.firstVertex + mesh.vertexCount > header.vertexCount ||
+            mesh.firstIndex + mesh.indexCount > header.indexCount ||
+            mesh.firstSubmesh + static_cast<uint64_t>(mesh.submeshCount) > header.submeshCount ||
+            mesh.firstLod + static_cast<uint64_t>(mesh.lodCount) > header.lodCount || mesh.lodCount >= MaxLodCount ||
+            mesh.firstMeshlet + static_cast<uint64_t>(mesh.meshletCount) > header.meshletCount)
+        {
+            LOG_WARNING("Cooked model has an invalid mesh");
+            model.meshes.clear();
+            return false;
+        }
+
+        model.meshes.push_back({
+            .name      = getString(mesh.name),
+            .vertices  = {vertices + mesh.firstVertex, static_cast<size_t>(mesh.vertexCount)},
+            .indices   = {indices + mesh.firstIndex, static_cast<size_t>(mesh.indexCount)},
+            .meshlets  = {meshlets + mesh.firstMeshlet, mesh.meshletCount},
+            .submeshes = {submeshes + mesh.firstSubmesh, submeshes + mesh.firstSubmesh + mesh.submeshCount},
+            .bounds    = mesh.bounds,
+        });
+
+        for (uint32_t l = 0; l < mesh.lodCount; l++)
+        {
+            auto &lod = lods[mesh.firstLod + l];
+            if (lod.firstSubmesh + static_cast<uint64_t>(mesh.submeshCount) > header.submeshCount)
+            {
+                LOG_WARNING("Cooked model has an invalid LOD");
+                model.meshes.clear();
+                return false;
+            }
+
+            model.meshes.back().lods.push_back({
+                .error     = lod.error,
+                .submeshes = {submeshes + lod.firstSubmesh, submeshes + lod.firstSubmesh + mesh.submeshCount},
+            });
+        }
+
+        // -------------- every submesh's meshlets have to belong to its mesh --------------
+        auto outsideMesh = [&](const SubmeshData &submesh) {
+            return submesh.firstMeshlet + static_cast<uint64_t>(submesh.meshletCount) > mesh.meshletCount;
+        };
+
+        auto &meshData = model.meshes.back();
+        bool  invalid  = std::ranges::any_of(meshData.submeshes, outsideMesh);
+        for (auto &lod : meshData.lods)
+        {
+            invalid |= std::ranges::any_of(lod.submeshes, outsideMesh);
+        }
+
+        if (invalid)
+        {
+            LOG_WARNING("Cooked model has an invalid submesh");
+            model.meshes.clear();
+            return false;
+        }
+    }
+
+    for (uint32_t i = 0; i < header.materialCount; i++)
+    {
+        auto &material = materials[i];
+        model.materials.push_back({
+            .name                   = getString(material.name),
+            .diffuse                = material.diffuse,
+            .diffuseImage           = material.diffuseImage,
+            .metallicRoughnessImage = material.metallicRoughnessImage,
+            .normalImage            = material.normalImage,
+        });
+    }
+
+    for (uint32_t i = 0; i < header.imageCount; i++)
+    {
+        auto &image = images[i];
+        if (image.offset + image.size > header.imageDataSize)
+        {
+            model.images.push_back({.name = getString(image.name)});
+            continue;
+        }
+
+        model.images.push_back({.name = getString(image.name), .bytes = {imageData + image.offset, image.size}});
+    }
+
+    // -------------- a node's parent has to come before it --------------
+    for (uint32_t i = 0; i < header.nodeCount; i++)
+    {
+        auto &node = nodes[i];
+        if (node.mesh < -1 || node.mesh >= static_cast<int64_t>(header.meshCount) || node.parent < -1 ||
+            node.parent >= static_cast<int64_t>(i))
+        {
+            LOG_WARNING("Cooked model has an invalid node");
+            model.meshes.clear();
+            model.nodes.clear();
+            return false;
+        }
+
+        model.nodes.push_back({
+            .name        = getString(node.name),
+            .mesh        = node.mesh,
+            .parent      = node.parent,
+            .scale       = node.scale,
+            .rotation    = node.rotation,
+            .translation = node.translation,
+        });
+    }
+
+    model.mappedFile = std::move(file);
+    return true;
+}
+
+std::filesystem::path getCookedPath(const std::filesystem::path &path)
+{
+    std::filesystem::path cooked = path;
+    return cooked.replace_extension(".bmesh");
+}
+
+} // namespace bisky::core::ModelCooker
\ No newline at end of file
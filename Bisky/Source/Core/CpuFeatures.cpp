@@ -0,0 +1,58 @@
+#include "Core/CpuFeatures.hpp"
+
+#include <cstdint>
+
+#ifdef _WIN32
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+
+namespace bisky::core::CpuFeatures
+{
+
+namespace
+{
+
+bool detectAvx()
+{
+    // -------------- the CPU has AVX and the OS uses XSAVE, which XGETBV needs --------------
+#ifdef _WIN32
+    int info[4];
+    __cpuid(info, 1);
+    const uint32_t ecx = static_cast<uint32_t>(info[2]);
+#else
+    uint32_t eax, ebx, ecx, edx;
+    if (!__get_cpuid(1u, &eax, &ebx, &ecx, &edx))
+    {
+        return false;
+    }
+#endif
+
+    const bool avx     = (ecx & (1u << 28)) != 0u;
+    const bool osxsave = (ecx & (1u << 27)) != 0u;
+    if (!avx || !osxsave)
+    {
+        return false;
+    }
+
+    // -------------- and the OS saves the upper halves of the registers --------------
+#ifdef _WIN32
+    const uint64_t xcr0 = _xgetbv(0);
+#else
+    uint32_t low, high;
+    __asm__("xgetbv" : "=a"(low), "=d"(high) : "c"(0u));
+    const uint64_t xcr0 = (static_cast<uint64_t>(high) << 32u) | low;
+#endif
+    return (xcr0 & 0x6u) == 0x6u;
+}
+
+} // namespace
+
+bool hasAvx()
+{
+    static const bool avx = detectAvx();
+    return avx;
+}
+
+} // namespace bisky::core::CpuFeatures
\ No newline at end of file
@@ -0,0 +1,264 @@
+#include "Common.hpp"
+
+#include "Core/DerivedDataCache.hpp"
+#include "Core/Hash.hpp"
+
+namespace bisky::core
+{
+
+void DerivedDataCache::setDirectory(const std::filesystem::path &path)
+{
+    std::error_code ec;
+    std::filesystem::create_directories(path, ec);
+    if (ec)
+    {
+        LOG_WARNING("Failed to create cache directory " + path.string() + ": " + ec.message());
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_directory = path;
+    }
+
+    trim();
+    LOG_INFO(fmt::format(
+        "Derived data cache set to {} ({:.2f} MB)", path.string(), getStats().size / (1024.0f * 1024.0f)
+    ));
+}
+
+void DerivedDataCache::setMaxSize(uint64_t bytes)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_maxSize = bytes;
+    }
+
+    trim();
+}
+
+bool DerivedDataCache::load(std::string_view bucket, uint64_t key, std::vector<uint8_t> &data)
+{
+    if (!isEnabled())
+    {
+        return false;
+    }
+
+    const std::filesystem::path path = getEntryPath(bucket, key);
+    if (!find(path))
+    {
+        return false;
+    }
+
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return false;
+    }
+
+    data.resize(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(reinterpret_cast<char *>(data.data()), static_cast<std::streamsize>(data.size()));
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.bytesRead += data.size();
+    return true;
+}
+
+std::unique_ptr<MappedFile> DerivedDataCache::map(std::string_view bucket, uint64_t key)
+{
+    if (!isEnabled())
+    {
+        return nullptr;
+    }
+
+    const std::filesystem::path path = getEntryPath(bucket, key);
+    if (!find(path))
+    {
+        return nullptr;
+    }
+
+    auto file = std::make_unique<MappedFile>(path);
+    if (!file->isValid())
+    {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stats.bytesRead += file->size();
+    return file;
+}
+
+bool DerivedDataCache::store(std::string_view bucket, uint64_t key, std::span<const uint8_t> data)
+{
+    return store(bucket, key, [&](const std::filesystem::path &path) {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(data.data()), static_cast<std::streamsize>(data.size()));
+        return static_cast<bool>(file);
+    });
+}
+
+bool DerivedDataCache::store(
+    std::string_view bucket, uint64_t key, const std::function<bool(const std::filesystem::path &)> &writer
+)
+{
+    if (!isEnabled())
+    {
+        return false;
+    }
+
+    const std::filesystem::path path     = getEntryPath(bucket, key);
+    const std::filesystem::path tempPath = getTempPath(path);
+
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    if (!writer(tempPath))
+    {
+        LOG_WARNING("Failed to write cache entry " + path.string());
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+    return commit(tempPath, path);
+}
+
+bool DerivedDataCache::isEnabled() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return !m_directory.empty();
+}
+
+CacheStats DerivedDataCache::getStats() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_stats;
+}
+
+std::filesystem::path DerivedDataCache::getEntryPath(std::string_view bucket, uint64_t key) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_directory / bucket / (toHexString(key) + ".bin");
+}
+
+std::filesystem::path DerivedDataCache::getTempPath(const std::filesystem::path &path) const
+{
+    // -------------- unique per thread so concurrent writers of the same key don't collide --------------
+    std::filesystem::path tempPath = path;
+    tempPath += "." + toHexString(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+    return tempPath;
+}
+
+bool DerivedDataCache::find(const std::filesystem::path &path)
+{
+    std::error_code ec;
+    bool            exists = std::filesystem::is_regular_file(path, ec);
+
+    // -------------- mark the entry as recently used --------------
+    if (exists)
+    {
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    }
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (exists)
+        m_stats.hits++;
+    else
+        m_stats.misses++;
+
+    return exists;
+}
+
+bool DerivedDataCache::commit(const std::filesystem::path &tempPath, const std::filesystem::path &path)
+{
+    bool full = false;
+    {
+        // -------------- under the lock, so writers of the same key each see what the last one left --------------
+        std::lock_guard<std::mutex> lock(m_mutex);
+        std::error_code             ec;
+        uint64_t                    replacedSize = std::filesystem::file_size(path, ec);
+        if (ec)
+        {
+            replacedSize = 0u;
+        }
+
+        std::filesystem::rename(tempPath, path, ec);
+        if (ec)
+        {
+            LOG_WARNING("Failed to commit cache entry " + path.string() + ": " + ec.message());
+            std::filesystem::remove(tempPath, ec);
+            return false;
+        }
+
+        const uint64_t size = std::filesystem::file_size(path, ec);
+        m_stats.writes++;
+        m_stats.bytesWritten += size;
+        m_stats.size -= std::min(replacedSize, m_stats.size);
+        m_stats.size += size;
+        full = m_stats.size > m_maxSize;
+    }
+
+    if (full)
+    {
+        trim();
+    }
+
+    return true;
+}
+
+void DerivedDataCache::trim()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_directory.empty())
+    {
+        return;
+    }
+
+    // -------------- gather every committed entry --------------
+    struct Entry
+    {
+        std::filesystem::path           path;
+        std::filesystem::file_time_type lastUsed;
+        uint64_t                        size;
+    };
+
+    std::vector<Entry> entries;
+    uint64_t           totalSize = 0u;
+    std::error_code    ec;
+    for (auto &file : std::filesystem::recursive_directory_iterator(m_directory, ec))
+    {
+        if (!file.is_regular_file(ec) || file.path().extension() != ".bin")
+        {
+            continue;
+        }
+
+        Entry entry = {.path = file.path(), .lastUsed = file.last_write_time(ec), .size = file.file_size(ec)};
+        totalSize += entry.size;
+        entries.push_back(std::move(entry));
+    }
+
+    // -------------- evict the least recently used entries until under 90% of the limit --------------
+    if (totalSize > m_maxSize)
+    {
+        std::ranges::sort(entries, [](const Entry &a, const Entry &b) { return a.lastUsed < b.lastUsed; });
+
+        const uint64_t target = m_maxSize / 10u * 9u;
+        for (auto &entry : entries)
+        {
+            if (totalSize <= target)
+            {
+                break;
+            }
+
+            // entries that are still mapped can't be deleted yet
+            if (std::filesystem::remove(entry.path, ec))
+            {
+                totalSize -= entry.size;
+                m_stats.evictions++;
+            }
+        }
+    }
+
+    m_stats.size = totalSize;
+}
+
+} // namespace bisky::core
\ No newline at end of file
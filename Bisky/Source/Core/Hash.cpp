@@ -0,0 +1,56 @@
+#include "Common.hpp"
+
+#include "Core/Hash.hpp"
+
+namespace bisky::core
+{
+
+void Hasher::update(const void *data, size_t size)
+{
+    constexpr uint64_t prime = 1099511628211ull;
+
+    const uint8_t *bytes = static_cast<const uint8_t *>(data);
+    uint64_t       hash  = m_hash;
+    for (size_t i = 0; i < size; i++)
+    {
+        hash = (hash ^ bytes[i]) * prime;
+    }
+
+    m_hash = hash;
+}
+
+void Hasher::update(std::string_view string)
+{
+    updateValue(static_cast<uint64_t>(string.size()));
+    update(string.data(), string.size());
+}
+
+bool Hasher::updateFile(const std::filesystem::path &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::vector<char> chunk(64u * 1024u);
+    while (file)
+    {
+        file.read(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+        update(chunk.data(), static_cast<size_t>(file.gcount()));
+    }
+
+    return true;
+}
+
+uint64_t Hasher::finish() const
+{
+    return m_hash;
+}
+
+std::string toHexString(uint64_t hash)
+{
+    return fmt::format("{:016x}", hash);
+}
+
+} // namespace bisky::core
\ No newline at end of file
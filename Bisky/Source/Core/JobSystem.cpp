@@ -0,0 +1,206 @@
+#include "Core/JobSystem.hpp"
+#include "Core/Logger.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace bisky::core
+{
+
+namespace
+{
+
+// set for worker threads so submissions go to the worker's own deque
+thread_local const JobSystem *t_owner = nullptr;
+thread_local uint32_t         t_index = 0u;
+
+} // namespace
+
+JobSystem &JobSystem::get()
+{
+    static JobSystem instance(std::max(std::thread::hardware_concurrency(), 2u) - 1u);
+    return instance;
+}
+
+JobSystem::JobSystem(uint32_t numWorkers)
+{
+    m_queues.reserve(numWorkers + 1u);
+    for (uint32_t i = 0; i < numWorkers + 1u; i++)
+    {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    m_workers.reserve(numWorkers);
+    for (uint32_t i = 0; i < numWorkers; i++)
+    {
+        m_workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+
+    LOG_INFO("Job system started with " + std::to_string(numWorkers) + " workers");
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+        m_running = false;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto &worker : m_workers)
+    {
+        worker.join();
+    }
+}
+
+void JobSystem::submit(std::function<void()> function, JobCounter *counter)
+{
+    if (counter)
+    {
+        counter->value.fetch_add(1u);
+    }
+
+    push(currentQueueIndex(), {.function = std::move(function), .counter = counter});
+}
+
+void JobSystem::parallelFor(
+    uint32_t count, uint32_t grainSize, std::function<void(uint32_t, uint32_t)> function, JobCounter *counter
+)
+{
+    if (count == 0u)
+    {
+        return;
+    }
+
+    grainSize           = std::max(grainSize, 1u);
+    uint32_t batches    = (count + grainSize - 1u) / grainSize;
+    auto     sharedFunc = std::make_shared<std::function<void(uint32_t, uint32_t)>>(std::move(function));
+    uint32_t queueIndex = currentQueueIndex();
+    counter->value.fetch_add(batches);
+
+    for (uint32_t batch = 0; batch < batches; batch++)
+    {
+        uint32_t begin = batch * grainSize;
+        uint32_t end   = std::min(begin + grainSize, count);
+        push(queueIndex, {.function = [sharedFunc, begin, end]() { (*sharedFunc)(begin, end); }, .counter = counter});
+    }
+}
+
+void JobSystem::parallelFor(uint32_t count, uint32_t grainSize, std::function<void(uint32_t, uint32_t)> function)
+{
+    JobCounter counter;
+    parallelFor(count, grainSize, std::move(function), &counter);
+    wait(&counter);
+}
+
+void JobSystem::wait(JobCounter *const counter)
+{
+    uint32_t index = currentQueueIndex();
+    while (counter->value.load() > 0u)
+    {
+        Job job;
+        if (tryGetJob(index, job))
+        {
+            execute(job);
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+uint32_t JobSystem::getWorkerCount() const
+{
+    return static_cast<uint32_t>(m_workers.size());
+}
+
+void JobSystem::workerLoop(uint32_t index)
+{
+    t_owner = this;
+    t_index = index;
+
+    while (m_running)
+    {
+        Job job;
+        if (tryGetJob(index, job))
+        {
+            execute(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepMutex);
+        m_wakeCondition.wait(lock, [this]() { return !m_running || m_pendingJobs.load() > 0u; });
+    }
+}
+
+bool JobSystem::tryGetJob(uint32_t index, Job &job)
+{
+    // -------------- pop the most recent job from our own deque --------------
+    {
+        auto                       &queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty())
+        {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            m_pendingJobs.fetch_sub(1u);
+            return true;
+        }
+    }
+
+    // -------------- steal the oldest job from someone else --------------
+    const uint32_t queueCount = static_cast<uint32_t>(m_queues.size());
+    for (uint32_t i = 1; i < queueCount; i++)
+    {
+        auto                       &queue = *m_queues[(index + i) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.jobs.empty())
+        {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            m_pendingJobs.fetch_sub(1u);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::execute(Job &job)
+{
+    job.function();
+
+    if (job.counter)
+    {
+        job.counter->value.fetch_sub(1u);
+    }
+}
+
+void JobSystem::push(uint32_t index, Job &&job)
+{
+    m_pendingJobs.fetch_add(1u);
+    {
+        auto                       &queue = *m_queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.jobs.push_back(std::move(job));
+    }
+
+    // -------------- wake a sleeping worker --------------
+    {
+        std::lock_guard<std::mutex> lock(m_sleepMutex);
+    }
+    m_wakeCondition.notify_one();
+}
+
+uint32_t JobSystem::currentQueueIndex() const
+{
+    if (t_owner == this)
+    {
+        return t_index;
+    }
+
+    return static_cast<uint32_t>(m_queues.size()) - 1u;
+}
+
+} // namespace bisky::core
\ No newline at end of file
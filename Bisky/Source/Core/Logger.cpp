@@ -1,11 +1,16 @@
-#include "Common.hpp"
-
 #include "Core/Logger.hpp"
 
+#include <fmt/color.h>
+#include <fmt/core.h>
+
+#include <filesystem>
+#include <mutex>
+
 namespace bisky::core
 {
 
-static LogLevel logLevel = Info;
+static LogLevel   logLevel = Info;
+static std::mutex logMutex; // keeps the prefix and message of jobs logging at once together
 
 void setLogLevel(const LogLevel &level)
 {
@@ -16,6 +21,7 @@ void _verbose(std::string_view msg, const std::string &filename, int line)
 {
     if (logLevel <= Verbose)
     {
+        std::lock_guard<std::mutex> lock(logMutex);
         fmt::print(fg(fmt::color::cyan),
                    "[V] {}.{}: ", std::filesystem::absolute(filename).filename().replace_extension().string(), line);
         fmt::print("{}\n", msg);
@@ -26,6 +32,7 @@ void _info(std::string_view msg, const std::string &filename, int line)
 {
     if (logLevel <= Info)
     {
+        std::lock_guard<std::mutex> lock(logMutex);
         fmt::print(fg(fmt::color::light_green),
                    "[I] {}.{}: ", std::filesystem::absolute(filename).filename().replace_extension().string(), line);
         fmt::print("{}\n", msg);
@@ -36,6 +43,7 @@ void _warning(std::string_view msg, const std::string &filename, int line)
 {
     if (logLevel <= Warning)
     {
+        std::lock_guard<std::mutex> lock(logMutex);
         fmt::print(fg(fmt::color::lemon_chiffon),
                    "[W] {}.{}: ", std::filesystem::absolute(filename).filename().replace_extension().string(), line);
         fmt::print("{}\n", msg);
@@ -46,6 +54,7 @@ void _error(std::string_view msg, const std::string &filename, int line)
 {
     if (logLevel <= Error)
     {
+        std::lock_guard<std::mutex> lock(logMutex);
         fmt::print(fg(fmt::color::indian_red),
                    "[E] {}.{}: ", std::filesystem::absolute(filename).filename().replace_extension().string(), line);
         fmt::print("{}\n", msg);
@@ -0,0 +1,969 @@
+#include "Common.hpp"
+
+#include "Core/Hash.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/ModelCooker.hpp"
+#include "Scene/MeshOptimizer.hpp"
+#include "Scene/MeshSimplifier.hpp"
+
+namespace bisky::core::ModelCooker
+{
+
+namespace
+{
+
+/*
+ * The range of a mesh's vertex and index arrays that a glTF primitive decodes into.
+ */
+struct PrimitiveRange
+{
+    const fastgltf::Primitive *primitive;
+    uint32_t                   meshIndex;
+    uint32_t                   submeshIndex;
+    uint32_t                   vertexStart;
+    uint32_t                   vertexCount;
+    uint32_t                   indexStart;
+    uint32_t                   indexCount;
+};
+
+/*
+ * Decodes the indices and vertex attributes of a primitive.
+ * Indices are relative to the primitive since draws pass its base vertex location.
+ * This only reads from the asset, so primitives can be decoded concurrently.
+ */
+void decodePrimitive(
+    const fastgltf::Asset &asset, const fastgltf::Primitive &p, scene::Vertex *const vertices, uint32_t *const indices
+)
+{
+    // -------------- get indices --------------
+    fastgltf::iterateAccessorWithIndex<uint32_t>(
+        asset, asset.accessors[p.indicesAccessor.value()],
+        [&](uint32_t index, size_t i) { indices[i] = index; }
+    );
+
+    // -------------- get vertices --------------
+    {
+        auto &accessor = asset.accessors[p.findAttribute("POSITION")->accessorIndex];
+        fastgltf::iterateAccessorWithIndex<dx::XMFLOAT3>(
+            asset, accessor,
+            [&](dx::XMFLOAT3 position, size_t index) {
+                scene::Vertex v{};
+                v.position = position;
+
+                vertices[index] = v;
+            }
+        );
+    }
+
+    // -------------- get normals --------------
+    {
+        auto normals = p.findAttribute("NORMAL");
+        if (normals != p.attributes.end())
+        {
+            auto &accessor = asset.accessors[normals->accessorIndex];
+            fastgltf::iterateAccessorWithIndex<dx::XMFLOAT3>(
+                asset, accessor, [&](dx::XMFLOAT3 normal, size_t index) { vertices[index].normal = normal; }
+            );
+        }
+    }
+
+    // -------------- get texcoords --------------
+    {
+        auto uvs = p.findAttribute("TEXCOORD_0");
+        if (uvs != p.attributes.end())
+        {
+            auto &accessor = asset.accessors[uvs->accessorIndex];
+            fastgltf::iterateAccessorWithIndex<dx::XMFLOAT2>(
+                asset, accessor, [&](dx::XMFLOAT2 texCoord, size_t index) { vertices[index].texCoord = texCoord; }
+            );
+        }
+    }
+
+    // -------------- get tangents --------------
+    // TODO: calculate tangents if not included
+    {
+        auto tangents = p.findAttribute("TANGENT");
+        if (tangents != p.attributes.end())
+        {
+            auto &accessor = asset.accessors[tangents->accessorIndex];
+            fastgltf::iterateAccessorWithIndex<dx::XMFLOAT4>(
+                asset, accessor, [&](dx::XMFLOAT4 tangent, size_t index) { vertices[index].tangent = tangent; }
+            );
+        }
+    }
+}
+
+/*
+ * Copies the encoded bytes of a glTF image.
+ * Images embedded in a buffer only copy their buffer view, external images are read from disk.
+ */
+std::vector<uint8_t> readImageBytes(
+    const fastgltf::Asset &asset, const fastgltf::Image &image, const std::filesystem::path &directory
+)
+{
+    std::vector<uint8_t> bytes;
+    auto                 copy = [&](const std::byte *data, size_t size) {
+        bytes.resize(size);
+        memcpy(bytes.data(), data, size);
+    };
+    auto readFile = [&](const std::filesystem::path &path, size_t offset) {
+        std::ifstream file(directory / path, std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            LOG_WARNING("Failed to open image " + (directory / path).string());
+            return;
+        }
+
+        size_t size = static_cast<size_t>(file.tellg()) - offset;
+        bytes.resize(size);
+        file.seekg(offset);
+        file.read(reinterpret_cast<char *>(bytes.data()), size);
+    };
+
+    std::visit(
+        fastgltf::visitor(
+            [&](auto &arg) {},
+            [&](const fastgltf::sources::Array &array) { copy(array.bytes.data(), array.bytes.size()); },
+            [&](const fastgltf::sources::URI &filePath) { readFile(filePath.uri.fspath(), filePath.fileByteOffset); },
+            [&](const fastgltf::sources::BufferView &view) {
+                auto &bufferView = asset.bufferViews[view.bufferViewIndex];
+                auto &buffer     = asset.buffers[bufferView.bufferIndex];
+                std::visit(
+                    fastgltf::visitor(
+                        [&](auto &arg) {},
+                        [&](const fastgltf::sources::Array &array) {
+                            copy(array.bytes.data() + bufferView.byteOffset, bufferView.byteLength);
+                        }
+                    ),
+                    buffer.data
+                );
+            }
+        ),
+        image.data
+    );
+
+    return bytes;
+}
+
+/*
+ * Runs the MeshOptimizer on every primitive's range, then closes the gaps left by welded vertices.
+ * Index counts never change, so only the base vertex locations of the submeshes move.
+ */
+void optimizePrimitives(ModelData &model, std::span<const PrimitiveRange> primitives, bool parallel)
+{
+    auto start = std::chrono::system_clock::now();
+
+    // -------------- optimize each primitive inside of its own range --------------
+    std::vector<scene::MeshOptimizationStats> stats(primitives.size());
+    auto                                      optimize = [&](uint32_t begin, uint32_t end) {
+        std::vector<scene::Vertex> vertices;
+        std::vector<uint32_t>      indices;
+        for (uint32_t i = begin; i < end; i++)
+        {
+            auto                &range        = primitives[i];
+            scene::Vertex *const meshVertices = model.vertexStorage[range.meshIndex].data() + range.vertexStart;
+            uint32_t *const      meshIndices  = model.indexStorage[range.meshIndex].data() + range.indexStart;
+
+            vertices.assign(meshVertices, meshVertices + range.vertexCount);
+            indices.assign(meshIndices, meshIndices + range.indexCount);
+
+            stats[i] = scene::MeshOptimizer::optimize(vertices, indices);
+
+            std::copy(vertices.begin(), vertices.end(), meshVertices);
+            std::copy(indices.begin(), indices.end(), meshIndices);
+        }
+    };
+
+    const uint32_t primitiveCount = static_cast<uint32_t>(primitives.size());
+    if (parallel)
+        JobSystem::get().parallelFor(primitiveCount, 1u, optimize);
+    else
+        optimize(0u, primitiveCount);
+
+    // -------------- move each primitive's vertices down to close the gaps --------------
+    std::vector<uint32_t>   vertexCounts(model.meshes.size(), 0u);
+    uint32_t                verticesBefore = 0u;
+    uint32_t                verticesAfter  = 0u;
+    uint32_t                triangles      = 0u;
+    scene::VertexCacheStats before         = {};
+    scene::VertexCacheStats after          = {};
+    for (uint32_t i = 0; i < primitiveCount; i++)
+    {
+        auto &range    = primitives[i];
+        auto &vertices = model.vertexStorage[range.meshIndex];
+        auto &written  = vertexCounts[range.meshIndex];
+
+        std::copy_n(vertices.begin() + range.vertexStart, stats[i].verticesAfter, vertices.begin() + written);
+        model.meshes[range.meshIndex].submeshes[range.submeshIndex].baseVertexLocation = written;
+        written += stats[i].verticesAfter;
+
+        // weight by triangle count so the totals match what a single draw of the model would get
+        const uint32_t primitiveTriangles = range.indexCount / 3u;
+        verticesBefore += stats[i].verticesBefore;
+        verticesAfter += stats[i].verticesAfter;
+        triangles += primitiveTriangles;
+        before.acmr += stats[i].before.acmr * primitiveTriangles;
+        before.atvr += stats[i].before.atvr * primitiveTriangles;
+        after.acmr += stats[i].after.acmr * primitiveTriangles;
+        after.atvr += stats[i].after.atvr * primitiveTriangles;
+    }
+
+    for (size_t m = 0; m < model.meshes.size(); m++)
+    {
+        model.vertexStorage[m].resize(vertexCounts[m]);
+        model.meshes[m].vertices = model.vertexStorage[m];
+    }
+
+    auto end     = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    const float weight = 1.0f / std::max(triangles, 1u);
+    LOG_INFO(fmt::format(
+        "Optimized {} primitives in {:.3f} ms: {} -> {} vertices, ACMR {:.3f} -> {:.3f}, ATVR {:.3f} -> {:.3f}",
+        primitiveCount, elapsed.count() / 1000.0f, verticesBefore, verticesAfter, before.acmr * weight,
+        after.acmr * weight, before.atvr * weight, after.atvr * weight
+    ));
+}
+
+/*
+ * The simplified index buffers of one primitive, from the most to the least detailed.
+ */
+struct PrimitiveLods
+{
+    std::vector<float>                 errors;
+    std::vector<std::vector<uint32_t>> indices;
+};
+
+/*
+ * Builds a LOD chain for every primitive by halving its triangle count with the MeshSimplifier.
+ * A primitive's chain ends early once simplification stalls or the error gets too large,
+ * meshes then reuse that primitive's last level so every LodData covers all submeshes.
+ */
+void generateLods(ModelData &model, std::span<const PrimitiveRange> primitives, bool parallel)
+{
+    // stop a chain when a level keeps more than this fraction of the previous level's triangles
+    constexpr float MinReduction = 0.85f;
+    // the largest error allowed, as a fraction of the primitive's bounding box diagonal
+    constexpr float MaxRelativeError = 0.05f;
+
+    auto start = std::chrono::system_clock::now();
+
+    // -------------- simplify each primitive from its full detail indices --------------
+    std::vector<PrimitiveLods> lods(primitives.size());
+    auto                       simplify = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            auto &range   = primitives[i];
+            auto &submesh = model.meshes[range.meshIndex].submeshes[range.submeshIndex];
+            auto &storage = model.vertexStorage[range.meshIndex];
+
+            std::span<const uint32_t> indices = {
+                model.indexStorage[range.meshIndex].data() + submesh.startIndexLocation, submesh.indexCount
+            };
+            if (indices.empty())
+                continue;
+
+            const uint32_t vertexCount = *std::max_element(indices.begin(), indices.end()) + 1u;
+            if (submesh.baseVertexLocation + static_cast<size_t>(vertexCount) > storage.size())
+                continue;
+
+            std::span<const scene::Vertex> vertices = {storage.data() + submesh.baseVertexLocation, vertexCount};
+
+            dx::XMVECTOR minimum = dx::XMLoadFloat3(&vertices[0].position);
+            dx::XMVECTOR maximum = minimum;
+            for (auto &vertex : vertices)
+            {
+                minimum = dx::XMVectorMin(minimum, dx::XMLoadFloat3(&vertex.position));
+                maximum = dx::XMVectorMax(maximum, dx::XMLoadFloat3(&vertex.position));
+            }
+
+            const float maxError =
+                dx::XMVectorGetX(dx::XMVector3Length(dx::XMVectorSubtract(maximum, minimum))) * MaxRelativeError;
+
+            uint32_t previousCount = submesh.indexCount;
+            for (uint32_t level = 1u; level < MaxLodCount; level++)
+            {
+                const uint32_t targetCount = (submesh.indexCount >> level) / 3u * 3u;
+                if (targetCount < 3u)
+                    break;
+
+                std::vector<uint32_t> result;
+                float error = scene::MeshSimplifier::simplify(vertices, indices, targetCount, maxError, result);
+                if (result.empty() || result.size() > previousCount * MinReduction)
+                    break;
+
+                scene::MeshOptimizer::optimizeVertexCache(result, vertexCount);
+
+                // levels are simplified from the full detail mesh, so keep the errors increasing
+                if (!lods[i].errors.empty())
+                    error = std::max(error, lods[i].errors.back());
+
+                previousCount = static_cast<uint32_t>(result.size());
+                lods[i].errors.push_back(error);
+                lods[i].indices.push_back(std::move(result));
+            }
+        }
+    };
+
+    const uint32_t primitiveCount = static_cast<uint32_t>(primitives.size());
+    if (parallel)
+        JobSystem::get().parallelFor(primitiveCount, 1u, simplify);
+    else
+        simplify(0u, primitiveCount);
+
+    // -------------- append every level to its mesh's index buffer --------------
+    for (size_t m = 0; m < model.meshes.size(); m++)
+    {
+        auto &mesh    = model.meshes[m];
+        auto &storage = model.indexStorage[m];
+
+        auto first = std::find_if(primitives.begin(), primitives.end(), [&](auto &range) {
+            return range.meshIndex == m;
+        });
+        auto last = std::find_if(first, primitives.end(), [&](auto &range) { return range.meshIndex != m; });
+
+        size_t levelCount = 0u;
+        for (auto it = first; it != last; it++)
+        {
+            levelCount = std::max(levelCount, lods[it - primitives.begin()].indices.size());
+        }
+
+        for (size_t level = 0; level < levelCount; level++)
+        {
+            auto &lod     = mesh.lods.emplace_back();
+            lod.submeshes = level == 0u ? mesh.submeshes : mesh.lods[level - 1u].submeshes;
+            if (level > 0u)
+                lod.error = mesh.lods[level - 1u].error;
+
+            for (auto it = first; it != last; it++)
+            {
+                auto &primitiveLods = lods[it - primitives.begin()];
+                if (level >= primitiveLods.indices.size())
+                    continue;
+
+                auto &indices              = primitiveLods.indices[level];
+                auto &submesh              = lod.submeshes[it->submeshIndex];
+                submesh.startIndexLocation = static_cast<uint32_t>(storage.size());
+                submesh.indexCount         = static_cast<uint32_t>(indices.size());
+                lod.error                  = std::max(lod.error, primitiveLods.errors[level]);
+                storage.insert(storage.end(), indices.begin(), indices.end());
+            }
+        }
+
+        mesh.indices = storage;
+    }
+
+    auto end     = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    // -------------- report the triangle count and error of each level --------------
+    for (auto &mesh : model.meshes)
+    {
+        auto countTriangles = [](std::span<const SubmeshData> submeshes) {
+            uint32_t triangles = 0u;
+            for (auto &submesh : submeshes)
+            {
+                triangles += submesh.indexCount / 3u;
+            }
+            return triangles;
+        };
+
+        std::string chain = std::to_string(countTriangles(mesh.submeshes));
+        for (auto &lod : mesh.lods)
+        {
+            chain += fmt::format(" -> {} ({:.5f})", countTriangles(lod.submeshes), lod.error);
+        }
+
+        LOG_INFO(fmt::format("LODs for {}: {} triangles", mesh.name, chain));
+    }
+
+    LOG_INFO(fmt::format("Generated LODs for {} primitives in {:.3f} ms", primitiveCount, elapsed.count() / 1000.0f));
+}
+
+/*
+ * An index range that is split into meshlets, shared by every submesh and LOD that draws it.
+ */
+struct MeshletRange
+{
+    uint32_t                    meshIndex;
+    uint32_t                    baseVertexLocation;
+    uint32_t                    startIndexLocation;
+    uint32_t                    indexCount;
+    std::vector<scene::Meshlet> meshlets;
+};
+
+/*
+ * Splits the index range of every submesh and LOD into meshlets.
+ * Meshlets only reorder triangles inside of their range, so the submeshes draw exactly what they drew before.
+ */
+void buildMeshlets(ModelData &model, bool parallel)
+{
+    auto start = std::chrono::system_clock::now();
+
+    // -------------- find the distinct index ranges, LODs reuse ranges that didn't simplify --------------
+    std::vector<MeshletRange> ranges;
+    for (uint32_t m = 0; m < model.meshes.size(); m++)
+    {
+        auto addRanges = [&](std::span<const SubmeshData> submeshes) {
+            for (auto &submesh : submeshes)
+            {
+                auto sameRange = [&](const MeshletRange &range) {
+                    return range.meshIndex == m && range.startIndexLocation == submesh.startIndexLocation;
+                };
+
+                if (submesh.indexCount > 0u && std::ranges::none_of(ranges, sameRange))
+                {
+                    ranges.push_back({
+                        .meshIndex          = m,
+                        .baseVertexLocation = submesh.baseVertexLocation,
+                        .startIndexLocation = submesh.startIndexLocation,
+                        .indexCount         = submesh.indexCount,
+                    });
+                }
+            }
+        };
+
+        addRanges(model.meshes[m].submeshes);
+        for (auto &lod : model.meshes[m].lods)
+        {
+            addRanges(lod.submeshes);
+        }
+    }
+
+    // -------------- split each range --------------
+    auto build = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            auto               &range   = ranges[i];
+            auto               &storage = model.vertexStorage[range.meshIndex];
+            std::span<uint32_t> indices = {
+                model.indexStorage[range.meshIndex].data() + range.startIndexLocation, range.indexCount
+            };
+
+            const uint32_t vertexCount = *std::max_element(indices.begin(), indices.end()) + 1u;
+            if (range.baseVertexLocation + static_cast<size_t>(vertexCount) > storage.size())
+                continue;
+
+            std::span<const scene::Vertex> vertices = {storage.data() + range.baseVertexLocation, vertexCount};
+            scene::MeshletBuilder::build(vertices, indices, range.meshlets);
+        }
+    };
+
+    const uint32_t rangeCount = static_cast<uint32_t>(ranges.size());
+    if (parallel)
+        JobSystem::get().parallelFor(rangeCount, 1u, build);
+    else
+        build(0u, rangeCount);
+
+    // -------------- gather the meshlets of each mesh and point the submeshes at them --------------
+    model.meshletStorage.resize(model.meshes.size());
+
+    uint64_t triangles = 0u;
+    uint64_t vertices  = 0u;
+    uint32_t meshlets  = 0u;
+    for (auto &range : ranges)
+    {
+        auto          &storage      = model.meshletStorage[range.meshIndex];
+        const uint32_t firstMeshlet = static_cast<uint32_t>(storage.size());
+        storage.insert(storage.end(), range.meshlets.begin(), range.meshlets.end());
+
+        auto assign = [&](std::span<SubmeshData> submeshes) {
+            for (auto &submesh : submeshes)
+            {
+                if (submesh.startIndexLocation == range.startIndexLocation && submesh.indexCount > 0u)
+                {
+                    submesh.firstMeshlet = firstMeshlet;
+                    submesh.meshletCount = static_cast<uint32_t>(range.meshlets.size());
+                }
+            }
+        };
+
+        auto &mesh = model.meshes[range.meshIndex];
+        assign(mesh.submeshes);
+        for (auto &lod : mesh.lods)
+        {
+            assign(lod.submeshes);
+        }
+
+        for (auto &meshlet : range.meshlets)
+        {
+            triangles += meshlet.indexCount / 3u;
+            vertices += meshlet.vertexCount;
+        }
+
+        meshlets += static_cast<uint32_t>(range.meshlets.size());
+    }
+
+    for (size_t m = 0; m < model.meshes.size(); m++)
+    {
+        model.meshes[m].meshlets = model.meshletStorage[m];
+    }
+
+    auto end     = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    const float weight = 1.0f / std::max(meshlets, 1u);
+    LOG_INFO(fmt::format(
+        "Built {} meshlets for {} index ranges in {:.3f} ms ({:.1f} triangles, {:.1f} vertices per meshlet)", meshlets,
+        rangeCount, elapsed.count() / 1000.0f, triangles * weight, vertices * weight
+    ));
+}
+
+int32_t getImageIndex(const fastgltf::Asset &asset, size_t textureIndex)
+{
+    auto &imageIndex = asset.textures[textureIndex].imageIndex;
+    return imageIndex.has_value() ? static_cast<int32_t>(imageIndex.value()) : -1;
+}
+
+/*
+ * Gets the angles XMMatrixRotationRollPitchYaw takes to build the same rotation as a quaternion.
+ *
+ * @param quaternion A unit quaternion.
+ * @return The pitch, yaw and roll in degrees.
+ */
+dx::XMFLOAT3 getPitchYawRoll(dx::FXMVECTOR quaternion)
+{
+    dx::XMFLOAT4X4 m;
+    dx::XMStoreFloat4x4(&m, dx::XMMatrixRotationQuaternion(quaternion));
+
+    // -------------- the third row of a roll, pitch, yaw rotation is (cos p sin y, -sin p, cos p cos y) --------------
+    const float cosPitch = std::hypot(m._31, m._33);
+    const float pitch    = std::atan2(-m._32, cosPitch);
+    float       yaw      = 0.0f;
+    float       roll     = 0.0f;
+    if (cosPitch > 1e-4f)
+    {
+        yaw  = std::atan2(m._31, m._33);
+        roll = std::atan2(m._12, m._22);
+    }
+    else
+    {
+        // looking straight up or down, yaw and roll turn around the same axis so yaw takes all of it
+        yaw = std::atan2(-m._13, m._11);
+    }
+
+    return {dx::XMConvertToDegrees(pitch), dx::XMConvertToDegrees(yaw), dx::XMConvertToDegrees(roll)};
+}
+
+/*
+ * Splits a glTF node's transform into the scale, rotation and translation of a NodeData.
+ * Matrices with shear can't be represented and lose it.
+ *
+ * @param node The glTF node.
+ * @param data The node to fill.
+ */
+void decomposeNode(const fastgltf::Node &node, NodeData &data)
+{
+    // -------------- a column major matrix for column vectors is the row major one for row vectors --------------
+    const fastgltf::math::fmat4x4 matrix = fastgltf::getTransformMatrix(node);
+
+    dx::XMFLOAT4X4 m;
+    for (size_t column = 0; column < 4; column++)
+    {
+        for (size_t row = 0; row < 4; row++)
+            m.m[column][row] = matrix[column][row];
+    }
+
+    dx::XMVECTOR scale;
+    dx::XMVECTOR rotation;
+    dx::XMVECTOR translation;
+    if (!dx::XMMatrixDecompose(&scale, &rotation, &translation, dx::XMLoadFloat4x4(&m)))
+    {
+        LOG_WARNING("Node " + data.name + " has a scale of 0, it is imported without scale and rotation");
+        data.translation = {m._41, m._42, m._43};
+        return;
+    }
+
+    dx::XMStoreFloat3(&data.scale, scale);
+    dx::XMStoreFloat3(&data.translation, translation);
+    data.rotation = getPitchYawRoll(rotation);
+}
+
+/*
+ * Adds a child node for every instance of a node using EXT_mesh_gpu_instancing.
+ * An instance's transform is applied before the node's, which is what being its child does.
+ *
+ * @param asset The glTF asset.
+ * @param node The glTF node.
+ * @param mesh The node's mesh, in ModelData::meshes.
+ * @param parent The node's index in ModelData::nodes.
+ * @param model The model to add the instances to.
+ * @return The number of instances, 0 if the node isn't instanced.
+ */
+uint32_t addInstances(
+    const fastgltf::Asset &asset, const fastgltf::Node &node, int32_t mesh, int32_t parent, ModelData &model
+)
+{
+    auto findAccessor = [&](std::string_view name) -> const fastgltf::Accessor * {
+        auto it = std::ranges::find_if(node.instancingAttributes, [&](auto &attribute) {
+            return std::string_view(attribute.name) == name;
+        });
+        return it != node.instancingAttributes.end() ? &asset.accessors[it->accessorIndex] : nullptr;
+    };
+
+    const fastgltf::Accessor *translations = findAccessor("TRANSLATION");
+    const fastgltf::Accessor *rotations    = findAccessor("ROTATION");
+    const fastgltf::Accessor *scales       = findAccessor("SCALE");
+    if (mesh < 0 || (!translations && !rotations && !scales))
+    {
+        return 0u;
+    }
+
+    // -------------- every attribute has one element per instance --------------
+    size_t count = 0u;
+    for (const fastgltf::Accessor *accessor : {translations, rotations, scales})
+    {
+        if (accessor)
+            count = std::max(count, accessor->count);
+    }
+
+    std::vector<dx::XMFLOAT3> instanceTranslations(count, {0.0f, 0.0f, 0.0f});
+    std::vector<dx::XMFLOAT4> instanceRotations(count, {0.0f, 0.0f, 0.0f, 1.0f});
+    std::vector<dx::XMFLOAT3> instanceScales(count, {1.0f, 1.0f, 1.0f});
+    if (translations)
+    {
+        fastgltf::iterateAccessorWithIndex<dx::XMFLOAT3>(
+            asset, *translations, [&](dx::XMFLOAT3 translation, size_t i) { instanceTranslations[i] = translation; }
+        );
+    }
+    if (rotations)
+    {
+        fastgltf::iterateAccessorWithIndex<dx::XMFLOAT4>(
+            asset, *rotations, [&](dx::XMFLOAT4 rotation, size_t i) { instanceRotations[i] = rotation; }
+        );
+    }
+    if (scales)
+    {
+        fastgltf::iterateAccessorWithIndex<dx::XMFLOAT3>(
+            asset, *scales, [&](dx::XMFLOAT3 scale, size_t i) { instanceScales[i] = scale; }
+        );
+    }
+
+    // -------------- the instances draw the mesh, the node only places them --------------
+    const std::string name = std::string(node.name);
+    model.nodes.reserve(model.nodes.size() + count);
+    for (size_t i = 0; i < count; i++)
+    {
+        model.nodes.push_back({
+            .name        = fmt::format("{}_{}", name, i),
+            .mesh        = mesh,
+            .parent      = parent,
+            .scale       = instanceScales[i],
+            .rotation    = getPitchYawRoll(dx::XMQuaternionNormalize(dx::XMLoadFloat4(&instanceRotations[i]))),
+            .translation = instanceTranslations[i],
+        });
+    }
+
+    return static_cast<uint32_t>(count);
+}
+
+/*
+ * Imports the nodes of the asset's default scene, or a node for every mesh if it has no scenes.
+ *
+ * @param asset The glTF asset.
+ * @param meshIndices The ModelData::meshes index of every glTF mesh.
+ * @param model The model to fill.
+ */
+void importNodes(const fastgltf::Asset &asset, std::span<const int32_t> meshIndices, ModelData &model)
+{
+    if (asset.scenes.empty())
+    {
+        for (size_t i = 0; i < model.meshes.size(); i++)
+        {
+            model.nodes.push_back({.name = model.meshes[i].name, .mesh = static_cast<int32_t>(i)});
+        }
+        return;
+    }
+
+    // -------------- walk the scene depth first, so every node is added after its parent --------------
+    const size_t                            sceneIndex    = asset.defaultScene.has_value() ? *asset.defaultScene : 0u;
+    const auto                             &roots         = asset.scenes[sceneIndex].nodeIndices;
+    uint32_t                                instanceCount = 0u;
+    std::vector<std::pair<size_t, int32_t>> stack; // glTF node and parent in ModelData::nodes
+    std::vector<uint8_t>                    visited(asset.nodes.size(), 0u);
+    for (size_t i = roots.size(); i-- > 0u;)
+    {
+        stack.push_back({roots[i], -1});
+    }
+
+    while (!stack.empty())
+    {
+        auto [nodeIndex, parent] = stack.back();
+        stack.pop_back();
+
+        // a node only ever has one parent, a node seen twice means the file has a cycle
+        if (visited[nodeIndex])
+        {
+            LOG_WARNING(fmt::format("Node {} is reachable more than once, skipping it", nodeIndex));
+            continue;
+        }
+        visited[nodeIndex] = 1u;
+
+        auto    &node  = asset.nodes[nodeIndex];
+        NodeData data  = {.name = std::string(node.name), .parent = parent};
+        int32_t  mesh  = node.meshIndex.has_value() ? meshIndices[node.meshIndex.value()] : -1;
+        int32_t  index = static_cast<int32_t>(model.nodes.size());
+        decomposeNode(node, data);
+        model.nodes.push_back(data);
+
+        // -------------- an instanced node draws its mesh from one child per instance instead --------------
+        const uint32_t instances = addInstances(asset, node, mesh, index, model);
+        if (instances == 0u)
+        {
+            model.nodes[index].mesh = mesh;
+        }
+        instanceCount += instances;
+
+        for (size_t i = node.children.size(); i-- > 0u;)
+        {
+            stack.push_back({node.children[i], index});
+        }
+    }
+
+    const auto drawn = std::ranges::count_if(model.nodes, [](const NodeData &node) { return node.mesh >= 0; });
+    LOG_INFO(fmt::format(
+        "Imported {} nodes, {} of them instances from EXT_mesh_gpu_instancing, drawing {} meshes {} times",
+        model.nodes.size(), instanceCount, model.meshes.size(), drawn
+    ));
+}
+
+} // namespace
+
+bool importGltf(const std::filesystem::path &path, ModelData &model, const ImportOptions &options)
+{
+    // -------------- use no flags if .glb, other load buffers --------------
+    fastgltf::Options flags;
+    if (path.extension() == ".glb")
+        flags = fastgltf::Options::None;
+    else
+        flags = fastgltf::Options::LoadExternalBuffers;
+
+    // -------------- attempt to load the file --------------
+    auto data = fastgltf::GltfDataBuffer::FromPath(path);
+    if (data.error() != fastgltf::Error::None)
+    {
+        LOG_WARNING("Failed to find " + path.string());
+        return false;
+    }
+
+    // -------------- attempt to parse the .gltf or .glb file --------------
+    fastgltf::Parser parser(fastgltf::Extensions::EXT_mesh_gpu_instancing);
+    auto             asset = parser.loadGltf(data.get(), path.parent_path(), flags);
+    if (auto error = asset.error(); error != fastgltf::Error::None)
+    {
+        LOG_WARNING("Failed to parse " + path.string());
+        return false;
+    }
+
+    // -------------- validate the file --------------
+    auto error = fastgltf::validate(asset.get());
+    if (error != fastgltf::Error::None)
+    {
+        LOG_WARNING("File is not a valid glTF file");
+        return false;
+    }
+
+    // -------------- copy the encoded images --------------
+    model.imageStorage.reserve(asset->images.size());
+    for (auto &image : asset->images)
+    {
+        auto &bytes = model.imageStorage.emplace_back(readImageBytes(asset.get(), image, path.parent_path()));
+        model.images.push_back({.name = std::string(image.name), .bytes = bytes});
+    }
+
+    // -------------- gather materials --------------
+    for (auto &&mat : asset->materials)
+    {
+        MaterialData material{};
+        material.name    = std::string(mat.name);
+        material.diffuse = {0.0f, 0.0f, 0.0f};
+        if (mat.pbrData.baseColorTexture.has_value())
+        {
+            material.diffuseImage = getImageIndex(asset.get(), mat.pbrData.baseColorTexture.value().textureIndex);
+            material.diffuse      = {1.0f, 0.0f, 0.0f};
+        }
+        if (mat.pbrData.metallicRoughnessTexture.has_value())
+        {
+            material.metallicRoughnessImage =
+                getImageIndex(asset.get(), mat.pbrData.metallicRoughnessTexture.value().textureIndex);
+        }
+        if (mat.normalTexture.has_value())
+        {
+            material.normalImage = getImageIndex(asset.get(), mat.normalTexture.value().textureIndex);
+        }
+
+        model.materials.push_back(material);
+    }
+
+    // -------------- meshes made of the same primitives are only decoded once --------------
+    std::vector<int32_t>                   meshIndices(asset->meshes.size(), -1);
+    std::map<std::vector<size_t>, int32_t> uniqueMeshes;
+    for (size_t i = 0; i < asset->meshes.size(); i++)
+    {
+        std::vector<size_t> key;
+        for (auto &&p : asset->meshes[i].primitives)
+        {
+            key.push_back(p.indicesAccessor.has_value() ? p.indicesAccessor.value() : SIZE_MAX);
+            key.push_back(p.materialIndex.has_value() ? p.materialIndex.value() : SIZE_MAX);
+            key.push_back(p.attributes.size());
+            for (auto &attribute : p.attributes)
+                key.push_back(attribute.accessorIndex);
+        }
+
+        auto [it, inserted] = uniqueMeshes.try_emplace(std::move(key), static_cast<int32_t>(uniqueMeshes.size()));
+        meshIndices[i]      = it->second;
+    }
+
+    if (uniqueMeshes.size() < asset->meshes.size())
+    {
+        LOG_INFO(fmt::format(
+            "{} of {} meshes repeat the primitives of another mesh and share it",
+            asset->meshes.size() - uniqueMeshes.size(), asset->meshes.size()
+        ));
+    }
+
+    // -------------- lay out the vertices and indices of every primitive --------------
+    std::vector<PrimitiveRange> primitives;
+    model.meshes.reserve(uniqueMeshes.size());
+    model.vertexStorage.reserve(uniqueMeshes.size());
+    model.indexStorage.reserve(uniqueMeshes.size());
+    for (size_t i = 0; i < asset->meshes.size(); i++)
+    {
+        if (meshIndices[i] != static_cast<int32_t>(model.meshes.size()))
+        {
+            continue;
+        }
+
+        auto &mesh     = asset->meshes[i];
+        auto &meshData = model.meshes.emplace_back();
+        meshData.name  = std::string(mesh.name);
+
+        // -------------- reserve a range for each primitive as a submesh --------------
+        uint32_t vertexCount = 0u;
+        uint32_t indexCount  = 0u;
+        meshData.submeshes.reserve(mesh.primitives.size());
+        for (auto &&p : mesh.primitives)
+        {
+            SubmeshData submesh{};
+            submesh.baseVertexLocation = vertexCount;
+            submesh.startIndexLocation = indexCount;
+            submesh.indexCount         = static_cast<uint32_t>(asset->accessors[p.indicesAccessor.value()].count);
+            if (p.materialIndex.has_value())
+            {
+                submesh.materialIndex = static_cast<int32_t>(p.materialIndex.value());
+            }
+
+            auto          &positions = asset->accessors[p.findAttribute("POSITION")->accessorIndex];
+            PrimitiveRange range     = {
+                .primitive    = &p,
+                .meshIndex    = static_cast<uint32_t>(model.meshes.size() - 1u),
+                .submeshIndex = static_cast<uint32_t>(meshData.submeshes.size()),
+                .vertexStart  = vertexCount,
+                .vertexCount  = static_cast<uint32_t>(positions.count),
+                .indexStart   = indexCount,
+                .indexCount   = submesh.indexCount,
+            };
+
+            meshData.submeshes.push_back(submesh);
+            primitives.push_back(range);
+
+            vertexCount += range.vertexCount;
+            indexCount += range.indexCount;
+        }
+
+        meshData.vertices = model.vertexStorage.emplace_back(vertexCount);
+        meshData.indices  = model.indexStorage.emplace_back(indexCount);
+    }
+
+    // -------------- decode every primitive into its range --------------
+    auto decodeStart = std::chrono::system_clock::now();
+    auto decode      = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            auto &range = primitives[i];
+            decodePrimitive(
+                asset.get(), *range.primitive, model.vertexStorage[range.meshIndex].data() + range.vertexStart,
+                model.indexStorage[range.meshIndex].data() + range.indexStart
+            );
+        }
+    };
+
+    const uint32_t primitiveCount = static_cast<uint32_t>(primitives.size());
+    if (options.parallel)
+    {
+        JobSystem::get().parallelFor(primitiveCount, 1u, decode);
+    }
+    else
+    {
+        decode(0u, primitiveCount);
+    }
+
+    auto decodeEnd     = std::chrono::system_clock::now();
+    auto decodeElapsed = std::chrono::duration_cast<std::chrono::microseconds>(decodeEnd - decodeStart);
+
+    LOG_INFO(fmt::format(
+        "Decoded {} primitives in {:.3f} ms ({}, {} workers)", primitives.size(), decodeElapsed.count() / 1000.0f,
+        options.parallel ? "parallel" : "serial", options.parallel ? JobSystem::get().getWorkerCount() : 0u
+    ));
+
+    if (options.optimizeMeshes)
+    {
+        optimizePrimitives(model, primitives, options.parallel);
+    }
+
+    if (options.generateLods)
+    {
+        generateLods(model, primitives, options.parallel);
+    }
+
+    if (options.buildMeshlets)
+    {
+        buildMeshlets(model, options.parallel);
+    }
+
+    // -------------- bounds last, optimizing may have dropped vertices --------------
+    for (auto &mesh : model.meshes)
+    {
+        mesh.bounds = scene::FrustumCuller::computeBounds(mesh.vertices);
+    }
+
+    importNodes(asset.get(), meshIndices, model);
+    return true;
+}
+
+SourceStamp getSourceStamp(const std::filesystem::path &path, const ImportOptions &options)
+{
+    SourceStamp stamp;
+
+    Hasher optionsHasher;
+    optionsHasher.updateValue(options.optimizeMeshes);
+    optionsHasher.updateValue(options.generateLods);
+    optionsHasher.updateValue(options.buildMeshlets);
+    stamp.optionsHash = optionsHasher.finish();
+
+    // -------------- the source, then everything next to a .gltf file sorted by name --------------
+    std::vector<std::filesystem::path> sources = {path};
+    std::error_code                    ec;
+    if (path.extension() == ".gltf")
+    {
+        for (auto &entry : std::filesystem::directory_iterator(path.parent_path(), ec))
+        {
+            if (entry.is_regular_file(ec) && entry.path() != path && entry.path().extension() != ".bmesh")
+                sources.push_back(entry.path());
+        }
+        std::sort(sources.begin() + 1, sources.end());
+    }
+
+    Hasher sourcesHasher;
+    for (auto &source : sources)
+    {
+        sourcesHasher.update(source.filename().string());
+        sourcesHasher.updateValue(std::filesystem::file_size(source, ec));
+        sourcesHasher.updateValue(std::filesystem::last_write_time(source, ec).time_since_epoch().count());
+    }
+    stamp.sourcesHash = sourcesHasher.finish();
+
+    return stamp;
+}
+
+} // namespace bisky::core::ModelCooker
\ No newline at end of file
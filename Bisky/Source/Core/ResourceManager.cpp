@@ -1,19 +1,180 @@
 #include "Common.hpp"
 
+#include "Core/DerivedDataCache.hpp"
+#include "Core/Hash.hpp"
+#include "Core/JobSystem.hpp"
+#include "Core/ModelCooker.hpp"
 #include "Core/ResourceManager.hpp"
 #include "Graphics/Device.hpp"
+#include "Graphics/TextureProcessor.hpp"
 #include "Scene/Material.hpp"
 #include "Scene/Vertex.hpp"
+#include "Scene/VertexQuantizer.hpp"
 
 namespace bisky::core
 {
 
+namespace
+{
+
+// bump these whenever the processing changes so stale cache entries are ignored
+constexpr uint32_t MeshProcessVersion    = 4u;
+constexpr uint32_t TextureProcessVersion = 2u;
+
+/*
+ * The header in front of the mip levels of a processed texture cache entry.
+ */
+struct ProcessedImageHeader
+{
+    uint32_t    width;
+    uint32_t    height;
+    uint32_t    mipLevels;
+    DXGI_FORMAT format;
+};
+
+/*
+ * Hashes everything a model import depends on.
+ * A .gltf file can reference any file next to it, so every file in its directory is hashed too.
+ *
+ * @param path The source model.
+ * @param options The import options, since they change the result.
+ * @param key The resulting cache key.
+ * @return True if the sources could be read.
+ */
+bool hashModelSource(const std::filesystem::path &path, const ModelCooker::ImportOptions &options, uint64_t &key)
+{
+    Hasher hasher;
+    hasher.update("mesh");
+    hasher.updateValue(MeshProcessVersion);
+    hasher.updateValue(ModelCooker::Version);
+    hasher.updateValue(sizeof(scene::Vertex));
+    hasher.updateValue(options.optimizeMeshes);
+    hasher.updateValue(options.generateLods);
+    hasher.updateValue(options.buildMeshlets);
+    if (!hasher.updateFile(path))
+    {
+        return false;
+    }
+
+    if (path.extension() == ".gltf")
+    {
+        std::vector<std::filesystem::path> dependencies;
+        std::error_code                    ec;
+        for (auto &entry : std::filesystem::directory_iterator(path.parent_path(), ec))
+        {
+            if (entry.is_regular_file(ec) && entry.path() != path && entry.path().extension() != ".bmesh")
+                dependencies.push_back(entry.path());
+        }
+
+        std::ranges::sort(dependencies);
+        for (auto &dependency : dependencies)
+        {
+            hasher.update(dependency.filename().string());
+            hasher.updateFile(dependency);
+        }
+    }
+
+    key = hasher.finish();
+    return true;
+}
+
+/*
+ * Decodes an encoded image, generates its mips and block compresses them,
+ * or reads the result from the derived data cache.
+ *
+ * @param name The name of the image for logging.
+ * @param bytes The encoded image.
+ * @param role What the image is sampled for.
+ * @param imageData The dimensions, format and mip levels of the processed image.
+ * @param entry Filled with a ProcessedImageHeader followed by the mip levels.
+ * @return True if the image could be decoded.
+ */
+bool processImage(
+    std::string_view name, std::span<const uint8_t> bytes, gfx::TextureRole role, gfx::ImageData &imageData,
+    std::vector<uint8_t> &entry
+)
+{
+    namespace TextureProcessor = gfx::TextureProcessor;
+
+    constexpr gfx::TextureQuality Quality = gfx::TextureQuality::High;
+
+    Hasher hasher;
+    hasher.update("texture");
+    hasher.updateValue(TextureProcessVersion);
+    hasher.updateValue(role);
+    hasher.updateValue(Quality);
+    hasher.update(bytes.data(), bytes.size());
+    const uint64_t key = hasher.finish();
+
+    // -------------- use the cached mips if they're complete --------------
+    auto &cache = DerivedDataCache::get();
+    if (cache.load("textures", key, entry) && entry.size() >= sizeof(ProcessedImageHeader))
+    {
+        ProcessedImageHeader header;
+        memcpy(&header, entry.data(), sizeof(ProcessedImageHeader));
+
+        const size_t size =
+            TextureProcessor::getTextureSize(header.format, header.width, header.height, header.mipLevels);
+        if (entry.size() == sizeof(ProcessedImageHeader) + size)
+        {
+            imageData.width        = static_cast<int>(header.width);
+            imageData.height       = static_cast<int>(header.height);
+            imageData.channelCount = 4;
+            imageData.format       = header.format;
+            imageData.mipLevels    = header.mipLevels;
+            return true;
+        }
+    }
+
+    // -------------- otherwise decode, process and store them --------------
+    unsigned char *pixels = stbi_load_from_memory(
+        bytes.data(), static_cast<int>(bytes.size()), &imageData.width, &imageData.height, &imageData.channelCount, 4
+    );
+    if (!pixels)
+    {
+        return false;
+    }
+
+    auto                  start = std::chrono::system_clock::now();
+    gfx::ProcessedTexture texture;
+    TextureProcessor::process(
+        pixels, static_cast<uint32_t>(imageData.width), static_cast<uint32_t>(imageData.height), role, Quality, texture
+    );
+    stbi_image_free(pixels);
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start);
+
+    imageData.channelCount = 4;
+    imageData.format       = texture.format;
+    imageData.mipLevels    = texture.mipLevels;
+
+    // -------------- report against the single RGBA8 level that used to be uploaded --------------
+    const float sourceSize = texture.width * texture.height * 4.0f / (1024.0f * 1024.0f);
+    const float size       = texture.data.size() / (1024.0f * 1024.0f);
+    LOG_INFO(fmt::format(
+        "{}: {}x{} {} with {} mips in {:.3f} ms ({:.1f} MB/s), {:.2f} MB -> {:.2f} MB, {:.2f} MB saved", name,
+        texture.width, texture.height, TextureProcessor::getFormatName(texture.format), texture.mipLevels,
+        elapsed.count() / 1000.0f, sourceSize / std::max(elapsed.count() / 1000000.0f, 1e-6f), sourceSize, size,
+        sourceSize - size
+    ));
+
+    ProcessedImageHeader header = {texture.width, texture.height, texture.mipLevels, texture.format};
+    entry.resize(sizeof(ProcessedImageHeader) + texture.data.size());
+    memcpy(entry.data(), &header, sizeof(ProcessedImageHeader));
+    memcpy(entry.data() + sizeof(ProcessedImageHeader), texture.data.data(), texture.data.size());
+
+    cache.store("textures", key, entry);
+    return true;
+}
+
+} // namespace
+
 void _setWorkingDirectory(const std::filesystem::path &filepath)
 {
     ResourceManager::get().setWorkingDirectory(filepath);
     ResourceManager::get().setShaderDirectory("Shaders");
     ResourceManager::get().setModelDirectory("Assets\\Models");
     ResourceManager::get().setTextureDirectory("Assets\\Textures");
+    DerivedDataCache::get().setDirectory(filepath / "Cache");
 }
 
 void ResourceManager::reset()
@@ -46,286 +207,323 @@ void ResourceManager::setTextureDirectory(const std::filesystem::path &path)
     LOG_INFO("Texture directory set to " + m_textureDirectory.string());
 }
 
-bool ResourceManager::loadMesh(gfx::Device *const device, const std::filesystem::path &filename)
+void ResourceManager::setImportOptions(const ModelCooker::ImportOptions &options)
 {
-    const std::filesystem::path path = m_modelDirectory / filename;
-
-    // -------------- use no flags if .glb, other load buffers --------------
-    fastgltf::Options flags;
-    if (path.extension() == ".glb")
-        flags = fastgltf::Options::None;
-    else
-        flags = fastgltf::Options::LoadExternalBuffers;
+    m_importOptions = options;
+}
 
-    // -------------- attempt to load the file --------------
-    auto data = fastgltf::GltfDataBuffer::FromPath(path);
-    if (data.error() != fastgltf::Error::None)
+bool ResourceManager::loadMesh(
+    gfx::Device *const device, const std::filesystem::path &filename, scene::VertexFormat vertexFormat,
+    std::vector<ModelNode> *nodes
+)
+{
+    auto                        start      = std::chrono::system_clock::now();
+    const std::filesystem::path path       = m_modelDirectory / filename;
+    const std::filesystem::path cookedPath = ModelCooker::getCookedPath(path);
+
+    // -------------- use the cooked file if it was cooked from these sources with these options --------------
+    ModelData        model;
+    std::string_view source = "";
+    std::error_code  ec;
+    if (std::filesystem::exists(cookedPath, ec))
     {
-        LOG_WARNING("Failed to find " + path.string());
-        return false;
+        // a cooked file shipped without its source is used as is
+        const bool                     hasSource = std::filesystem::exists(path, ec);
+        const ModelCooker::SourceStamp stamp     = ModelCooker::getSourceStamp(path, m_importOptions);
+        if (ModelCooker::read(cookedPath, model, hasSource ? &stamp : nullptr))
+            source = "the cooked file";
     }
 
-    // -------------- attempt to parse the .gltf or .glb file --------------
-    fastgltf::Parser parser;
-    auto             asset = parser.loadGltf(data.get(), path.parent_path(), flags);
-    if (auto error = asset.error(); error != fastgltf::Error::None)
+    // -------------- then the derived data cache --------------
+    auto    &cache = DerivedDataCache::get();
+    uint64_t key   = 0u;
+    if (source.empty() && hashModelSource(path, m_importOptions, key))
     {
-        LOG_WARNING("Failed to parse " + path.string());
-        return false;
+        model = ModelData{};
+        if (ModelCooker::read(cache.map("meshes", key), model))
+            source = "the derived data cache";
     }
 
-    // -------------- validate the file --------------
-    auto error = fastgltf::validate(asset.get());
-    if (error != fastgltf::Error::None)
+    // -------------- otherwise import the source file and cache it --------------
+    if (source.empty())
     {
-        LOG_WARNING("File is not a valid glTF file");
-        return false;
+        model = ModelData{};
+        if (!ModelCooker::importGltf(path, model, m_importOptions))
+        {
+            return false;
+        }
+
+        source = "a glTF import";
+        if (key != 0u)
+        {
+            cache.store("meshes", key, [&](const std::filesystem::path &entry) {
+                return ModelCooker::write(entry, model);
+            });
+        }
     }
 
-    // -------------- load textures --------------
-    std::vector<std::shared_ptr<gfx::Texture>> textures;
-    for (auto &image : asset->images)
+    auto readEnd     = std::chrono::system_clock::now();
+    auto readElapsed = std::chrono::duration_cast<std::chrono::microseconds>(readEnd - start);
+
+    // -------------- the materials decide how each image is compressed --------------
+    std::vector<gfx::TextureRole> roles(model.images.size(), gfx::TextureRole::Diffuse);
+    for (auto &material : model.materials)
     {
-        std::shared_ptr<gfx::Texture> texture = std::make_shared<gfx::Texture>();
-        std::visit(
-            fastgltf::visitor(
-                [&](auto &arg) {}, [&](fastgltf::sources::Array &array) { LOG_INFO("hi"); },
-                [&](fastgltf::sources::BufferView &view) {
-                    auto &bufferView = asset->bufferViews[view.bufferViewIndex];
-                    auto &buffer     = asset->buffers[bufferView.bufferIndex];
-                    std::visit(
-                        fastgltf::visitor(
-                            [&](auto &arg) {}, [&](fastgltf::sources::URI &filePath) {},
-                            [&](fastgltf::sources::Array &array) {
-                                auto texture = device->createImageFromMemory(
-                                    reinterpret_cast<stbi_uc *>(array.bytes.data() + bufferView.byteOffset),
-                                    array.bytes.size()
-                                );
-
-                                if (!texture)
-                                {
-                                    LOG_WARNING("Failed to create image from memory");
-                                    return;
-                                }
-
-                                std::string name = image.name.data();
-                                if (name.empty())
-                                    name = "texture_" + std::to_string(m_textures.size());
-
-                                m_textures[name] = texture;
-                                textures.push_back(texture);
-                                LOG_INFO("Loaded texture: " + name);
-                            }
-                        ),
-                        buffer.data
-                    );
-                }
-            ),
-            image.data
-        );
+        if (material.normalImage >= 0 && static_cast<size_t>(material.normalImage) < roles.size())
+            roles[material.normalImage] = gfx::TextureRole::Normal;
+        if (material.metallicRoughnessImage >= 0 && static_cast<size_t>(material.metallicRoughnessImage) < roles.size())
+            roles[material.metallicRoughnessImage] = gfx::TextureRole::MetallicRoughness;
     }
 
-    // -------------- create materials --------------
-    std::vector<std::shared_ptr<scene::Material>> materials;
-    for (auto &&mat : asset->materials)
+    std::vector<std::string> names(model.images.size());
+    for (size_t i = 0; i < model.images.size(); i++)
     {
-        std::shared_ptr<scene::Material> newMat = std::make_shared<scene::Material>();
-        if (mat.pbrData.baseColorTexture.has_value())
-        {
-            size_t image = asset->textures[mat.pbrData.baseColorTexture.value().textureIndex].imageIndex.value();
-            if (image < textures.size())
-            {
-                newMat->diffuseTexture = textures[image].get();
-            }
+        names[i] = model.images[i].name.empty() ? "texture_" + std::to_string(m_textures.size() + i)
+                                                : model.images[i].name;
+    }
 
-            XMStoreFloat3(&newMat->diffuse, dx::FXMVECTOR{1.0f, 0.0f, 0.0f});
-        }
-        if (mat.pbrData.metallicRoughnessTexture.has_value())
+    // -------------- decode and process every image on the job system --------------
+    auto                              imageStart = std::chrono::system_clock::now();
+    std::vector<gfx::ImageData>       imageData(model.images.size());
+    std::vector<std::vector<uint8_t>> entries(model.images.size());
+    std::vector<uint8_t>              processed(model.images.size(), 0u);
+    auto                              process = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
         {
-            size_t image =
-                asset->textures[mat.pbrData.metallicRoughnessTexture.value().textureIndex].imageIndex.value();
-            if (image < textures.size())
-            {
-                newMat->metallicRoughnessTexture = textures[image].get();
-            }
+            auto &image = model.images[i];
+            if (!image.bytes.empty())
+                processed[i] = processImage(names[i], image.bytes, roles[i], imageData[i], entries[i]) ? 1u : 0u;
         }
-        if (mat.normalTexture.has_value())
+    };
+
+    const uint32_t imageCount = static_cast<uint32_t>(model.images.size());
+    if (m_importOptions.parallel)
+        JobSystem::get().parallelFor(imageCount, 1u, process);
+    else
+        process(0u, imageCount);
+
+    auto imageElapsed =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - imageStart);
+    LOG_INFO(fmt::format(
+        "Processed {} images in {:.3f} ms ({}, {} workers)", imageCount, imageElapsed.count() / 1000.0f,
+        m_importOptions.parallel ? "parallel" : "serial",
+        m_importOptions.parallel ? JobSystem::get().getWorkerCount() : 0u
+    ));
+
+    // -------------- begin resource upload block, shared by every texture and mesh --------------
+    gfx::ResourceUpload upload(device);
+    upload.Begin();
+
+    // -------------- only the resources and views are created on this thread --------------
+    std::vector<gfx::Texture *> textures(model.images.size(), nullptr);
+    for (size_t i = 0; i < model.images.size(); i++)
+    {
+        if (!processed[i])
         {
-            size_t image = asset->textures[mat.normalTexture.value().textureIndex].imageIndex.value();
-            if (image < textures.size())
-            {
-                newMat->normalTexture = textures[image].get();
-            }
+            if (!model.images[i].bytes.empty())
+                LOG_WARNING("Failed to create image from memory");
+            continue;
         }
 
-        materials.push_back(newMat);
-        m_materials[mat.name.data()] = newMat;
+        auto texture = device->createImageFromPixels(
+            entries[i].data() + sizeof(ProcessedImageHeader), imageData[i], upload
+        );
+
+        m_textures[names[i]] = texture;
+        textures[i]          = texture.get();
+        LOG_INFO("Loaded texture: " + names[i]);
     }
 
-    // -------------- load the vertices and indices --------------
-    std::vector<scene::Vertex> vertices;
-    std::vector<uint32_t>      indices;
-    bool                       includesTangents = false;
-    for (auto &&mesh : asset->meshes)
+    // -------------- create materials --------------
+    auto getTexture = [&](int32_t image) -> gfx::Texture * {
+        return image >= 0 && static_cast<size_t>(image) < textures.size() ? textures[image] : nullptr;
+    };
+
+    std::vector<std::shared_ptr<scene::Material>> materials;
+    for (auto &material : model.materials)
     {
-        // -------------- reset vertices and indices --------------
-        vertices.clear();
-        indices.clear();
-        includesTangents = false;
+        std::shared_ptr<scene::Material> newMat = std::make_shared<scene::Material>();
+        newMat->diffuse                         = material.diffuse;
+        newMat->diffuseTexture                  = getTexture(material.diffuseImage);
+        newMat->metallicRoughnessTexture        = getTexture(material.metallicRoughnessImage);
+        newMat->normalTexture                   = getTexture(material.normalImage);
 
-        // -------------- create a mesh --------------
-        std::unique_ptr<scene::Mesh> newMesh = std::make_unique<scene::Mesh>();
-        newMesh->name                        = mesh.name;
-        newMesh->indexFormat                 = DXGI_FORMAT_R32_UINT;
-        newMesh->vertexByteStride            = sizeof(scene::Vertex);
+        materials.push_back(newMat);
+        m_materials[material.name] = newMat;
+    }
+
+    std::vector<std::unique_ptr<scene::Mesh>> newMeshes;
+    std::vector<scene::Mesh *>                meshes(model.meshes.size(), nullptr);
+    for (size_t i = 0; i < model.meshes.size(); i++)
+    {
+        // -------------- unnamed meshes are named after the file --------------
+        auto             &mesh = model.meshes[i];
+        const std::string name = mesh.name.empty() ? fmt::format("{}_{}", filename.stem().string(), i) : mesh.name;
 
         // -------------- if mesh exists, skip over it --------------
-        auto it = m_meshes.find(newMesh->name);
-        if (it != m_meshes.end())
+        auto sameName = [&](const std::unique_ptr<scene::Mesh> &newMesh) { return newMesh->name == name; };
+        if (auto it = m_meshes.find(name); it != m_meshes.end())
         {
+            meshes[i] = it->second.get();
             continue;
         }
-
-        // -------------- load each primitive as a submesh --------------
-        newMesh->submeshes.reserve(mesh.primitives.size());
-        for (auto &&p : mesh.primitives)
+        if (auto it = std::ranges::find_if(newMeshes, sameName); it != newMeshes.end())
         {
-            auto indexAccessor = p.indicesAccessor.value();
-
-            // -------------- add a submesh --------------
-            scene::Submesh submesh;
-            submesh.baseVertexLocation = static_cast<uint32_t>(vertices.size());
-            submesh.startIndexLocation = static_cast<uint32_t>(indices.size());
-            submesh.indexCount         = static_cast<uint32_t>(asset->accessors[indexAccessor].count);
+            meshes[i] = it->get();
+            continue;
+        }
 
-            // -------------- add material --------------
-            if (p.materialIndex.has_value())
+        // -------------- create a mesh --------------
+        auto &newMesh        = newMeshes.emplace_back(std::make_unique<scene::Mesh>());
+        newMesh->name        = name;
+        newMesh->indexFormat = DXGI_FORMAT_R32_UINT;
+
+        // -------------- add each submesh with its material --------------
+        auto addSubmeshes = [&](std::span<const SubmeshData> submeshes, std::vector<scene::Submesh> &newSubmeshes) {
+            newSubmeshes.reserve(submeshes.size());
+            for (auto &submesh : submeshes)
             {
-                submesh.material = materials[p.materialIndex.value()].get();
+                scene::Submesh newSubmesh{};
+                newSubmesh.baseVertexLocation = submesh.baseVertexLocation;
+                newSubmesh.startIndexLocation = submesh.startIndexLocation;
+                newSubmesh.indexCount         = submesh.indexCount;
+                newSubmesh.firstMeshlet       = submesh.firstMeshlet;
+                newSubmesh.meshletCount       = submesh.meshletCount;
+                if (submesh.materialIndex >= 0 && static_cast<size_t>(submesh.materialIndex) < materials.size())
+                {
+                    newSubmesh.material = materials[submesh.materialIndex].get();
+                }
+
+                newSubmeshes.push_back(newSubmesh);
             }
+        };
 
-            newMesh->submeshes.push_back(submesh);
+        newMesh->meshlets.assign(mesh.meshlets.begin(), mesh.meshlets.end());
+        addSubmeshes(mesh.submeshes, newMesh->submeshes);
+        for (auto &lod : mesh.lods)
+        {
+            auto &newLod = newMesh->lods.emplace_back();
+            newLod.error = lod.error;
+            addSubmeshes(lod.submeshes, newLod.submeshes);
+        }
 
-            // -------------- get indices --------------
-            indices.reserve(indices.size() + submesh.indexCount);
-            fastgltf::iterateAccessor<uint32_t>(asset.get(), asset->accessors[indexAccessor], [&](uint32_t index) {
-                indices.push_back(index + submesh.baseVertexLocation);
-            });
+        // -------------- the bounds were computed on import, for LOD selection and culling --------------
+        newMesh->bounds = mesh.bounds;
 
-            // -------------- get vertices --------------
-            {
-                auto &accessor = asset->accessors[p.findAttribute("POSITION")->accessorIndex];
-                vertices.resize(vertices.size() + accessor.count);
-                fastgltf::iterateAccessorWithIndex<dx::XMFLOAT3>(
-                    asset.get(), accessor,
-                    [&](dx::XMFLOAT3 position, size_t index) {
-                        scene::Vertex v;
-                        v.position = position;
-
-                        vertices[submesh.baseVertexLocation + index] = v;
-                    }
-                );
-            }
+        // -------------- pack the vertices if requested --------------
+        std::vector<scene::PackedVertex> packedVertices;
+        scene::QuantizationReport        report     = {};
+        const void                      *vertexData = mesh.vertices.data();
 
-            // -------------- get normals --------------
-            {
-                auto normals = p.findAttribute("NORMAL");
-                if (normals != p.attributes.end())
-                {
-                    auto &accessor = asset->accessors[normals->accessorIndex];
-                    fastgltf::iterateAccessorWithIndex<dx::XMFLOAT3>(
-                        asset.get(), accessor,
-                        [&](dx::XMFLOAT3 normal, size_t index) {
-                            vertices[submesh.baseVertexLocation + index].normal = normal;
-                        }
-                    );
-                }
-            }
+        newMesh->vertexFormat     = vertexFormat;
+        newMesh->vertexByteStride = sizeof(scene::Vertex);
+        if (vertexFormat == scene::VertexFormat::Packed)
+        {
+            auto &bounds = newMesh->quantization;
+            bounds       = scene::VertexQuantizer::computeBounds(mesh.vertices);
+            packedVertices.resize(mesh.vertices.size());
+            scene::VertexQuantizer::encodeSimd(mesh.vertices, bounds, packedVertices);
+
+            report                    = scene::VertexQuantizer::measure(mesh.vertices, packedVertices, bounds);
+            vertexData                = packedVertices.data();
+            newMesh->vertexByteStride = sizeof(scene::PackedVertex);
+        }
 
-            // -------------- get texcoords --------------
-            {
-                auto uvs = p.findAttribute("TEXCOORD_0");
-                if (uvs != p.attributes.end())
-                {
-                    auto &accessor = asset->accessors[uvs->accessorIndex];
-                    fastgltf::iterateAccessorWithIndex<dx::XMFLOAT2>(
-                        asset.get(), accessor,
-                        [&](dx::XMFLOAT2 texCoord, size_t index) {
-                            vertices[submesh.baseVertexLocation + index].texCoord = texCoord;
-                        }
-                    );
-                }
-            }
+        // -------------- indices are submesh relative, so most meshes fit in 16 bits --------------
+        std::vector<uint16_t> narrowedIndices;
+        const void           *indexData = mesh.indices.data();
+        if (scene::VertexQuantizer::fitsIn16Bits(mesh.indices))
+        {
+            narrowedIndices.resize(mesh.indices.size());
+            scene::VertexQuantizer::narrowIndices(mesh.indices, narrowedIndices);
 
-            // -------------- get tangents --------------
-            {
-                auto tangents = p.findAttribute("TANGENT");
-                if (tangents != p.attributes.end())
-                {
-                    auto &accessor = asset->accessors[tangents->accessorIndex];
-                    fastgltf::iterateAccessorWithIndex<dx::XMFLOAT4>(
-                        asset.get(), accessor,
-                        [&](dx::XMFLOAT4 tangent, size_t index) {
-                            vertices[submesh.baseVertexLocation + index].tangent = tangent;
-                        }
-                    );
-
-                    includesTangents = true;
-                }
-            }
+            indexData            = narrowedIndices.data();
+            newMesh->indexFormat = DXGI_FORMAT_R16_UINT;
         }
 
-        // TODO: calculate tangents if not included
-        // if (!includesTangents)
-        //{
-        //    for (size_t i = 0; i < indices.size(); i += 3)
-        //    {
-        //        auto i0 = indices[i];
-        //        auto i1 = indices[i + 1];
-        //        auto i2 = indices[i + 2];
-
-        //        auto v0 = vertices[i0];
-        //        auto v1 = vertices[i1];
-        //        auto v2 = vertices[i2];
-        //    }
-        //}
-
-        // -------------- begin resource upload block --------------
-        gfx::ResourceUpload upload(device);
-        upload.Begin();
-
-        // -------------- create upload buffers --------------
-        newMesh->vertexBufferByteSize = static_cast<uint32_t>(vertices.size()) * sizeof(scene::Vertex);
-        newMesh->indexBufferByteSize  = static_cast<uint32_t>(indices.size()) * sizeof(uint32_t);
-        newMesh->vertexBuffer         = device->createUploadBuffer(newMesh->vertexBufferByteSize, vertices.data());
-        newMesh->indexBuffer          = device->createUploadBuffer(newMesh->indexBufferByteSize, indices.data());
-
-        // -------------- create shader resource view --------------
-        newMesh->vertexBuffer->srvDescriptor = device->getCbvSrvUavHeap()->allocate();
-        D3D12_SHADER_RESOURCE_VIEW_DESC desc = {
-            .Format                  = DXGI_FORMAT_UNKNOWN,
-            .ViewDimension           = D3D12_SRV_DIMENSION_BUFFER,
-            .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
-            .Buffer =
-                {
-                    .FirstElement        = 0,
-                    .NumElements         = static_cast<UINT>(vertices.size()),
-                    .StructureByteStride = sizeof(scene::Vertex),
-                    .Flags               = D3D12_BUFFER_SRV_FLAG_NONE,
-                },
-        };
-        device->createShaderResourceView(newMesh->vertexBuffer.get(), &desc);
+        // -------------- copy the geometry into the geometry pool --------------
+        const uint32_t vertexCount = static_cast<uint32_t>(mesh.vertices.size());
+        const uint32_t indexCount  = static_cast<uint32_t>(mesh.indices.size());
+        if (!newMesh->createGeometry(device, vertexData, vertexCount, indexData, indexCount, upload))
+        {
+            LOG_ERROR("Failed to add mesh " + name + " to the geometry pool");
+            newMeshes.pop_back();
+            continue;
+        }
+
+        meshes[i] = newMesh.get();
+
+        LOG_INFO(fmt::format(
+            "Mesh {}: {:.1f} -> {:.1f} KB ({} vertices, {}-bit indices), "
+            "max error: position {:.5f}, normal {:.3f} deg, tangent {:.3f} deg, uv {:.5f}",
+            name, (mesh.vertices.size_bytes() + mesh.indices.size_bytes()) / 1024.0f,
+            (newMesh->vertexBufferByteSize + newMesh->indexBufferByteSize) / 1024.0f,
+            vertexFormat == scene::VertexFormat::Packed ? "packed" : "full",
+            newMesh->indexFormat == DXGI_FORMAT_R16_UINT ? 16u : 32u, report.maxPositionError, report.maxNormalError,
+            report.maxTangentError, report.maxTexCoordError
+        ));
+    }
 
-        // -------------- end resource upload block --------------
-        auto finish = upload.Finish();
-        finish.wait();
+    // -------------- end resource upload block --------------
+    // frames are drawn on the same queue after the copies, so there's nothing to wait for
+    upload.Finish();
 
+    for (auto &newMesh : newMeshes)
+    {
         // -------------- mesh loaded successfully --------------
         LOG_INFO("Loaded mesh: " + newMesh->name);
         m_meshes[newMesh->name] = std::move(newMesh);
     }
 
-    LOG_INFO("Loaded " + path.string());
+    // -------------- nodes point at the meshes, so instances of a mesh share its geometry --------------
+    if (nodes)
+    {
+        nodes->clear();
+        nodes->reserve(model.nodes.size());
+        for (auto &node : model.nodes)
+        {
+            nodes->push_back({
+                .name        = node.name,
+                .mesh        = node.mesh >= 0 ? meshes[node.mesh] : nullptr,
+                .parent      = node.parent,
+                .scale       = node.scale,
+                .rotation    = node.rotation,
+                .translation = node.translation,
+            });
+        }
+    }
+
+    auto end     = std::chrono::system_clock::now();
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+    // -------------- report load timings --------------
+    LOG_INFO(fmt::format(
+        "Loaded {} from {} in {:.3f} ms (reading took {:.3f} ms)", path.string(), source, elapsed.count() / 1000.0f,
+        readElapsed.count() / 1000.0f
+    ));
+
+    // -------------- report where the memory went --------------
+    const gfx::MemoryStats defaultStats = device->getMemoryAllocator()->getStats(D3D12_HEAP_TYPE_DEFAULT);
+    const gfx::MemoryStats uploadStats  = device->getMemoryAllocator()->getStats(D3D12_HEAP_TYPE_UPLOAD);
+    LOG_INFO(fmt::format(
+        "Heaps: {:.2f} / {:.2f} MB default ({} resources), {:.2f} / {:.2f} MB upload ({} resources)",
+        defaultStats.usedBytes / (1024.0f * 1024.0f), defaultStats.reservedBytes / (1024.0f * 1024.0f),
+        defaultStats.allocationCount, uploadStats.usedBytes / (1024.0f * 1024.0f),
+        uploadStats.reservedBytes / (1024.0f * 1024.0f), uploadStats.allocationCount
+    ));
+
+    const gfx::GeometryPoolStats poolStats = device->getGeometryPool()->getStats();
+
+    auto reportPool = [](std::string_view name, const gfx::OffsetAllocatorStats &stats) {
+        LOG_INFO(fmt::format(
+            "Geometry pool {}: {:.2f} / {:.2f} MB in {} allocations, {} free ranges, {:.1f}% fragmented", name,
+            (stats.capacity - stats.freeBytes) / (1024.0f * 1024.0f), stats.capacity / (1024.0f * 1024.0f),
+            stats.allocationCount, stats.freeRangeCount, stats.getFragmentation() * 100.0f
+        ));
+    };
+    reportPool("vertices", poolStats.vertices);
+    reportPool("16-bit indices", poolStats.indices16);
+    reportPool("32-bit indices", poolStats.indices32);
     return true;
 }
 
@@ -68,10 +68,10 @@ void Editor::beginFrame()
 
 void Editor::render(scene::Scene *const scene)
 {
-    scene::Camera *camera        = scene->getCamera();
-    dx::XMFLOAT3   position      = camera->getPosition3f();
-    auto          &renderObjects = scene->getRenderObjects();
-    auto          &lights        = scene->getLights();
+    scene::Camera         *camera   = scene->getCamera();
+    dx::XMFLOAT3           position = camera->getPosition3f();
+    scene::EntityRegistry *entities = scene->getEntities();
+    auto                  &lights   = scene->getLights();
 
     ImGui::Begin("Scene");
     if (ImGui::CollapsingHeader("Camera", ImGuiTreeNodeFlags_DefaultOpen))
@@ -110,25 +110,35 @@ void Editor::render(scene::Scene *const scene)
     }
     if (ImGui::CollapsingHeader("Objects", ImGuiTreeNodeFlags_DefaultOpen))
     {
-        for (auto &object : renderObjects)
-        {
-            auto scale       = object->transform->getScale3f();
-            auto rotation    = object->transform->getRotation3f();
-            auto translation = object->transform->getTranslation3f();
-
-            if (ImGui::TreeNode(object->name.c_str()))
-            {
-                ImGui::Unindent();
-                if (ImGui::SliderFloat3("Position", (float *)&translation, -10.0f, 10.0f))
-                    object->transform->setTranslation(translation.x, translation.y, translation.z);
-                if (ImGui::SliderFloat3("Rotation", (float *)&rotation, -180.0f, 180.0f))
-                    object->transform->setRotation(rotation.x, rotation.y, rotation.z);
-                if (ImGui::SliderFloat3("Scale", (float *)&scale, 0.0f, 100.0f))
-                    object->transform->setScale(scale.x, scale.y, scale.z);
-                ImGui::Indent();
-                ImGui::TreePop();
+        entities->forEach<gfx::Transform, scene::RenderFlags>(
+            [&](const scene::Entity *handles, uint32_t count, gfx::Transform *transforms, scene::RenderFlags *flags) {
+                for (uint32_t row = 0; row < count; row++)
+                {
+                    auto &transform   = transforms[row];
+                    auto  name        = scene->getName(handles[row]);
+                    auto  scale       = transform.getScale3f();
+                    auto  rotation    = transform.getRotation3f();
+                    auto  translation = transform.getTranslation3f();
+
+                    // names aren't unique, so the entity's index tells the tree nodes apart
+                    ImGui::PushID(static_cast<int>(handles[row].index));
+                    if (ImGui::TreeNode("Entity", "%.*s", static_cast<int>(name.size()), name.data()))
+                    {
+                        ImGui::Unindent();
+                        ImGui::Checkbox("Visible", &flags[row].visible);
+                        if (ImGui::SliderFloat3("Position", (float *)&translation, -10.0f, 10.0f))
+                            transform.setTranslation(translation.x, translation.y, translation.z);
+                        if (ImGui::SliderFloat3("Rotation", (float *)&rotation, -180.0f, 180.0f))
+                            transform.setRotation(rotation.x, rotation.y, rotation.z);
+                        if (ImGui::SliderFloat3("Scale", (float *)&scale, 0.0f, 100.0f))
+                            transform.setScale(scale.x, scale.y, scale.z);
+                        ImGui::Indent();
+                        ImGui::TreePop();
+                    }
+                    ImGui::PopID();
+                }
             }
-        }
+        );
     }
     if (ImGui::CollapsingHeader("Lights", ImGuiTreeNodeFlags_DefaultOpen))
     {
@@ -6,50 +6,86 @@
 namespace bisky::gfx
 {
 
-Allocator::Allocator(Device *const device, uint32_t size)
+Allocation::Allocation(
+    ID3D12Resource *resource, uint8_t *cpuBase, D3D12_GPU_VIRTUAL_ADDRESS gpuBase, uint32_t offset, uint32_t size
+)
+    : resource(resource), gpuBase(gpuBase), offset(offset), size(size), m_cpuBase(cpuBase)
 {
-    buffer = device->createUploadBuffer(size);
-
-    void *mapped;
-    buffer->resource->Map(0, nullptr, &mapped);
+}
 
-    cpuBase  = (char *)mapped;
-    gpuBase  = buffer->resource->GetGPUVirtualAddress();
-    at       = 0u;
-    capacity = size;
+Allocator::Allocator(Device *const device, uint32_t size) : device(device), arena(size)
+{
+    syncPages();
 }
 
 Allocator::~Allocator()
 {
-    if (cpuBase)
+    for (auto &page : pages)
     {
-        buffer->resource->Unmap(0, nullptr);
+        page.buffer->resource->Unmap(0, nullptr);
     }
 
-    buffer.reset();
+    pages.clear();
 }
 
 Allocation Allocator::allocate(uint32_t size, uint32_t align)
 {
-    uint32_t alignedSize = (size + (align - 1)) & (-(int32_t)align);
-    uint32_t aligned     = (at + (align - 1)) & (-(int32_t)align);
-
-    Allocation allocation = {
-        .resource = buffer->resource.Get(),
-        .cpuBase  = cpuBase + aligned,
-        .gpuBase  = gpuBase + aligned,
-        .offset   = aligned,
-        .size     = alignedSize,
-    };
-
-    at = aligned + size;
+    const ArenaRegion region = arena.allocate(size, align);
+    if (region.page >= pages.size())
+    {
+        syncPages();
+    }
 
-    return allocation;
+    const Page &page = pages[region.page];
+    return Allocation(
+        page.buffer->resource.Get(), page.cpuBase + region.offset, page.gpuBase + region.offset,
+        static_cast<uint32_t>(region.offset), (size + (align - 1)) & (-(int32_t)align)
+    );
 }
 
 void Allocator::reset()
 {
-    at = 0;
+    arena.reset();
+    syncPages();
+}
+
+void Allocator::syncPages()
+{
+    // -------------- drop pages the arena no longer has --------------
+    const uint32_t pageCount = arena.getPageCount();
+    for (uint32_t i = pageCount; i < pages.size(); i++)
+    {
+        pages[i].buffer->resource->Unmap(0, nullptr);
+    }
+    pages.resize(std::min<size_t>(pages.size(), pageCount));
+
+    // -------------- recreate pages that changed size, create new ones --------------
+    for (uint32_t i = 0; i < pageCount; i++)
+    {
+        const uint64_t size = arena.getPageSize(i);
+        if (i < pages.size() && pages[i].buffer->resource->GetDesc().Width == size)
+        {
+            continue;
+        }
+
+        if (i < pages.size())
+        {
+            pages[i].buffer->resource->Unmap(0, nullptr);
+        }
+        else
+        {
+            pages.emplace_back();
+        }
+
+        Page &page  = pages[i];
+        page.buffer = device->createUploadBuffer(static_cast<uint32_t>(size));
+
+        void *mapped;
+        page.buffer->resource->Map(0, nullptr, &mapped);
+
+        page.cpuBase = (uint8_t *)mapped;
+        page.gpuBase = page.buffer->resource->GetGPUVirtualAddress();
+    }
 }
 
 } // namespace bisky::gfx
\ No newline at end of file
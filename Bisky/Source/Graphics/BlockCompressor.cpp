@@ -0,0 +1,565 @@
+#include "Graphics/BlockCompressor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+namespace bisky::gfx::BlockCompressor
+{
+
+namespace
+{
+
+constexpr uint32_t PixelCount = 16u;
+
+// the interpolation weights of a 4 bit BC7 index, out of 64
+constexpr int Bc7Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+using Points = float[PixelCount][4];
+
+void toPoints(const uint8_t *pixels, Points &points)
+{
+    for (uint32_t i = 0; i < PixelCount; i++)
+    {
+        for (uint32_t c = 0; c < 4u; c++)
+        {
+            points[i][c] = pixels[i * 4u + c];
+        }
+    }
+}
+
+/*
+ * Fits a line through the points along their principal axis, long enough to cover every point's projection.
+ *
+ * @param points The points to fit.
+ * @param channels The number of channels to use, the others are left at zero.
+ * @param start The end of the line with the smallest projection.
+ * @param end The end of the line with the largest projection.
+ */
+void fitLine(const Points &points, uint32_t channels, float start[4], float end[4])
+{
+    float mean[4] = {};
+    for (uint32_t i = 0; i < PixelCount; i++)
+    {
+        for (uint32_t c = 0; c < channels; c++)
+        {
+            mean[c] += points[i][c] / PixelCount;
+        }
+    }
+
+    float covariance[4][4] = {};
+    for (uint32_t i = 0; i < PixelCount; i++)
+    {
+        for (uint32_t a = 0; a < channels; a++)
+        {
+            for (uint32_t b = 0; b < channels; b++)
+            {
+                covariance[a][b] += (points[i][a] - mean[a]) * (points[i][b] - mean[b]);
+            }
+        }
+    }
+
+    // -------------- power iteration, starting from the row of the channel with the largest spread --------------
+    uint32_t widest = 0u;
+    for (uint32_t c = 1; c < channels; c++)
+    {
+        widest = covariance[c][c] > covariance[widest][widest] ? c : widest;
+    }
+
+    float axis[4] = {};
+    for (uint32_t c = 0; c < channels; c++)
+    {
+        axis[c] = covariance[widest][c];
+    }
+
+    for (uint32_t iteration = 0; iteration < 8u; iteration++)
+    {
+        float next[4] = {};
+        float largest = 0.0f;
+        for (uint32_t a = 0; a < channels; a++)
+        {
+            for (uint32_t b = 0; b < channels; b++)
+            {
+                next[a] += covariance[a][b] * axis[b];
+            }
+
+            largest = std::max(largest, std::abs(next[a]));
+        }
+
+        // a flat block has no axis
+        if (largest < 1e-6f)
+            break;
+
+        for (uint32_t c = 0; c < channels; c++)
+        {
+            axis[c] = next[c] / largest;
+        }
+    }
+
+    float length = 0.0f;
+    for (uint32_t c = 0; c < channels; c++)
+    {
+        length += axis[c] * axis[c];
+    }
+
+    length = std::sqrt(length);
+    for (uint32_t c = 0; c < channels; c++)
+    {
+        axis[c] = length > 0.0f ? axis[c] / length : 0.0f;
+    }
+
+    // -------------- the line spans the projections of every point --------------
+    float minimum = 0.0f;
+    float maximum = 0.0f;
+    for (uint32_t i = 0; i < PixelCount; i++)
+    {
+        float projection = 0.0f;
+        for (uint32_t c = 0; c < channels; c++)
+        {
+            projection += (points[i][c] - mean[c]) * axis[c];
+        }
+
+        minimum = std::min(minimum, projection);
+        maximum = std::max(maximum, projection);
+    }
+
+    for (uint32_t c = 0; c < 4u; c++)
+    {
+        start[c] = c < channels ? std::clamp(mean[c] + axis[c] * minimum, 0.0f, 255.0f) : 0.0f;
+        end[c]   = c < channels ? std::clamp(mean[c] + axis[c] * maximum, 0.0f, 255.0f) : 0.0f;
+    }
+}
+
+/*
+ * Refits the ends of a line so interpolating them with the given weights is closest to the points.
+ *
+ * @param points The points that were fit.
+ * @param channels The number of channels to use.
+ * @param weights How far along the line each point is, from 0 at start to 1 at end.
+ * @param start The first end of the line.
+ * @param end The second end of the line.
+ * @return False if every point has the same weight, in which case the line is left alone.
+ */
+bool refitLine(const Points &points, uint32_t channels, const float *weights, float start[4], float end[4])
+{
+    // -------------- minimize sum(((1 - w) * start + w * end - point)^2) --------------
+    float aa    = 0.0f;
+    float ab    = 0.0f;
+    float bb    = 0.0f;
+    float ap[4] = {};
+    float bp[4] = {};
+    for (uint32_t i = 0; i < PixelCount; i++)
+    {
+        const float a = 1.0f - weights[i];
+        const float b = weights[i];
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (uint32_t c = 0; c < channels; c++)
+        {
+            ap[c] += a * points[i][c];
+            bp[c] += b * points[i][c];
+        }
+    }
+
+    const float determinant = aa * bb - ab * ab;
+    if (std::abs(determinant) < 1e-6f)
+    {
+        return false;
+    }
+
+    for (uint32_t c = 0; c < channels; c++)
+    {
+        start[c] = std::clamp((bb * ap[c] - ab * bp[c]) / determinant, 0.0f, 255.0f);
+        end[c]   = std::clamp((aa * bp[c] - ab * ap[c]) / determinant, 0.0f, 255.0f);
+    }
+
+    return true;
+}
+
+/*
+ * Writes values into a block from the least significant bit of the first byte up.
+ */
+struct BitWriter
+{
+    uint8_t *data;
+    uint32_t position = 0u;
+
+    void write(uint32_t value, uint32_t bits)
+    {
+        for (uint32_t b = 0; b < bits; b++, position++)
+        {
+            data[position >> 3u] |= static_cast<uint8_t>(((value >> b) & 1u) << (position & 7u));
+        }
+    }
+};
+
+// -------------- BC1 --------------
+
+uint16_t toRgb565(const float color[4])
+{
+    const uint32_t r = static_cast<uint32_t>(color[0] * 31.0f / 255.0f + 0.5f);
+    const uint32_t g = static_cast<uint32_t>(color[1] * 63.0f / 255.0f + 0.5f);
+    const uint32_t b = static_cast<uint32_t>(color[2] * 31.0f / 255.0f + 0.5f);
+    return static_cast<uint16_t>((r << 11u) | (g << 5u) | b);
+}
+
+void fromRgb565(uint16_t color, int rgb[3])
+{
+    const int r = (color >> 11u) & 31;
+    const int g = (color >> 5u) & 63;
+    const int b = color & 31;
+    rgb[0]      = (r << 3) | (r >> 2);
+    rgb[1]      = (g << 2) | (g >> 4);
+    rgb[2]      = (b << 3) | (b >> 2);
+}
+
+/*
+ * Picks the closest of the four colors between two endpoints for every pixel.
+ *
+ * @return The squared error of the block.
+ */
+uint32_t pickBc1Indices(const Points &points, uint16_t color0, uint16_t color1, uint8_t indices[PixelCount])
+{
+    int palette[4][3];
+    fromRgb565(color0, palette[0]);
+    fromRgb565(color1, palette[1]);
+    for (uint32_t c = 0; c < 3u; c++)
+    {
+        palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+        palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+    }
+
+    uint32_t error = 0u;
+    for (uint32_t i = 0; i < PixelCount; i++)
+    {
+        uint32_t best = std::numeric_limits<uint32_t>::max();
+        for (uint8_t p = 0; p < 4u; p++)
+        {
+            uint32_t distance = 0u;
+            for (uint32_t c = 0; c < 3u; c++)
+            {
+                const int difference = static_cast<int>(points[i][c]) - palette[p][c];
+                distance += difference * difference;
+            }
+
+            if (distance < best)
+            {
+                best       = distance;
+                indices[i] = p;
+            }
+        }
+
+        error += best;
+    }
+
+    return error;
+}
+
+// -------------- BC4 --------------
+
+/*
+ * Picks the closest of the eight values between two endpoints for every pixel.
+ *
+ * @return The squared error of the block.
+ */
+uint32_t pickBc4Indices(const Points &points, int value0, int value1, uint8_t indices[PixelCount])
+{
+    int palette[8] = {value0, value1};
+    for (int p = 2; p < 8; p++)
+    {
+        palette[p] = ((8 - p) * value0 + (p - 1) * value1) / 7;
+    }
+
+    uint32_t error = 0u;
+    for (uint32_t i = 0; i < PixelCount; i++)
+    {
+        uint32_t best = std::numeric_limits<uint32_t>::max();
+        for (uint8_t p = 0; p < 8u; p++)
+        {
+            const int      difference = static_cast<int>(points[i][0]) - palette[p];
+            const uint32_t distance   = difference * difference;
+            if (distance < best)
+            {
+                best       = distance;
+                indices[i] = p;
+            }
+        }
+
+        error += best;
+    }
+
+    return error;
+}
+
+// -------------- BC7 --------------
+
+/*
+ * The two RGBA endpoints of a mode 6 block, 7 bits per channel plus a shared lowest bit per endpoint.
+ */
+struct Bc7Endpoints
+{
+    uint8_t  colors[2][4];
+    uint32_t pBits[2];
+};
+
+Bc7Endpoints quantizeBc7(const float start[4], const float end[4], uint32_t pBit0, uint32_t pBit1)
+{
+    Bc7Endpoints endpoints = {.pBits = {pBit0, pBit1}};
+    for (uint32_t c = 0; c < 4u; c++)
+    {
+        endpoints.colors[0][c] = static_cast<uint8_t>(std::clamp((start[c] - pBit0) * 0.5f + 0.5f, 0.0f, 127.0f));
+        endpoints.colors[1][c] = static_cast<uint8_t>(std::clamp((end[c] - pBit1) * 0.5f + 0.5f, 0.0f, 127.0f));
+    }
+
+    return endpoints;
+}
+
+/*
+ * Picks the closest of the sixteen colors between two endpoints for every pixel.
+ *
+ * @return The squared error of the block.
+ */
+uint32_t pickBc7Indices(const Points &points, const Bc7Endpoints &endpoints, uint8_t indices[PixelCount])
+{
+    int palette[16][4];
+    for (uint32_t c = 0; c < 4u; c++)
+    {
+        const int value0 = (endpoints.colors[0][c] << 1) | endpoints.pBits[0];
+        const int value1 = (endpoints.colors[1][c] << 1) | endpoints.pBits[1];
+        for (uint32_t p = 0; p < 16u; p++)
+        {
+            palette[p][c] = ((64 - Bc7Weights[p]) * value0 + Bc7Weights[p] * value1 + 32) >> 6;
+        }
+    }
+
+    uint32_t error = 0u;
+    for (uint32_t i = 0; i < PixelCount; i++)
+    {
+        uint32_t best = std::numeric_limits<uint32_t>::max();
+        for (uint8_t p = 0; p < 16u; p++)
+        {
+            uint32_t distance = 0u;
+            for (uint32_t c = 0; c < 4u; c++)
+            {
+                const int difference = static_cast<int>(points[i][c]) - palette[p][c];
+                distance += difference * difference;
+            }
+
+            if (distance < best)
+            {
+                best       = distance;
+                indices[i] = p;
+            }
+        }
+
+        error += best;
+    }
+
+    return error;
+}
+
+} // namespace
+
+void encodeBc1(const uint8_t *pixels, uint8_t *block)
+{
+    Points points;
+    toPoints(pixels, points);
+
+    // -------------- endpoints at the ends of the principal axis --------------
+    float start[4], end[4];
+    fitLine(points, 3u, start, end);
+
+    uint16_t color0 = toRgb565(start);
+    uint16_t color1 = toRgb565(end);
+    uint8_t  indices[PixelCount];
+    uint32_t error = pickBc1Indices(points, color0, color1, indices);
+
+    // -------------- refit to the chosen indices and keep whichever is better --------------
+    constexpr float Weights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+
+    float weights[PixelCount];
+    for (uint32_t i = 0; i < PixelCount; i++)
+    {
+        weights[i] = Weights[indices[i]];
+    }
+
+    if (refitLine(points, 3u, weights, start, end))
+    {
+        uint8_t        refitIndices[PixelCount];
+        const uint16_t refit0     = toRgb565(start);
+        const uint16_t refit1     = toRgb565(end);
+        const uint32_t refitError = pickBc1Indices(points, refit0, refit1, refitIndices);
+        if (refitError < error)
+        {
+            color0 = refit0;
+            color1 = refit1;
+            memcpy(indices, refitIndices, sizeof(indices));
+        }
+    }
+
+    // -------------- color0 > color1 selects the four color mode --------------
+    if (color0 < color1)
+    {
+        std::swap(color0, color1);
+        for (uint8_t &index : indices)
+        {
+            index ^= 1u;
+        }
+    }
+    else if (color0 == color1)
+    {
+        memset(indices, 0, sizeof(indices));
+    }
+
+    uint32_t packed = 0u;
+    for (uint32_t i = 0; i < PixelCount; i++)
+    {
+        packed |= static_cast<uint32_t>(indices[i]) << (i * 2u);
+    }
+
+    memcpy(block, &color0, sizeof(uint16_t));
+    memcpy(block + 2u, &color1, sizeof(uint16_t));
+    memcpy(block + 4u, &packed, sizeof(uint32_t));
+}
+
+void encodeBc3(const uint8_t *pixels, uint8_t *block)
+{
+    encodeBc4(pixels, 3u, block);
+    encodeBc1(pixels, block + Bc4BlockSize);
+}
+
+void encodeBc4(const uint8_t *pixels, uint32_t channel, uint8_t *block)
+{
+    Points points = {};
+    for (uint32_t i = 0; i < PixelCount; i++)
+    {
+        points[i][0] = pixels[i * 4u + channel];
+    }
+
+    // -------------- the largest value first selects the eight value mode --------------
+    int value0 = 0;
+    int value1 = 255;
+    for (auto &point : points)
+    {
+        value0 = std::max(value0, static_cast<int>(point[0]));
+        value1 = std::min(value1, static_cast<int>(point[0]));
+    }
+
+    uint8_t indices[PixelCount] = {};
+    if (value0 != value1)
+    {
+        uint32_t error = pickBc4Indices(points, value0, value1, indices);
+
+        // -------------- refit to the chosen indices and keep whichever is better --------------
+        float weights[PixelCount];
+        for (uint32_t i = 0; i < PixelCount; i++)
+        {
+            weights[i] = indices[i] < 2u ? static_cast<float>(indices[i]) : (indices[i] - 1u) / 7.0f;
+        }
+
+        float start[4] = {static_cast<float>(value0)};
+        float end[4]   = {static_cast<float>(value1)};
+        if (refitLine(points, 1u, weights, start, end))
+        {
+            const int refit0 = static_cast<int>(start[0] + 0.5f);
+            const int refit1 = static_cast<int>(end[0] + 0.5f);
+
+            uint8_t refitIndices[PixelCount];
+            if (refit0 > refit1 && pickBc4Indices(points, refit0, refit1, refitIndices) < error)
+            {
+                value0 = refit0;
+                value1 = refit1;
+                memcpy(indices, refitIndices, sizeof(indices));
+            }
+        }
+    }
+
+    uint64_t packed = 0u;
+    for (uint32_t i = 0; i < PixelCount; i++)
+    {
+        packed |= static_cast<uint64_t>(indices[i]) << (i * 3u);
+    }
+
+    block[0] = static_cast<uint8_t>(value0);
+    block[1] = static_cast<uint8_t>(value1);
+    for (uint32_t i = 0; i < 6u; i++)
+    {
+        block[2u + i] = static_cast<uint8_t>(packed >> (i * 8u));
+    }
+}
+
+void encodeBc5(const uint8_t *pixels, uint8_t *block)
+{
+    encodeBc4(pixels, 0u, block);
+    encodeBc4(pixels, 1u, block + Bc4BlockSize);
+}
+
+void encodeBc7(const uint8_t *pixels, uint8_t *block)
+{
+    Points points;
+    toPoints(pixels, points);
+
+    float start[4], end[4];
+    fitLine(points, 4u, start, end);
+
+    // -------------- try every p-bit combination, then refit to the best indices and try again --------------
+    Bc7Endpoints best      = {};
+    uint32_t     bestError = std::numeric_limits<uint32_t>::max();
+    uint8_t      indices[PixelCount];
+    for (uint32_t pass = 0; pass < 2u; pass++)
+    {
+        for (uint32_t pBits = 0; pBits < 4u; pBits++)
+        {
+            uint8_t      candidateIndices[PixelCount];
+            Bc7Endpoints endpoints = quantizeBc7(start, end, pBits & 1u, pBits >> 1u);
+            uint32_t     error     = pickBc7Indices(points, endpoints, candidateIndices);
+            if (error < bestError)
+            {
+                best      = endpoints;
+                bestError = error;
+                memcpy(indices, candidateIndices, sizeof(indices));
+            }
+        }
+
+        float weights[PixelCount];
+        for (uint32_t i = 0; i < PixelCount; i++)
+        {
+            weights[i] = Bc7Weights[indices[i]] / 64.0f;
+        }
+
+        if (pass > 0u || bestError == 0u || !refitLine(points, 4u, weights, start, end))
+            break;
+    }
+
+    // -------------- the first index drops its top bit, so it has to be below 8 --------------
+    if (indices[0] >= 8u)
+    {
+        std::swap(best.colors[0], best.colors[1]);
+        std::swap(best.pBits[0], best.pBits[1]);
+        for (uint8_t &index : indices)
+        {
+            index = 15u - index;
+        }
+    }
+
+    memset(block, 0, Bc7BlockSize);
+    BitWriter writer = {.data = block};
+    writer.write(1u << 6u, 7u); // mode 6
+    for (uint32_t c = 0; c < 4u; c++)
+    {
+        writer.write(best.colors[0][c], 7u);
+        writer.write(best.colors[1][c], 7u);
+    }
+
+    writer.write(best.pBits[0], 1u);
+    writer.write(best.pBits[1], 1u);
+    for (uint32_t i = 0; i < PixelCount; i++)
+    {
+        writer.write(indices[i], i == 0u ? 3u : 4u);
+    }
+}
+
+} // namespace bisky::gfx::BlockCompressor
\ No newline at end of file
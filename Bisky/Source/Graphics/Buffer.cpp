@@ -35,7 +35,10 @@ Buffer::Buffer()
 
 Buffer::~Buffer()
 {
-    resource.Reset();
+    if (memory.allocator)
+    {
+        memory.allocator->free(memory, std::move(resource));
+    }
 }
 
 } // namespace bisky::gfx
\ No newline at end of file
@@ -39,6 +39,11 @@ uint64_t CommandQueue::getCompletedValue() const
     return m_fence->GetCompletedValue();
 }
 
+uint64_t CommandQueue::getNextValue() const
+{
+    return m_fenceValue + 1u;
+}
+
 void CommandQueue::executeCommandLists(const std::span<const CommandList *const> commandLists)
 {
     std::vector<ID3D12CommandList *> lists;
@@ -54,8 +59,9 @@ void CommandQueue::executeCommandLists(const std::span<const CommandList *const>
 
 uint64_t CommandQueue::signal()
 {
-    m_commandQueue->Signal(m_fence.Get(), ++m_fenceValue);
-    return m_fenceValue;
+    const uint64_t fenceValue = ++m_fenceValue;
+    m_commandQueue->Signal(m_fence.Get(), fenceValue);
+    return fenceValue;
 }
 
 void CommandQueue::waitForFence(const uint64_t fenceValue) const
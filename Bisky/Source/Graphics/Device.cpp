@@ -1,7 +1,9 @@
 #include "Common.hpp"
 
+#include "Core/JobSystem.hpp"
 #include "Graphics/Constants.hpp"
 #include "Graphics/Device.hpp"
+#include "Graphics/ResourceUpload.hpp"
 #include "Graphics/Utilities.hpp"
 #include "Graphics/Window.hpp"
 
@@ -15,9 +17,12 @@ Device::Device(Window *window, DXGI_FORMAT backBufferFormat, DXGI_FORMAT hdrRend
     initDescriptorHeaps();
     initFactory();
     initCommandQueue();
+    initMemoryAllocator();
     initSwapChain(window);
     getBuffers(window->getWidth(), window->getHeight());
     initFrameResources();
+    initUploadManager();
+    initGeometryPool();
 
     LOG_INFO("D3D12 initialized");
 }
@@ -33,7 +38,16 @@ Device::~Device()
         m_frameResources[i].reset();
     }
 
+    for (uint32_t i = 0; i < FramesInFlight; i++)
+    {
+        m_hdrRenderTargetBuffers[i].reset();
+    }
+
+    m_depthStencilBuffer.reset();
     m_swapChain.Reset();
+    m_geometryPool.reset();
+    m_uploadManager.reset();
+    m_memoryAllocator.reset();
     m_directCommandQueue.reset();
     m_factory.Reset();
     m_cbvSrvUavHeap.reset();
@@ -45,6 +59,9 @@ Device::~Device()
 void Device::beginFrame(GraphicsCommandList *const cmdList)
 {
     m_currentBackBufferIndex = m_swapChain->GetCurrentBackBufferIndex();
+    m_uploadManager->beginFrame();
+    m_geometryPool->retire();
+    m_memoryAllocator->retire();
 
     cmdList->addBarrier(getRenderTargetBuffer(), D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
     cmdList->addBarrier(getHdrRenderTargetBuffer(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_RENDER_TARGET);
@@ -152,24 +169,104 @@ void Device::getBuffers(uint32_t width, uint32_t height)
 
 void Device::addGraphicsPipelineState(std::string_view name, const GraphicsPipelineStateDesc &gfxDesc)
 {
+    if (m_batchingPipelineStates)
+    {
+        // -------------- copy the formats since the description only holds a span --------------
+        auto &pending           = m_pendingPipelineStates.emplace_back(name, gfxDesc);
+        pending.rtvFormats      = {gfxDesc.rtvFormats.begin(), gfxDesc.rtvFormats.end()};
+        pending.desc.rtvFormats = pending.rtvFormats;
+        return;
+    }
+
     m_pipelineStates[name] = std::make_unique<PipelineState>(m_device.Get(), gfxDesc);
     LOG_INFO("Pipeline state " + std::string(name) + " created");
 }
 
+void Device::addGraphicsPipelineStates(
+    std::span<const std::string_view> names, std::span<const GraphicsPipelineStateDesc> gfxDescs
+)
+{
+    auto  start     = std::chrono::system_clock::now();
+    auto &jobSystem = core::JobSystem::get();
+
+    // -------------- compile every shader stage concurrently --------------
+    std::vector<ShaderCompileJob> jobs;
+    jobs.reserve(gfxDescs.size() * 2u);
+    for (auto &gfxDesc : gfxDescs)
+    {
+        jobs.push_back({
+            .shaderType = ShaderType::Vertex,
+            .filename   = gfxDesc.vertexShader.name,
+            .entryPoint = std::wstring(gfxDesc.vertexShader.entryPoint),
+        });
+        jobs.push_back({
+            .shaderType = ShaderType::Pixel,
+            .filename   = gfxDesc.pixelShader.name,
+            .entryPoint = std::wstring(gfxDesc.pixelShader.entryPoint),
+        });
+    }
+
+    ShaderCompiler::compileBatch(jobs, jobSystem);
+    auto compileEnd = std::chrono::system_clock::now();
+
+    // -------------- create the pipeline states concurrently --------------
+    std::vector<std::unique_ptr<PipelineState>> pipelineStates(gfxDescs.size());
+    jobSystem.parallelFor(static_cast<uint32_t>(gfxDescs.size()), 1u, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            pipelineStates[i] = std::make_unique<PipelineState>(
+                m_device.Get(), gfxDescs[i], jobs[i * 2u].resultBlob.Get(), jobs[i * 2u + 1u].resultBlob.Get()
+            );
+        }
+    });
+
+    for (size_t i = 0; i < gfxDescs.size(); i++)
+    {
+        m_pipelineStates[names[i]] = std::move(pipelineStates[i]);
+        LOG_INFO("Pipeline state " + std::string(names[i]) + " created");
+    }
+
+    auto end            = std::chrono::system_clock::now();
+    auto compileElapsed = std::chrono::duration_cast<std::chrono::microseconds>(compileEnd - start);
+    auto createElapsed  = std::chrono::duration_cast<std::chrono::microseconds>(end - compileEnd);
+    LOG_INFO(fmt::format(
+        "Compiled {} shader stages in {:.3f} ms and created {} pipeline states in {:.3f} ms on {} threads",
+        jobs.size(), compileElapsed.count() / 1000.0f, gfxDescs.size(), createElapsed.count() / 1000.0f,
+        jobSystem.getWorkerCount() + 1u
+    ));
+}
+
+void Device::beginPipelineStateBatch()
+{
+    m_batchingPipelineStates = true;
+}
+
+void Device::endPipelineStateBatch()
+{
+    m_batchingPipelineStates = false;
+
+    std::vector<std::string_view>          names;
+    std::vector<GraphicsPipelineStateDesc> gfxDescs;
+    for (auto &pending : m_pendingPipelineStates)
+    {
+        names.push_back(pending.name);
+        gfxDescs.push_back(pending.desc);
+    }
+
+    addGraphicsPipelineStates(names, gfxDescs);
+    m_pendingPipelineStates.clear();
+}
+
 void Device::addRootSignature(std::string_view name, const gfx::RootParameters &parameters)
 {
     m_rootSignatures[name] = std::make_unique<RootSignature>(m_device.Get(), parameters);
     LOG_INFO("Root signature " + std::string(name) + " created");
 }
 
-std::unique_ptr<Buffer> Device::createUploadBuffer(uint32_t size, void *data, uint32_t dataSize)
+std::unique_ptr<Buffer> Device::createUploadBuffer(uint32_t size, const void *data, uint32_t dataSize)
 {
     std::unique_ptr<Buffer> buffer = std::make_unique<Buffer>();
 
-    D3D12_HEAP_PROPERTIES heap = {
-        .Type = D3D12_HEAP_TYPE_UPLOAD,
-    };
-
     D3D12_RESOURCE_DESC resource = {
         .Dimension        = D3D12_RESOURCE_DIMENSION_BUFFER,
         .Alignment        = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
@@ -183,9 +280,8 @@ std::unique_ptr<Buffer> Device::createUploadBuffer(uint32_t size, void *data, ui
         .Flags            = D3D12_RESOURCE_FLAG_NONE,
     };
 
-    m_device->CreateCommittedResource(
-        &heap, D3D12_HEAP_FLAG_NONE, &resource, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-        IID_PPV_ARGS(&buffer->resource)
+    m_memoryAllocator->createResource(
+        D3D12_HEAP_TYPE_UPLOAD, resource, D3D12_RESOURCE_STATE_GENERIC_READ, nullptr, buffer->memory, buffer->resource
     );
 
     if (data)
@@ -205,23 +301,43 @@ std::unique_ptr<Buffer> Device::createUploadBuffer(uint32_t size, void *data, ui
     return std::move(buffer);
 }
 
+std::unique_ptr<Buffer> Device::createBuffer(uint32_t size, D3D12_RESOURCE_FLAGS flags)
+{
+    std::unique_ptr<Buffer> buffer = std::make_unique<Buffer>();
+
+    D3D12_RESOURCE_DESC resource = {
+        .Dimension        = D3D12_RESOURCE_DIMENSION_BUFFER,
+        .Alignment        = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
+        .Width            = size,
+        .Height           = 1,
+        .DepthOrArraySize = 1,
+        .MipLevels        = 1,
+        .Format           = DXGI_FORMAT_UNKNOWN,
+        .SampleDesc       = {.Count = 1, .Quality = 0},
+        .Layout           = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+        .Flags            = flags,
+    };
+
+    m_memoryAllocator->createResource(
+        D3D12_HEAP_TYPE_DEFAULT, resource, D3D12_RESOURCE_STATE_COMMON, nullptr, buffer->memory, buffer->resource
+    );
+
+    return std::move(buffer);
+}
+
 std::unique_ptr<Texture> Device::createTexture2D(
-    uint32_t width, uint32_t height, DXGI_FORMAT format, D3D12_RESOURCE_FLAGS flags
+    uint32_t width, uint32_t height, DXGI_FORMAT format, D3D12_RESOURCE_FLAGS flags, uint32_t mipLevels
 )
 {
     std::unique_ptr<Texture> texture = std::make_unique<Texture>();
 
-    D3D12_HEAP_PROPERTIES heap = {
-        .Type = D3D12_HEAP_TYPE_DEFAULT,
-    };
-
     D3D12_RESOURCE_DESC resource = {
         .Dimension        = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
         .Alignment        = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
         .Width            = width,
         .Height           = height,
         .DepthOrArraySize = 1,
-        .MipLevels        = 1,
+        .MipLevels        = static_cast<UINT16>(mipLevels),
         .Format           = format,
         .SampleDesc       = {.Count = 1, .Quality = 0},
         .Layout           = D3D12_TEXTURE_LAYOUT_UNKNOWN,
@@ -232,9 +348,9 @@ std::unique_ptr<Texture> Device::createTexture2D(
     if (format == DXGI_FORMAT_D24_UNORM_S8_UINT || format == DXGI_FORMAT_D32_FLOAT)
     {
         optClear.DepthStencil = {.Depth = 1.0f, .Stencil = 0};
-        m_device->CreateCommittedResource(
-            &heap, D3D12_HEAP_FLAG_NONE, &resource, D3D12_RESOURCE_STATE_DEPTH_WRITE, &optClear,
-            IID_PPV_ARGS(&texture->resource)
+        m_memoryAllocator->createResource(
+            D3D12_HEAP_TYPE_DEFAULT, resource, D3D12_RESOURCE_STATE_DEPTH_WRITE, &optClear, texture->memory,
+            texture->resource
         );
     }
     else if (flags & D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET)
@@ -243,41 +359,69 @@ std::unique_ptr<Texture> Device::createTexture2D(
         optClear.Color[1] = 0.15f;
         optClear.Color[2] = 0.15f;
         optClear.Color[3] = 1.0f;
-        m_device->CreateCommittedResource(
-            &heap, D3D12_HEAP_FLAG_NONE, &resource, D3D12_RESOURCE_STATE_COMMON, &optClear,
-            IID_PPV_ARGS(&texture->resource)
+        m_memoryAllocator->createResource(
+            D3D12_HEAP_TYPE_DEFAULT, resource, D3D12_RESOURCE_STATE_COMMON, &optClear, texture->memory,
+            texture->resource
         );
     }
     else
     {
-        m_device->CreateCommittedResource(
-            &heap, D3D12_HEAP_FLAG_NONE, &resource, D3D12_RESOURCE_STATE_COMMON, nullptr,
-            IID_PPV_ARGS(&texture->resource)
+        m_memoryAllocator->createResource(
+            D3D12_HEAP_TYPE_DEFAULT, resource, D3D12_RESOURCE_STATE_COMMON, nullptr, texture->memory, texture->resource
         );
     }
 
     return std::move(texture);
 }
 
-void Device::copyToTexture(unsigned char *data, const ImageData &imageData, Texture *const texture)
+void Device::copyToTexture(const unsigned char *data, const ImageData &imageData, Texture *const texture)
 {
     // -------------- begin upload block --------------
     ResourceUpload upload(this);
     upload.Begin();
 
-    // -------------- create upload buffer --------------
-    std::unique_ptr<Buffer> uploadBuffer =
-        createUploadBuffer(static_cast<uint32_t>(imageData.width * imageData.height * 4), data);
-
-    // -------------- copy upload buffer to texture --------------
-    upload.getCommandList()->copyTextureRegion(uploadBuffer.get(), texture, imageData);
+    copyToTexture(data, imageData, texture, upload);
 
     // -------------- end upload block --------------
     auto finish = upload.Finish();
     finish.wait();
 }
 
-std::shared_ptr<Texture> Device::createImageFromMemory(unsigned char *data, size_t dataSize)
+void Device::copyToTexture(
+    const unsigned char *data, const ImageData &imageData, Texture *const texture, ResourceUpload &upload
+)
+{
+    // -------------- the copy needs every row of every level aligned to 256 bytes --------------
+    const D3D12_RESOURCE_DESC                       desc = texture->resource->GetDesc();
+    std::vector<D3D12_PLACED_SUBRESOURCE_FOOTPRINT> footprints(imageData.mipLevels);
+    std::vector<UINT>                               rowCounts(imageData.mipLevels);
+    std::vector<UINT64>                             rowSizes(imageData.mipLevels);
+    UINT64                                          uploadSize = 0u;
+    m_device->GetCopyableFootprints(
+        &desc, 0u, imageData.mipLevels, 0u, footprints.data(), rowCounts.data(), rowSizes.data(), &uploadSize
+    );
+
+    // -------------- stage every level --------------
+    const StagingAllocation staging = upload.allocate(uploadSize);
+    for (uint32_t mip = 0; mip < imageData.mipLevels; mip++)
+    {
+        uint8_t *const level = staging.cpuAddress + footprints[mip].Offset;
+        for (UINT row = 0; row < rowCounts[mip]; row++)
+        {
+            memcpy(level + static_cast<size_t>(row) * footprints[mip].Footprint.RowPitch, data, rowSizes[mip]);
+            data += rowSizes[mip];
+        }
+    }
+
+    // -------------- copy staging memory to texture --------------
+    for (uint32_t mip = 0; mip < imageData.mipLevels; mip++)
+    {
+        footprints[mip].Offset += staging.offset;
+        upload.getCommandList()->copyTextureRegion(staging.buffer, texture, footprints[mip], mip);
+    }
+}
+
+std::shared_ptr<Texture> Device::createImageFromMemory(const unsigned char *data, size_t dataSize)
 {
     // -------------- attempt to load the image --------------
     ImageData      imageData;
@@ -290,10 +434,34 @@ std::shared_ptr<Texture> Device::createImageFromMemory(unsigned char *data, size
         return nullptr;
     }
 
-    // -------------- create a texture and copy the data to it --------------
-    std::unique_ptr<Texture> texture = createTexture2D(imageData.width, imageData.height, imageData.format);
-    copyToTexture(loadedImage, imageData, texture.get());
+    std::shared_ptr<Texture> texture = createImageFromPixels(loadedImage, imageData);
     stbi_image_free(loadedImage);
+    return texture;
+}
+
+std::shared_ptr<Texture> Device::createImageFromPixels(const unsigned char *pixels, const ImageData &imageData)
+{
+    // -------------- begin upload block --------------
+    ResourceUpload upload(this);
+    upload.Begin();
+
+    std::shared_ptr<Texture> texture = createImageFromPixels(pixels, imageData, upload);
+
+    // -------------- end upload block --------------
+    auto finish = upload.Finish();
+    finish.wait();
+    return texture;
+}
+
+std::shared_ptr<Texture> Device::createImageFromPixels(
+    const unsigned char *pixels, const ImageData &imageData, ResourceUpload &upload
+)
+{
+    // -------------- create a texture and record the copy of the data to it --------------
+    std::unique_ptr<Texture> texture = createTexture2D(
+        imageData.width, imageData.height, imageData.format, D3D12_RESOURCE_FLAG_NONE, imageData.mipLevels
+    );
+    copyToTexture(pixels, imageData, texture.get(), upload);
 
     // -------------- create a shader resource view for the texture --------------
     texture->srvDescriptor              = m_cbvSrvUavHeap->allocate();
@@ -339,6 +507,21 @@ CommandQueue *const Device::getDirectCommandQueue() const
     return m_directCommandQueue.get();
 }
 
+UploadManager *const Device::getUploadManager() const
+{
+    return m_uploadManager.get();
+}
+
+GeometryPool *const Device::getGeometryPool() const
+{
+    return m_geometryPool.get();
+}
+
+MemoryAllocator *const Device::getMemoryAllocator() const
+{
+    return m_memoryAllocator.get();
+}
+
 IDXGISwapChain4 *const Device::getSwapChain() const
 {
     return m_swapChain.Get();
@@ -459,6 +642,13 @@ void Device::initDevice()
     LOG_VERBOSE("Device created");
 }
 
+void Device::initMemoryAllocator()
+{
+    m_memoryAllocator = std::make_unique<MemoryAllocator>(m_device.Get(), m_directCommandQueue.get());
+
+    LOG_VERBOSE(fmt::format("Memory allocator created with {} MB heaps", MemoryAllocator::DefaultHeapSize >> 20));
+}
+
 void Device::initDescriptorHeaps()
 {
     m_rtvHeap       = std::make_unique<DescriptorHeap>(m_device.Get(), DescriptorType::Rtv, 64);
@@ -557,4 +747,18 @@ void Device::initFrameResources()
     LOG_VERBOSE("Frame resources created");
 }
 
+void Device::initUploadManager()
+{
+    m_uploadManager = std::make_unique<UploadManager>(this);
+
+    LOG_VERBOSE(fmt::format("Staging ring created with {} MB", m_uploadManager->getCapacity() >> 20));
+}
+
+void Device::initGeometryPool()
+{
+    m_geometryPool = std::make_unique<GeometryPool>(this);
+
+    LOG_VERBOSE("Geometry pool created");
+}
+
 } // namespace bisky::gfx
\ No newline at end of file
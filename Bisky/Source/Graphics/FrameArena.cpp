@@ -0,0 +1,107 @@
+#include "Graphics/FrameArena.hpp"
+
+#include <algorithm>
+
+namespace bisky::gfx
+{
+
+namespace
+{
+
+uint64_t alignUp(uint64_t value, uint64_t alignment)
+{
+    return (value + (alignment - 1u)) & ~(alignment - 1u);
+}
+
+} // namespace
+
+FrameArena::FrameArena(uint64_t baseSize, uint64_t minimumSize)
+    : m_pageSizes(1u, alignUp(std::max(baseSize, minimumSize), PageGranularity)), m_minimumSize(minimumSize)
+{
+}
+
+ArenaRegion FrameArena::allocate(uint64_t size, uint64_t alignment)
+{
+    const uint64_t alignedSize = alignUp(size, alignment);
+    uint64_t       offset      = alignUp(m_at, alignment);
+
+    // -------------- move on to the first page after this one that fits --------------
+    while (offset + alignedSize > m_pageSizes[m_page])
+    {
+        m_frame.wastedBytes += m_pageSizes[m_page] - m_at;
+        m_page++;
+        m_at   = 0u;
+        offset = 0u;
+
+        if (m_page == m_pageSizes.size())
+        {
+            m_pageSizes.push_back(alignUp(std::max(alignedSize, m_pageSizes.back() * 2u), PageGranularity));
+        }
+    }
+
+    m_frame.usedBytes += size;
+    m_frame.wastedBytes += alignedSize - size + (offset - m_at);
+    m_frame.pageCount = m_page + 1u;
+    m_at              = offset + alignedSize;
+
+    return {.page = m_page, .offset = offset};
+}
+
+void FrameArena::reset()
+{
+    // -------------- record the frame --------------
+    m_history[m_historyIndex] = m_frame.usedBytes + m_frame.wastedBytes;
+    m_historyIndex            = (m_historyIndex + 1u) % HistoryLength;
+    m_historyCount            = std::min(m_historyCount + 1u, HistoryLength);
+
+    m_lastFrame = m_frame;
+    m_frame     = {};
+    m_page      = 0u;
+    m_at        = 0u;
+
+    // -------------- grow to fit the busiest recent frame, or shrink once a full history used little --------------
+    const uint64_t highWater = getHighWater();
+    uint64_t       baseSize  = m_pageSizes.front();
+    if (highWater > baseSize)
+    {
+        baseSize = alignUp(highWater + highWater / 4u, PageGranularity);
+    }
+    else if (m_historyCount == HistoryLength && highWater < baseSize / 4u)
+    {
+        baseSize = std::max(alignUp(highWater * 2u, PageGranularity), alignUp(m_minimumSize, PageGranularity));
+    }
+
+    m_pageSizes.assign(1u, baseSize);
+}
+
+uint32_t FrameArena::getPageCount() const
+{
+    return static_cast<uint32_t>(m_pageSizes.size());
+}
+
+uint64_t FrameArena::getPageSize(uint32_t page) const
+{
+    return m_pageSizes[page];
+}
+
+uint64_t FrameArena::getBaseSize() const
+{
+    return m_pageSizes.front();
+}
+
+uint64_t FrameArena::getHighWater() const
+{
+    return *std::max_element(m_history.begin(), m_history.begin() + m_historyCount);
+}
+
+const ArenaFrameStats &FrameArena::getFrameStats() const
+{
+    return m_frame;
+}
+
+const ArenaFrameStats &FrameArena::getLastFrameStats() const
+{
+    return m_lastFrame;
+}
+
+} // namespace bisky::gfx
\ No newline at end of file
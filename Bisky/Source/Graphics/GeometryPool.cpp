@@ -0,0 +1,130 @@
+#include "Common.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandQueue.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/GeometryPool.hpp"
+#include "Graphics/GraphicsCommandList.hpp"
+
+namespace bisky::gfx
+{
+
+GeometryPool::GeometryPool(Device *const device, uint32_t vertexCapacity, uint32_t indexCapacity)
+    : m_queue(device->getDirectCommandQueue()),
+      m_vertices{device->createBuffer(vertexCapacity), OffsetAllocator(vertexCapacity)},
+      m_indices16{device->createBuffer(indexCapacity), OffsetAllocator(indexCapacity)},
+      m_indices32{device->createBuffer(indexCapacity), OffsetAllocator(indexCapacity)}
+{
+}
+
+GeometryPool::~GeometryPool()
+{
+}
+
+bool GeometryPool::addVertices(
+    const void *data, uint32_t count, uint32_t stride, ResourceUpload &upload, GeometryRange &range
+)
+{
+    return add(m_vertices, data, static_cast<uint64_t>(count) * stride, stride, upload, range);
+}
+
+bool GeometryPool::addIndices(
+    const void *data, uint32_t count, DXGI_FORMAT format, ResourceUpload &upload, GeometryRange &range
+)
+{
+    const uint64_t stride = format == DXGI_FORMAT_R16_UINT ? 2u : 4u;
+    return add(format == DXGI_FORMAT_R16_UINT ? m_indices16 : m_indices32, data, count * stride, stride, upload, range);
+}
+
+void GeometryPool::free(const GeometryRange &range)
+{
+    if (!range.buffer)
+    {
+        return;
+    }
+
+    // frames still in flight may be drawing from the range, the next signal covers every one of them,
+    // so all the frees of a frame share the value the frame ends with
+    m_pendingFrees.push_back({.fenceValue = m_queue->getNextValue(), .range = range});
+}
+
+void GeometryPool::retire()
+{
+    const uint64_t completedValue = m_queue->getCompletedValue();
+    while (!m_pendingFrees.empty() && m_pendingFrees.front().fenceValue <= completedValue)
+    {
+        const GeometryRange &range = m_pendingFrees.front().range;
+        getPool(range.buffer).allocator.free({.offset = range.offset, .size = range.size});
+        m_pendingFrees.pop_front();
+    }
+}
+
+IndexBufferView GeometryPool::getIndexBufferView(DXGI_FORMAT format) const
+{
+    const Pool &pool = format == DXGI_FORMAT_R16_UINT ? m_indices16 : m_indices32;
+    return {
+        .bufferLocation = pool.buffer->resource->GetGPUVirtualAddress(),
+        .sizeInBytes    = static_cast<uint32_t>(pool.allocator.getStats().capacity),
+        .format         = format,
+    };
+}
+
+Buffer *const GeometryPool::getVertexBuffer() const
+{
+    return m_vertices.buffer.get();
+}
+
+GeometryPoolStats GeometryPool::getStats() const
+{
+    return {
+        .vertices  = m_vertices.allocator.getStats(),
+        .indices16 = m_indices16.allocator.getStats(),
+        .indices32 = m_indices32.allocator.getStats(),
+    };
+}
+
+bool GeometryPool::add(
+    Pool &pool, const void *data, uint64_t size, uint64_t alignment, ResourceUpload &upload, GeometryRange &range
+)
+{
+    OffsetAllocation allocation;
+    if (!pool.allocator.allocate(size, alignment, allocation))
+    {
+        const OffsetAllocatorStats stats = pool.allocator.getStats();
+        LOG_ERROR(fmt::format(
+            "Geometry pool is out of room for {} bytes ({} bytes free, largest free range {} bytes)", size,
+            stats.freeBytes, stats.largestFreeRange
+        ));
+        return false;
+    }
+
+    // -------------- stage the data --------------
+    const StagingAllocation staging = upload.allocate(size, D3D12_RAW_UAV_SRV_BYTE_ALIGNMENT);
+    memcpy(staging.cpuAddress, data, size);
+
+    // -------------- copy it into the pool buffer --------------
+    // buffers are back in common after every submission, so each copy starts and ends there, which lets
+    // several meshes be added in one upload block and draws promote the buffer to the state they read it in
+    GraphicsCommandList *const cmdList = upload.getCommandList();
+    cmdList->addBarrier(pool.buffer.get(), D3D12_RESOURCE_STATE_COMMON, D3D12_RESOURCE_STATE_COPY_DEST);
+    cmdList->dispatchBarriers();
+    cmdList->copyBufferRegion(staging.buffer, staging.offset, pool.buffer.get(), allocation.offset, size);
+    cmdList->addBarrier(pool.buffer.get(), D3D12_RESOURCE_STATE_COPY_DEST, D3D12_RESOURCE_STATE_COMMON);
+    cmdList->dispatchBarriers();
+
+    range = {.buffer = pool.buffer.get(), .offset = allocation.offset, .size = allocation.size};
+    return true;
+}
+
+GeometryPool::Pool &GeometryPool::getPool(const Buffer *const buffer)
+{
+    if (buffer == m_indices16.buffer.get())
+        return m_indices16;
+
+    if (buffer == m_indices32.buffer.get())
+        return m_indices32;
+
+    return m_vertices;
+}
+
+} // namespace bisky::gfx
\ No newline at end of file
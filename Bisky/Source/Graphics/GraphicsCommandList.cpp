@@ -62,41 +62,30 @@ void GraphicsCommandList::copyBufferRegion(Buffer *const src, Buffer *const dst,
     m_commandList->CopyBufferRegion(dst->resource.Get(), 0, src->resource.Get(), 0, bufferSize);
 }
 
-void GraphicsCommandList::copyTextureRegion(Buffer *const src, Texture *const dst, const ImageData &imageData)
+void GraphicsCommandList::copyBufferRegion(
+    Buffer *const src, uint64_t srcOffset, Buffer *const dst, uint64_t dstOffset, size_t size
+)
+{
+    m_commandList->CopyBufferRegion(dst->resource.Get(), dstOffset, src->resource.Get(), srcOffset, size);
+}
+
+void GraphicsCommandList::copyTextureRegion(
+    Buffer *const src, Texture *const dst, const D3D12_PLACED_SUBRESOURCE_FOOTPRINT &footprint, uint32_t subresource
+)
 {
     D3D12_TEXTURE_COPY_LOCATION copySrc = {
-        .pResource = src->resource.Get(),
-        .Type      = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
-        .PlacedFootprint =
-            {
-                .Offset = 0u,
-                .Footprint =
-                    {
-                        .Format   = imageData.format,
-                        .Width    = static_cast<UINT>(imageData.width),
-                        .Height   = static_cast<UINT>(imageData.height),
-                        .Depth    = 1u,
-                        .RowPitch = static_cast<UINT>(imageData.width * 4u),
-                    },
-            },
+        .pResource       = src->resource.Get(),
+        .Type            = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
+        .PlacedFootprint = footprint,
     };
 
     D3D12_TEXTURE_COPY_LOCATION copyDst = {
         .pResource        = dst->resource.Get(),
         .Type             = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
-        .SubresourceIndex = 0u,
+        .SubresourceIndex = subresource,
     };
 
-    D3D12_BOX box = {
-        .left   = 0u,
-        .top    = 0u,
-        .front  = 0u,
-        .right  = static_cast<UINT>(imageData.width),
-        .bottom = static_cast<UINT>(imageData.height),
-        .back   = 1u
-    };
-
-    m_commandList->CopyTextureRegion(&copyDst, 0, 0, 0, &copySrc, &box);
+    m_commandList->CopyTextureRegion(&copyDst, 0, 0, 0, &copySrc, nullptr);
 }
 
 void GraphicsCommandList::setDescriptorHeaps(const std::span<const DescriptorHeap *const> &descriptorHeaps)
@@ -161,6 +150,11 @@ void GraphicsCommandList::setConstantBufferView(uint32_t index, D3D12_GPU_VIRTUA
     m_commandList->SetGraphicsRootConstantBufferView(index, handle);
 }
 
+void GraphicsCommandList::setShaderResourceView(uint32_t index, D3D12_GPU_VIRTUAL_ADDRESS handle)
+{
+    m_commandList->SetGraphicsRootShaderResourceView(index, handle);
+}
+
 void GraphicsCommandList::set32BitConstants(uint32_t index, uint32_t numValues, void *data)
 {
     m_commandList->SetGraphicsRoot32BitConstants(index, numValues, data, 0u);
@@ -0,0 +1,242 @@
+#include "Common.hpp"
+
+#include "Graphics/CommandQueue.hpp"
+#include "Graphics/MemoryAllocator.hpp"
+
+namespace bisky::gfx
+{
+
+MemoryAllocator::MemoryAllocator(ID3D12Device10 *device, CommandQueue *queue, uint64_t heapSize)
+    : m_device(device), m_queue(queue), m_heapSize(heapSize)
+{
+    m_pools[UploadBuffers] = {
+        .type      = D3D12_HEAP_TYPE_UPLOAD,
+        .flags     = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,
+        .alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
+    };
+    m_pools[Buffers] = {
+        .type      = D3D12_HEAP_TYPE_DEFAULT,
+        .flags     = D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS,
+        .alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
+    };
+    m_pools[Textures] = {
+        .type      = D3D12_HEAP_TYPE_DEFAULT,
+        .flags     = D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES,
+        .alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
+    };
+    m_pools[RenderTargets] = {
+        .type      = D3D12_HEAP_TYPE_DEFAULT,
+        .flags     = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES,
+        .alignment = D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT,
+    };
+}
+
+bool MemoryAllocator::createResource(
+    D3D12_HEAP_TYPE heapType, const D3D12_RESOURCE_DESC &desc, D3D12_RESOURCE_STATES state,
+    const D3D12_CLEAR_VALUE *clearValue, MemoryAllocation &allocation, wrl::ComPtr<ID3D12Resource> &resource
+)
+{
+    // -------------- small textures can be 4 KB aligned, if the driver says so for this one --------------
+    const PoolType                 poolType   = getPoolType(heapType, desc);
+    D3D12_RESOURCE_DESC            placedDesc = desc;
+    D3D12_RESOURCE_ALLOCATION_INFO info       = {};
+    if (poolType == Textures && desc.SampleDesc.Count == 1u)
+    {
+        placedDesc.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+        info                 = m_device->GetResourceAllocationInfo(0u, 1u, &placedDesc);
+    }
+
+    // -------------- otherwise let the driver pick 64 KB, or 4 MB for multisampled targets --------------
+    if (info.Alignment != D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT)
+    {
+        placedDesc.Alignment = 0u;
+        info                 = m_device->GetResourceAllocationInfo(0u, 1u, &placedDesc);
+    }
+
+    if (info.SizeInBytes == UINT64_MAX)
+    {
+        LOG_ERROR("Invalid resource description, can't place the resource");
+        return false;
+    }
+
+    std::lock_guard lock(m_mutex);
+    freeCompleted();
+
+    // -------------- find a heap with room, or make a new one --------------
+    Pool          &pool      = m_pools[poolType];
+    const bool     dedicated = info.SizeInBytes > m_heapSize / 2u;
+    uint32_t       heapIndex = InvalidHeap;
+    TlsfAllocation block     = {};
+    if (!dedicated)
+    {
+        for (uint32_t i = 0; i < pool.heaps.size(); i++)
+        {
+            Heap &heap = pool.heaps[i];
+            if (heap.heap && !heap.dedicated && heap.allocator.allocate(info.SizeInBytes, info.Alignment, block))
+            {
+                heapIndex = i;
+                break;
+            }
+        }
+    }
+
+    if (heapIndex == InvalidHeap)
+    {
+        heapIndex = createHeap(pool, dedicated ? info.SizeInBytes : m_heapSize, dedicated);
+        if (heapIndex == InvalidHeap)
+        {
+            return false;
+        }
+
+        pool.heaps[heapIndex].allocator.allocate(info.SizeInBytes, info.Alignment, block);
+    }
+
+    // -------------- place the resource --------------
+    Heap         &heap = pool.heaps[heapIndex];
+    const HRESULT hr   = m_device->CreatePlacedResource(
+        heap.heap.Get(), block.offset, &placedDesc, state, clearValue, IID_PPV_ARGS(&resource)
+    );
+
+    allocation = {.allocator = this, .pool = poolType, .heap = heapIndex, .block = block};
+    if (FAILED(hr))
+    {
+        LOG_ERROR(fmt::format("Failed to place a resource of {} bytes", info.SizeInBytes));
+        allocation.allocator = nullptr;
+        heap.allocator.free(block);
+        if (heap.dedicated)
+        {
+            heap.heap.Reset();
+        }
+        return false;
+    }
+
+    return true;
+}
+
+void MemoryAllocator::free(MemoryAllocation &allocation, wrl::ComPtr<ID3D12Resource> resource)
+{
+    std::lock_guard lock(m_mutex);
+
+    // frames still in flight may be using the resource, and a resource placed in the memory next would alias it,
+    // waiting for the next signal covers them without one per free and keeps the pending frees in fence order
+    m_pendingFrees.push_back(
+        {.fenceValue = m_queue->getNextValue(), .allocation = allocation, .resource = std::move(resource)}
+    );
+    allocation.allocator = nullptr;
+}
+
+void MemoryAllocator::retire()
+{
+    std::lock_guard lock(m_mutex);
+    freeCompleted();
+}
+
+MemoryStats MemoryAllocator::getStats(D3D12_HEAP_TYPE heapType) const
+{
+    std::lock_guard lock(m_mutex);
+
+    MemoryStats stats = {};
+    for (auto &pool : m_pools)
+    {
+        if (pool.type != heapType)
+        {
+            continue;
+        }
+
+        for (auto &heap : pool.heaps)
+        {
+            if (!heap.heap)
+            {
+                continue;
+            }
+
+            const TlsfStats heapStats = heap.allocator.getStats();
+            stats.reservedBytes += heapStats.capacity;
+            stats.usedBytes += heapStats.usedBytes;
+            stats.largestFreeBlock = std::max(stats.largestFreeBlock, heapStats.largestFreeBlock);
+            stats.heapCount++;
+            stats.allocationCount += heapStats.allocationCount;
+        }
+    }
+
+    return stats;
+}
+
+MemoryAllocator::PoolType MemoryAllocator::getPoolType(D3D12_HEAP_TYPE heapType, const D3D12_RESOURCE_DESC &desc) const
+{
+    if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+    {
+        return heapType == D3D12_HEAP_TYPE_UPLOAD ? UploadBuffers : Buffers;
+    }
+
+    if (desc.Flags & (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL))
+    {
+        return RenderTargets;
+    }
+
+    return Textures;
+}
+
+void MemoryAllocator::freeCompleted()
+{
+    const uint64_t completedValue = m_queue->getCompletedValue();
+    while (!m_pendingFrees.empty() && m_pendingFrees.front().fenceValue <= completedValue)
+    {
+        PendingFree &pending = m_pendingFrees.front();
+        pending.resource.Reset();
+
+        Heap &heap = m_pools[pending.allocation.pool].heaps[pending.allocation.heap];
+        heap.allocator.free(pending.allocation.block);
+        if (heap.dedicated)
+        {
+            heap.heap.Reset();
+        }
+
+        m_pendingFrees.pop_front();
+    }
+}
+
+uint32_t MemoryAllocator::createHeap(Pool &pool, uint64_t size, bool dedicated)
+{
+    size = (size + pool.alignment - 1u) & ~(pool.alignment - 1u);
+
+    D3D12_HEAP_DESC desc = {
+        .SizeInBytes = size,
+        .Properties  = {.Type = pool.type},
+        .Alignment   = pool.alignment,
+        .Flags       = pool.flags,
+    };
+
+    wrl::ComPtr<ID3D12Heap> heap;
+    if (FAILED(m_device->CreateHeap(&desc, IID_PPV_ARGS(&heap))))
+    {
+        LOG_ERROR(fmt::format("Failed to create a heap of {:.2f} MB", size / (1024.0f * 1024.0f)));
+        return InvalidHeap;
+    }
+
+    Heap newHeap = {
+        .heap      = std::move(heap),
+        .allocator = TlsfAllocator(size, D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT),
+        .dedicated = dedicated,
+    };
+
+    // -------------- reuse the slot of a released dedicated heap --------------
+    for (uint32_t i = 0; i < pool.heaps.size(); i++)
+    {
+        if (!pool.heaps[i].heap)
+        {
+            pool.heaps[i] = std::move(newHeap);
+            return i;
+        }
+    }
+
+    pool.heaps.push_back(std::move(newHeap));
+    if (!dedicated)
+    {
+        LOG_VERBOSE(fmt::format("Reserved heap {} of {:.2f} MB", pool.heaps.size(), size / (1024.0f * 1024.0f)));
+    }
+
+    return static_cast<uint32_t>(pool.heaps.size() - 1u);
+}
+
+} // namespace bisky::gfx
\ No newline at end of file
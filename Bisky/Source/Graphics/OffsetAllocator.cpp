@@ -0,0 +1,125 @@
+#include "Graphics/OffsetAllocator.hpp"
+
+namespace bisky::gfx
+{
+
+float OffsetAllocatorStats::getFragmentation() const
+{
+    if (freeBytes == 0u)
+    {
+        return 0.0f;
+    }
+
+    return 1.0f - static_cast<float>(largestFreeRange) / static_cast<float>(freeBytes);
+}
+
+OffsetAllocator::OffsetAllocator(uint64_t capacity) : m_capacity(capacity), m_freeBytes(0u)
+{
+    if (capacity > 0u)
+    {
+        insertFreeRange(0u, capacity);
+    }
+}
+
+bool OffsetAllocator::allocate(uint64_t size, uint64_t alignment, OffsetAllocation &allocation)
+{
+    if (size == 0u)
+    {
+        return false;
+    }
+
+    // -------------- smallest free range that still fits once aligned --------------
+    for (auto it = m_freeBySize.lower_bound(size); it != m_freeBySize.end(); it++)
+    {
+        const uint64_t rangeOffset = it->second;
+        const uint64_t rangeSize   = it->first;
+        const uint64_t aligned     = (rangeOffset + alignment - 1u) / alignment * alignment;
+        if (aligned + size > rangeOffset + rangeSize)
+        {
+            continue;
+        }
+
+        // -------------- give back what's left before and after the allocation --------------
+        eraseFreeRange(m_freeByOffset.find(rangeOffset));
+        if (aligned > rangeOffset)
+        {
+            insertFreeRange(rangeOffset, aligned - rangeOffset);
+        }
+        if (aligned + size < rangeOffset + rangeSize)
+        {
+            insertFreeRange(aligned + size, rangeOffset + rangeSize - aligned - size);
+        }
+
+        allocation = {.offset = aligned, .size = size};
+        m_allocationCount++;
+        return true;
+    }
+
+    return false;
+}
+
+void OffsetAllocator::free(const OffsetAllocation &allocation)
+{
+    uint64_t offset = allocation.offset;
+    uint64_t size   = allocation.size;
+
+    // -------------- merge with the free range after --------------
+    auto next = m_freeByOffset.lower_bound(offset);
+    if (next != m_freeByOffset.end() && next->first == offset + size)
+    {
+        size += next->second;
+        eraseFreeRange(next);
+    }
+
+    // -------------- and the one before --------------
+    auto previous = m_freeByOffset.lower_bound(offset);
+    if (previous != m_freeByOffset.begin())
+    {
+        previous--;
+        if (previous->first + previous->second == offset)
+        {
+            offset = previous->first;
+            size += previous->second;
+            eraseFreeRange(previous);
+        }
+    }
+
+    insertFreeRange(offset, size);
+    m_allocationCount--;
+}
+
+OffsetAllocatorStats OffsetAllocator::getStats() const
+{
+    return {
+        .capacity         = m_capacity,
+        .freeBytes        = m_freeBytes,
+        .largestFreeRange = m_freeBySize.empty() ? 0u : m_freeBySize.rbegin()->first,
+        .freeRangeCount   = static_cast<uint32_t>(m_freeByOffset.size()),
+        .allocationCount  = m_allocationCount,
+    };
+}
+
+void OffsetAllocator::insertFreeRange(uint64_t offset, uint64_t size)
+{
+    m_freeByOffset.emplace(offset, size);
+    m_freeBySize.emplace(size, offset);
+    m_freeBytes += size;
+}
+
+void OffsetAllocator::eraseFreeRange(std::map<uint64_t, uint64_t>::iterator range)
+{
+    auto [first, last] = m_freeBySize.equal_range(range->second);
+    for (auto it = first; it != last; it++)
+    {
+        if (it->second == range->first)
+        {
+            m_freeBySize.erase(it);
+            break;
+        }
+    }
+
+    m_freeBytes -= range->second;
+    m_freeByOffset.erase(range);
+}
+
+} // namespace bisky::gfx
\ No newline at end of file
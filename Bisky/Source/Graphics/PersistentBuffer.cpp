@@ -0,0 +1,32 @@
+#include "Common.hpp"
+
+#include "Graphics/Device.hpp"
+#include "Graphics/PersistentBuffer.hpp"
+
+namespace bisky::gfx
+{
+
+PersistentBuffer::PersistentBuffer(Device *const device, uint32_t size)
+    : m_buffer(device->createUploadBuffer(size)), m_cpuBase(nullptr), m_size(size)
+{
+    void *mapped;
+    m_buffer->resource->Map(0, nullptr, &mapped);
+    m_cpuBase = static_cast<uint8_t *>(mapped);
+}
+
+PersistentBuffer::~PersistentBuffer()
+{
+    m_buffer->resource->Unmap(0, nullptr);
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS PersistentBuffer::getGpuAddress() const
+{
+    return m_buffer->resource->GetGPUVirtualAddress();
+}
+
+uint32_t PersistentBuffer::getSize() const
+{
+    return m_size;
+}
+
+} // namespace bisky::gfx
\ No newline at end of file
@@ -7,6 +7,49 @@ namespace bisky::gfx
 
 PipelineState::PipelineState(ID3D12Device10 *const device, const GraphicsPipelineStateDesc &gfxD)
 {
+    wrl::ComPtr<IDxcBlob> vs;
+    wrl::ComPtr<IDxcBlob> errors;
+    if (!ShaderCompiler::compile(ShaderType::Vertex, gfxD.vertexShader.name, gfxD.vertexShader.entryPoint, vs, errors))
+    {
+        LOG_WARNING(std::string(static_cast<const char *>(errors->GetBufferPointer())));
+    }
+
+    wrl::ComPtr<IDxcBlob> ps;
+    if (!ShaderCompiler::compile(ShaderType::Pixel, gfxD.pixelShader.name, gfxD.pixelShader.entryPoint, ps, errors))
+    {
+        LOG_WARNING(std::string(static_cast<const char *>(errors->GetBufferPointer())));
+    }
+
+    init(device, gfxD, vs.Get(), ps.Get());
+}
+
+PipelineState::PipelineState(
+    ID3D12Device10 *const device, const GraphicsPipelineStateDesc &gfxD, IDxcBlob *const vs, IDxcBlob *const ps
+)
+{
+    init(device, gfxD, vs, ps);
+}
+
+PipelineState::~PipelineState()
+{
+    m_pipelineState.Reset();
+}
+
+ID3D12PipelineState *const PipelineState::getPipelineState() const
+{
+    return m_pipelineState.Get();
+}
+
+void PipelineState::init(
+    ID3D12Device10 *const device, const GraphicsPipelineStateDesc &gfxD, IDxcBlob *const vs, IDxcBlob *const ps
+)
+{
+    if (!vs || !ps)
+    {
+        LOG_ERROR("Missing shader bytecode for pipeline state");
+        return;
+    }
+
     constexpr D3D12_RENDER_TARGET_BLEND_DESC renderTargetBlendDesc = {
         .BlendEnable           = false,
         .LogicOpEnable         = false,
@@ -38,19 +81,6 @@ PipelineState::PipelineState(ID3D12Device10 *const device, const GraphicsPipelin
         .StencilWriteMask = D3D12_DEFAULT_STENCIL_WRITE_MASK,
     };
 
-    wrl::ComPtr<IDxcBlob> vs;
-    wrl::ComPtr<IDxcBlob> errors;
-    if (!ShaderCompiler::compile(ShaderType::Vertex, gfxD.vertexShader.name, gfxD.vertexShader.entryPoint, vs, errors))
-    {
-        LOG_WARNING(std::string(static_cast<const char *>(errors->GetBufferPointer())));
-    }
-
-    wrl::ComPtr<IDxcBlob> ps;
-    if (!ShaderCompiler::compile(ShaderType::Pixel, gfxD.pixelShader.name, gfxD.pixelShader.entryPoint, ps, errors))
-    {
-        LOG_WARNING(std::string(static_cast<const char *>(errors->GetBufferPointer())));
-    }
-
     D3D12_GRAPHICS_PIPELINE_STATE_DESC gps = {
         .pRootSignature = gfxD.rootSignature,
         .VS =
@@ -94,14 +124,4 @@ PipelineState::PipelineState(ID3D12Device10 *const device, const GraphicsPipelin
     device->CreateGraphicsPipelineState(&gps, IID_PPV_ARGS(&m_pipelineState));
 }
 
-PipelineState::~PipelineState()
-{
-    m_pipelineState.Reset();
-}
-
-ID3D12PipelineState *const PipelineState::getPipelineState() const
-{
-    return m_pipelineState.Get();
-}
-
 } // namespace bisky::gfx
\ No newline at end of file
@@ -1,13 +1,23 @@
 #include "Common.hpp"
 
+#include "Graphics/Buffer.hpp"
 #include "Graphics/CommandQueue.hpp"
 #include "Graphics/Device.hpp"
 #include "Graphics/GraphicsCommandList.hpp"
 #include "Graphics/ResourceUpload.hpp"
+#include "Graphics/UploadManager.hpp"
 
 namespace bisky::gfx
 {
 
+void UploadTicket::wait() const
+{
+    if (queue)
+    {
+        queue->waitForFence(fenceValue);
+    }
+}
+
 ResourceUpload::ResourceUpload(Device *const device) : m_device(*device)
 {
     m_graphicsCommandList = std::make_unique<GraphicsCommandList>(device);
@@ -15,26 +25,65 @@ ResourceUpload::ResourceUpload(Device *const device) : m_device(*device)
 
 ResourceUpload::~ResourceUpload()
 {
+    // regions allocated without a Finish were never read
+    m_device.getUploadManager()->cancel(m_regions);
 }
 
 void ResourceUpload::Begin()
 {
+    // the previous command list belongs to the upload manager after Finish
+    if (!m_graphicsCommandList)
+    {
+        m_graphicsCommandList = std::make_unique<GraphicsCommandList>(&m_device);
+    }
+
     m_graphicsCommandList->reset();
 }
 
-std::future<void> ResourceUpload::Finish()
+UploadTicket ResourceUpload::Finish()
+{
+    CommandQueue *const queue = m_device.getDirectCommandQueue();
+
+    std::array<const CommandList *const, 1> cmdLists = {m_graphicsCommandList.get()};
+    queue->executeCommandLists(cmdLists);
+    const uint64_t fenceValue = queue->signal();
+
+    // -------------- hand everything the copies read from to the upload manager --------------
+    UploadManager *const uploadManager = m_device.getUploadManager();
+    uploadManager->submit(m_regions, fenceValue);
+    for (std::unique_ptr<Buffer> &buffer : m_uploadBuffers)
+    {
+        uploadManager->release(std::move(buffer), fenceValue);
+    }
+    uploadManager->release(std::move(m_graphicsCommandList), fenceValue);
+
+    m_regions.clear();
+    m_uploadBuffers.clear();
+    return {.queue = queue, .fenceValue = fenceValue};
+}
+
+StagingAllocation ResourceUpload::allocate(uint64_t size, uint64_t alignment)
 {
-    std::promise<void> p;
-    std::future<void>  future = p.get_future();
+    StagingAllocation allocation;
+    if (m_device.getUploadManager()->allocate(size, alignment, allocation))
+    {
+        m_regions.push_back(allocation.sequence);
+        return allocation;
+    }
+
+    // -------------- too big for the ring, use a buffer of its own --------------
+    std::unique_ptr<Buffer> buffer = m_device.createUploadBuffer(static_cast<uint32_t>(size));
 
-    std::thread([&p, this]() {
-        std::array<const CommandList *const, 1> cmdLists = {m_graphicsCommandList.get()};
-        m_device.getDirectCommandQueue()->executeCommandLists(cmdLists);
-        m_device.getDirectCommandQueue()->flush();
-        p.set_value_at_thread_exit();
-    }).join();
+    allocation = {.buffer = buffer.get(), .cpuAddress = nullptr, .offset = 0u, .sequence = 0u};
+    buffer->resource->Map(0, nullptr, reinterpret_cast<void **>(&allocation.cpuAddress));
 
-    return future;
+    addUploadBuffer(std::move(buffer));
+    return allocation;
+}
+
+void ResourceUpload::addUploadBuffer(std::unique_ptr<Buffer> buffer)
+{
+    m_uploadBuffers.push_back(std::move(buffer));
 }
 
 GraphicsCommandList *const ResourceUpload::getCommandList() const
@@ -1,14 +1,98 @@
 #include "Common.hpp"
 
+#include "Core/DerivedDataCache.hpp"
+#include "Core/Hash.hpp"
+#include "Core/JobSystem.hpp"
 #include "Core/ResourceManager.hpp"
 #include "Graphics/ShaderCompiler.hpp"
 
 namespace bisky::gfx::ShaderCompiler
 {
 
-wrl::ComPtr<IDxcCompiler3>      compiler;
-wrl::ComPtr<IDxcUtils>          utils;
-wrl::ComPtr<IDxcIncludeHandler> includeHandler;
+// DXC instances aren't thread safe, so every compiling thread creates its own
+thread_local wrl::ComPtr<IDxcCompiler3>      compiler;
+thread_local wrl::ComPtr<IDxcUtils>          utils;
+thread_local wrl::ComPtr<IDxcIncludeHandler> includeHandler;
+
+namespace
+{
+
+// bump this whenever the way shaders are compiled changes
+constexpr uint32_t ShaderCacheVersion = 1u;
+
+std::atomic<bool> cacheEnabled = true;
+
+/*
+ * Hashes a file and, recursively, every file it includes.
+ * Includes are resolved next to the including file first and then in the include directory,
+ * the same order the default include handler searches in. Missing includes are hashed
+ * by name so that creating one later still changes the key.
+ *
+ * @param hasher The hasher to update.
+ * @param path The file to hash.
+ * @param includePath The shader include directory.
+ * @param visited Files that have already been hashed.
+ */
+void hashSourceTree(
+    core::Hasher &hasher, const std::filesystem::path &path, const std::filesystem::path &includePath,
+    std::vector<std::filesystem::path> &visited
+)
+{
+    const std::filesystem::path canonical = std::filesystem::weakly_canonical(path);
+    if (std::ranges::find(visited, canonical) != visited.end())
+    {
+        return;
+    }
+    visited.push_back(canonical);
+
+    std::ifstream file(path, std::ios::binary);
+    std::string   source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    hasher.update(path.filename().generic_string());
+    hasher.update(source);
+
+    // -------------- find every #include "..." and #include <...> --------------
+    std::istringstream lines(source);
+    std::string        line;
+    while (std::getline(lines, line))
+    {
+        size_t directive = line.find_first_not_of(" \t");
+        if (directive == std::string::npos || line.compare(directive, 1, "#") != 0)
+        {
+            continue;
+        }
+
+        size_t keyword = line.find_first_not_of(" \t", directive + 1u);
+        if (keyword == std::string::npos || line.compare(keyword, 7, "include") != 0)
+        {
+            continue;
+        }
+
+        size_t open  = line.find_first_of("\"<", keyword + 7u);
+        size_t close = open == std::string::npos ? open : line.find_first_of("\">", open + 1u);
+        if (close == std::string::npos)
+        {
+            continue;
+        }
+
+        const std::filesystem::path include = line.substr(open + 1u, close - open - 1u);
+        std::filesystem::path       local   = path.parent_path() / include;
+        std::error_code             ec;
+        if (std::filesystem::is_regular_file(local, ec))
+        {
+            hashSourceTree(hasher, local, includePath, visited);
+        }
+        else if (std::filesystem::is_regular_file(includePath / include, ec))
+        {
+            hashSourceTree(hasher, includePath / include, includePath, visited);
+        }
+        else
+        {
+            hasher.update(include.generic_string());
+        }
+    }
+}
+
+} // namespace
 
 bool compile(
     const ShaderType &shaderType, const std::filesystem::path &filename, const std::wstring_view entryPoint,
@@ -62,6 +146,45 @@ bool compile(
     compilationArgs.push_back(DXC_ARG_OPTIMIZATION_LEVEL3);
 #endif
 
+    // -------------- build the cache key from the sources, compiler and arguments --------------
+    core::Hasher hasher;
+    hasher.update("shader");
+    hasher.updateValue(ShaderCacheVersion);
+
+    wrl::ComPtr<IDxcVersionInfo> versionInfo;
+    if (SUCCEEDED(compiler.As(&versionInfo)))
+    {
+        uint32_t major = 0u;
+        uint32_t minor = 0u;
+        versionInfo->GetVersion(&major, &minor);
+        hasher.updateValue(major);
+        hasher.updateValue(minor);
+    }
+
+    for (LPCWSTR arg : compilationArgs)
+    {
+        hasher.update(arg, wcslen(arg) * sizeof(wchar_t));
+        hasher.updateValue(L'\0');
+    }
+
+    std::vector<std::filesystem::path> visited;
+    hashSourceTree(hasher, path, includePath, visited);
+    const uint64_t key = hasher.finish();
+
+    // -------------- use the cached DXIL if nothing changed --------------
+    auto                &cache = core::DerivedDataCache::get();
+    std::vector<uint8_t> dxil;
+    if (cacheEnabled && cache.load("shaders", key, dxil))
+    {
+        wrl::ComPtr<IDxcBlobEncoding> cachedBlob;
+        if (SUCCEEDED(utils->CreateBlob(dxil.data(), static_cast<uint32_t>(dxil.size()), DXC_CP_ACP, &cachedBlob)))
+        {
+            resultBlob = cachedBlob;
+            LOG_INFO("Loaded cached " + path.string());
+            return true;
+        }
+    }
+
     wrl::ComPtr<IDxcBlobEncoding> sourceBlob;
     if (FAILED(utils->LoadFile(path.c_str(), nullptr, &sourceBlob)))
     {
@@ -92,6 +215,16 @@ bool compile(
         compiledBuffer->GetOutput(DXC_OUT_OBJECT, IID_PPV_ARGS(&resultBlob), nullptr);
         LOG_INFO("Compiled " + path.string());
         result = true;
+
+        HRESULT status = E_FAIL;
+        compiledBuffer->GetStatus(&status);
+        if (cacheEnabled && SUCCEEDED(status) && resultBlob->GetBufferSize() > 0u)
+        {
+            cache.store(
+                "shaders", key,
+                {static_cast<const uint8_t *>(resultBlob->GetBufferPointer()), resultBlob->GetBufferSize()}
+            );
+        }
     }
     if (compiledBuffer->HasOutput(DXC_OUT_ERRORS))
     {
@@ -101,4 +234,37 @@ bool compile(
     return result;
 }
 
+bool compileBatch(std::span<ShaderCompileJob> jobs, core::JobSystem &jobSystem)
+{
+    jobSystem.parallelFor(static_cast<uint32_t>(jobs.size()), 1u, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            auto &job     = jobs[i];
+            job.succeeded = compile(job.shaderType, job.filename, job.entryPoint, job.resultBlob, job.errorBlob);
+        }
+    });
+
+    bool result = true;
+    for (auto &job : jobs)
+    {
+        if (job.succeeded)
+        {
+            continue;
+        }
+
+        result = false;
+        if (job.errorBlob && job.errorBlob->GetBufferSize() > 0u)
+        {
+            LOG_WARNING(std::string(static_cast<const char *>(job.errorBlob->GetBufferPointer())));
+        }
+    }
+
+    return result;
+}
+
+void setCacheEnabled(bool enabled)
+{
+    cacheEnabled = enabled;
+}
+
 } // namespace bisky::gfx::ShaderCompiler
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "Graphics/StagingRing.hpp"
+
+namespace bisky::gfx
+{
+
+StagingRing::StagingRing(uint64_t capacity) : m_capacity(capacity)
+{
+}
+
+bool StagingRing::allocate(uint64_t size, uint64_t alignment, StagingRegion &region)
+{
+    if (size > m_capacity)
+    {
+        return false;
+    }
+
+    // -------------- align within the ring, skip to the start if it doesn't fit before the end --------------
+    const uint64_t offset  = m_head % m_capacity;
+    uint64_t       aligned = (offset + (alignment - 1u)) & ~(alignment - 1u);
+    if (aligned + size > m_capacity)
+    {
+        aligned = m_capacity;
+    }
+
+    const uint64_t end = m_head + (aligned - offset) + size;
+    if (end - m_tail > m_capacity)
+    {
+        return false;
+    }
+
+    region.offset   = aligned % m_capacity;
+    region.sequence = m_firstSequence + m_regions.size();
+
+    m_regions.push_back({.end = end, .fenceValue = 0u, .submitted = false});
+    m_head = end;
+    return true;
+}
+
+void StagingRing::submit(uint64_t sequence, uint64_t fenceValue)
+{
+    Region &region    = m_regions[sequence - m_firstSequence];
+    region.fenceValue = fenceValue;
+    region.submitted  = true;
+}
+
+void StagingRing::cancel(uint64_t sequence)
+{
+    submit(sequence, 0u);
+}
+
+void StagingRing::retire(uint64_t completedFenceValue)
+{
+    while (!m_regions.empty() && m_regions.front().submitted && m_regions.front().fenceValue <= completedFenceValue)
+    {
+        m_tail = m_regions.front().end;
+        m_regions.pop_front();
+        m_firstSequence++;
+    }
+
+    // -------------- start from the beginning again once everything is free --------------
+    if (m_regions.empty())
+    {
+        m_head = m_tail = 0u;
+    }
+}
+
+uint64_t StagingRing::getOldestFenceValue() const
+{
+    if (m_regions.empty() || !m_regions.front().submitted)
+    {
+        return 0u;
+    }
+
+    return m_regions.front().fenceValue;
+}
+
+uint64_t StagingRing::getUsedBytes() const
+{
+    return m_head - m_tail;
+}
+
+uint64_t StagingRing::getCapacity() const
+{
+    return m_capacity;
+}
+
+uint32_t StagingRing::getRegionCount() const
+{
+    return static_cast<uint32_t>(m_regions.size());
+}
+
+} // namespace bisky::gfx
\ No newline at end of file
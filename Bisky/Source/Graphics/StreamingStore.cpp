@@ -0,0 +1,44 @@
+#include "Common.hpp"
+
+#include "Graphics/StreamingStore.hpp"
+
+#include <emmintrin.h>
+
+namespace bisky::gfx::StreamingStore
+{
+
+void copy(void *destination, const void *source, size_t size)
+{
+    auto       *out = static_cast<__m128i *>(destination);
+    const auto *in  = static_cast<const __m128i *>(source);
+
+    // -------------- a whole write-combining line at a time --------------
+    for (; size >= 64u; size -= 64u, in += 4, out += 4)
+    {
+        const __m128i a = _mm_loadu_si128(in);
+        const __m128i b = _mm_loadu_si128(in + 1);
+        const __m128i c = _mm_loadu_si128(in + 2);
+        const __m128i d = _mm_loadu_si128(in + 3);
+        _mm_stream_si128(out, a);
+        _mm_stream_si128(out + 1, b);
+        _mm_stream_si128(out + 2, c);
+        _mm_stream_si128(out + 3, d);
+    }
+
+    for (; size >= 16u; size -= 16u, in++, out++)
+    {
+        _mm_stream_si128(out, _mm_loadu_si128(in));
+    }
+
+    if (size > 0u)
+    {
+        memcpy(out, in, size);
+    }
+}
+
+void fence()
+{
+    _mm_sfence();
+}
+
+} // namespace bisky::gfx::StreamingStore
\ No newline at end of file
@@ -15,4 +15,12 @@ int32_t Texture::GetSrvIndex(const Texture *const texture)
     return -1;
 }
 
+Texture::~Texture()
+{
+    if (memory.allocator)
+    {
+        memory.allocator->free(memory, std::move(resource));
+    }
+}
+
 } // namespace bisky::gfx
\ No newline at end of file
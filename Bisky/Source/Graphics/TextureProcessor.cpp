@@ -0,0 +1,432 @@
+#include "Core/JobSystem.hpp"
+#include "Core/Logger.hpp"
+#include "Graphics/BlockCompressor.hpp"
+#include "Graphics/TextureProcessor.hpp"
+
+#include <DirectXMath.h>
+#include <fmt/core.h>
+
+#include <emmintrin.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+// the alias Common.hpp declares for the files that use it
+namespace dx = DirectX;
+
+namespace bisky::gfx::TextureProcessor
+{
+
+namespace
+{
+
+/*
+ * Converts sRGB bytes to linear values, and linear values back to the closest sRGB byte.
+ */
+struct SrgbTables
+{
+    float toLinear[256];
+    float thresholds[255]; // the linear value half way between two neighbouring bytes
+};
+
+float srgbToLinear(float value)
+{
+    return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+}
+
+const SrgbTables &getSrgbTables()
+{
+    static const SrgbTables tables = [] {
+        SrgbTables result;
+        for (uint32_t i = 0; i < 256u; i++)
+        {
+            result.toLinear[i] = srgbToLinear(i / 255.0f);
+        }
+
+        // the conversion is monotonic, so the right byte is the number of thresholds below the value
+        for (uint32_t i = 0; i < 255u; i++)
+        {
+            result.thresholds[i] = srgbToLinear((i + 0.5f) / 255.0f);
+        }
+
+        return result;
+    }();
+    return tables;
+}
+
+/*
+ * The source texels one destination texel covers along an axis, and how much of each it covers.
+ */
+struct FilterFootprint
+{
+    uint32_t first;
+    uint32_t count;
+    float    weights[3];
+};
+
+/*
+ * Gets the footprints of a box filter from one size to a smaller one.
+ * Halving an odd size covers two and a half texels, so the middle one is shared.
+ *
+ * @param source The size of the source level.
+ * @param destination The size of the destination level.
+ * @return One footprint per destination texel.
+ */
+std::vector<FilterFootprint> getFootprints(uint32_t source, uint32_t destination)
+{
+    const float scale = static_cast<float>(source) / destination;
+
+    std::vector<FilterFootprint> footprints(destination);
+    for (uint32_t i = 0; i < destination; i++)
+    {
+        const float begin = i * scale;
+        const float end   = (i + 1u) * scale;
+
+        auto &footprint = footprints[i];
+        footprint.first = static_cast<uint32_t>(begin);
+        footprint.count = 0u;
+        for (uint32_t k = footprint.first; k < source && k < end && footprint.count < 3u; k++)
+        {
+            const float coverage = std::min(end, k + 1.0f) - std::max(begin, static_cast<float>(k));
+
+            footprint.weights[footprint.count++] = coverage / scale;
+        }
+    }
+
+    return footprints;
+}
+
+/*
+ * Box filters a level of RGBA texels, one SSE register per texel.
+ */
+void downsample(
+    const std::vector<__m128> &source, uint32_t sourceWidth, uint32_t sourceHeight, std::vector<__m128> &destination,
+    uint32_t width, uint32_t height
+)
+{
+    const std::vector<FilterFootprint> columns = getFootprints(sourceWidth, width);
+    const std::vector<FilterFootprint> rows    = getFootprints(sourceHeight, height);
+
+    destination.resize(static_cast<size_t>(width) * height);
+    for (uint32_t y = 0; y < height; y++)
+    {
+        const FilterFootprint &row = rows[y];
+        for (uint32_t x = 0; x < width; x++)
+        {
+            const FilterFootprint &column = columns[x];
+
+            __m128 sum = _mm_setzero_ps();
+            for (uint32_t r = 0; r < row.count; r++)
+            {
+                const __m128 *texels = source.data() + static_cast<size_t>(row.first + r) * sourceWidth;
+                __m128        rowSum = _mm_setzero_ps();
+                for (uint32_t c = 0; c < column.count; c++)
+                {
+                    rowSum = _mm_add_ps(rowSum, _mm_mul_ps(texels[column.first + c], _mm_set1_ps(column.weights[c])));
+                }
+
+                sum = _mm_add_ps(sum, _mm_mul_ps(rowSum, _mm_set1_ps(row.weights[r])));
+            }
+
+            destination[static_cast<size_t>(y) * width + x] = sum;
+        }
+    }
+}
+
+/*
+ * Rescales the XYZ of every texel of a normal map back to unit length, W is kept.
+ */
+void renormalize(std::vector<__m128> &texels)
+{
+    const dx::XMVECTOR half = dx::XMVectorReplicate(0.5f);
+    for (__m128 &texel : texels)
+    {
+        dx::XMVECTOR normal = dx::XMVectorSubtract(dx::XMVectorAdd(texel, texel), dx::g_XMOne);
+        normal              = dx::XMVectorMultiplyAdd(dx::XMVector3Normalize(normal), half, half);
+        texel               = dx::XMVectorSelect(texel, normal, dx::g_XMSelect1110);
+    }
+}
+
+void toTexels(const uint8_t *pixels, size_t count, bool srgb, std::vector<__m128> &texels)
+{
+    const SrgbTables &tables = getSrgbTables();
+    const __m128      scale  = _mm_set1_ps(1.0f / 255.0f);
+
+    texels.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint8_t *pixel = pixels + i * 4u;
+        if (srgb)
+        {
+            texels[i] = _mm_setr_ps(
+                tables.toLinear[pixel[0]], tables.toLinear[pixel[1]], tables.toLinear[pixel[2]], pixel[3] / 255.0f
+            );
+        }
+        else
+        {
+            texels[i] = _mm_mul_ps(_mm_setr_ps(pixel[0], pixel[1], pixel[2], pixel[3]), scale);
+        }
+    }
+}
+
+void toPixels(const std::vector<__m128> &texels, bool srgb, uint8_t *pixels)
+{
+    const SrgbTables &tables = getSrgbTables();
+    const __m128      scale  = _mm_set1_ps(255.0f);
+
+    for (size_t i = 0; i < texels.size(); i++)
+    {
+        // -------------- clamp, scale and round every channel, then pack them into bytes --------------
+        __m128  clamped = _mm_min_ps(_mm_max_ps(texels[i], _mm_setzero_ps()), _mm_set1_ps(1.0f));
+        __m128i value   = _mm_cvtps_epi32(_mm_mul_ps(clamped, scale));
+        value           = _mm_packs_epi32(value, value);
+        value           = _mm_packus_epi16(value, value);
+
+        const int packed = _mm_cvtsi128_si32(value);
+        uint8_t  *pixel  = pixels + i * 4u;
+        memcpy(pixel, &packed, sizeof(packed));
+        if (srgb)
+        {
+            alignas(16) float linear[4];
+            _mm_store_ps(linear, texels[i]);
+            for (uint32_t c = 0; c < 3u; c++)
+            {
+                pixel[c] = static_cast<uint8_t>(
+                    std::upper_bound(std::begin(tables.thresholds), std::end(tables.thresholds), linear[c]) -
+                    std::begin(tables.thresholds)
+                );
+            }
+        }
+    }
+}
+
+uint32_t getBlockSize(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+    case DXGI_FORMAT_BC1_UNORM:
+    case DXGI_FORMAT_BC1_UNORM_SRGB:
+    case DXGI_FORMAT_BC4_UNORM:
+        return BlockCompressor::Bc1BlockSize;
+    case DXGI_FORMAT_BC3_UNORM:
+    case DXGI_FORMAT_BC3_UNORM_SRGB:
+    case DXGI_FORMAT_BC5_UNORM:
+    case DXGI_FORMAT_BC6H_UF16:
+    case DXGI_FORMAT_BC7_UNORM:
+    case DXGI_FORMAT_BC7_UNORM_SRGB:
+        return BlockCompressor::Bc7BlockSize;
+    default:
+        return 0u;
+    }
+}
+
+} // namespace
+
+DXGI_FORMAT getFormat(TextureRole role, TextureQuality quality, bool hasAlpha)
+{
+    switch (role)
+    {
+    case TextureRole::Normal:
+        return DXGI_FORMAT_BC5_UNORM;
+    case TextureRole::MetallicRoughness:
+        return DXGI_FORMAT_BC1_UNORM;
+    default:
+        if (quality == TextureQuality::High)
+            return DXGI_FORMAT_BC7_UNORM;
+
+        return hasAlpha ? DXGI_FORMAT_BC3_UNORM : DXGI_FORMAT_BC1_UNORM;
+    }
+}
+
+std::string_view getFormatName(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+    case DXGI_FORMAT_BC1_UNORM:
+        return "BC1";
+    case DXGI_FORMAT_BC3_UNORM:
+        return "BC3";
+    case DXGI_FORMAT_BC5_UNORM:
+        return "BC5";
+    case DXGI_FORMAT_BC7_UNORM:
+        return "BC7";
+    case DXGI_FORMAT_R8G8B8A8_UNORM:
+        return "RGBA8";
+    default:
+        return "unknown";
+    }
+}
+
+uint32_t getMipCount(uint32_t width, uint32_t height)
+{
+    uint32_t levels = 1u;
+    for (uint32_t size = std::max(width, height); size > 1u; size >>= 1u)
+    {
+        levels++;
+    }
+
+    return levels;
+}
+
+SurfaceInfo getSurfaceInfo(DXGI_FORMAT format, uint32_t width, uint32_t height)
+{
+    const uint32_t blockSize = getBlockSize(format);
+    if (blockSize == 0u)
+    {
+        return {width * 4u, height};
+    }
+
+    return {std::max((width + 3u) / 4u, 1u) * blockSize, std::max((height + 3u) / 4u, 1u)};
+}
+
+size_t getTextureSize(DXGI_FORMAT format, uint32_t width, uint32_t height, uint32_t mipLevels)
+{
+    size_t size = 0u;
+    for (uint32_t mip = 0; mip < mipLevels; mip++)
+    {
+        const SurfaceInfo surface = getSurfaceInfo(format, std::max(width >> mip, 1u), std::max(height >> mip, 1u));
+        size += static_cast<size_t>(surface.rowBytes) * surface.rowCount;
+    }
+
+    return size;
+}
+
+void generateMips(const uint8_t *pixels, uint32_t width, uint32_t height, TextureRole role, std::vector<uint8_t> &mips)
+{
+    const bool     srgb      = role == TextureRole::Diffuse;
+    const uint32_t mipLevels = getMipCount(width, height);
+
+    mips.resize(getTextureSize(DXGI_FORMAT_R8G8B8A8_UNORM, width, height, mipLevels));
+    memcpy(mips.data(), pixels, static_cast<size_t>(width) * height * 4u);
+
+    // -------------- every level is filtered from the full precision level above it --------------
+    std::vector<__m128> level;
+    std::vector<__m128> next;
+    toTexels(pixels, static_cast<size_t>(width) * height, srgb, level);
+
+    size_t offset = static_cast<size_t>(width) * height * 4u;
+    for (uint32_t mip = 1; mip < mipLevels; mip++)
+    {
+        const uint32_t mipWidth  = std::max(width >> 1u, 1u);
+        const uint32_t mipHeight = std::max(height >> 1u, 1u);
+        downsample(level, width, height, next, mipWidth, mipHeight);
+        if (role == TextureRole::Normal)
+        {
+            renormalize(next);
+        }
+
+        toPixels(next, srgb, mips.data() + offset);
+        offset += static_cast<size_t>(mipWidth) * mipHeight * 4u;
+
+        std::swap(level, next);
+        width  = mipWidth;
+        height = mipHeight;
+    }
+}
+
+void compress(
+    const uint8_t *pixels, uint32_t width, uint32_t height, DXGI_FORMAT format, uint8_t *blocks, bool parallel
+)
+{
+    void (*encode)(const uint8_t *, uint8_t *) = nullptr;
+    switch (format)
+    {
+    case DXGI_FORMAT_BC1_UNORM:
+        encode = BlockCompressor::encodeBc1;
+        break;
+    case DXGI_FORMAT_BC3_UNORM:
+        encode = BlockCompressor::encodeBc3;
+        break;
+    case DXGI_FORMAT_BC5_UNORM:
+        encode = BlockCompressor::encodeBc5;
+        break;
+    case DXGI_FORMAT_BC7_UNORM:
+        encode = BlockCompressor::encodeBc7;
+        break;
+    default:
+        LOG_ERROR(fmt::format("No block encoder for format {}", static_cast<int>(format)));
+        return;
+    }
+
+    const SurfaceInfo surface    = getSurfaceInfo(format, width, height);
+    const uint32_t    blocksWide = std::max((width + 3u) / 4u, 1u);
+    const uint32_t    blockSize  = surface.rowBytes / blocksWide;
+
+    auto encodeRows = [&](uint32_t begin, uint32_t end) {
+        uint8_t block[64];
+        for (uint32_t by = begin; by < end; by++)
+        {
+            for (uint32_t bx = 0; bx < blocksWide; bx++)
+            {
+                // -------------- gather the block, repeating the edges of levels smaller than it --------------
+                for (uint32_t y = 0; y < 4u; y++)
+                {
+                    const uint32_t sy = std::min(by * 4u + y, height - 1u);
+                    for (uint32_t x = 0; x < 4u; x++)
+                    {
+                        const uint32_t sx = std::min(bx * 4u + x, width - 1u);
+                        memcpy(block + (y * 4u + x) * 4u, pixels + (static_cast<size_t>(sy) * width + sx) * 4u, 4u);
+                    }
+                }
+
+                encode(block, blocks + static_cast<size_t>(by) * surface.rowBytes + bx * blockSize);
+            }
+        }
+    };
+
+    if (parallel)
+        core::JobSystem::get().parallelFor(surface.rowCount, std::max(1024u / blocksWide, 1u), encodeRows);
+    else
+        encodeRows(0u, surface.rowCount);
+}
+
+void process(
+    const uint8_t *pixels, uint32_t width, uint32_t height, TextureRole role, TextureQuality quality,
+    ProcessedTexture &texture, bool parallel
+)
+{
+    texture.width     = width;
+    texture.height    = height;
+    texture.mipLevels = getMipCount(width, height);
+
+    std::vector<uint8_t> mips;
+    generateMips(pixels, width, height, role, mips);
+
+    // -------------- the largest level of a block compressed texture has to be made of whole blocks --------------
+    if (width % 4u != 0u || height % 4u != 0u)
+    {
+        texture.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+        texture.data   = std::move(mips);
+        return;
+    }
+
+    bool hasAlpha = false;
+    for (size_t i = 3u; i < static_cast<size_t>(width) * height * 4u && !hasAlpha; i += 4u)
+    {
+        hasAlpha = pixels[i] != 255u;
+    }
+
+    texture.format = getFormat(role, quality, hasAlpha);
+    texture.data.resize(getTextureSize(texture.format, width, height, texture.mipLevels));
+
+    // -------------- compress every level --------------
+    size_t sourceOffset      = 0u;
+    size_t destinationOffset = 0u;
+    for (uint32_t mip = 0; mip < texture.mipLevels; mip++)
+    {
+        const uint32_t    mipWidth  = std::max(width >> mip, 1u);
+        const uint32_t    mipHeight = std::max(height >> mip, 1u);
+        const SurfaceInfo surface   = getSurfaceInfo(texture.format, mipWidth, mipHeight);
+        compress(
+            mips.data() + sourceOffset, mipWidth, mipHeight, texture.format, texture.data.data() + destinationOffset,
+            parallel
+        );
+
+        sourceOffset += static_cast<size_t>(mipWidth) * mipHeight * 4u;
+        destinationOffset += static_cast<size_t>(surface.rowBytes) * surface.rowCount;
+    }
+}
+
+} // namespace bisky::gfx::TextureProcessor
\ No newline at end of file
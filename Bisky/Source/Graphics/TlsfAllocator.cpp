@@ -0,0 +1,297 @@
+#include "Graphics/TlsfAllocator.hpp"
+
+#include <algorithm>
+#include <bit>
+
+namespace bisky::gfx
+{
+
+TlsfAllocator::TlsfAllocator(uint64_t capacity, uint64_t granularity)
+    : m_capacity(capacity), m_granularity(granularity)
+{
+    for (auto &freeList : m_freeLists)
+    {
+        freeList.fill(InvalidBlock);
+    }
+
+    if (capacity >= granularity)
+    {
+        insertFreeBlock(createBlock(0u, capacity));
+    }
+}
+
+bool TlsfAllocator::allocate(uint64_t size, uint64_t alignment, TlsfAllocation &allocation)
+{
+    size      = (std::max(size, uint64_t(1u)) + m_granularity - 1u) & ~(m_granularity - 1u);
+    alignment = std::max(alignment, m_granularity);
+
+    // -------------- a block this big fits the size wherever its start lands --------------
+    const uint64_t padded = size + alignment - m_granularity;
+    uint32_t       block  = findFreeBlock(padded);
+    if (block == InvalidBlock)
+    {
+        // -------------- the blocks in the padded size's own bin might still be big enough --------------
+        uint32_t firstLevel, secondLevel;
+        getBin(padded / m_granularity, firstLevel, secondLevel);
+        if (firstLevel < FirstLevelCount)
+        {
+            for (block = m_freeLists[firstLevel][secondLevel]; block != InvalidBlock; block = m_blocks[block].nextFree)
+            {
+                if (m_blocks[block].size >= padded)
+                    break;
+            }
+        }
+
+        if (block == InvalidBlock)
+        {
+            return false;
+        }
+    }
+    removeFreeBlock(block);
+
+    // -------------- the space before the aligned start stays free --------------
+    const uint64_t offset  = m_blocks[block].offset;
+    const uint64_t aligned = (offset + alignment - 1u) & ~(alignment - 1u);
+    if (aligned > offset)
+    {
+        const uint32_t front = block;
+        splitBlock(front, aligned - offset);
+        block = m_blocks[front].nextPhysical;
+        insertFreeBlock(front);
+    }
+
+    // -------------- and so does the space after the end --------------
+    if (m_blocks[block].size > size)
+    {
+        splitBlock(block, size);
+        insertFreeBlock(m_blocks[block].nextPhysical);
+    }
+
+    m_blocks[block].free = false;
+    m_usedBytes += size;
+    m_allocationCount++;
+
+    allocation = {.offset = aligned, .size = size, .block = block};
+    return true;
+}
+
+void TlsfAllocator::free(const TlsfAllocation &allocation)
+{
+    uint32_t block = allocation.block;
+    m_blocks[block].free = true;
+    m_usedBytes -= m_blocks[block].size;
+    m_allocationCount--;
+
+    // -------------- merge with the free neighbours --------------
+    const uint32_t next = m_blocks[block].nextPhysical;
+    if (next != InvalidBlock && m_blocks[next].free)
+    {
+        removeFreeBlock(next);
+        mergeBlocks(block, next);
+    }
+
+    const uint32_t previous = m_blocks[block].previousPhysical;
+    if (previous != InvalidBlock && m_blocks[previous].free)
+    {
+        removeFreeBlock(previous);
+        mergeBlocks(previous, block);
+        block = previous;
+    }
+
+    insertFreeBlock(block);
+}
+
+bool TlsfAllocator::isEmpty() const
+{
+    return m_allocationCount == 0u;
+}
+
+TlsfStats TlsfAllocator::getStats() const
+{
+    // -------------- the largest block is in the highest bin with any blocks --------------
+    uint64_t largestFreeBlock = 0u;
+    if (m_firstLevelBitmap != 0u)
+    {
+        const uint32_t firstLevel  = 63u - std::countl_zero(m_firstLevelBitmap);
+        const uint32_t secondLevel = 31u - std::countl_zero(m_secondLevelBitmaps[firstLevel]);
+        uint32_t       block       = m_freeLists[firstLevel][secondLevel];
+        while (block != InvalidBlock)
+        {
+            largestFreeBlock = std::max(largestFreeBlock, m_blocks[block].size);
+            block            = m_blocks[block].nextFree;
+        }
+    }
+
+    return {
+        .capacity         = m_capacity,
+        .usedBytes        = m_usedBytes,
+        .largestFreeBlock = largestFreeBlock,
+        .allocationCount  = m_allocationCount,
+        .freeBlockCount   = m_freeBlockCount,
+    };
+}
+
+void TlsfAllocator::getBin(uint64_t units, uint32_t &firstLevel, uint32_t &secondLevel) const
+{
+    // -------------- small sizes get a bin each, bigger ones share bins a 16th of their power of two --------------
+    if (units < SecondLevelCount)
+    {
+        firstLevel  = 0u;
+        secondLevel = static_cast<uint32_t>(units);
+        return;
+    }
+
+    const uint32_t highestBit = 63u - std::countl_zero(units);
+    firstLevel                = highestBit - SecondLevelBits + 1u;
+    secondLevel               = static_cast<uint32_t>(units >> (highestBit - SecondLevelBits)) ^ SecondLevelCount;
+}
+
+uint32_t TlsfAllocator::findFreeBlock(uint64_t size) const
+{
+    // -------------- round up to the next bin, so any block in the bins searched fits --------------
+    uint64_t units = size / m_granularity;
+    if (units >= SecondLevelCount)
+    {
+        const uint32_t highestBit = 63u - std::countl_zero(units);
+        units += (uint64_t(1u) << (highestBit - SecondLevelBits)) - 1u;
+    }
+
+    uint32_t firstLevel, secondLevel;
+    getBin(units, firstLevel, secondLevel);
+    if (firstLevel >= FirstLevelCount)
+    {
+        return InvalidBlock;
+    }
+
+    // -------------- the first bin with blocks at this level, or failing that at a higher level --------------
+    uint32_t secondLevelBitmap = m_secondLevelBitmaps[firstLevel] & (~0u << secondLevel);
+    if (secondLevelBitmap == 0u)
+    {
+        const uint64_t firstLevelBitmap =
+            firstLevel + 1u < 64u ? m_firstLevelBitmap & (~uint64_t(0u) << (firstLevel + 1u)) : 0u;
+        if (firstLevelBitmap == 0u)
+        {
+            return InvalidBlock;
+        }
+
+        firstLevel        = std::countr_zero(firstLevelBitmap);
+        secondLevelBitmap = m_secondLevelBitmaps[firstLevel];
+    }
+
+    secondLevel = std::countr_zero(secondLevelBitmap);
+    return m_freeLists[firstLevel][secondLevel];
+}
+
+void TlsfAllocator::insertFreeBlock(uint32_t block)
+{
+    uint32_t firstLevel, secondLevel;
+    getBin(m_blocks[block].size / m_granularity, firstLevel, secondLevel);
+
+    const uint32_t head          = m_freeLists[firstLevel][secondLevel];
+    m_blocks[block].free         = true;
+    m_blocks[block].previousFree = InvalidBlock;
+    m_blocks[block].nextFree     = head;
+    if (head != InvalidBlock)
+    {
+        m_blocks[head].previousFree = block;
+    }
+
+    m_freeLists[firstLevel][secondLevel] = block;
+    m_secondLevelBitmaps[firstLevel] |= 1u << secondLevel;
+    m_firstLevelBitmap |= uint64_t(1u) << firstLevel;
+    m_freeBlockCount++;
+}
+
+void TlsfAllocator::removeFreeBlock(uint32_t block)
+{
+    uint32_t firstLevel, secondLevel;
+    getBin(m_blocks[block].size / m_granularity, firstLevel, secondLevel);
+
+    const uint32_t previous = m_blocks[block].previousFree;
+    const uint32_t next     = m_blocks[block].nextFree;
+    if (previous != InvalidBlock)
+    {
+        m_blocks[previous].nextFree = next;
+    }
+    if (next != InvalidBlock)
+    {
+        m_blocks[next].previousFree = previous;
+    }
+
+    // -------------- clear the bits of bins that are now empty --------------
+    if (m_freeLists[firstLevel][secondLevel] == block)
+    {
+        m_freeLists[firstLevel][secondLevel] = next;
+        if (next == InvalidBlock)
+        {
+            m_secondLevelBitmaps[firstLevel] &= ~(1u << secondLevel);
+            if (m_secondLevelBitmaps[firstLevel] == 0u)
+            {
+                m_firstLevelBitmap &= ~(uint64_t(1u) << firstLevel);
+            }
+        }
+    }
+
+    m_freeBlockCount--;
+}
+
+uint32_t TlsfAllocator::createBlock(uint64_t offset, uint64_t size)
+{
+    const Block newBlock = {
+        .offset           = offset,
+        .size             = size,
+        .previousPhysical = InvalidBlock,
+        .nextPhysical     = InvalidBlock,
+        .previousFree     = InvalidBlock,
+        .nextFree         = InvalidBlock,
+        .free             = false,
+    };
+
+    if (!m_unusedBlocks.empty())
+    {
+        const uint32_t block = m_unusedBlocks.back();
+        m_unusedBlocks.pop_back();
+        m_blocks[block] = newBlock;
+        return block;
+    }
+
+    m_blocks.push_back(newBlock);
+    return static_cast<uint32_t>(m_blocks.size() - 1u);
+}
+
+void TlsfAllocator::destroyBlock(uint32_t block)
+{
+    m_unusedBlocks.push_back(block);
+}
+
+void TlsfAllocator::splitBlock(uint32_t block, uint64_t size)
+{
+    const uint32_t rest = createBlock(m_blocks[block].offset + size, m_blocks[block].size - size);
+    const uint32_t next = m_blocks[block].nextPhysical;
+
+    m_blocks[rest].previousPhysical = block;
+    m_blocks[rest].nextPhysical     = next;
+    if (next != InvalidBlock)
+    {
+        m_blocks[next].previousPhysical = rest;
+    }
+
+    m_blocks[block].nextPhysical = rest;
+    m_blocks[block].size         = size;
+}
+
+void TlsfAllocator::mergeBlocks(uint32_t previous, uint32_t block)
+{
+    const uint32_t next = m_blocks[block].nextPhysical;
+
+    m_blocks[previous].size += m_blocks[block].size;
+    m_blocks[previous].nextPhysical = next;
+    if (next != InvalidBlock)
+    {
+        m_blocks[next].previousPhysical = previous;
+    }
+
+    destroyBlock(block);
+}
+
+} // namespace bisky::gfx
\ No newline at end of file
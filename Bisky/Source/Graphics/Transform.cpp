@@ -1,92 +1,114 @@
 #include "Common.hpp"
 
 #include "Graphics/Transform.hpp"
+#include "Graphics/TransformStorage.hpp"
 
 namespace bisky::gfx
 {
 
-Transform::Transform()
+Transform::Transform(TransformStorage *storage, uint32_t index) : m_storage(storage), m_index(index)
 {
-    XMStoreFloat3(&m_scale, dx::FXMVECTOR{1.0f, 1.0f, 1.0f});
-    XMStoreFloat3(&m_rotation, dx::FXMVECTOR{0.0f, 0.0f, 0.0f});
-    XMStoreFloat3(&m_translation, dx::FXMVECTOR{0.0f, 0.0f, 0.0f});
 }
 
 void Transform::setScale(float x, float y, float z)
 {
-    XMStoreFloat3(&m_scale, dx::FXMVECTOR{x, y, z});
+    m_storage->setScale(m_index, x, y, z);
 }
 
 void Transform::setTranslation(float x, float y, float z)
 {
-    XMStoreFloat3(&m_translation, dx::FXMVECTOR{x, y, z});
+    m_storage->setTranslation(m_index, x, y, z);
 }
 
 void Transform::addTranslation(float x, float y, float z)
 {
-    XMStoreFloat3(&m_translation, dx::XMVectorAdd(XMLoadFloat3(&m_translation), dx::FXMVECTOR{x, y, z}));
+    m_storage->addTranslation(m_index, x, y, z);
 }
 
 void Transform::setRotation(float x, float y, float z)
 {
-    XMStoreFloat3(&m_rotation, dx::FXMVECTOR{x, y, z});
+    m_storage->setRotation(m_index, x, y, z);
+}
+
+bool Transform::takeChanged()
+{
+    return m_storage->takeChanged(m_index);
 }
 
 dx::XMMATRIX Transform::getLocalToWorld() const
 {
-    dx::XMMATRIX s = dx::XMMatrixScaling(m_scale.x, m_scale.y, m_scale.z);
-    dx::XMMATRIX r = dx::XMMatrixRotationQuaternion(dx::XMQuaternionRotationRollPitchYaw(
-        dx::XMConvertToRadians(m_rotation.x), dx::XMConvertToRadians(m_rotation.y),
-        dx::XMConvertToRadians(m_rotation.z)));
-    dx::XMMATRIX t = dx::XMMatrixTranslation(m_translation.x, m_translation.y, m_translation.z);
+    return m_storage->getLocalToWorld(m_index);
+}
+
+dx::XMMATRIX Transform::getWorldToLocal() const
+{
+    return m_storage->getWorldToLocal(m_index);
+}
 
-    return s * r * t;
+dx::XMMATRIX Transform::getNormalMatrix() const
+{
+    return dx::XMMatrixTranspose(m_storage->getWorldToLocal(m_index));
 }
 
 dx::XMVECTOR Transform::getScale() const
 {
-    return XMLoadFloat3(&m_scale);
+    const dx::XMFLOAT3 scale = m_storage->getScale(m_index);
+    return XMLoadFloat3(&scale);
 }
 
 dx::XMFLOAT3 Transform::getScale3f() const
 {
-    return m_scale;
+    return m_storage->getScale(m_index);
 }
 
 dx::XMMATRIX Transform::getScaleMatrix() const
 {
-    return dx::XMMatrixScaling(m_scale.x, m_scale.y, m_scale.z);
+    const dx::XMFLOAT3 scale = m_storage->getScale(m_index);
+    return dx::XMMatrixScaling(scale.x, scale.y, scale.z);
 }
 
 dx::XMVECTOR Transform::getRotation() const
 {
-    return XMLoadFloat3(&m_rotation);
+    const dx::XMFLOAT3 rotation = m_storage->getRotation(m_index);
+    return XMLoadFloat3(&rotation);
 }
 
 dx::XMFLOAT3 Transform::getRotation3f() const
 {
-    return m_rotation;
+    return m_storage->getRotation(m_index);
 }
 
 dx::XMMATRIX Transform::getRotationMatrix() const
 {
-    return dx::XMMatrixRotationQuaternion(
-        dx::XMQuaternionRotationRollPitchYaw(m_rotation.y, m_rotation.x, m_rotation.z));
+    const dx::XMFLOAT3 rotation = m_storage->getRotation(m_index);
+    return dx::XMMatrixRotationQuaternion(dx::XMQuaternionRotationRollPitchYaw(rotation.y, rotation.x, rotation.z));
 }
 
 dx::XMVECTOR Transform::getTranslation() const
 {
-    return XMLoadFloat3(&m_translation);
+    const dx::XMFLOAT3 translation = m_storage->getTranslation(m_index);
+    return XMLoadFloat3(&translation);
 }
 
 dx::XMFLOAT3 Transform::getTranslation3f() const
 {
-    return m_translation;
+    return m_storage->getTranslation(m_index);
 }
 
 dx::XMMATRIX Transform::getTranslationMatrix() const
 {
-    return dx::XMMatrixTranslation(m_translation.x, m_translation.y, m_translation.z);
+    const dx::XMFLOAT3 translation = m_storage->getTranslation(m_index);
+    return dx::XMMatrixTranslation(translation.x, translation.y, translation.z);
+}
+
+uint32_t Transform::getIndex() const
+{
+    return m_index;
+}
+
+uint32_t Transform::getParentIndex() const
+{
+    return m_storage->getParent(m_index);
 }
 
 } // namespace bisky::gfx
\ No newline at end of file
@@ -0,0 +1,608 @@
+#include "Common.hpp"
+
+#include "Core/CpuFeatures.hpp"
+#include "Core/JobSystem.hpp"
+#include "Graphics/TransformStorage.hpp"
+
+#include <immintrin.h>
+
+namespace bisky::gfx
+{
+
+namespace
+{
+
+constexpr float DegreesToRadians = 0.0174532925f;
+constexpr float Pi               = 3.141592654f;
+constexpr float HalfPi           = 1.570796327f;
+constexpr float TwoPi            = 6.283185307f;
+constexpr float InverseTwoPi     = 0.159154943f;
+
+/*
+ * 4 lanes of SSE2.
+ */
+struct Sse
+{
+    using Vector = __m128;
+
+    constexpr static uint32_t Width = 4u;
+
+    static Vector load(const float *p)
+    {
+        return _mm_loadu_ps(p);
+    }
+
+    static Vector set(float value)
+    {
+        return _mm_set1_ps(value);
+    }
+
+    static Vector add(Vector a, Vector b)
+    {
+        return _mm_add_ps(a, b);
+    }
+
+    static Vector sub(Vector a, Vector b)
+    {
+        return _mm_sub_ps(a, b);
+    }
+
+    static Vector mul(Vector a, Vector b)
+    {
+        return _mm_mul_ps(a, b);
+    }
+
+    static Vector div(Vector a, Vector b)
+    {
+        return _mm_div_ps(a, b);
+    }
+
+    static Vector round(Vector a)
+    {
+        return _mm_cvtepi32_ps(_mm_cvtps_epi32(a));
+    }
+
+    static Vector andOf(Vector a, Vector b)
+    {
+        return _mm_and_ps(a, b);
+    }
+
+    static Vector andNot(Vector a, Vector b)
+    {
+        return _mm_andnot_ps(a, b);
+    }
+
+    static Vector orOf(Vector a, Vector b)
+    {
+        return _mm_or_ps(a, b);
+    }
+
+    static Vector greater(Vector a, Vector b)
+    {
+        return _mm_cmpgt_ps(a, b);
+    }
+
+    static Vector select(Vector mask, Vector a, Vector b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    /*
+     * Stores one row of each lane's matrix, the four vectors hold one column each.
+     */
+    static void storeRow(dx::XMFLOAT4X4 *matrices, uint32_t row, Vector x, Vector y, Vector z, Vector w)
+    {
+        _MM_TRANSPOSE4_PS(x, y, z, w);
+        _mm_storeu_ps(&matrices[0].m[row][0], x);
+        _mm_storeu_ps(&matrices[1].m[row][0], y);
+        _mm_storeu_ps(&matrices[2].m[row][0], z);
+        _mm_storeu_ps(&matrices[3].m[row][0], w);
+    }
+};
+
+/*
+ * 8 lanes of AVX. Only used after IsSupported checked the CPU, the rest of the build stays SSE2.
+ */
+struct Avx
+{
+    using Vector = __m256;
+
+    constexpr static uint32_t Width = 8u;
+
+    static Vector load(const float *p)
+    {
+        return _mm256_loadu_ps(p);
+    }
+
+    static Vector set(float value)
+    {
+        return _mm256_set1_ps(value);
+    }
+
+    static Vector add(Vector a, Vector b)
+    {
+        return _mm256_add_ps(a, b);
+    }
+
+    static Vector sub(Vector a, Vector b)
+    {
+        return _mm256_sub_ps(a, b);
+    }
+
+    static Vector mul(Vector a, Vector b)
+    {
+        return _mm256_mul_ps(a, b);
+    }
+
+    static Vector div(Vector a, Vector b)
+    {
+        return _mm256_div_ps(a, b);
+    }
+
+    static Vector round(Vector a)
+    {
+        return _mm256_cvtepi32_ps(_mm256_cvtps_epi32(a));
+    }
+
+    static Vector andOf(Vector a, Vector b)
+    {
+        return _mm256_and_ps(a, b);
+    }
+
+    static Vector andNot(Vector a, Vector b)
+    {
+        return _mm256_andnot_ps(a, b);
+    }
+
+    static Vector orOf(Vector a, Vector b)
+    {
+        return _mm256_or_ps(a, b);
+    }
+
+    static Vector greater(Vector a, Vector b)
+    {
+        return _mm256_cmp_ps(a, b, _CMP_GT_OQ);
+    }
+
+    static Vector select(Vector mask, Vector a, Vector b)
+    {
+        return _mm256_blendv_ps(b, a, mask);
+    }
+
+    /*
+     * Stores one row of each lane's matrix, the four vectors hold one column each.
+     * Transposes within each 128-bit half, the low half holds lanes 0-3 and the high half lanes 4-7.
+     */
+    static void storeRow(dx::XMFLOAT4X4 *matrices, uint32_t row, Vector x, Vector y, Vector z, Vector w)
+    {
+        const __m256 xy0 = _mm256_unpacklo_ps(x, y);
+        const __m256 xy1 = _mm256_unpackhi_ps(x, y);
+        const __m256 zw0 = _mm256_unpacklo_ps(z, w);
+        const __m256 zw1 = _mm256_unpackhi_ps(z, w);
+        const __m256 r0  = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 r1  = _mm256_shuffle_ps(xy0, zw0, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 r2  = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 r3  = _mm256_shuffle_ps(xy1, zw1, _MM_SHUFFLE(3, 2, 3, 2));
+
+        _mm_storeu_ps(&matrices[0].m[row][0], _mm256_castps256_ps128(r0));
+        _mm_storeu_ps(&matrices[1].m[row][0], _mm256_castps256_ps128(r1));
+        _mm_storeu_ps(&matrices[2].m[row][0], _mm256_castps256_ps128(r2));
+        _mm_storeu_ps(&matrices[3].m[row][0], _mm256_castps256_ps128(r3));
+        _mm_storeu_ps(&matrices[4].m[row][0], _mm256_extractf128_ps(r0, 1));
+        _mm_storeu_ps(&matrices[5].m[row][0], _mm256_extractf128_ps(r1, 1));
+        _mm_storeu_ps(&matrices[6].m[row][0], _mm256_extractf128_ps(r2, 1));
+        _mm_storeu_ps(&matrices[7].m[row][0], _mm256_extractf128_ps(r3, 1));
+    }
+};
+
+/*
+ * Sine and cosine of angles in degrees, with the polynomials XMScalarSinCos uses.
+ */
+template <typename Lanes>
+void sinCos(typename Lanes::Vector degrees, typename Lanes::Vector &sin, typename Lanes::Vector &cos)
+{
+    using V = Lanes;
+
+    // -------------- wrap into [-pi, pi] --------------
+    auto x = V::mul(degrees, V::set(DegreesToRadians));
+    x      = V::sub(x, V::mul(V::round(V::mul(x, V::set(InverseTwoPi))), V::set(TwoPi)));
+
+    // -------------- fold into [-pi/2, pi/2] with sin(x) == sin(+-pi - x), where cosine changes sign --------------
+    const auto signMask  = V::set(-0.0f);
+    const auto reflected = V::sub(V::orOf(V::set(Pi), V::andOf(x, signMask)), x);
+    const auto outside   = V::greater(V::andNot(signMask, x), V::set(HalfPi));
+    const auto sign      = V::select(outside, V::set(-1.0f), V::set(1.0f));
+    x                    = V::select(outside, reflected, x);
+
+    const auto x2 = V::mul(x, x);
+
+    // -------------- 11-degree minimax approximation --------------
+    auto s = V::add(V::mul(V::set(-2.3889859e-08f), x2), V::set(2.7525562e-06f));
+    s      = V::add(V::mul(s, x2), V::set(-0.00019840874f));
+    s      = V::add(V::mul(s, x2), V::set(0.0083333310f));
+    s      = V::add(V::mul(s, x2), V::set(-0.16666667f));
+    s      = V::add(V::mul(s, x2), V::set(1.0f));
+    sin    = V::mul(s, x);
+
+    // -------------- 10-degree minimax approximation --------------
+    auto c = V::add(V::mul(V::set(-2.6051615e-07f), x2), V::set(2.4760495e-05f));
+    c      = V::add(V::mul(c, x2), V::set(-0.0013888378f));
+    c      = V::add(V::mul(c, x2), V::set(0.041666638f));
+    c      = V::add(V::mul(c, x2), V::set(-0.5f));
+    c      = V::add(V::mul(c, x2), V::set(1.0f));
+    cos    = V::mul(c, sign);
+}
+
+/*
+ * Where a kernel reads a block of transforms from, one array per component.
+ */
+struct Source
+{
+    const float *scaleX;
+    const float *scaleY;
+    const float *scaleZ;
+    const float *pitch;
+    const float *yaw;
+    const float *roll;
+    const float *translationX;
+    const float *translationY;
+    const float *translationZ;
+};
+
+/*
+ * Builds the matrices of Lanes::Width transforms, one transform per lane.
+ *
+ * @param source The components of every transform.
+ * @param first The first transform to build.
+ * @param localToWorld Filled with scale * rotation * translation, starting at first.
+ * @param worldToLocal Filled with the inverse, starting at first.
+ */
+template <typename Lanes>
+void build(const Source &source, uint32_t first, dx::XMFLOAT4X4 *localToWorld, dx::XMFLOAT4X4 *worldToLocal)
+{
+    using V = Lanes;
+
+    const auto sx = V::load(source.scaleX + first);
+    const auto sy = V::load(source.scaleY + first);
+    const auto sz = V::load(source.scaleZ + first);
+    const auto tx = V::load(source.translationX + first);
+    const auto ty = V::load(source.translationY + first);
+    const auto tz = V::load(source.translationZ + first);
+
+    typename V::Vector sp, cp, sh, ch, sr, cr;
+    sinCos<V>(V::load(source.pitch + first), sp, cp);
+    sinCos<V>(V::load(source.yaw + first), sh, ch);
+    sinCos<V>(V::load(source.roll + first), sr, cr);
+
+    // -------------- roll, then pitch, then yaw, the same as XMMatrixRotationRollPitchYaw --------------
+    const auto srsp = V::mul(sr, sp);
+    const auto crsp = V::mul(cr, sp);
+    const auto r00  = V::add(V::mul(cr, ch), V::mul(srsp, sh));
+    const auto r01  = V::mul(sr, cp);
+    const auto r02  = V::sub(V::mul(srsp, ch), V::mul(cr, sh));
+    const auto r10  = V::sub(V::mul(crsp, sh), V::mul(sr, ch));
+    const auto r11  = V::mul(cr, cp);
+    const auto r12  = V::add(V::mul(sr, sh), V::mul(crsp, ch));
+    const auto r20  = V::mul(cp, sh);
+    const auto r21  = V::sub(V::set(0.0f), sp);
+    const auto r22  = V::mul(cp, ch);
+
+    // -------------- scale * rotation * translation scales the rows and puts the translation last --------------
+    const auto zero = V::set(0.0f);
+    const auto one  = V::set(1.0f);
+    V::storeRow(localToWorld + first, 0u, V::mul(sx, r00), V::mul(sx, r01), V::mul(sx, r02), zero);
+    V::storeRow(localToWorld + first, 1u, V::mul(sy, r10), V::mul(sy, r11), V::mul(sy, r12), zero);
+    V::storeRow(localToWorld + first, 2u, V::mul(sz, r20), V::mul(sz, r21), V::mul(sz, r22), zero);
+    V::storeRow(localToWorld + first, 3u, tx, ty, tz, one);
+
+    // -------------- the inverse is translation^-1 * rotation^T * scale^-1 --------------
+    const auto ix  = V::div(one, sx);
+    const auto iy  = V::div(one, sy);
+    const auto iz  = V::div(one, sz);
+    const auto i00 = V::mul(r00, ix);
+    const auto i01 = V::mul(r10, iy);
+    const auto i02 = V::mul(r20, iz);
+    const auto i10 = V::mul(r01, ix);
+    const auto i11 = V::mul(r11, iy);
+    const auto i12 = V::mul(r21, iz);
+    const auto i20 = V::mul(r02, ix);
+    const auto i21 = V::mul(r12, iy);
+    const auto i22 = V::mul(r22, iz);
+    const auto i30 = V::sub(zero, V::add(V::add(V::mul(tx, i00), V::mul(ty, i10)), V::mul(tz, i20)));
+    const auto i31 = V::sub(zero, V::add(V::add(V::mul(tx, i01), V::mul(ty, i11)), V::mul(tz, i21)));
+    const auto i32 = V::sub(zero, V::add(V::add(V::mul(tx, i02), V::mul(ty, i12)), V::mul(tz, i22)));
+    V::storeRow(worldToLocal + first, 0u, i00, i01, i02, zero);
+    V::storeRow(worldToLocal + first, 1u, i10, i11, i12, zero);
+    V::storeRow(worldToLocal + first, 2u, i20, i21, i22, zero);
+    V::storeRow(worldToLocal + first, 3u, i30, i31, i32, one);
+}
+
+} // namespace
+
+TransformStorage::TransformStorage()
+{
+    m_kernel = IsSupported(TransformKernel::Avx) ? TransformKernel::Avx : TransformKernel::Sse;
+}
+
+Transform TransformStorage::create(uint32_t parent)
+{
+    assert(parent == NoParent || parent < m_count);
+
+    // -------------- grow a whole block at a time, the padding holds identity transforms --------------
+    if (m_count == m_scale.x.size())
+    {
+        const size_t size = m_count + BlockSize;
+        auto         grow = [size](Components &components, float value) {
+            components.x.resize(size, value);
+            components.y.resize(size, value);
+            components.z.resize(size, value);
+        };
+
+        grow(m_scale, 1.0f);
+        grow(m_rotation, 0.0f);
+        grow(m_translation, 0.0f);
+        m_changed.resize(size, 0u);
+        m_dirty.resize(size, 0u);
+        m_stamps.resize(size, 0u);
+        m_local.resize(size);
+        m_localInverse.resize(size);
+        m_world.resize(size);
+        m_worldInverse.resize(size);
+    }
+
+    const uint32_t index = m_count++;
+    m_parents.push_back(parent);
+    m_depths.push_back(parent == NoParent ? 0u : m_depths[parent] + 1u);
+    m_changed[index] = 1u;
+    m_sorted         = false;
+    markDirty(index);
+    return Transform(this, index);
+}
+
+void TransformStorage::setScale(uint32_t index, float x, float y, float z)
+{
+    m_scale.x[index] = x;
+    m_scale.y[index] = y;
+    m_scale.z[index] = z;
+    m_changed[index] = 1u;
+    markDirty(index);
+}
+
+void TransformStorage::setRotation(uint32_t index, float x, float y, float z)
+{
+    m_rotation.x[index] = x;
+    m_rotation.y[index] = y;
+    m_rotation.z[index] = z;
+    m_changed[index]    = 1u;
+    markDirty(index);
+}
+
+void TransformStorage::setTranslation(uint32_t index, float x, float y, float z)
+{
+    m_translation.x[index] = x;
+    m_translation.y[index] = y;
+    m_translation.z[index] = z;
+    m_changed[index]       = 1u;
+    markDirty(index);
+}
+
+void TransformStorage::addTranslation(uint32_t index, float x, float y, float z)
+{
+    setTranslation(index, m_translation.x[index] + x, m_translation.y[index] + y, m_translation.z[index] + z);
+}
+
+bool TransformStorage::takeChanged(uint32_t index)
+{
+    const bool changed = m_changed[index] != 0u;
+    m_changed[index]   = 0u;
+    return changed;
+}
+
+void TransformStorage::invalidate()
+{
+    std::fill_n(m_changed.begin(), m_count, uint8_t(1u));
+    std::fill_n(m_dirty.begin(), m_count, uint8_t(1u));
+    m_dirtyCount = m_count;
+}
+
+void TransformStorage::update()
+{
+    if (m_dirtyCount == 0u)
+    {
+        return;
+    }
+
+    if (!m_sorted)
+    {
+        sortByDepth();
+    }
+
+    // -------------- local matrices, a block's dirty flags are read as one word to skip clean blocks --------------
+    m_updateIndex++;
+    for (uint32_t first = 0; first < m_count && m_dirtyCount > 0u; first += BlockSize)
+    {
+        uint64_t dirty;
+        memcpy(&dirty, &m_dirty[first], sizeof(dirty));
+        if (dirty == 0u)
+        {
+            continue;
+        }
+
+        buildBlock(first);
+        for (uint32_t i = first; i < first + BlockSize; i++)
+        {
+            m_stamps[i] = m_dirty[i] ? m_updateIndex : m_stamps[i];
+        }
+
+        // every flag is 0 or 1, so the bits set are the transforms that were dirty
+        m_dirtyCount -= std::popcount(dirty);
+        memset(&m_dirty[first], 0, BlockSize);
+    }
+
+    // -------------- world matrices, one level at a time below the roots --------------
+    for (size_t level = 1; level + 1 < m_levels.size(); level++)
+    {
+        const uint32_t begin = m_levels[level];
+        const uint32_t end   = m_levels[level + 1];
+        if (end - begin < ParallelThreshold)
+        {
+            propagate(begin, end);
+            continue;
+        }
+
+        auto propagateBatch = [this, begin](uint32_t first, uint32_t last) {
+            propagate(begin + first, begin + last);
+        };
+        core::JobSystem::get().parallelFor(end - begin, ParallelGrainSize, propagateBatch);
+    }
+}
+
+void TransformStorage::computeLocals(uint32_t first, uint32_t count)
+{
+    const uint32_t end = std::min(first + count, m_count);
+    for (uint32_t block = first - first % BlockSize; block < end; block += BlockSize)
+    {
+        buildBlock(block);
+    }
+}
+
+void TransformStorage::setKernel(TransformKernel kernel)
+{
+    assert(IsSupported(kernel));
+    m_kernel = kernel;
+}
+
+dx::XMFLOAT3 TransformStorage::getScale(uint32_t index) const
+{
+    return {m_scale.x[index], m_scale.y[index], m_scale.z[index]};
+}
+
+dx::XMFLOAT3 TransformStorage::getRotation(uint32_t index) const
+{
+    return {m_rotation.x[index], m_rotation.y[index], m_rotation.z[index]};
+}
+
+dx::XMFLOAT3 TransformStorage::getTranslation(uint32_t index) const
+{
+    return {m_translation.x[index], m_translation.y[index], m_translation.z[index]};
+}
+
+dx::XMMATRIX TransformStorage::getLocalToWorld(uint32_t index) const
+{
+    return XMLoadFloat4x4(m_parents[index] == NoParent ? &m_local[index] : &m_world[index]);
+}
+
+dx::XMMATRIX TransformStorage::getWorldToLocal(uint32_t index) const
+{
+    return XMLoadFloat4x4(m_parents[index] == NoParent ? &m_localInverse[index] : &m_worldInverse[index]);
+}
+
+uint32_t TransformStorage::getParent(uint32_t index) const
+{
+    return m_parents[index];
+}
+
+uint32_t TransformStorage::getDepth(uint32_t index) const
+{
+    return m_depths[index];
+}
+
+TransformKernel TransformStorage::getKernel() const
+{
+    return m_kernel;
+}
+
+uint32_t TransformStorage::getCount() const
+{
+    return m_count;
+}
+
+bool TransformStorage::IsSupported(TransformKernel kernel)
+{
+    return kernel == TransformKernel::Sse || core::CpuFeatures::hasAvx();
+}
+
+void TransformStorage::buildBlock(uint32_t first)
+{
+    const Source source = {
+        .scaleX       = m_scale.x.data(),
+        .scaleY       = m_scale.y.data(),
+        .scaleZ       = m_scale.z.data(),
+        .pitch        = m_rotation.x.data(),
+        .yaw          = m_rotation.y.data(),
+        .roll         = m_rotation.z.data(),
+        .translationX = m_translation.x.data(),
+        .translationY = m_translation.y.data(),
+        .translationZ = m_translation.z.data(),
+    };
+
+    if (m_kernel == TransformKernel::Avx)
+    {
+        build<Avx>(source, first, m_local.data(), m_localInverse.data());
+        _mm256_zeroupper();
+    }
+    else
+    {
+        build<Sse>(source, first, m_local.data(), m_localInverse.data());
+        build<Sse>(source, first + Sse::Width, m_local.data(), m_localInverse.data());
+    }
+}
+
+void TransformStorage::propagate(uint32_t begin, uint32_t end)
+{
+    for (uint32_t i = begin; i < end; i++)
+    {
+        // -------------- skip nodes where neither the local matrix nor the parent moved --------------
+        const Node &node = m_nodes[i];
+        if (m_stamps[node.index] != m_updateIndex && m_stamps[node.parent] != m_updateIndex)
+        {
+            continue;
+        }
+
+        // -------------- local * parent, and its inverse parent^-1 * local^-1 --------------
+        const dx::XMMATRIX local        = XMLoadFloat4x4(&m_local[node.index]);
+        const dx::XMMATRIX localInverse = XMLoadFloat4x4(&m_localInverse[node.index]);
+        XMStoreFloat4x4(&m_world[node.index], dx::XMMatrixMultiply(local, getLocalToWorld(node.parent)));
+        XMStoreFloat4x4(&m_worldInverse[node.index], dx::XMMatrixMultiply(getWorldToLocal(node.parent), localInverse));
+
+        m_stamps[node.index]  = m_updateIndex;
+        m_changed[node.index] = 1u;
+    }
+}
+
+void TransformStorage::sortByDepth()
+{
+    // -------------- count the nodes on every level, then where every level starts --------------
+    const uint32_t levelCount = m_count > 0u ? *std::max_element(m_depths.begin(), m_depths.end()) + 1u : 0u;
+    m_levels.assign(levelCount + 1u, 0u);
+    for (uint32_t depth : m_depths)
+    {
+        m_levels[depth + 1u]++;
+    }
+
+    for (uint32_t level = 0; level < levelCount; level++)
+    {
+        m_levels[level + 1u] += m_levels[level];
+    }
+
+    // -------------- place every node after the others on its level, keeping index order within a level --------------
+    std::vector<uint32_t> next(m_levels.begin(), m_levels.end() - 1);
+    m_nodes.resize(m_count);
+    for (uint32_t i = 0; i < m_count; i++)
+    {
+        m_nodes[next[m_depths[i]]++] = {.index = i, .parent = m_parents[i]};
+    }
+
+    m_sorted = true;
+}
+
+void TransformStorage::markDirty(uint32_t index)
+{
+    if (m_dirty[index] == 0u)
+    {
+        m_dirty[index] = 1u;
+        m_dirtyCount++;
+    }
+}
+
+} // namespace bisky::gfx
\ No newline at end of file
@@ -0,0 +1,123 @@
+#include "Common.hpp"
+
+#include "Graphics/Buffer.hpp"
+#include "Graphics/CommandQueue.hpp"
+#include "Graphics/Device.hpp"
+#include "Graphics/GraphicsCommandList.hpp"
+#include "Graphics/UploadManager.hpp"
+
+namespace bisky::gfx
+{
+
+UploadManager::UploadManager(Device *const device, uint64_t capacity)
+    : m_queue(device->getDirectCommandQueue()), m_ring(capacity)
+{
+    m_buffer = device->createUploadBuffer(static_cast<uint32_t>(capacity));
+
+    // upload heaps can stay mapped for as long as the buffer lives
+    m_buffer->resource->Map(0, nullptr, reinterpret_cast<void **>(&m_cpuBase));
+}
+
+UploadManager::~UploadManager()
+{
+    m_queue->flush();
+    retire();
+
+    m_buffer->resource->Unmap(0, nullptr);
+    m_buffer.reset();
+}
+
+bool UploadManager::allocate(uint64_t size, uint64_t alignment, StagingAllocation &allocation)
+{
+    m_frameBytes += size;
+
+    StagingRegion region;
+    bool          allocated = m_ring.allocate(size, alignment, region);
+    while (!allocated)
+    {
+        retire();
+        allocated = m_ring.allocate(size, alignment, region);
+
+        // -------------- wait for the oldest submission if there's still no room --------------
+        const uint64_t fenceValue = m_ring.getOldestFenceValue();
+        if (allocated || fenceValue == 0u)
+        {
+            break;
+        }
+
+        m_queue->waitForFence(fenceValue);
+    }
+
+    if (!allocated)
+    {
+        return false;
+    }
+
+    allocation = {
+        .buffer     = m_buffer.get(),
+        .cpuAddress = m_cpuBase + region.offset,
+        .offset     = region.offset,
+        .sequence   = region.sequence,
+    };
+    return true;
+}
+
+void UploadManager::submit(std::span<const uint64_t> sequences, uint64_t fenceValue)
+{
+    for (uint64_t sequence : sequences)
+    {
+        m_ring.submit(sequence, fenceValue);
+    }
+}
+
+void UploadManager::cancel(std::span<const uint64_t> sequences)
+{
+    for (uint64_t sequence : sequences)
+    {
+        m_ring.cancel(sequence);
+    }
+}
+
+void UploadManager::release(std::unique_ptr<Buffer> buffer, uint64_t fenceValue)
+{
+    m_pendingReleases.push_back({.fenceValue = fenceValue, .buffer = std::move(buffer), .commandList = nullptr});
+}
+
+void UploadManager::release(std::unique_ptr<GraphicsCommandList> commandList, uint64_t fenceValue)
+{
+    m_pendingReleases.push_back({.fenceValue = fenceValue, .buffer = nullptr, .commandList = std::move(commandList)});
+}
+
+void UploadManager::beginFrame()
+{
+    retire();
+    m_frameBytes = 0u;
+}
+
+uint64_t UploadManager::getUsedBytes() const
+{
+    return m_ring.getUsedBytes();
+}
+
+uint64_t UploadManager::getCapacity() const
+{
+    return m_ring.getCapacity();
+}
+
+uint64_t UploadManager::getFrameBytes() const
+{
+    return m_frameBytes;
+}
+
+void UploadManager::retire()
+{
+    const uint64_t completedValue = m_queue->getCompletedValue();
+
+    m_ring.retire(completedValue);
+    while (!m_pendingReleases.empty() && m_pendingReleases.front().fenceValue <= completedValue)
+    {
+        m_pendingReleases.pop_front();
+    }
+}
+
+} // namespace bisky::gfx
\ No newline at end of file
@@ -13,7 +13,7 @@ namespace bisky::renderer
 
 FinalRenderPass::FinalRenderPass(gfx::Device *const device) : m_device(device)
 {
-    m_screenQuad = std::make_unique<scene::RenderObject>();
+    m_screenQuad = std::make_unique<scene::MeshInstance>();
 
     core::ResourceManager::get().addMesh(scene::ScreenQuad::mesh(device));
     m_screenQuad->mesh = core::ResourceManager::get().getMesh("ScreenQuad");
@@ -46,19 +46,15 @@ void FinalRenderPass::draw(gfx::FrameResource *const frameResource, core::FrameS
     // -------------- bind root signature --------------
     cmdList->setRootSignature(m_device->getRootSignature("finalRenderPass"));
 
-    // -------------- allocate constants --------------
-    gfx::Allocation allocation = frameResource->resourceAllocator->allocate(sizeof(FinalRenderPass::RenderResource));
-    FinalRenderPass::RenderResource *resource = (FinalRenderPass::RenderResource *)allocation.cpuBase;
-    resource->vertexBufferIndex               = gfx::Buffer::GetSrvIndex(m_screenQuad->mesh->vertexBuffer.get());
-    resource->textureIndex                    = gfx::Texture::GetSrvIndex(m_device->getHdrRenderTargetBuffer());
-    cmdList->set32BitConstants(0, 2u, (void *)resource);
+    // -------------- set constants --------------
+    FinalRenderPass::RenderResource resource = {
+        .vertexBufferIndex = mesh->vertexSrv.index,
+        .textureIndex      = gfx::Texture::GetSrvIndex(m_device->getHdrRenderTargetBuffer()),
+    };
+    cmdList->set32BitConstants(0, 2u, (void *)&resource);
 
     // -------------- input assembly --------------
-    cmdList->setIndexBuffer({
-        .bufferLocation = mesh->indexBuffer->resource->GetGPUVirtualAddress(),
-        .sizeInBytes    = mesh->indexBufferByteSize,
-        .format         = mesh->indexFormat,
-    });
+    cmdList->setIndexBuffer(m_device->getGeometryPool()->getIndexBufferView(mesh->indexFormat));
     cmdList->setPrimitiveTopology(m_screenQuad->primitiveTopology);
 
     // -------------- draw --------------
@@ -1,19 +1,34 @@
 #include "Common.hpp"
 
 #include "Core/FrameStats.hpp"
+#include "Core/ModelCooker.hpp"
 #include "Graphics/Constants.hpp"
 #include "Graphics/Device.hpp"
 #include "Graphics/ShaderCompiler.hpp"
 #include "Graphics/Window.hpp"
 #include "Renderer/ForwardRenderer.hpp"
+#include "Scene/FrustumCuller.hpp"
+#include "Scene/LodSelector.hpp"
 #include "Scene/Material.hpp"
+#include "Scene/MeshletCuller.hpp"
 #include "Scene/Scene.hpp"
 
 namespace bisky::renderer
 {
 
-ForwardRenderer::ForwardRenderer(gfx::Window *const window, gfx::Device *const backend) : m_backend(backend)
+static_assert(std::size(core::FrameStats{}.lodObjectCounts) >= core::ModelCooker::MaxLodCount);
+
+constexpr uint32_t RenderResourceConstantCount = sizeof(gfx::RenderResource) / sizeof(uint32_t);
+
+ForwardRenderer::ForwardRenderer(gfx::Window *const window, gfx::Device *const backend)
+    : m_backend(backend), m_lodErrorThreshold(1.0f), m_meshletCulling(true), m_frustumCulling(true),
+      m_cullKernel(scene::CullKernel::Sse)
 {
+    if (scene::FrustumCuller::isSupported(scene::CullKernel::Avx))
+    {
+        m_cullKernel = scene::CullKernel::Avx;
+    }
+
     initRootSignatures();
     initPipelineStateObjects();
 
@@ -29,9 +44,15 @@ void ForwardRenderer::draw(
     core::FrameStats *const frameStats
 )
 {
-    frameStats->drawCount     = 0;
-    frameStats->triangleCount = 0;
-    auto start                = std::chrono::system_clock::now();
+    frameStats->drawCount          = 0;
+    frameStats->triangleCount      = 0;
+    frameStats->lodTriangleSavings = 0;
+    frameStats->meshletCount       = 0;
+    frameStats->meshletsCulled     = 0;
+    frameStats->objectsVisible     = 0;
+    frameStats->objectsCulled      = 0;
+    std::ranges::fill(frameStats->lodObjectCounts, 0u);
+    auto start = std::chrono::system_clock::now();
 
     // -------------- grab the graphics command list --------------
     auto cmdList       = frameResource->graphicsCommandList.get();
@@ -69,83 +90,248 @@ void ForwardRenderer::draw(
     // -------------- bind root signature --------------
     cmdList->setRootSignature(m_backend->getRootSignature("opaque"));
 
-    // -------------- allocate scene buffer --------------
-    auto             *camera      = scene->getArcballCamera();
-    gfx::Allocation   sceneAlloc  = frameResource->resourceAllocator->allocate(sizeof(gfx::SceneBuffer));
-    gfx::SceneBuffer *sceneBuffer = reinterpret_cast<gfx::SceneBuffer *>(sceneAlloc.cpuBase);
-    XMStoreFloat4x4(&sceneBuffer->view, camera->getView());
-    XMStoreFloat4x4(&sceneBuffer->projection, camera->getProjection());
-    XMStoreFloat4x4(&sceneBuffer->viewProjection, camera->getView() * camera->getProjection());
-    XMStoreFloat4(&sceneBuffer->viewPosition, camera->getPosition());
+    // -------------- build the scene buffer and stream it out --------------
+    auto            *camera     = scene->getArcballCamera();
+    gfx::Allocation  sceneAlloc = frameResource->resourceAllocator->allocate(sizeof(gfx::SceneBuffer));
+    gfx::SceneBuffer sceneBuffer;
+    XMStoreFloat4x4(&sceneBuffer.view, camera->getView());
+    XMStoreFloat4x4(&sceneBuffer.projection, camera->getProjection());
+    XMStoreFloat4x4(&sceneBuffer.viewProjection, camera->getView() * camera->getProjection());
+    XMStoreFloat4(&sceneBuffer.viewPosition, camera->getPosition());
+    sceneAlloc.write(sceneBuffer);
     cmdList->setConstantBufferView(0u, sceneAlloc.gpuBase);
 
-    // -------------- allocate lights --------------
-    auto             &lights      = scene->getLights();
-    gfx::Allocation   alloc       = frameResource->resourceAllocator->allocate(sizeof(gfx::LightBuffer));
-    gfx::LightBuffer *lightBuffer = reinterpret_cast<gfx::LightBuffer *>(alloc.cpuBase);
-    for (size_t i = 0; i < lights.size(); i++)
+    // -------------- and the lights --------------
+    auto            &lights = scene->getLights();
+    gfx::Allocation  alloc  = frameResource->resourceAllocator->allocate(sizeof(gfx::LightBuffer));
+    gfx::LightBuffer lightBuffer{};
+    lightBuffer.numLights = static_cast<uint32_t>(std::min<size_t>(lights.size(), std::size(lightBuffer.lights)));
+    for (uint32_t i = 0; i < lightBuffer.numLights; i++)
     {
-        lightBuffer->lights[i] = lights[i];
+        lightBuffer.lights[i] = lights[i];
     }
-    lightBuffer->numLights = static_cast<uint32_t>(min(lights.size(), 10));
+    alloc.write(lightBuffer);
     cmdList->setConstantBufferView(1u, alloc.gpuBase);
 
-    for (auto &object : scene->getRenderObjects())
+    const float projectionScale = scene::LodSelector::getProjectionScale(camera->getFovY(), camera->getHeight());
+    const auto  frustum         = scene::MeshletCuller::getFrustum(camera->getView() * camera->getProjection());
+    const auto  eye             = camera->getPosition();
+
+    // -------------- every entity's constants live in one packed structured buffer per frame resource --------------
+    scene::EntityRegistry *entities    = scene->getEntities();
+    const uint32_t         objectCount =
+        entities->count<gfx::Transform, scene::MeshInstance, scene::Bounds, scene::RenderFlags>();
+    ObjectConstants       &constants   = m_objectConstants[m_backend->getCurrentFrameResourceIndex()];
+    uint32_t               objectIndex = 0u;
+    frameStats->objectBytes            = 0u;
+
+    // entities are visited in the same order until one is created, destroyed or moved, so their slots stay put
+    const bool resized    = reserveObjectConstants(constants, objectCount);
+    const bool rewriteAll = resized || constants.version != entities->getVersion();
+    constants.version     = entities->getVersion();
+    if (constants.buffer)
     {
-        auto *mesh = object->mesh;
-
-        // -------------- input assembly --------------
-        cmdList->setIndexBuffer({
-            .bufferLocation = mesh->indexBuffer->resource->GetGPUVirtualAddress(),
-            .sizeInBytes    = mesh->indexBufferByteSize,
-            .format         = mesh->indexFormat,
-        });
-        cmdList->setPrimitiveTopology(object->primitiveTopology);
-
-        // -------------- allocate render resource --------------
-        gfx::Allocation      alloc = frameResource->resourceAllocator->allocate(sizeof(gfx::RenderResource));
-        gfx::RenderResource *rr    = (gfx::RenderResource *)alloc.cpuBase;
-        rr->vertexBufferIndex      = gfx::Buffer::GetSrvIndex(mesh->vertexBuffer.get());
-        rr->sceneBufferIndex       = -1;
-
-        // -------------- allocate object constants --------------
-        gfx::Allocation    objectAlloc = frameResource->resourceAllocator->allocate(sizeof(gfx::ObjectBuffer));
-        gfx::ObjectBuffer *ptr         = (gfx::ObjectBuffer *)objectAlloc.cpuBase;
-        XMStoreFloat4x4(&ptr->world, object->transform->getLocalToWorld());
-        XMStoreFloat4x4(&ptr->inverseWorld, dx::XMMatrixInverse(nullptr, object->transform->getLocalToWorld()));
-        XMStoreFloat4x4(&ptr->transposeInverseWorld, dx::XMMatrixTranspose(XMLoadFloat4x4(&ptr->inverseWorld)));
-        cmdList->setConstantBufferView(2u, objectAlloc.gpuBase);
-
-        for (auto &submesh : mesh->submeshes)
-        {
-            // ------------- finish setting 32-bit constants -------------
-            rr->diffuseTextureIndex           = gfx::Texture::GetSrvIndex(submesh.material->diffuseTexture);
-            rr->metallicRoughnessTextureIndex = gfx::Texture::GetSrvIndex(submesh.material->metallicRoughnessTexture);
-            rr->normalTextureIndex            = gfx::Texture::GetSrvIndex(submesh.material->normalTexture);
-            cmdList->set32BitConstants(3u, 5u, reinterpret_cast<void *>(rr));
-
-            // -------------- draw submesh --------------
-            cmdList->drawIndexedInstanced(submesh);
-            frameStats->drawCount++;
-            frameStats->triangleCount += submesh.indexCount / 3u;
-        }
+        cmdList->setShaderResourceView(2u, constants.buffer->getGpuAddress());
     }
 
+    // every mesh shares the geometry pool's index buffers, so they're only bound when the index format changes
+    const gfx::GeometryPool *geometryPool     = m_backend->getGeometryPool();
+    DXGI_FORMAT              boundIndexFormat = DXGI_FORMAT_UNKNOWN;
+
+    entities->forEach<const gfx::Transform, const scene::MeshInstance, const scene::Bounds, scene::RenderFlags>(
+        [&](const scene::Entity *, uint32_t count, const gfx::Transform *transforms,
+            const scene::MeshInstance *instances, const scene::Bounds *bounds, scene::RenderFlags *flags) {
+            // -------------- cull the whole chunk before recording any of it, 4 or 8 entities at a time --------------
+            m_visibility.resize(count);
+            if (m_frustumCulling)
+            {
+                scene::FrustumCuller::cull(frustum, bounds, count, m_visibility.data(), m_cullKernel);
+            }
+            else
+            {
+                std::ranges::fill(m_visibility, uint8_t(1u));
+            }
+
+            for (uint32_t row = 0; row < count; row++)
+            {
+                auto                 *mesh      = instances[row].mesh;
+                const gfx::Transform &transform = transforms[row];
+                scene::RenderFlags   &flag      = flags[row];
+                const dx::XMMATRIX    world     = transform.getLocalToWorld();
+
+                // -------------- root constants, the entity's index picks out its constants --------------
+                gfx::RenderResource rr = {
+                    .vertexBufferIndex = mesh->vertexSrv.index,
+                    .sceneBufferIndex  = -1,
+                    .objectIndex       = objectIndex++,
+                };
+
+                // -------------- entities that haven't moved still have their constants from last time --------------
+                if (rewriteAll || flag.numFramesDirty > 0u)
+                {
+                    gfx::ObjectBuffer objectBuffer;
+                    XMStoreFloat4x4(&objectBuffer.world, world);
+                    XMStoreFloat4x4(&objectBuffer.transposeInverseWorld, transform.getNormalMatrix());
+                    objectBuffer.positionMin   = mesh->quantization.min;
+                    objectBuffer.positionScale = mesh->quantization.scale;
+                    objectBuffer.vertexFormat  = static_cast<uint32_t>(mesh->vertexFormat);
+                    objectBuffer.padding       = 0.0f;
+
+                    constants.buffer->write(rr.objectIndex, objectBuffer);
+
+                    flag.numFramesDirty      = flag.numFramesDirty > 0u ? flag.numFramesDirty - 1u : 0u;
+                    frameStats->objectBytes += sizeof(gfx::ObjectBuffer);
+                }
+
+                if (!flag.visible)
+                {
+                    continue;
+                }
+
+                // -------------- culled entities still get their constants, they may be back next frame --------------
+                if (m_visibility[row] == 0u)
+                {
+                    frameStats->objectsCulled++;
+                    continue;
+                }
+                frameStats->objectsVisible++;
+
+                // -------------- pick the level of detail --------------
+                const uint32_t lod =
+                    scene::LodSelector::select(*mesh, world, eye, projectionScale, m_lodErrorThreshold);
+                frameStats->lodObjectCounts[lod]++;
+
+                // -------------- move the frustum into the entity's space for meshlet culling --------------
+                const scene::MeshletCullData cullData =
+                    scene::MeshletCuller::prepare(frustum, world, transform.getWorldToLocal(), eye);
+
+                // -------------- input assembly --------------
+                if (mesh->indexFormat != boundIndexFormat)
+                {
+                    cmdList->setIndexBuffer(geometryPool->getIndexBufferView(mesh->indexFormat));
+                    boundIndexFormat = mesh->indexFormat;
+                }
+                cmdList->setPrimitiveTopology(instances[row].primitiveTopology);
+
+                auto &submeshes = scene::LodSelector::getSubmeshes(*mesh, lod);
+                for (size_t i = 0; i < submeshes.size(); i++)
+                {
+                    auto &submesh = submeshes[i];
+
+                    // ------------- finish setting 32-bit constants -------------
+                    const scene::Material *material  = submesh.material;
+                    rr.diffuseTextureIndex           = gfx::Texture::GetSrvIndex(material->diffuseTexture);
+                    rr.metallicRoughnessTextureIndex = gfx::Texture::GetSrvIndex(material->metallicRoughnessTexture);
+                    rr.normalTextureIndex            = gfx::Texture::GetSrvIndex(material->normalTexture);
+                    cmdList->set32BitConstants(3u, RenderResourceConstantCount, reinterpret_cast<void *>(&rr));
+
+                    frameStats->lodTriangleSavings += (mesh->submeshes[i].indexCount - submesh.indexCount) / 3u;
+
+                    // -------------- draw submesh --------------
+                    if (!m_meshletCulling || submesh.meshletCount == 0u)
+                    {
+                        cmdList->drawIndexedInstanced(submesh);
+                        frameStats->drawCount++;
+                        frameStats->triangleCount += submesh.indexCount / 3u;
+                        continue;
+                    }
+
+                    // -------------- or only its visible meshlets, neighbouring meshlets share a draw --------------
+                    scene::Submesh range = submesh;
+                    range.indexCount     = 0u;
+                    auto drawRange       = [&]() {
+                        if (range.indexCount == 0u)
+                            return;
+
+                        cmdList->drawIndexedInstanced(range);
+                        frameStats->drawCount++;
+                        frameStats->triangleCount += range.indexCount / 3u;
+                        range.indexCount = 0u;
+                    };
+
+                    for (uint32_t m = 0; m < submesh.meshletCount; m++)
+                    {
+                        auto &meshlet = mesh->meshlets[submesh.firstMeshlet + m];
+                        if (!scene::MeshletCuller::isVisible(meshlet, cullData))
+                        {
+                            drawRange();
+                            frameStats->meshletsCulled++;
+                            continue;
+                        }
+
+                        if (range.indexCount == 0u)
+                            range.startIndexLocation = submesh.startIndexLocation + meshlet.startIndexLocation;
+
+                        range.indexCount += meshlet.indexCount;
+                    }
+
+                    drawRange();
+                    frameStats->meshletCount += submesh.meshletCount;
+                }
+            }
+        }
+    );
+
     // -------------- calculate mesh draw time --------------
     auto end                 = std::chrono::system_clock::now();
     auto elapsed             = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
     frameStats->meshDrawTime = elapsed.count() / 1000.0f;
 }
 
+void ForwardRenderer::setLodErrorThreshold(float threshold)
+{
+    m_lodErrorThreshold = threshold;
+}
+
+float ForwardRenderer::getLodErrorThreshold() const
+{
+    return m_lodErrorThreshold;
+}
+
+void ForwardRenderer::setMeshletCulling(bool enabled)
+{
+    m_meshletCulling = enabled;
+}
+
+bool ForwardRenderer::getMeshletCulling() const
+{
+    return m_meshletCulling;
+}
+
+void ForwardRenderer::setFrustumCulling(bool enabled)
+{
+    m_frustumCulling = enabled;
+}
+
+bool ForwardRenderer::getFrustumCulling() const
+{
+    return m_frustumCulling;
+}
+
+bool ForwardRenderer::reserveObjectConstants(ObjectConstants &constants, uint32_t objectCount)
+{
+    if (objectCount <= constants.capacity)
+    {
+        return false;
+    }
+
+    // -------------- the frame resource is no longer in flight, so the old buffer can go right away --------------
+    constants.capacity = std::max(objectCount, constants.capacity * 2u);
+    constants.buffer   = std::make_unique<gfx::PersistentBuffer>(
+        m_backend, constants.capacity * static_cast<uint32_t>(sizeof(gfx::ObjectBuffer))
+    );
+    return true;
+}
+
 void ForwardRenderer::initRootSignatures()
 {
     gfx::RootParameters parameters{};
     parameters.addDescriptor(0u, D3D12_ROOT_PARAMETER_TYPE_CBV);
     parameters.addDescriptor(1u, D3D12_ROOT_PARAMETER_TYPE_CBV);
-    parameters.addDescriptor(2u, D3D12_ROOT_PARAMETER_TYPE_CBV);
-    parameters.add32BitConstants(3u, 5u);
+    parameters.addDescriptor(0u, D3D12_ROOT_PARAMETER_TYPE_SRV);
+    parameters.add32BitConstants(3u, RenderResourceConstantCount);
     parameters.addStaticSampler({
-        .Filter           = D3D12_FILTER_MIN_MAG_POINT_MIP_LINEAR,
+        .Filter           = D3D12_FILTER_MIN_MAG_MIP_LINEAR,
         .AddressU         = D3D12_TEXTURE_ADDRESS_MODE_WRAP,
         .AddressV         = D3D12_TEXTURE_ADDRESS_MODE_WRAP,
         .AddressW         = D3D12_TEXTURE_ADDRESS_MODE_WRAP,
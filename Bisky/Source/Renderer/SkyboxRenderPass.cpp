@@ -11,10 +11,10 @@ namespace bisky::renderer
 
 SkyboxRenderPass::SkyboxRenderPass(gfx::Device *const device) : m_device(device)
 {
-    core::ResourceManager::get().loadMesh(device, "Cube\\Cube.gltf");
+    // the skybox shader reads full vertices
+    core::ResourceManager::get().loadMesh(device, "Cube\\Cube.gltf", scene::VertexFormat::Full);
 
-    m_cube       = std::make_unique<scene::RenderObject>();
-    m_cube->name = "skybox";
+    m_cube       = std::make_unique<scene::MeshInstance>();
     m_cube->mesh = core::ResourceManager::get().getMesh("Cube");
 
     initRootSignature();
@@ -38,28 +38,23 @@ void SkyboxRenderPass::draw(
         cmdList->setPipelineState(m_device->getPipelineState("skyboxRenderPass"));
         cmdList->setRootSignature(m_device->getRootSignature("skyboxRenderPass"));
 
-        gfx::Allocation renderResourceAlloc =
-            frameResource->resourceAllocator->allocate(sizeof(SkyboxRenderPass::RenderResource));
-        SkyboxRenderPass::RenderResource *renderResource =
-            (SkyboxRenderPass::RenderResource *)renderResourceAlloc.cpuBase;
-        renderResource->vertexBufferIndex = gfx::Buffer::GetSrvIndex(m_cube->mesh->vertexBuffer.get());
-        renderResource->textureIndex      = gfx::Texture::GetSrvIndex(skybox->getTexture());
-        cmdList->set32BitConstants(1u, 2u, renderResource);
+        SkyboxRenderPass::RenderResource renderResource = {
+            .vertexBufferIndex = m_cube->mesh->vertexSrv.index,
+            .textureIndex      = gfx::Texture::GetSrvIndex(skybox->getTexture()),
+        };
+        cmdList->set32BitConstants(1u, 2u, &renderResource);
 
-        cmdList->setIndexBuffer({
-            .bufferLocation = m_cube->mesh->indexBuffer->resource->GetGPUVirtualAddress(),
-            .sizeInBytes    = m_cube->mesh->indexBufferByteSize,
-            .format         = m_cube->mesh->indexFormat,
-        });
+        cmdList->setIndexBuffer(m_device->getGeometryPool()->getIndexBufferView(m_cube->mesh->indexFormat));
         cmdList->setPrimitiveTopology(m_cube->primitiveTopology);
 
         // TODO: Figure out how to reuse these constants
-        gfx::Allocation   sceneBufferAlloc = frameResource->resourceAllocator->allocate(sizeof(gfx::SceneBuffer));
-        gfx::SceneBuffer *sceneBuffer      = (gfx::SceneBuffer *)sceneBufferAlloc.cpuBase;
-        XMStoreFloat4x4(&sceneBuffer->view, camera->getView());
-        XMStoreFloat4x4(&sceneBuffer->projection, camera->getProjection());
-        XMStoreFloat4x4(&sceneBuffer->viewProjection, camera->getView() * camera->getProjection());
-        XMStoreFloat4(&sceneBuffer->viewPosition, camera->getPosition());
+        gfx::Allocation  sceneBufferAlloc = frameResource->resourceAllocator->allocate(sizeof(gfx::SceneBuffer));
+        gfx::SceneBuffer sceneBuffer;
+        XMStoreFloat4x4(&sceneBuffer.view, camera->getView());
+        XMStoreFloat4x4(&sceneBuffer.projection, camera->getProjection());
+        XMStoreFloat4x4(&sceneBuffer.viewProjection, camera->getView() * camera->getProjection());
+        XMStoreFloat4(&sceneBuffer.viewPosition, camera->getPosition());
+        sceneBufferAlloc.write(sceneBuffer);
         cmdList->setConstantBufferView(0u, sceneBufferAlloc.gpuBase);
 
         for (auto &submesh : m_cube->mesh->submeshes)
@@ -133,4 +133,14 @@ XMVECTOR ArcballCamera::getPosition() const
     return XMVector4Transform(XMVectorSet(0.0f, 0.0f, 0.0f, 1.0f), XMLoadFloat4x4(&m_inverseView));
 }
 
+float ArcballCamera::getFovY() const
+{
+    return XMConvertToRadians(m_fov);
+}
+
+uint32_t ArcballCamera::getHeight() const
+{
+    return m_height;
+}
+
 } // namespace bisky::scene
\ No newline at end of file
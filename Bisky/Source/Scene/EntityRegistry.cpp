@@ -0,0 +1,273 @@
+#include "Scene/EntityRegistry.hpp"
+
+#include <atomic>
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+namespace bisky::scene
+{
+
+namespace
+{
+
+// the size of every registered component, by component index
+std::array<uint32_t, EntityRegistry::MaxComponents> g_componentSizes = {};
+std::atomic<uint32_t>                               g_componentCount = 0u;
+
+uint32_t alignUp(uint32_t value, uint32_t alignment)
+{
+    return (value + alignment - 1u) & ~(alignment - 1u);
+}
+
+/*
+ * Calls a function with the index of every component in a mask.
+ */
+template <typename Function> void forEachComponent(ComponentMask mask, Function &&function)
+{
+    for (; mask != 0u; mask &= mask - 1u)
+    {
+        function(static_cast<uint32_t>(std::countr_zero(mask)));
+    }
+}
+
+} // namespace
+
+EntityRegistry::EntityRegistry()
+{
+}
+
+void EntityRegistry::destroy(Entity entity)
+{
+    if (!isAlive(entity))
+    {
+        return;
+    }
+
+    // -------------- bump the generation so every handle to the entity stops matching --------------
+    Slot &slot = m_slots[entity.index];
+    removeRow(slot);
+    slot.generation = slot.generation == UINT32_MAX ? 1u : slot.generation + 1u;
+    m_freeSlots.push_back(entity.index);
+    m_count--;
+    m_version++;
+}
+
+bool EntityRegistry::isAlive(Entity entity) const
+{
+    return entity.index < m_slots.size() && entity.generation != 0u &&
+           m_slots[entity.index].generation == entity.generation;
+}
+
+uint64_t EntityRegistry::getVersion() const
+{
+    return m_version;
+}
+
+uint32_t EntityRegistry::getCount() const
+{
+    return m_count;
+}
+
+uint32_t EntityRegistry::getArchetypeCount() const
+{
+    return static_cast<uint32_t>(m_archetypes.size());
+}
+
+uint32_t EntityRegistry::getChunkCount() const
+{
+    size_t chunkCount = 0u;
+    for (auto &archetype : m_archetypes)
+    {
+        chunkCount += archetype->chunks.size();
+    }
+    return static_cast<uint32_t>(chunkCount);
+}
+
+Entity EntityRegistry::allocate(ComponentMask mask)
+{
+    // -------------- reuse a free slot, its generation was bumped when it was freed --------------
+    uint32_t index = static_cast<uint32_t>(m_slots.size());
+    if (!m_freeSlots.empty())
+    {
+        index = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    }
+    else
+    {
+        m_slots.emplace_back();
+    }
+
+    Entity entity = {.index = index, .generation = m_slots[index].generation};
+    pushRow(findArchetype(mask), entity, m_slots[index]);
+    m_count++;
+    m_version++;
+    return entity;
+}
+
+void EntityRegistry::setMask(Entity entity, ComponentMask mask)
+{
+    const Slot from = m_slots[entity.index];
+    if (m_archetypes[from.archetype]->mask == mask)
+    {
+        return;
+    }
+
+    // -------------- append the entity to its new archetype and copy the components both have --------------
+    const uint32_t archetypeIndex = findArchetype(mask);
+    Slot           to             = from;
+    pushRow(archetypeIndex, entity, to);
+
+    const Archetype &source      = *m_archetypes[from.archetype];
+    const Archetype &destination = *m_archetypes[archetypeIndex];
+    const Chunk     &sourceChunk = source.chunks[from.chunk];
+    const Chunk     &targetChunk = destination.chunks[to.chunk];
+    forEachComponent(source.mask & mask, [&](uint32_t id) {
+        const uint32_t size = g_componentSizes[id];
+        memcpy(
+            targetChunk.data + destination.offsets[id] + to.row * size,
+            sourceChunk.data + source.offsets[id] + from.row * size, size
+        );
+    });
+
+    // -------------- then fill the hole it left behind --------------
+    removeRow(from);
+    m_slots[entity.index] = to;
+    m_version++;
+}
+
+uint32_t EntityRegistry::findArchetype(ComponentMask mask)
+{
+    auto it = m_archetypeIndices.find(mask);
+    if (it != m_archetypeIndices.end())
+    {
+        return it->second;
+    }
+
+    // -------------- fit as many entities as possible, with every array starting on a cache line --------------
+    uint32_t rowSize    = sizeof(Entity);
+    uint32_t arrayCount = 1u;
+    forEachComponent(mask, [&](uint32_t id) {
+        rowSize += g_componentSizes[id];
+        arrayCount++;
+    });
+
+    auto archetype  = std::make_unique<Archetype>();
+    archetype->mask = mask;
+    for (uint32_t capacity = (ChunkSize - arrayCount * ArrayAlignment) / rowSize; capacity > 0u; capacity--)
+    {
+        uint32_t offset = alignUp(capacity * sizeof(Entity), ArrayAlignment);
+        forEachComponent(mask, [&](uint32_t id) {
+            archetype->offsets[id] = offset;
+            offset                 = alignUp(offset + capacity * g_componentSizes[id], ArrayAlignment);
+        });
+
+        if (offset <= ChunkSize)
+        {
+            archetype->capacity = capacity;
+            break;
+        }
+    }
+
+    assert(archetype->capacity > 0u);
+
+    const uint32_t index     = static_cast<uint32_t>(m_archetypes.size());
+    m_archetypeIndices[mask] = index;
+    m_archetypes.push_back(std::move(archetype));
+    return index;
+}
+
+void EntityRegistry::pushRow(uint32_t archetypeIndex, Entity entity, Slot &slot)
+{
+    Archetype &archetype = *m_archetypes[archetypeIndex];
+    if (archetype.chunks.empty() || archetype.chunks.back().count == archetype.capacity)
+    {
+        Chunk          &chunk   = archetype.chunks.emplace_back();
+        chunk.memory            = std::make_unique_for_overwrite<uint8_t[]>(ChunkSize + ArrayAlignment);
+        const uintptr_t address = reinterpret_cast<uintptr_t>(chunk.memory.get());
+        chunk.data              = chunk.memory.get() + (ArrayAlignment - address % ArrayAlignment) % ArrayAlignment;
+    }
+
+    Chunk         &chunk    = archetype.chunks.back();
+    const uint32_t row      = chunk.count++;
+    getEntities(chunk)[row] = entity;
+    forEachComponent(archetype.mask, [&](uint32_t id) {
+        const uint32_t size = g_componentSizes[id];
+        memset(chunk.data + archetype.offsets[id] + row * size, 0, size);
+    });
+
+    archetype.count++;
+    slot.archetype = archetypeIndex;
+    slot.chunk     = static_cast<uint32_t>(archetype.chunks.size() - 1u);
+    slot.row       = row;
+}
+
+void EntityRegistry::removeRow(const Slot &slot)
+{
+    Archetype &archetype = *m_archetypes[slot.archetype];
+    Chunk     &chunk     = archetype.chunks[slot.chunk];
+    Chunk     &last      = archetype.chunks.back();
+    uint32_t   lastRow   = last.count - 1u;
+
+    // -------------- move the archetype's last entity into the hole, so the arrays stay packed --------------
+    if (&chunk != &last || slot.row != lastRow)
+    {
+        const Entity moved           = getEntities(last)[lastRow];
+        getEntities(chunk)[slot.row] = moved;
+        forEachComponent(archetype.mask, [&](uint32_t id) {
+            const uint32_t size = g_componentSizes[id];
+            memcpy(
+                chunk.data + archetype.offsets[id] + slot.row * size,
+                last.data + archetype.offsets[id] + lastRow * size, size
+            );
+        });
+
+        m_slots[moved.index].chunk = slot.chunk;
+        m_slots[moved.index].row   = slot.row;
+    }
+
+    // -------------- release the last chunk once it's empty --------------
+    archetype.count--;
+    if (--last.count == 0u)
+    {
+        archetype.chunks.pop_back();
+    }
+}
+
+ComponentMask EntityRegistry::getMask(Entity entity) const
+{
+    return m_archetypes[m_slots[entity.index].archetype]->mask;
+}
+
+void *EntityRegistry::getComponent(Entity entity, uint32_t id)
+{
+    if (!isAlive(entity))
+    {
+        return nullptr;
+    }
+
+    const Slot      &slot      = m_slots[entity.index];
+    const Archetype &archetype = *m_archetypes[slot.archetype];
+    if ((archetype.mask & (ComponentMask(1u) << id)) == 0u)
+    {
+        return nullptr;
+    }
+
+    return archetype.chunks[slot.chunk].data + archetype.offsets[id] + slot.row * g_componentSizes[id];
+}
+
+Entity *EntityRegistry::getEntities(const Chunk &chunk)
+{
+    return reinterpret_cast<Entity *>(chunk.data);
+}
+
+uint32_t EntityRegistry::RegisterComponent(uint32_t size)
+{
+    const uint32_t id = g_componentCount.fetch_add(1u);
+    assert(id < MaxComponents);
+
+    g_componentSizes[id] = size;
+    return id;
+}
+
+} // namespace bisky::scene
\ No newline at end of file
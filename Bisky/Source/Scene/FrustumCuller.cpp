@@ -0,0 +1,211 @@
+#include "Core/CpuFeatures.hpp"
+#include "Scene/FrustumCuller.hpp"
+
+#include <immintrin.h>
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstring>
+
+namespace bisky::scene::FrustumCuller
+{
+
+namespace
+{
+
+static_assert(sizeof(Bounds) == 4u * sizeof(float), "spheres are loaded as center and radius in one vector");
+
+// the four bytes of visible for every 4 lane mask, lane 0 in the lowest byte
+constexpr std::array<uint32_t, 16> LaneBytes = []() {
+    std::array<uint32_t, 16> bytes = {};
+    for (uint32_t mask = 0; mask < bytes.size(); mask++)
+    {
+        for (uint32_t lane = 0; lane < 4u; lane++)
+        {
+            bytes[mask] |= ((mask >> lane) & 1u) << (lane * 8u);
+        }
+    }
+    return bytes;
+}();
+
+/*
+ * Stores the visible bytes of four lanes.
+ *
+ * @param visible Where the first lane's byte goes.
+ * @param mask The visible lanes, one bit each.
+ * @return The number of visible lanes.
+ */
+uint32_t storeLanes(uint8_t *visible, uint32_t mask)
+{
+    memcpy(visible, &LaneBytes[mask], sizeof(uint32_t));
+    return static_cast<uint32_t>(std::popcount(mask));
+}
+
+uint32_t cullScalar(const Frustum &frustum, const Bounds *spheres, uint32_t count, uint8_t *visible)
+{
+    uint32_t visibleCount = 0u;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        const Bounds &sphere = spheres[i];
+
+        bool outside = false;
+        for (const dx::XMFLOAT4 &plane : frustum.planes)
+        {
+            const float distance =
+                sphere.center.x * plane.x + sphere.center.y * plane.y + sphere.center.z * plane.z + plane.w;
+            outside |= distance + sphere.radius < 0.0f;
+        }
+
+        visible[i]    = outside ? 0u : 1u;
+        visibleCount += outside ? 0u : 1u;
+    }
+    return visibleCount;
+}
+
+uint32_t cullSse(const Frustum &frustum, const Bounds *spheres, uint32_t count, uint8_t *visible)
+{
+    // -------------- every plane in its own lanes --------------
+    __m128 planeX[6], planeY[6], planeZ[6], planeW[6];
+    for (uint32_t p = 0; p < 6u; p++)
+    {
+        planeX[p] = _mm_set1_ps(frustum.planes[p].x);
+        planeY[p] = _mm_set1_ps(frustum.planes[p].y);
+        planeZ[p] = _mm_set1_ps(frustum.planes[p].z);
+        planeW[p] = _mm_set1_ps(frustum.planes[p].w);
+    }
+
+    const __m128 zero         = _mm_setzero_ps();
+    uint32_t     visibleCount = 0u;
+    uint32_t     i            = 0u;
+    for (; i + 4u <= count; i += 4u)
+    {
+        // -------------- four spheres, transposed so each vector holds one component of all of them --------------
+        __m128 x = _mm_loadu_ps(&spheres[i + 0u].center.x);
+        __m128 y = _mm_loadu_ps(&spheres[i + 1u].center.x);
+        __m128 z = _mm_loadu_ps(&spheres[i + 2u].center.x);
+        __m128 r = _mm_loadu_ps(&spheres[i + 3u].center.x);
+        _MM_TRANSPOSE4_PS(x, y, z, r);
+
+        __m128 outside = zero;
+        for (uint32_t p = 0; p < 6u; p++)
+        {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(x, planeX[p]), _mm_mul_ps(y, planeY[p]));
+            distance        = _mm_add_ps(_mm_add_ps(distance, _mm_mul_ps(z, planeZ[p])), planeW[p]);
+            outside         = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, r), zero));
+        }
+
+        visibleCount += storeLanes(visible + i, ~_mm_movemask_ps(outside) & 0xFu);
+    }
+
+    return visibleCount + cullScalar(frustum, spheres + i, count - i, visible + i);
+}
+
+/*
+ * Only called after isSupported checked the CPU, the rest of the build stays SSE2.
+ */
+uint32_t cullAvx(const Frustum &frustum, const Bounds *spheres, uint32_t count, uint8_t *visible)
+{
+    __m256 planeX[6], planeY[6], planeZ[6], planeW[6];
+    for (uint32_t p = 0; p < 6u; p++)
+    {
+        planeX[p] = _mm256_set1_ps(frustum.planes[p].x);
+        planeY[p] = _mm256_set1_ps(frustum.planes[p].y);
+        planeZ[p] = _mm256_set1_ps(frustum.planes[p].z);
+        planeW[p] = _mm256_set1_ps(frustum.planes[p].w);
+    }
+
+    auto loadPair = [&](uint32_t first) {
+        const __m256 low = _mm256_castps128_ps256(_mm_loadu_ps(&spheres[first].center.x));
+        return _mm256_insertf128_ps(low, _mm_loadu_ps(&spheres[first + 4u].center.x), 1);
+    };
+
+    const __m256 zero         = _mm256_setzero_ps();
+    uint32_t     visibleCount = 0u;
+    uint32_t     i            = 0u;
+    for (; i + 8u <= count; i += 8u)
+    {
+        // -------------- spheres 0-3 in the low half and 4-7 in the high half, transposed per half --------------
+        const __m256 s0 = loadPair(i + 0u);
+        const __m256 s1 = loadPair(i + 1u);
+        const __m256 s2 = loadPair(i + 2u);
+        const __m256 s3 = loadPair(i + 3u);
+        const __m256 a  = _mm256_unpacklo_ps(s0, s1);
+        const __m256 b  = _mm256_unpackhi_ps(s0, s1);
+        const __m256 c  = _mm256_unpacklo_ps(s2, s3);
+        const __m256 d  = _mm256_unpackhi_ps(s2, s3);
+        const __m256 x  = _mm256_shuffle_ps(a, c, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 y  = _mm256_shuffle_ps(a, c, _MM_SHUFFLE(3, 2, 3, 2));
+        const __m256 z  = _mm256_shuffle_ps(b, d, _MM_SHUFFLE(1, 0, 1, 0));
+        const __m256 r  = _mm256_shuffle_ps(b, d, _MM_SHUFFLE(3, 2, 3, 2));
+
+        __m256 outside = zero;
+        for (uint32_t p = 0; p < 6u; p++)
+        {
+            __m256 distance = _mm256_add_ps(_mm256_mul_ps(x, planeX[p]), _mm256_mul_ps(y, planeY[p]));
+            distance        = _mm256_add_ps(_mm256_add_ps(distance, _mm256_mul_ps(z, planeZ[p])), planeW[p]);
+            outside         = _mm256_or_ps(outside, _mm256_cmp_ps(_mm256_add_ps(distance, r), zero, _CMP_LT_OQ));
+        }
+
+        const uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_ps(outside)) & 0xFFu;
+        visibleCount += storeLanes(visible + i, mask & 0xFu);
+        visibleCount += storeLanes(visible + i + 4u, mask >> 4u);
+    }
+    _mm256_zeroupper();
+
+    return visibleCount + cullSse(frustum, spheres + i, count - i, visible + i);
+}
+
+} // namespace
+
+MeshBounds computeBounds(std::span<const Vertex> vertices)
+{
+    MeshBounds bounds;
+    if (vertices.empty())
+    {
+        return bounds;
+    }
+
+    // -------------- the box first, the sphere is centered on it --------------
+    dx::XMVECTOR minimum = dx::XMLoadFloat3(&vertices[0].position);
+    dx::XMVECTOR maximum = minimum;
+    for (auto &vertex : vertices)
+    {
+        minimum = dx::XMVectorMin(minimum, dx::XMLoadFloat3(&vertex.position));
+        maximum = dx::XMVectorMax(maximum, dx::XMLoadFloat3(&vertex.position));
+    }
+
+    const dx::XMVECTOR center   = dx::XMVectorScale(dx::XMVectorAdd(minimum, maximum), 0.5f);
+    dx::XMVECTOR       radiusSq = dx::XMVectorZero();
+    for (auto &vertex : vertices)
+    {
+        const dx::XMVECTOR offset = dx::XMVectorSubtract(dx::XMLoadFloat3(&vertex.position), center);
+        radiusSq                  = dx::XMVectorMax(radiusSq, dx::XMVector3LengthSq(offset));
+    }
+
+    dx::XMStoreFloat3(&bounds.center, center);
+    bounds.radius = dx::XMVectorGetX(dx::XMVectorSqrt(radiusSq));
+    return bounds;
+}
+
+uint32_t cull(const Frustum &frustum, const Bounds *spheres, uint32_t count, uint8_t *visible, CullKernel kernel)
+{
+    assert(isSupported(kernel));
+
+    switch (kernel)
+    {
+    case CullKernel::Avx:
+        return cullAvx(frustum, spheres, count, visible);
+    case CullKernel::Sse:
+        return cullSse(frustum, spheres, count, visible);
+    default:
+        return cullScalar(frustum, spheres, count, visible);
+    }
+}
+
+bool isSupported(CullKernel kernel)
+{
+    return kernel != CullKernel::Avx || core::CpuFeatures::hasAvx();
+}
+
+} // namespace bisky::scene::FrustumCuller
\ No newline at end of file
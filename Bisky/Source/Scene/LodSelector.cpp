@@ -0,0 +1,54 @@
+#include "Common.hpp"
+
+#include "Scene/LodSelector.hpp"
+
+namespace bisky::scene::LodSelector
+{
+
+float getProjectionScale(float fovY, uint32_t height)
+{
+    return static_cast<float>(height) / (2.0f * std::tan(fovY * 0.5f));
+}
+
+uint32_t select(
+    const Mesh &mesh, dx::FXMMATRIX world, dx::FXMVECTOR cameraPosition, float projectionScale, float threshold
+)
+{
+    // keeps objects that intersect the camera from dividing by zero
+    constexpr float MinDistance = 1e-3f;
+
+    if (mesh.lods.empty())
+    {
+        return 0u;
+    }
+
+    // -------------- the largest axis scale grows both the error and the bounds --------------
+    const float scale = std::sqrt(std::max(
+        {dx::XMVectorGetX(dx::XMVector3LengthSq(world.r[0])), dx::XMVectorGetX(dx::XMVector3LengthSq(world.r[1])),
+         dx::XMVectorGetX(dx::XMVector3LengthSq(world.r[2]))}
+    ));
+
+    // -------------- distance to the closest point of the bounding sphere --------------
+    dx::XMVECTOR center   = dx::XMVector3Transform(dx::XMLoadFloat3(&mesh.bounds.center), world);
+    float        distance = dx::XMVectorGetX(dx::XMVector3Length(dx::XMVectorSubtract(center, cameraPosition)));
+    distance              = std::max(distance - mesh.bounds.radius * scale, MinDistance);
+
+    // -------------- take the coarsest level that still looks the same --------------
+    const float pixelsPerUnit = scale * projectionScale / distance;
+    for (uint32_t lod = static_cast<uint32_t>(mesh.lods.size()); lod > 0u; lod--)
+    {
+        if (mesh.lods[lod - 1u].error * pixelsPerUnit <= threshold)
+        {
+            return lod;
+        }
+    }
+
+    return 0u;
+}
+
+const std::vector<Submesh> &getSubmeshes(const Mesh &mesh, uint32_t lod)
+{
+    return lod == 0u || lod > mesh.lods.size() ? mesh.submeshes : mesh.lods[lod - 1u].submeshes;
+}
+
+} // namespace bisky::scene::LodSelector
\ No newline at end of file
@@ -1,9 +1,76 @@
 #include "Common.hpp"
 
+#include "Graphics/Device.hpp"
 #include "Scene/Material.hpp"
 #include "Scene/Mesh.hpp"
 
 namespace bisky::scene
 {
 
+Mesh::~Mesh()
+{
+    if (geometryPool)
+    {
+        geometryPool->free(vertices);
+        geometryPool->free(indices);
+    }
+}
+
+bool Mesh::createGeometry(
+    gfx::Device *const device, const void *vertexData, uint32_t vertexCount, const void *indexData, uint32_t indexCount,
+    gfx::ResourceUpload &upload
+)
+{
+    // -------------- sub-allocate from the pool --------------
+    gfx::GeometryPool *const pool = device->getGeometryPool();
+    if (!pool->addVertices(vertexData, vertexCount, vertexByteStride, upload, vertices))
+    {
+        return false;
+    }
+
+    if (!pool->addIndices(indexData, indexCount, indexFormat, upload, indices))
+    {
+        pool->free(vertices);
+        vertices = {};
+        return false;
+    }
+
+    const uint32_t indexByteStride = indexFormat == DXGI_FORMAT_R16_UINT ? 2u : 4u;
+    geometryPool                   = pool;
+    vertexBufferByteSize           = vertexCount * vertexByteStride;
+    indexBufferByteSize            = indexCount * indexByteStride;
+
+    // -------------- draws index from the start of the shared index buffer --------------
+    const uint32_t firstIndex = static_cast<uint32_t>(indices.offset / indexByteStride);
+    for (Submesh &submesh : submeshes)
+    {
+        submesh.startIndexLocation += firstIndex;
+    }
+    for (MeshLod &lod : lods)
+    {
+        for (Submesh &submesh : lod.submeshes)
+        {
+            submesh.startIndexLocation += firstIndex;
+        }
+    }
+
+    // -------------- the vertex view starts at the mesh's first vertex, so base vertices stay as they are --------------
+    vertexSrv                            = device->getCbvSrvUavHeap()->allocate();
+    D3D12_SHADER_RESOURCE_VIEW_DESC desc = {
+        .Format                  = DXGI_FORMAT_UNKNOWN,
+        .ViewDimension           = D3D12_SRV_DIMENSION_BUFFER,
+        .Shader4ComponentMapping = D3D12_DEFAULT_SHADER_4_COMPONENT_MAPPING,
+        .Buffer =
+            {
+                .FirstElement        = vertices.offset / vertexByteStride,
+                .NumElements         = vertexCount,
+                .StructureByteStride = vertexByteStride,
+                .Flags               = D3D12_BUFFER_SRV_FLAG_NONE,
+            },
+    };
+    device->getDevice()->CreateShaderResourceView(vertices.buffer->resource.Get(), &desc, vertexSrv.cpu);
+
+    return true;
+}
+
 } // namespace bisky::scene
\ No newline at end of file
@@ -0,0 +1,468 @@
+#include "Scene/MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+
+namespace bisky::scene::MeshOptimizer
+{
+
+namespace
+{
+
+// -------------- Forsyth's vertex scoring constants --------------
+constexpr uint32_t MaxCacheSize      = 32u;
+constexpr float    CacheDecayPower   = 1.5f;
+constexpr float    LastTriangleScore = 0.75f;
+constexpr float    ValenceBoostScale = 2.0f;
+constexpr float    ValenceBoostPower = 0.5f;
+
+constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+float getVertexScore(int32_t cachePosition, uint32_t remainingTriangles)
+{
+    if (remainingTriangles == 0u)
+    {
+        return -1.0f;
+    }
+
+    float score = 0.0f;
+    if (cachePosition >= 0)
+    {
+        // the last triangle's vertices get a fixed score so the next triangle doesn't just reuse one edge
+        if (cachePosition < 3)
+            score = LastTriangleScore;
+        else
+            score = std::pow(1.0f - (cachePosition - 3) / static_cast<float>(MaxCacheSize - 3u), CacheDecayPower);
+    }
+
+    // boost vertices with few triangles left so they get finished off instead of left stranded
+    score += ValenceBoostScale * std::pow(static_cast<float>(remainingTriangles), -ValenceBoostPower);
+    return score;
+}
+
+uint32_t hashVertex(const Vertex &vertex)
+{
+    uint32_t words[sizeof(Vertex) / sizeof(uint32_t)];
+    memcpy(words, &vertex, sizeof(Vertex));
+
+    uint32_t hash = 2166136261u;
+    for (uint32_t word : words)
+    {
+        hash = (hash ^ word) * 16777619u;
+    }
+
+    return hash ^ (hash >> 15u);
+}
+
+/*
+ * A FIFO post-transform cache, tracked with a timestamp per vertex.
+ * A vertex is in the cache while fewer than cacheSize misses happened since it was added.
+ */
+struct FifoCache
+{
+    std::vector<uint32_t> timestamps;
+    uint32_t              time;
+    uint32_t              size;
+
+    FifoCache(uint32_t vertexCount, uint32_t cacheSize)
+        : timestamps(vertexCount, 0u), time(cacheSize + 1u), size(cacheSize)
+    {
+    }
+
+    uint32_t access(uint32_t vertex)
+    {
+        if (time - timestamps[vertex] > size)
+        {
+            timestamps[vertex] = time++;
+            return 1u;
+        }
+
+        return 0u;
+    }
+
+    uint32_t accessTriangle(const uint32_t *triangle)
+    {
+        return access(triangle[0]) + access(triangle[1]) + access(triangle[2]);
+    }
+
+    void flush()
+    {
+        time += size + 1u;
+    }
+};
+
+} // namespace
+
+uint32_t weldVertices(std::vector<Vertex> &vertices, std::span<uint32_t> indices)
+{
+    const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+
+    // -------------- open addressing table of unique vertices --------------
+    uint32_t tableSize = 1u;
+    while (tableSize < vertexCount * 2u)
+    {
+        tableSize *= 2u;
+    }
+
+    std::vector<uint32_t> table(tableSize, InvalidIndex);
+    std::vector<uint32_t> remap(vertexCount);
+    uint32_t              uniqueCount = 0u;
+    for (uint32_t i = 0; i < vertexCount; i++)
+    {
+        uint32_t slot = hashVertex(vertices[i]) & (tableSize - 1u);
+        while (table[slot] != InvalidIndex && memcmp(&vertices[table[slot]], &vertices[i], sizeof(Vertex)) != 0)
+        {
+            slot = (slot + 1u) & (tableSize - 1u);
+        }
+
+        // -------------- unique vertices are compacted in place, the table points at the compacted copy --------------
+        if (table[slot] == InvalidIndex)
+        {
+            table[slot]           = uniqueCount;
+            vertices[uniqueCount] = vertices[i];
+            uniqueCount++;
+        }
+
+        remap[i] = table[slot];
+    }
+
+    for (auto &index : indices)
+    {
+        index = remap[index];
+    }
+
+    vertices.resize(uniqueCount);
+    return uniqueCount;
+}
+
+void optimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount)
+{
+    const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3u);
+    if (triangleCount == 0u)
+    {
+        return;
+    }
+
+    // -------------- build the triangle adjacency of every vertex --------------
+    std::vector<uint32_t> remaining(vertexCount, 0u);
+    for (uint32_t index : indices)
+    {
+        remaining[index]++;
+    }
+
+    std::vector<uint32_t> offsets(vertexCount + 1u, 0u);
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        offsets[v + 1u] = offsets[v] + remaining[v];
+    }
+
+    std::vector<uint32_t> adjacency(indices.size());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for (uint32_t t = 0; t < triangleCount; t++)
+    {
+        for (uint32_t k = 0; k < 3u; k++)
+        {
+            adjacency[fill[indices[t * 3u + k]]++] = t;
+        }
+    }
+
+    // -------------- initial scores --------------
+    std::vector<int32_t> cachePositions(vertexCount, -1);
+    std::vector<float>   vertexScores(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        vertexScores[v] = getVertexScore(-1, remaining[v]);
+    }
+
+    std::vector<float> triangleScores(triangleCount);
+    std::vector<bool>  emitted(triangleCount, false);
+    int64_t            best      = 0;
+    float              bestScore = -1.0f;
+    for (uint32_t t = 0; t < triangleCount; t++)
+    {
+        const uint32_t *triangle = &indices[t * 3u];
+        triangleScores[t] = vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+        if (triangleScores[t] > bestScore)
+        {
+            best      = t;
+            bestScore = triangleScores[t];
+        }
+    }
+
+    // -------------- greedily emit the best scoring triangle --------------
+    std::vector<uint32_t>                   output(indices.size());
+    std::array<uint32_t, MaxCacheSize + 3u> cache;
+    std::array<uint32_t, MaxCacheSize + 3u> newCache;
+    uint32_t                                cacheCount = 0u;
+    uint32_t                                cursor     = 0u;
+    for (uint32_t emittedCount = 0; emittedCount < triangleCount; emittedCount++)
+    {
+        // -------------- nothing in the cache is connected to a triangle, start somewhere new --------------
+        if (best < 0)
+        {
+            while (emitted[cursor])
+            {
+                cursor++;
+            }
+            best = cursor;
+        }
+
+        const uint32_t triangle[3] = {indices[best * 3u], indices[best * 3u + 1u], indices[best * 3u + 2u]};
+        memcpy(&output[emittedCount * 3u], triangle, sizeof(triangle));
+        emitted[best] = true;
+
+        // -------------- remove the triangle from its vertices' adjacency --------------
+        for (uint32_t v : triangle)
+        {
+            uint32_t *begin = &adjacency[offsets[v]];
+            uint32_t *end   = begin + remaining[v];
+            std::iter_swap(std::find(begin, end, static_cast<uint32_t>(best)), end - 1);
+            remaining[v]--;
+        }
+
+        // -------------- push the triangle's vertices to the front of the cache --------------
+        uint32_t newCacheCount = 0u;
+        for (uint32_t v : triangle)
+        {
+            newCache[newCacheCount++] = v;
+        }
+        for (uint32_t i = 0; i < cacheCount; i++)
+        {
+            uint32_t v = cache[i];
+            if (v != triangle[0] && v != triangle[1] && v != triangle[2])
+                newCache[newCacheCount++] = v;
+        }
+
+        // -------------- rescore everything that moved, including what fell out of the cache --------------
+        for (uint32_t i = 0; i < newCacheCount; i++)
+        {
+            uint32_t v        = newCache[i];
+            cachePositions[v] = i < MaxCacheSize ? static_cast<int32_t>(i) : -1;
+
+            float score     = getVertexScore(cachePositions[v], remaining[v]);
+            float delta     = score - vertexScores[v];
+            vertexScores[v] = score;
+            for (uint32_t j = offsets[v]; j < offsets[v] + remaining[v]; j++)
+            {
+                triangleScores[adjacency[j]] += delta;
+            }
+        }
+
+        cacheCount = std::min(newCacheCount, MaxCacheSize);
+        std::copy(newCache.begin(), newCache.begin() + cacheCount, cache.begin());
+
+        // -------------- the next triangle is the best one touching the cache --------------
+        best      = -1;
+        bestScore = -1.0f;
+        for (uint32_t i = 0; i < cacheCount; i++)
+        {
+            uint32_t v = cache[i];
+            for (uint32_t j = offsets[v]; j < offsets[v] + remaining[v]; j++)
+            {
+                uint32_t t = adjacency[j];
+                if (triangleScores[t] > bestScore)
+                {
+                    best      = t;
+                    bestScore = triangleScores[t];
+                }
+            }
+        }
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+void optimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex> vertices, float threshold)
+{
+    const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3u);
+    const uint32_t vertexCount   = static_cast<uint32_t>(vertices.size());
+    if (triangleCount == 0u)
+    {
+        return;
+    }
+
+    // -------------- hard boundaries, where the cache starts over with three misses --------------
+    FifoCache             cache(vertexCount, CacheSize);
+    std::vector<uint32_t> hardBoundaries;
+    for (uint32_t t = 0; t < triangleCount; t++)
+    {
+        if (cache.accessTriangle(&indices[t * 3u]) == 3u || t == 0u)
+            hardBoundaries.push_back(t);
+    }
+    hardBoundaries.push_back(triangleCount);
+
+    // -------------- soft boundaries, split each cluster once it reaches its own ACMR --------------
+    std::vector<uint32_t> clusters;
+    for (size_t i = 0; i + 1u < hardBoundaries.size(); i++)
+    {
+        const uint32_t start = hardBoundaries[i];
+        const uint32_t end   = hardBoundaries[i + 1u];
+
+        uint32_t clusterMisses = 0u;
+        cache.flush();
+        for (uint32_t t = start; t < end; t++)
+        {
+            clusterMisses += cache.accessTriangle(&indices[t * 3u]);
+        }
+
+        const float clusterThreshold = threshold * clusterMisses / static_cast<float>(end - start);
+        clusters.push_back(start);
+
+        uint32_t misses    = 0u;
+        uint32_t triangles = 0u;
+        cache.flush();
+        for (uint32_t t = start; t < end; t++)
+        {
+            misses += cache.accessTriangle(&indices[t * 3u]);
+            triangles++;
+            if (misses / static_cast<float>(triangles) <= clusterThreshold)
+            {
+                clusters.push_back(t + 1u);
+                misses    = 0u;
+                triangles = 0u;
+                cache.flush();
+            }
+        }
+
+        // the last split leaves a small, cache unfriendly cluster, so merge it into the one before
+        if (clusters.back() != start)
+            clusters.pop_back();
+    }
+    clusters.push_back(triangleCount);
+
+    // -------------- score clusters by how much they face away from the mesh center --------------
+    dx::XMVECTOR meshCenter = dx::XMVectorZero();
+    for (auto &vertex : vertices)
+    {
+        meshCenter = dx::XMVectorAdd(meshCenter, dx::XMLoadFloat3(&vertex.position));
+    }
+    meshCenter = dx::XMVectorScale(meshCenter, 1.0f / std::max(vertexCount, 1u));
+
+    const uint32_t        clusterCount = static_cast<uint32_t>(clusters.size() - 1u);
+    std::vector<float>    clusterScores(clusterCount, 0.0f);
+    std::vector<uint32_t> clusterOrder(clusterCount);
+    for (uint32_t c = 0; c < clusterCount; c++)
+    {
+        dx::XMVECTOR centroid = dx::XMVectorZero();
+        dx::XMVECTOR normal   = dx::XMVectorZero();
+        float        area     = 0.0f;
+        for (uint32_t t = clusters[c]; t < clusters[c + 1u]; t++)
+        {
+            dx::XMVECTOR p0 = dx::XMLoadFloat3(&vertices[indices[t * 3u]].position);
+            dx::XMVECTOR p1 = dx::XMLoadFloat3(&vertices[indices[t * 3u + 1u]].position);
+            dx::XMVECTOR p2 = dx::XMLoadFloat3(&vertices[indices[t * 3u + 2u]].position);
+
+            dx::XMVECTOR cross        = dx::XMVector3Cross(dx::XMVectorSubtract(p1, p0), dx::XMVectorSubtract(p2, p0));
+            float        triangleArea = dx::XMVectorGetX(dx::XMVector3Length(cross));
+
+            dx::XMVECTOR center = dx::XMVectorAdd(dx::XMVectorAdd(p0, p1), p2);
+
+            centroid = dx::XMVectorAdd(centroid, dx::XMVectorScale(center, triangleArea / 3.0f));
+            normal   = dx::XMVectorAdd(normal, cross);
+            area += triangleArea;
+        }
+
+        if (area > 0.0f)
+        {
+            centroid         = dx::XMVectorScale(centroid, 1.0f / area);
+            dx::XMVECTOR dir = dx::XMVectorSubtract(centroid, meshCenter);
+            clusterScores[c] = dx::XMVectorGetX(dx::XMVector3Dot(dir, dx::XMVector3Normalize(normal)));
+        }
+
+        clusterOrder[c] = c;
+    }
+
+    std::ranges::stable_sort(clusterOrder, [&](uint32_t a, uint32_t b) { return clusterScores[a] > clusterScores[b]; });
+
+    // -------------- write the clusters out in their new order --------------
+    std::vector<uint32_t> output;
+    output.reserve(indices.size());
+    for (uint32_t c : clusterOrder)
+    {
+        output.insert(output.end(), indices.begin() + clusters[c] * 3u, indices.begin() + clusters[c + 1u] * 3u);
+    }
+
+    std::copy(output.begin(), output.end(), indices.begin());
+}
+
+uint32_t optimizeVertexFetch(std::vector<Vertex> &vertices, std::span<uint32_t> indices)
+{
+    std::vector<uint32_t> remap(vertices.size(), InvalidIndex);
+    std::vector<Vertex>   reordered;
+    reordered.reserve(vertices.size());
+
+    for (auto &index : indices)
+    {
+        if (remap[index] == InvalidIndex)
+        {
+            remap[index] = static_cast<uint32_t>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+
+        index = remap[index];
+    }
+
+    vertices = std::move(reordered);
+    return static_cast<uint32_t>(vertices.size());
+}
+
+VertexCacheStats analyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize)
+{
+    const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3u);
+    if (triangleCount == 0u)
+    {
+        return {};
+    }
+
+    FifoCache         cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount, false);
+    uint32_t          misses          = 0u;
+    uint32_t          referencedCount = 0u;
+    for (uint32_t index : indices)
+    {
+        misses += cache.access(index);
+        if (!referenced[index])
+        {
+            referenced[index] = true;
+            referencedCount++;
+        }
+    }
+
+    return {
+        .acmr = misses / static_cast<float>(triangleCount),
+        .atvr = misses / static_cast<float>(referencedCount),
+    };
+}
+
+MeshOptimizationStats optimize(std::vector<Vertex> &vertices, std::vector<uint32_t> &indices)
+{
+    MeshOptimizationStats stats = {};
+    stats.verticesBefore        = static_cast<uint32_t>(vertices.size());
+
+    // -------------- only triangle lists with valid indices can be reordered --------------
+    bool valid = indices.size() % 3u == 0u;
+    for (uint32_t index : indices)
+    {
+        valid = valid && index < vertices.size();
+    }
+
+    if (!valid)
+    {
+        stats.verticesAfter = stats.verticesBefore;
+        return stats;
+    }
+
+    stats.before = analyzeVertexCache(indices, stats.verticesBefore);
+
+    uint32_t vertexCount = weldVertices(vertices, indices);
+    optimizeVertexCache(indices, vertexCount);
+    optimizeOverdraw(indices, vertices);
+    stats.verticesAfter = optimizeVertexFetch(vertices, indices);
+
+    stats.after = analyzeVertexCache(indices, stats.verticesAfter);
+    return stats;
+}
+
+} // namespace bisky::scene::MeshOptimizer
\ No newline at end of file
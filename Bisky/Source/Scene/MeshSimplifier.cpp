@@ -0,0 +1,416 @@
+#include "Common.hpp"
+
+#include "Scene/MeshSimplifier.hpp"
+
+namespace bisky::scene::MeshSimplifier
+{
+
+namespace
+{
+
+// borders are held in place by planes perpendicular to them, weighted above the surface planes
+constexpr double   BorderWeight = 10.0;
+constexpr uint32_t InvalidIndex = UINT32_MAX;
+
+/*
+ * The sum of squared distances to a set of planes, stored as a symmetric 4x4 matrix.
+ */
+struct Quadric
+{
+    double a2, b2, c2, d2;
+    double ab, ac, ad;
+    double bc, bd, cd;
+    double weight;
+
+    void addPlane(double a, double b, double c, double d, double w)
+    {
+        a2 += w * a * a;
+        b2 += w * b * b;
+        c2 += w * c * c;
+        d2 += w * d * d;
+        ab += w * a * b;
+        ac += w * a * c;
+        ad += w * a * d;
+        bc += w * b * c;
+        bd += w * b * d;
+        cd += w * c * d;
+        weight += w;
+    }
+
+    Quadric operator+(const Quadric &other) const
+    {
+        return {
+            a2 + other.a2, b2 + other.b2, c2 + other.c2, d2 + other.d2, ab + other.ab, ac + other.ac,
+            ad + other.ad, bc + other.bc, bd + other.bd, cd + other.cd, weight + other.weight,
+        };
+    }
+
+    /*
+     * The RMS distance from a point to every plane in the quadric.
+     */
+    float getError(const dx::XMFLOAT3 &p) const
+    {
+        if (weight <= 0.0)
+        {
+            return 0.0f;
+        }
+
+        const double x = p.x, y = p.y, z = p.z;
+        const double squared = a2 * x * x + b2 * y * y + c2 * z * z + d2 +
+                               2.0 * (ab * x * y + ac * x * z + bc * y * z + ad * x + bd * y + cd * z);
+        return static_cast<float>(std::sqrt(std::abs(squared) / weight));
+    }
+};
+
+/*
+ * An edge collapse that moves every vertex at the position of from onto the position of to.
+ */
+struct Collapse
+{
+    uint32_t from;
+    uint32_t to;
+    float    error;
+};
+
+uint64_t getEdgeKey(uint32_t a, uint32_t b)
+{
+    return static_cast<uint64_t>(std::min(a, b)) << 32u | std::max(a, b);
+}
+
+dx::XMVECTOR getTriangleNormal(dx::FXMVECTOR p0, dx::FXMVECTOR p1, dx::FXMVECTOR p2)
+{
+    return dx::XMVector3Cross(dx::XMVectorSubtract(p1, p0), dx::XMVectorSubtract(p2, p0));
+}
+
+/*
+ * Finds the first vertex with the same position as each vertex.
+ * The rest are chained together so every vertex at a position can be visited.
+ */
+void buildPositionRemap(
+    std::span<const Vertex> vertices, std::vector<uint32_t> &canonical, std::vector<uint32_t> &wedges
+)
+{
+    const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+
+    uint32_t tableSize = 1u;
+    while (tableSize < vertexCount * 2u)
+    {
+        tableSize *= 2u;
+    }
+
+    std::vector<uint32_t> table(tableSize, InvalidIndex);
+    canonical.resize(vertexCount);
+    wedges.resize(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; v++)
+    {
+        uint32_t bits[3];
+        memcpy(bits, &vertices[v].position, sizeof(bits));
+
+        uint32_t slot = ((bits[0] * 73856093u) ^ (bits[1] * 19349663u) ^ (bits[2] * 83492791u)) & (tableSize - 1u);
+        while (table[slot] != InvalidIndex &&
+               memcmp(&vertices[table[slot]].position, &vertices[v].position, sizeof(dx::XMFLOAT3)) != 0)
+        {
+            slot = (slot + 1u) & (tableSize - 1u);
+        }
+
+        if (table[slot] == InvalidIndex)
+        {
+            table[slot]  = v;
+            canonical[v] = v;
+            wedges[v]    = v;
+        }
+        else
+        {
+            const uint32_t first = table[slot];
+            canonical[v]         = first;
+            wedges[v]            = wedges[first];
+            wedges[first]        = v;
+        }
+    }
+}
+
+} // namespace
+
+float simplify(
+    std::span<const Vertex> vertices, std::span<const uint32_t> indices, uint32_t targetIndexCount, float maxError,
+    std::vector<uint32_t> &result
+)
+{
+    const uint32_t vertexCount = static_cast<uint32_t>(vertices.size());
+    result.assign(indices.begin(), indices.end());
+    if (indices.size() % 3u != 0u || result.size() <= targetIndexCount)
+    {
+        return 0.0f;
+    }
+
+    std::vector<uint32_t> canonical, wedges;
+    buildPositionRemap(vertices, canonical, wedges);
+
+    auto position = [&](uint32_t v) { return dx::XMLoadFloat3(&vertices[v].position); };
+
+    // -------------- count directed edges between positions to find borders and non-manifold edges --------------
+    std::unordered_map<uint64_t, uint32_t> directedEdges;
+    for (size_t i = 0; i < indices.size(); i += 3u)
+    {
+        for (uint32_t k = 0; k < 3u; k++)
+        {
+            const uint32_t a = canonical[indices[i + k]];
+            const uint32_t b = canonical[indices[i + (k + 1u) % 3u]];
+            directedEdges[static_cast<uint64_t>(a) << 32u | b]++;
+        }
+    }
+
+    std::vector<bool>            border(vertexCount, false);
+    std::vector<bool>            locked(vertexCount, false);
+    std::unordered_set<uint64_t> borderEdges;
+    for (auto &[key, count] : directedEdges)
+    {
+        const uint32_t a = static_cast<uint32_t>(key >> 32u);
+        const uint32_t b = static_cast<uint32_t>(key);
+        if (count > 1u)
+        {
+            locked[a] = locked[b] = true;
+        }
+        else if (!directedEdges.contains(static_cast<uint64_t>(b) << 32u | a))
+        {
+            border[a] = border[b] = true;
+            borderEdges.insert(getEdgeKey(a, b));
+        }
+    }
+
+    // -------------- sum the area weighted planes around every position --------------
+    std::vector<Quadric> quadrics(vertexCount, Quadric{});
+    for (size_t i = 0; i < indices.size(); i += 3u)
+    {
+        const uint32_t     corners[3] = {indices[i], indices[i + 1u], indices[i + 2u]};
+        const dx::XMVECTOR p0         = position(corners[0]);
+        const dx::XMVECTOR normal     = getTriangleNormal(p0, position(corners[1]), position(corners[2]));
+        const float        length     = dx::XMVectorGetX(dx::XMVector3Length(normal));
+        if (length == 0.0f)
+        {
+            continue;
+        }
+
+        dx::XMFLOAT3 n;
+        dx::XMStoreFloat3(&n, dx::XMVectorScale(normal, 1.0f / length));
+        const float d = -dx::XMVectorGetX(dx::XMVector3Dot(dx::XMLoadFloat3(&n), p0));
+        for (uint32_t corner : corners)
+        {
+            quadrics[canonical[corner]].addPlane(n.x, n.y, n.z, d, length * 0.5);
+        }
+
+        // -------------- border edges also get a plane along the edge, perpendicular to the triangle --------------
+        for (uint32_t k = 0; k < 3u; k++)
+        {
+            const uint32_t a = canonical[corners[k]];
+            const uint32_t b = canonical[corners[(k + 1u) % 3u]];
+            if (!borderEdges.contains(getEdgeKey(a, b)))
+            {
+                continue;
+            }
+
+            const dx::XMVECTOR edge       = dx::XMVectorSubtract(position(b), position(a));
+            const float        edgeLength = dx::XMVectorGetX(dx::XMVector3Length(edge));
+            if (edgeLength == 0.0f)
+            {
+                continue;
+            }
+
+            dx::XMFLOAT3 p;
+            dx::XMStoreFloat3(&p, dx::XMVector3Normalize(dx::XMVector3Cross(edge, dx::XMLoadFloat3(&n))));
+            const float  pd = -dx::XMVectorGetX(dx::XMVector3Dot(dx::XMLoadFloat3(&p), position(a)));
+            const double w  = BorderWeight * edgeLength * edgeLength;
+            quadrics[a].addPlane(p.x, p.y, p.z, pd, w);
+            quadrics[b].addPlane(p.x, p.y, p.z, pd, w);
+        }
+    }
+
+    // -------------- collapse edges in passes until the target is reached --------------
+    std::vector<uint32_t> offsets(vertexCount + 1u);
+    std::vector<uint32_t> adjacency;
+    std::vector<uint32_t> remap(vertexCount);
+    std::vector<bool>     collapseLocked(vertexCount);
+    std::vector<uint32_t> wedgeTargets;
+    std::vector<uint64_t> edges;
+    std::vector<Collapse> collapses;
+    float                 error = 0.0f;
+    while (result.size() > targetIndexCount)
+    {
+        const uint32_t triangleCount = static_cast<uint32_t>(result.size() / 3u);
+
+        // -------------- triangles around each vertex --------------
+        std::fill(offsets.begin(), offsets.end(), 0u);
+        for (uint32_t index : result)
+        {
+            offsets[index + 1u]++;
+        }
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            offsets[v + 1u] += offsets[v];
+        }
+
+        adjacency.resize(result.size());
+        std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+        for (uint32_t t = 0; t < triangleCount; t++)
+        {
+            for (uint32_t k = 0; k < 3u; k++)
+            {
+                adjacency[fill[result[t * 3u + k]]++] = t;
+            }
+        }
+
+        // -------------- cheapest valid direction of every edge --------------
+        edges.clear();
+        for (uint32_t t = 0; t < triangleCount; t++)
+        {
+            for (uint32_t k = 0; k < 3u; k++)
+            {
+                const uint32_t a = canonical[result[t * 3u + k]];
+                const uint32_t b = canonical[result[t * 3u + (k + 1u) % 3u]];
+                if (a != b)
+                    edges.push_back(getEdgeKey(a, b));
+            }
+        }
+        std::ranges::sort(edges);
+        edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+        auto canCollapse = [&](uint32_t from, uint32_t to) {
+            return !locked[from] && (!border[from] || borderEdges.contains(getEdgeKey(from, to)));
+        };
+
+        collapses.clear();
+        for (uint64_t edge : edges)
+        {
+            const uint32_t a = static_cast<uint32_t>(edge >> 32u);
+            const uint32_t b = static_cast<uint32_t>(edge);
+
+            Collapse best = {.from = InvalidIndex, .to = InvalidIndex, .error = std::numeric_limits<float>::max()};
+            for (auto [from, to] : {std::pair{a, b}, std::pair{b, a}})
+            {
+                const float collapseError = (quadrics[from] + quadrics[to]).getError(vertices[to].position);
+                if (canCollapse(from, to) && collapseError < best.error)
+                    best = {.from = from, .to = to, .error = collapseError};
+            }
+
+            if (best.from != InvalidIndex)
+                collapses.push_back(best);
+        }
+
+        std::ranges::sort(collapses, [](const Collapse &a, const Collapse &b) { return a.error < b.error; });
+
+        // -------------- apply the cheapest collapses that don't touch each other --------------
+        std::iota(remap.begin(), remap.end(), 0u);
+        std::fill(collapseLocked.begin(), collapseLocked.end(), false);
+
+        const uint32_t removeGoal = (static_cast<uint32_t>(result.size()) - targetIndexCount) / 3u;
+        uint32_t       removed    = 0u;
+        uint32_t       applied    = 0u;
+        for (auto &collapse : collapses)
+        {
+            if (collapse.error > maxError || removed >= removeGoal)
+            {
+                break;
+            }
+
+            if (collapseLocked[collapse.from] || collapseLocked[collapse.to])
+            {
+                continue;
+            }
+
+            // -------------- every vertex at from needs a vertex at to that shares one of its triangles --------------
+            bool valid = true;
+            wedgeTargets.clear();
+            uint32_t v = collapse.from;
+            do
+            {
+                uint32_t target = offsets[v] == offsets[v + 1u] ? collapse.to : InvalidIndex;
+                for (uint32_t j = offsets[v]; j < offsets[v + 1u] && target == InvalidIndex; j++)
+                {
+                    for (uint32_t k = 0; k < 3u; k++)
+                    {
+                        if (canonical[result[adjacency[j] * 3u + k]] == collapse.to)
+                            target = result[adjacency[j] * 3u + k];
+                    }
+                }
+
+                valid = valid && target != InvalidIndex;
+                wedgeTargets.push_back(target);
+                v = wedges[v];
+            } while (v != collapse.from && valid);
+
+            // -------------- the triangles that stay must not flip over --------------
+            const dx::XMVECTOR destination = position(collapse.to);
+            v                              = collapse.from;
+            do
+            {
+                for (uint32_t j = offsets[v]; j < offsets[v + 1u] && valid; j++)
+                {
+                    const uint32_t *triangle = &result[adjacency[j] * 3u];
+                    if (canonical[triangle[0]] == collapse.to || canonical[triangle[1]] == collapse.to ||
+                        canonical[triangle[2]] == collapse.to)
+                    {
+                        continue;
+                    }
+
+                    dx::XMVECTOR before[3], after[3];
+                    for (uint32_t k = 0; k < 3u; k++)
+                    {
+                        before[k] = position(triangle[k]);
+                        after[k]  = triangle[k] == v ? destination : before[k];
+                    }
+
+                    const dx::XMVECTOR normalBefore = getTriangleNormal(before[0], before[1], before[2]);
+                    const dx::XMVECTOR normalAfter  = getTriangleNormal(after[0], after[1], after[2]);
+                    valid = dx::XMVectorGetX(dx::XMVector3Dot(normalBefore, normalAfter)) > 0.0f;
+                }
+
+                v = wedges[v];
+            } while (v != collapse.from && valid);
+
+            if (!valid)
+            {
+                continue;
+            }
+
+            v = collapse.from;
+            for (uint32_t target : wedgeTargets)
+            {
+                remap[v] = target;
+                v        = wedges[v];
+            }
+
+            quadrics[collapse.to]         = quadrics[collapse.to] + quadrics[collapse.from];
+            collapseLocked[collapse.from] = true;
+            collapseLocked[collapse.to]   = true;
+            error                         = std::max(error, collapse.error);
+
+            removed += border[collapse.from] ? 1u : 2u;
+            applied++;
+        }
+
+        if (applied == 0u)
+        {
+            break;
+        }
+
+        // -------------- rewrite the triangles and drop the ones that collapsed --------------
+        size_t written = 0u;
+        for (size_t i = 0; i < result.size(); i += 3u)
+        {
+            const uint32_t a = remap[result[i]];
+            const uint32_t b = remap[result[i + 1u]];
+            const uint32_t c = remap[result[i + 2u]];
+            if (canonical[a] != canonical[b] && canonical[b] != canonical[c] && canonical[a] != canonical[c])
+            {
+                result[written++] = a;
+                result[written++] = b;
+                result[written++] = c;
+            }
+        }
+        result.resize(written);
+    }
+
+    return error;
+}
+
+} // namespace bisky::scene::MeshSimplifier
\ No newline at end of file
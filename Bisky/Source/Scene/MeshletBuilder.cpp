@@ -0,0 +1,271 @@
+#include "Scene/MeshOptimizer.hpp"
+#include "Scene/MeshletBuilder.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace bisky::scene::MeshletBuilder
+{
+
+namespace
+{
+
+constexpr uint32_t InvalidIndex = std::numeric_limits<uint32_t>::max();
+
+/*
+ * The triangles that use each vertex, stored as compressed rows.
+ * Each row keeps the triangles that haven't been emitted yet at its front.
+ */
+struct TriangleAdjacency
+{
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> liveCounts;
+    std::vector<uint32_t> triangles;
+};
+
+TriangleAdjacency buildAdjacency(std::span<const uint32_t> indices, uint32_t vertexCount)
+{
+    TriangleAdjacency adjacency;
+    adjacency.offsets.assign(vertexCount + 1u, 0u);
+    adjacency.triangles.resize(indices.size());
+
+    for (uint32_t index : indices)
+    {
+        adjacency.offsets[index + 1u]++;
+    }
+
+    adjacency.liveCounts.assign(adjacency.offsets.begin() + 1, adjacency.offsets.end());
+    std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin());
+
+    std::vector<uint32_t> written(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        adjacency.triangles[written[indices[i]]++] = static_cast<uint32_t>(i / 3u);
+    }
+
+    return adjacency;
+}
+
+void removeTriangle(TriangleAdjacency &adjacency, uint32_t vertex, uint32_t triangle)
+{
+    uint32_t *row  = adjacency.triangles.data() + adjacency.offsets[vertex];
+    uint32_t &live = adjacency.liveCounts[vertex];
+    for (uint32_t i = 0; i < live; i++)
+    {
+        if (row[i] == triangle)
+        {
+            std::swap(row[i], row[live - 1u]);
+            live--;
+            return;
+        }
+    }
+}
+
+} // namespace
+
+uint32_t build(std::span<const Vertex> vertices, std::span<uint32_t> indices, std::vector<Meshlet> &meshlets)
+{
+    const uint32_t triangleCount = static_cast<uint32_t>(indices.size() / 3u);
+    if (triangleCount == 0u)
+    {
+        return 0u;
+    }
+
+    const uint32_t    vertexCount = *std::max_element(indices.begin(), indices.end()) + 1u;
+    TriangleAdjacency adjacency   = buildAdjacency(indices, vertexCount);
+
+    // -------------- triangle centroids to keep meshlets compact --------------
+    std::vector<dx::XMFLOAT3> centroids(triangleCount);
+    for (uint32_t t = 0; t < triangleCount; t++)
+    {
+        dx::XMVECTOR sum = dx::XMVectorZero();
+        for (uint32_t k = 0; k < 3u; k++)
+        {
+            sum = dx::XMVectorAdd(sum, dx::XMLoadFloat3(&vertices[indices[t * 3u + k]].position));
+        }
+
+        dx::XMStoreFloat3(&centroids[t], dx::XMVectorScale(sum, 1.0f / 3.0f));
+    }
+
+    // -------------- grow meshlets until every triangle has been emitted --------------
+    std::vector<bool>     emitted(triangleCount, false);
+    std::vector<uint32_t> marker(vertexCount, InvalidIndex); // the meshlet that last used each vertex
+    std::vector<uint32_t> localIndices(vertexCount);          // the vertex's index inside of that meshlet
+    std::vector<uint32_t> meshletVertices;
+    std::vector<uint32_t> order;
+    order.reserve(indices.size());
+    meshletVertices.reserve(MaxVertices);
+
+    const uint32_t firstMeshlet = static_cast<uint32_t>(meshlets.size());
+    uint32_t       seed         = 0u;
+    while (true)
+    {
+        // the next unemitted triangle in the original order, which is usually close to the last meshlet
+        while (seed < triangleCount && emitted[seed])
+            seed++;
+
+        if (seed == triangleCount)
+            break;
+
+        const uint32_t id          = static_cast<uint32_t>(meshlets.size()) - firstMeshlet;
+        const uint32_t start       = static_cast<uint32_t>(order.size());
+        dx::XMVECTOR   centroidSum = dx::XMVectorZero();
+        uint32_t       triangles   = 0u;
+        meshletVertices.clear();
+
+        uint32_t next = seed;
+        while (next != InvalidIndex)
+        {
+            // -------------- add the triangle --------------
+            emitted[next] = true;
+            for (uint32_t k = 0; k < 3u; k++)
+            {
+                const uint32_t v = indices[next * 3u + k];
+                removeTriangle(adjacency, v, next);
+                if (marker[v] != id)
+                {
+                    marker[v]       = id;
+                    localIndices[v] = static_cast<uint32_t>(meshletVertices.size());
+                    meshletVertices.push_back(v);
+                }
+
+                order.push_back(localIndices[v]);
+            }
+
+            centroidSum = dx::XMVectorAdd(centroidSum, dx::XMLoadFloat3(&centroids[next]));
+            triangles++;
+            if (triangles == MaxTriangles)
+                break;
+
+            // -------------- pick the neighbour with the fewest new vertices, then the closest one --------------
+            const dx::XMVECTOR center       = dx::XMVectorScale(centroidSum, 1.0f / triangles);
+            uint32_t           bestExtra    = 4u;
+            float              bestDistance = std::numeric_limits<float>::max();
+            next                            = InvalidIndex;
+            for (uint32_t v : meshletVertices)
+            {
+                const uint32_t *row = adjacency.triangles.data() + adjacency.offsets[v];
+                for (uint32_t i = 0; i < adjacency.liveCounts[v]; i++)
+                {
+                    const uint32_t t     = row[i];
+                    uint32_t       extra = 0u;
+                    for (uint32_t k = 0; k < 3u; k++)
+                    {
+                        extra += marker[indices[t * 3u + k]] != id ? 1u : 0u;
+                    }
+
+                    if (meshletVertices.size() + extra > MaxVertices || extra > bestExtra)
+                        continue;
+
+                    dx::XMVECTOR offset   = dx::XMVectorSubtract(dx::XMLoadFloat3(&centroids[t]), center);
+                    float        distance = dx::XMVectorGetX(dx::XMVector3LengthSq(offset));
+                    if (extra < bestExtra || distance < bestDistance)
+                    {
+                        next         = t;
+                        bestExtra    = extra;
+                        bestDistance = distance;
+                    }
+                }
+            }
+        }
+
+        // -------------- order the triangles for the vertex cache, then go back to mesh indices --------------
+        std::span<uint32_t> meshletIndices = std::span<uint32_t>(order).subspan(start);
+        MeshOptimizer::optimizeVertexCache(meshletIndices, static_cast<uint32_t>(meshletVertices.size()));
+        for (uint32_t &index : meshletIndices)
+        {
+            index = meshletVertices[index];
+        }
+
+        Meshlet meshlet            = computeBounds(vertices, meshletIndices);
+        meshlet.startIndexLocation = start;
+        meshlets.push_back(meshlet);
+    }
+
+    std::copy(order.begin(), order.end(), indices.begin());
+    return static_cast<uint32_t>(meshlets.size()) - firstMeshlet;
+}
+
+Meshlet computeBounds(std::span<const Vertex> vertices, std::span<const uint32_t> indices)
+{
+    Meshlet meshlet    = {};
+    meshlet.indexCount = static_cast<uint32_t>(indices.size());
+    meshlet.coneCutoff = 1.0f;
+    if (indices.empty())
+    {
+        return meshlet;
+    }
+
+    std::vector<uint32_t> unique(indices.begin(), indices.end());
+    std::sort(unique.begin(), unique.end());
+    unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+    meshlet.vertexCount = static_cast<uint32_t>(unique.size());
+
+    // -------------- bounding sphere around the center of the box --------------
+    dx::XMVECTOR minimum = dx::XMLoadFloat3(&vertices[unique[0]].position);
+    dx::XMVECTOR maximum = minimum;
+    for (uint32_t v : unique)
+    {
+        minimum = dx::XMVectorMin(minimum, dx::XMLoadFloat3(&vertices[v].position));
+        maximum = dx::XMVectorMax(maximum, dx::XMLoadFloat3(&vertices[v].position));
+    }
+
+    dx::XMVECTOR center = dx::XMVectorScale(dx::XMVectorAdd(minimum, maximum), 0.5f);
+    for (uint32_t v : unique)
+    {
+        dx::XMVECTOR offset = dx::XMVectorSubtract(dx::XMLoadFloat3(&vertices[v].position), center);
+        meshlet.radius      = std::max(meshlet.radius, dx::XMVectorGetX(dx::XMVector3Length(offset)));
+    }
+
+    dx::XMStoreFloat3(&meshlet.center, center);
+
+    // -------------- normal cone around the average face normal --------------
+    std::vector<dx::XMFLOAT3> normals;
+    normals.reserve(indices.size() / 3u);
+    for (size_t i = 0; i + 2u < indices.size(); i += 3u)
+    {
+        dx::XMVECTOR a      = dx::XMLoadFloat3(&vertices[indices[i]].position);
+        dx::XMVECTOR b      = dx::XMLoadFloat3(&vertices[indices[i + 1u]].position);
+        dx::XMVECTOR c      = dx::XMLoadFloat3(&vertices[indices[i + 2u]].position);
+        dx::XMVECTOR normal = dx::XMVector3Cross(dx::XMVectorSubtract(b, a), dx::XMVectorSubtract(c, a));
+
+        // degenerate triangles are never rasterized, so they don't widen the cone
+        if (dx::XMVectorGetX(dx::XMVector3LengthSq(normal)) > 0.0f)
+        {
+            dx::XMStoreFloat3(&normals.emplace_back(), dx::XMVector3Normalize(normal));
+        }
+    }
+
+    dx::XMVECTOR axis = dx::XMVectorZero();
+    for (auto &normal : normals)
+    {
+        axis = dx::XMVectorAdd(axis, dx::XMLoadFloat3(&normal));
+    }
+
+    if (normals.empty() || dx::XMVectorGetX(dx::XMVector3LengthSq(axis)) < 1e-12f)
+    {
+        return meshlet;
+    }
+
+    axis             = dx::XMVector3Normalize(axis);
+    float minimumDot = 1.0f;
+    for (auto &normal : normals)
+    {
+        minimumDot = std::min(minimumDot, dx::XMVectorGetX(dx::XMVector3Dot(dx::XMLoadFloat3(&normal), axis)));
+    }
+
+    dx::XMStoreFloat3(&meshlet.coneAxis, axis);
+
+    // a cone wider than a hemisphere always has a triangle facing the camera
+    if (minimumDot > 0.0f)
+    {
+        meshlet.coneCutoff = std::sqrt(1.0f - minimumDot * minimumDot);
+    }
+
+    return meshlet;
+}
+
+} // namespace bisky::scene::MeshletBuilder
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "Scene/MeshletCuller.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace bisky::scene::MeshletCuller
+{
+
+Frustum getFrustum(dx::FXMMATRIX viewProjection)
+{
+    // -------------- points are row vectors, so the planes come from the columns --------------
+    dx::XMMATRIX columns = dx::XMMatrixTranspose(viewProjection);
+
+    std::array<dx::XMVECTOR, 6> planes = {
+        dx::XMVectorAdd(columns.r[3], columns.r[0]),      // left
+        dx::XMVectorSubtract(columns.r[3], columns.r[0]), // right
+        dx::XMVectorAdd(columns.r[3], columns.r[1]),      // bottom
+        dx::XMVectorSubtract(columns.r[3], columns.r[1]), // top
+        columns.r[2],                                     // near
+        dx::XMVectorSubtract(columns.r[3], columns.r[2]), // far
+    };
+
+    Frustum frustum;
+    for (size_t i = 0; i < planes.size(); i++)
+    {
+        dx::XMStoreFloat4(&frustum.planes[i], dx::XMPlaneNormalize(planes[i]));
+    }
+
+    return frustum;
+}
+
+MeshletCullData prepare(
+    const Frustum &frustum, dx::FXMMATRIX world, dx::CXMMATRIX worldToLocal, dx::FXMVECTOR cameraPosition
+)
+{
+    // uniform within a percent is close enough for the cones
+    constexpr float UniformScaleTolerance = 1.01f;
+
+    MeshletCullData data;
+
+    // -------------- dot(plane * transpose(world), local) == dot(plane, local * world) --------------
+    dx::XMMATRIX transposed = dx::XMMatrixTranspose(world);
+    for (size_t i = 0; i < std::size(frustum.planes); i++)
+    {
+        dx::XMStoreFloat4(&data.planes[i], dx::XMVector4Transform(dx::XMLoadFloat4(&frustum.planes[i]), transposed));
+    }
+
+    // -------------- the camera in local space for the cone test --------------
+    dx::XMStoreFloat3(&data.cameraPosition, dx::XMVector3Transform(cameraPosition, worldToLocal));
+
+    const float scaleX  = dx::XMVectorGetX(dx::XMVector3Length(world.r[0]));
+    const float scaleY  = dx::XMVectorGetX(dx::XMVector3Length(world.r[1]));
+    const float scaleZ  = dx::XMVectorGetX(dx::XMVector3Length(world.r[2]));
+    const float minimum = std::min({scaleX, scaleY, scaleZ});
+
+    data.scale       = std::max({scaleX, scaleY, scaleZ});
+    data.coneCulling = minimum > 0.0f && data.scale <= minimum * UniformScaleTolerance;
+    return data;
+}
+
+bool isVisible(const Meshlet &meshlet, const MeshletCullData &data)
+{
+    dx::XMVECTOR center = dx::XMVectorSetW(dx::XMLoadFloat3(&meshlet.center), 1.0f);
+
+    // -------------- frustum --------------
+    const float radius = meshlet.radius * data.scale;
+    for (auto &plane : data.planes)
+    {
+        if (dx::XMVectorGetX(dx::XMVector4Dot(dx::XMLoadFloat4(&plane), center)) < -radius)
+        {
+            return false;
+        }
+    }
+
+    // -------------- normal cone --------------
+    if (data.coneCulling && meshlet.coneCutoff < 1.0f)
+    {
+        dx::XMVECTOR view     = dx::XMVectorSubtract(center, dx::XMLoadFloat3(&data.cameraPosition));
+        const float  distance = dx::XMVectorGetX(dx::XMVector3Length(view));
+        const float  facing   = dx::XMVectorGetX(dx::XMVector3Dot(view, dx::XMLoadFloat3(&meshlet.coneAxis)));
+        if (facing >= meshlet.coneCutoff * distance + meshlet.radius)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+} // namespace bisky::scene::MeshletCuller
\ No newline at end of file
@@ -1,6 +0,0 @@
-#include "Common.hpp"
-
-#include "Graphics/Texture.hpp"
-#include "Scene/Material.hpp"
-#include "Scene/Mesh.hpp"
-#include "Scene/RenderObject.hpp"
\ No newline at end of file
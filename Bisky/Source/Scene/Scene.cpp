@@ -7,6 +7,7 @@
 #include "Graphics/ResourceUpload.hpp"
 #include "Graphics/Utilities.hpp"
 #include "Graphics/Window.hpp"
+#include "Scene/Mesh.hpp"
 #include "Scene/Scene.hpp"
 #include "Scene/ScreenQuad.hpp"
 
@@ -16,6 +17,8 @@ namespace bisky::scene
 Scene::Scene(gfx::Window *const window, gfx::Device *const device, std::string_view name)
     : m_name(name), m_device(device), m_window(window)
 {
+    m_transforms    = std::make_unique<gfx::TransformStorage>();
+    m_entities      = std::make_unique<EntityRegistry>();
     m_camera        = std::make_unique<Camera>(window->getAspectRatio(), 0.1f, 100.0f);
     m_arcballCamera = std::make_unique<ArcballCamera>(window->getWidth(), window->getHeight());
 
@@ -31,20 +34,99 @@ Scene::Scene(gfx::Window *const window, gfx::Device *const device, std::string_v
 Scene::~Scene()
 {
     m_skybox.reset();
-    m_renderObjects.clear();
+    m_entities.reset();
     m_arcballCamera.reset();
     m_camera.reset();
+    m_transforms.reset();
 }
 
 void Scene::update(const core::GameTimer *const timer)
 {
     m_camera->input(timer);
     m_camera->updateViewMatrix();
+
+    // -------------- rebuild the matrices of every block of transforms that changed, 8 at a time --------------
+    m_transforms->update();
+
+    // -------------- a moved entity's bounds follow it, and its constants are uploaded again --------------
+    m_entities->parallelForEach<gfx::Transform, const MeshInstance, Bounds, RenderFlags>(
+        [](const Entity *, uint32_t count, gfx::Transform *transforms, const MeshInstance *instances, Bounds *bounds,
+           RenderFlags *flags) {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                if (!transforms[i].takeChanged())
+                {
+                    continue;
+                }
+
+                // the largest scale of any axis, the same as BoundingSphere::Transform
+                const dx::XMMATRIX world  = transforms[i].getLocalToWorld();
+                const Mesh        &mesh   = *instances[i].mesh;
+                const dx::XMVECTOR center = dx::XMVector3Transform(dx::XMLoadFloat3(&mesh.bounds.center), world);
+                const dx::XMVECTOR scale  = dx::XMVectorMax(
+                    dx::XMVector3LengthSq(world.r[0]),
+                    dx::XMVectorMax(dx::XMVector3LengthSq(world.r[1]), dx::XMVector3LengthSq(world.r[2]))
+                );
+
+                dx::XMStoreFloat3(&bounds[i].center, center);
+                bounds[i].radius        = mesh.bounds.radius * std::sqrt(dx::XMVectorGetX(scale));
+                flags[i].numFramesDirty = gfx::Device::FramesInFlight;
+            }
+        }
+    );
+}
+
+bool Scene::loadModel(const std::filesystem::path &filename, uint32_t parent)
+{
+    std::vector<core::ModelNode> nodes;
+    if (!core::ResourceManager::get().loadMesh(m_device, filename, VertexFormat::Packed, &nodes))
+    {
+        return false;
+    }
+
+    // -------------- parents come first, so their transforms always exist before their children's --------------
+    std::vector<uint32_t> transforms(nodes.size());
+    size_t                entityCount = 0u;
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        auto          &node      = nodes[i];
+        gfx::Transform transform = m_transforms->create(node.parent >= 0 ? transforms[node.parent] : parent);
+        transform.setScale(node.scale.x, node.scale.y, node.scale.z);
+        transform.setRotation(node.rotation.x, node.rotation.y, node.rotation.z);
+        transform.setTranslation(node.translation.x, node.translation.y, node.translation.z);
+        transforms[i] = transform.getIndex();
+
+        if (!node.mesh)
+        {
+            continue;
+        }
+
+        const Entity entity = m_entities->create(transform, MeshInstance{.mesh = node.mesh}, Bounds{}, RenderFlags{});
+        if (m_names.size() <= entity.index)
+        {
+            m_names.resize(entity.index + 1u);
+        }
+        m_names[entity.index] = node.name.empty() ? "Entity" : node.name;
+        entityCount++;
+    }
+
+    LOG_INFO(fmt::format("Added {} entities for the {} nodes of {}", entityCount, nodes.size(), filename.string()));
+    return true;
 }
 
-const std::vector<std::shared_ptr<RenderObject>> &Scene::getRenderObjects() const
+EntityRegistry *const Scene::getEntities() const
 {
-    return m_renderObjects;
+    return m_entities.get();
+}
+
+std::string_view Scene::getName(Entity entity) const
+{
+    return entity.index < m_names.size() ? std::string_view(m_names[entity.index]) : std::string_view();
+}
+
+gfx::TransformStorage *const Scene::getTransforms() const
+{
+    return m_transforms.get();
 }
 
 Camera *const Scene::getCamera() const
@@ -71,14 +153,10 @@ void Scene::initDefaultScene()
 {
     m_camera->setPosition(0.0f, 0.0f, -5.0f);
 
-    if (core::ResourceManager::get().loadMesh(m_device, "DamagedHelmet.glb"))
-    {
-        auto ro  = m_renderObjects.emplace_back(std::make_shared<RenderObject>());
-        ro->mesh = core::ResourceManager::get().getMesh("mesh_helmet_LP_13930damagedHelmet");
-        ro->transform->setScale(1.0f, 1.0f, 1.0f);
-        ro->transform->setRotation(90.0f, 0.0f, 180.0f);
-        LOG_INFO("Added new render object");
-    }
+    // -------------- the helmet's node stands it up facing +z, turn it around to face the camera --------------
+    gfx::Transform helmet = m_transforms->create();
+    helmet.setRotation(0.0f, 180.0f, 0.0f);
+    loadModel("DamagedHelmet.glb", helmet.getIndex());
 
     auto &light = m_lights.emplace_back();
     XMStoreFloat4(&light.position, dx::FXMVECTOR{0.0f, 3.0f, -3.0f, 1.0f});
@@ -0,0 +1,408 @@
+#include "Scene/VertexQuantizer.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+#include <emmintrin.h>
+
+namespace bisky::scene::VertexQuantizer
+{
+
+namespace
+{
+
+static_assert(sizeof(Vertex) == 12u * sizeof(float));
+
+constexpr float UnormMax = 65535.0f;
+constexpr float SnormMax = 32767.0f;
+
+/*
+ * The scale that takes an offset from the bounds minimum to a unorm16 value.
+ */
+dx::XMFLOAT3 getInverseScale(const QuantizationBounds &bounds)
+{
+    auto inverse = [](float scale) { return scale > 0.0f ? 1.0f / scale : 0.0f; };
+    return {inverse(bounds.scale.x), inverse(bounds.scale.y), inverse(bounds.scale.z)};
+}
+
+uint16_t toUnorm16(float value, float min, float inverseScale)
+{
+    return static_cast<uint16_t>(std::lrint(std::clamp((value - min) * inverseScale, 0.0f, UnormMax)));
+}
+
+int16_t toSnorm16(float value)
+{
+    return static_cast<int16_t>(std::lrint(std::clamp(value, -1.0f, 1.0f) * SnormMax));
+}
+
+float fromSnorm16(int16_t value)
+{
+    return std::max(value / SnormMax, -1.0f);
+}
+
+/*
+ * Round to nearest even float to half conversion, the SSE2 version below mirrors every step.
+ */
+uint16_t toHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    const uint32_t sign = bits & 0x80000000u;
+    bits ^= sign;
+
+    uint32_t half;
+    if (bits >= 0x47800000u)
+    {
+        // -------------- too large for a half, infinity or NaN --------------
+        half = bits > 0x7F800000u ? 0x7E00u : 0x7C00u;
+    }
+    else if (bits < 0x38800000u)
+    {
+        // -------------- subnormal half, let the float adder do the rounding --------------
+        const uint32_t magicBits = 0x3F000000u;
+        float          magic;
+        memcpy(&magic, &magicBits, sizeof(magic));
+
+        float absolute;
+        memcpy(&absolute, &bits, sizeof(absolute));
+        absolute += magic;
+        memcpy(&half, &absolute, sizeof(half));
+        half -= magicBits;
+    }
+    else
+    {
+        // -------------- normal half, rebias the exponent and round the mantissa --------------
+        const uint32_t mantissaOdd = (bits >> 13u) & 1u;
+        bits += 0xC8000FFFu;
+        bits += mantissaOdd;
+        half = bits >> 13u;
+    }
+
+    return static_cast<uint16_t>(half | (sign >> 16u));
+}
+
+float fromHalf(uint16_t half)
+{
+    const uint32_t sign     = (half & 0x8000u) << 16u;
+    const uint32_t exponent = (half >> 10u) & 0x1Fu;
+    const uint32_t mantissa = half & 0x3FFu;
+
+    float value;
+    if (exponent == 0u)
+        value = std::ldexp(static_cast<float>(mantissa), -24);
+    else if (exponent == 0x1Fu)
+        value = mantissa == 0u ? std::numeric_limits<float>::infinity() : std::numeric_limits<float>::quiet_NaN();
+    else
+        value = std::ldexp(static_cast<float>(mantissa | 0x400u), static_cast<int>(exponent) - 25);
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    bits |= sign;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+/*
+ * Projects a direction onto the octahedron and unfolds the lower half over the upper half.
+ */
+void toOctahedral(float x, float y, float z, int16_t *const encoded)
+{
+    const float length  = std::abs(x) + std::abs(y) + std::abs(z);
+    const float inverse = length > 0.0f ? 1.0f / length : 0.0f;
+
+    float u = x * inverse;
+    float v = y * inverse;
+    if (z < 0.0f)
+    {
+        const float foldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+        const float foldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+        u                   = foldedU;
+        v                   = foldedV;
+    }
+
+    encoded[0] = toSnorm16(u);
+    encoded[1] = toSnorm16(v);
+}
+
+dx::XMFLOAT3 fromOctahedral(const int16_t *const encoded)
+{
+    float x = fromSnorm16(encoded[0]);
+    float y = fromSnorm16(encoded[1]);
+    float z = 1.0f - std::abs(x) - std::abs(y);
+
+    const float t = std::max(-z, 0.0f);
+    x += x >= 0.0f ? -t : t;
+    y += y >= 0.0f ? -t : t;
+
+    const float length = std::sqrt(x * x + y * y + z * z);
+    return {x / length, y / length, z / length};
+}
+
+void encodeVertex(
+    const Vertex &vertex, const QuantizationBounds &bounds, const dx::XMFLOAT3 &inverseScale, PackedVertex &packed
+)
+{
+    packed.position[0] = toUnorm16(vertex.position.x, bounds.min.x, inverseScale.x);
+    packed.position[1] = toUnorm16(vertex.position.y, bounds.min.y, inverseScale.y);
+    packed.position[2] = toUnorm16(vertex.position.z, bounds.min.z, inverseScale.z);
+    packed.tangentSign = vertex.tangent.w < 0.0f ? 1u : 0u;
+    toOctahedral(vertex.normal.x, vertex.normal.y, vertex.normal.z, packed.normal);
+    toOctahedral(vertex.tangent.x, vertex.tangent.y, vertex.tangent.z, packed.tangent);
+    packed.texCoord[0] = toHalf(vertex.texCoord.x);
+    packed.texCoord[1] = toHalf(vertex.texCoord.y);
+}
+
+// -------------- SSE2 versions of the helpers above, one vertex per lane --------------
+
+__m128i toUnorm16x4(__m128 value, float min, float inverseScale)
+{
+    __m128 scaled = _mm_mul_ps(_mm_sub_ps(value, _mm_set1_ps(min)), _mm_set1_ps(inverseScale));
+    scaled        = _mm_min_ps(_mm_max_ps(scaled, _mm_setzero_ps()), _mm_set1_ps(UnormMax));
+    return _mm_cvtps_epi32(scaled);
+}
+
+__m128i toSnorm16x4(__m128 value)
+{
+    __m128 clamped = _mm_min_ps(_mm_max_ps(value, _mm_set1_ps(-1.0f)), _mm_set1_ps(1.0f));
+    return _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(clamped, _mm_set1_ps(SnormMax))), _mm_set1_epi32(0xFFFF));
+}
+
+__m128i toHalfx4(__m128 value)
+{
+    const __m128i signMask = _mm_set1_epi32(static_cast<int>(0x80000000u));
+    const __m128i magic    = _mm_set1_epi32(0x3F000000);
+
+    const __m128i bits     = _mm_castps_si128(value);
+    const __m128i sign     = _mm_and_si128(bits, signMask);
+    const __m128i absolute = _mm_xor_si128(bits, sign);
+
+    // -------------- infinity or NaN --------------
+    const __m128i isNaN    = _mm_cmpgt_epi32(absolute, _mm_set1_epi32(0x7F800000));
+    const __m128i special  = _mm_or_si128(_mm_set1_epi32(0x7C00), _mm_and_si128(isNaN, _mm_set1_epi32(0x0200)));
+    const __m128i isNormal = _mm_cmpgt_epi32(_mm_set1_epi32(0x47800000), absolute);
+
+    // -------------- subnormal --------------
+    const __m128  subnormalSum = _mm_add_ps(_mm_castsi128_ps(absolute), _mm_castsi128_ps(magic));
+    const __m128i subnormal    = _mm_sub_epi32(_mm_castps_si128(subnormalSum), magic);
+    const __m128i isSubnormal  = _mm_cmpgt_epi32(_mm_set1_epi32(0x38800000), absolute);
+
+    // -------------- normal --------------
+    const __m128i rebias      = _mm_set1_epi32(static_cast<int>(0xC8000FFFu));
+    const __m128i mantissaOdd = _mm_and_si128(_mm_srli_epi32(absolute, 13), _mm_set1_epi32(1));
+    const __m128i rounded     = _mm_add_epi32(_mm_add_epi32(absolute, rebias), mantissaOdd);
+    const __m128i normal      = _mm_srli_epi32(rounded, 13);
+
+    __m128i half = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+    half         = _mm_or_si128(_mm_and_si128(isNormal, half), _mm_andnot_si128(isNormal, special));
+    return _mm_or_si128(half, _mm_srli_epi32(sign, 16));
+}
+
+void toOctahedralx4(__m128 x, __m128 y, __m128 z, __m128i &u16, __m128i &v16)
+{
+    const __m128 absMask  = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+    const __m128 one      = _mm_set1_ps(1.0f);
+    const __m128 minusOne = _mm_set1_ps(-1.0f);
+    const __m128 zero     = _mm_setzero_ps();
+
+    const __m128 absXY   = _mm_add_ps(_mm_and_ps(x, absMask), _mm_and_ps(y, absMask));
+    const __m128 length  = _mm_add_ps(absXY, _mm_and_ps(z, absMask));
+    const __m128 inverse = _mm_and_ps(_mm_cmpgt_ps(length, zero), _mm_div_ps(one, length));
+
+    const __m128 u = _mm_mul_ps(x, inverse);
+    const __m128 v = _mm_mul_ps(y, inverse);
+
+    auto         signOf  = [&](__m128 value) {
+        const __m128 positive = _mm_cmpge_ps(value, zero);
+        return _mm_or_ps(_mm_and_ps(positive, one), _mm_andnot_ps(positive, minusOne));
+    };
+    const __m128 foldedU = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(v, absMask)), signOf(u));
+    const __m128 foldedV = _mm_mul_ps(_mm_sub_ps(one, _mm_and_ps(u, absMask)), signOf(v));
+
+    const __m128 lower = _mm_cmplt_ps(z, zero);
+    u16                = toSnorm16x4(_mm_or_ps(_mm_and_ps(lower, foldedU), _mm_andnot_ps(lower, u)));
+    v16                = toSnorm16x4(_mm_or_ps(_mm_and_ps(lower, foldedV), _mm_andnot_ps(lower, v)));
+}
+
+__m128i pack16x2(__m128i low, __m128i high)
+{
+    return _mm_or_si128(low, _mm_slli_epi32(high, 16));
+}
+
+} // namespace
+
+QuantizationBounds computeBounds(std::span<const Vertex> vertices)
+{
+    if (vertices.empty())
+    {
+        return {};
+    }
+
+    dx::XMFLOAT3 min = vertices[0].position;
+    dx::XMFLOAT3 max = vertices[0].position;
+    for (auto &vertex : vertices)
+    {
+        const dx::XMFLOAT3 &p = vertex.position;
+
+        min = {std::min(min.x, p.x), std::min(min.y, p.y), std::min(min.z, p.z)};
+        max = {std::max(max.x, p.x), std::max(max.y, p.y), std::max(max.z, p.z)};
+    }
+
+    return {
+        .min   = min,
+        .scale = {(max.x - min.x) / UnormMax, (max.y - min.y) / UnormMax, (max.z - min.z) / UnormMax},
+    };
+}
+
+void encode(std::span<const Vertex> vertices, const QuantizationBounds &bounds, std::span<PackedVertex> packed)
+{
+    const dx::XMFLOAT3 inverseScale = getInverseScale(bounds);
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        encodeVertex(vertices[i], bounds, inverseScale, packed[i]);
+    }
+}
+
+void encodeSimd(std::span<const Vertex> vertices, const QuantizationBounds &bounds, std::span<PackedVertex> packed)
+{
+    const dx::XMFLOAT3 inverseScale = getInverseScale(bounds);
+
+    size_t i = 0;
+    for (; i + 4u <= vertices.size(); i += 4u)
+    {
+        // -------------- load four vertices as three rows of four floats each --------------
+        // the registers are named after what they hold once transposed
+        const float *source = reinterpret_cast<const float *>(&vertices[i]);
+        __m128       px     = _mm_loadu_ps(source + 0u);
+        __m128       py     = _mm_loadu_ps(source + 12u);
+        __m128       pz     = _mm_loadu_ps(source + 24u);
+        __m128       nx     = _mm_loadu_ps(source + 36u);
+        __m128       ny     = _mm_loadu_ps(source + 4u);
+        __m128       nz     = _mm_loadu_ps(source + 16u);
+        __m128       u      = _mm_loadu_ps(source + 28u);
+        __m128       v      = _mm_loadu_ps(source + 40u);
+        __m128       tx     = _mm_loadu_ps(source + 8u);
+        __m128       ty     = _mm_loadu_ps(source + 20u);
+        __m128       tz     = _mm_loadu_ps(source + 32u);
+        __m128       tw     = _mm_loadu_ps(source + 44u);
+
+        // -------------- transpose so each register holds one attribute of every vertex --------------
+        _MM_TRANSPOSE4_PS(px, py, pz, nx);
+        _MM_TRANSPOSE4_PS(ny, nz, u, v);
+        _MM_TRANSPOSE4_PS(tx, ty, tz, tw);
+
+        // -------------- encode --------------
+        const __m128i qx   = toUnorm16x4(px, bounds.min.x, inverseScale.x);
+        const __m128i qy   = toUnorm16x4(py, bounds.min.y, inverseScale.y);
+        const __m128i qz   = toUnorm16x4(pz, bounds.min.z, inverseScale.z);
+        const __m128i sign = _mm_and_si128(_mm_castps_si128(_mm_cmplt_ps(tw, _mm_setzero_ps())), _mm_set1_epi32(1));
+
+        __m128i normalU, normalV, tangentU, tangentV;
+        toOctahedralx4(nx, ny, nz, normalU, normalV);
+        toOctahedralx4(tx, ty, tz, tangentU, tangentV);
+
+        // -------------- pack into the five 32-bit words of a PackedVertex --------------
+        __m128 word0 = _mm_castsi128_ps(pack16x2(qx, qy));
+        __m128 word1 = _mm_castsi128_ps(pack16x2(qz, sign));
+        __m128 word2 = _mm_castsi128_ps(pack16x2(normalU, normalV));
+        __m128 word3 = _mm_castsi128_ps(pack16x2(tangentU, tangentV));
+        _MM_TRANSPOSE4_PS(word0, word1, word2, word3);
+
+        alignas(16) uint32_t word4[4];
+        _mm_store_si128(reinterpret_cast<__m128i *>(word4), pack16x2(toHalfx4(u), toHalfx4(v)));
+
+        const __m128 rows[4]     = {word0, word1, word2, word3};
+        uint8_t     *destination = reinterpret_cast<uint8_t *>(&packed[i]);
+        for (uint32_t k = 0; k < 4u; k++)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(destination), _mm_castps_si128(rows[k]));
+            memcpy(destination + 16u, &word4[k], sizeof(uint32_t));
+            destination += sizeof(PackedVertex);
+        }
+    }
+
+    // -------------- the rest one at a time --------------
+    for (; i < vertices.size(); i++)
+    {
+        encodeVertex(vertices[i], bounds, inverseScale, packed[i]);
+    }
+}
+
+Vertex decode(const PackedVertex &packed, const QuantizationBounds &bounds)
+{
+    Vertex vertex{};
+    vertex.position = {
+        bounds.min.x + packed.position[0] * bounds.scale.x,
+        bounds.min.y + packed.position[1] * bounds.scale.y,
+        bounds.min.z + packed.position[2] * bounds.scale.z,
+    };
+    vertex.normal   = fromOctahedral(packed.normal);
+    vertex.texCoord = {fromHalf(packed.texCoord[0]), fromHalf(packed.texCoord[1])};
+
+    dx::XMFLOAT3 tangent = fromOctahedral(packed.tangent);
+    vertex.tangent       = {tangent.x, tangent.y, tangent.z, packed.tangentSign ? -1.0f : 1.0f};
+    return vertex;
+}
+
+QuantizationReport measure(
+    std::span<const Vertex> vertices, std::span<const PackedVertex> packed, const QuantizationBounds &bounds
+)
+{
+    QuantizationReport report = {
+        .fullBytes   = vertices.size_bytes(),
+        .packedBytes = packed.size_bytes(),
+    };
+
+    // the angle between two directions in degrees, zero length source directions are skipped
+    auto angleBetween = [](float x, float y, float z, const dx::XMFLOAT3 &decoded) {
+        const float length = std::sqrt(x * x + y * y + z * z);
+        if (length == 0.0f)
+        {
+            return 0.0f;
+        }
+
+        const float cosine = (x * decoded.x + y * decoded.y + z * decoded.z) / length;
+        return std::acos(std::clamp(cosine, -1.0f, 1.0f)) * 180.0f / 3.14159265f;
+    };
+
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        const Vertex &source  = vertices[i];
+        const Vertex  decoded = decode(packed[i], bounds);
+
+        const float deltaX = decoded.position.x - source.position.x;
+        const float deltaY = decoded.position.y - source.position.y;
+        const float deltaZ = decoded.position.z - source.position.z;
+        const float deltaU = std::abs(decoded.texCoord.x - source.texCoord.x);
+        const float deltaV = std::abs(decoded.texCoord.y - source.texCoord.y);
+
+        const float        positionError  = std::sqrt(deltaX * deltaX + deltaY * deltaY + deltaZ * deltaZ);
+        const dx::XMFLOAT3 decodedTangent = {decoded.tangent.x, decoded.tangent.y, decoded.tangent.z};
+
+        report.maxPositionError = std::max(report.maxPositionError, positionError);
+        report.maxTexCoordError = std::max({report.maxTexCoordError, deltaU, deltaV});
+        report.maxNormalError   = std::max(
+            report.maxNormalError, angleBetween(source.normal.x, source.normal.y, source.normal.z, decoded.normal)
+        );
+        report.maxTangentError = std::max(
+            report.maxTangentError, angleBetween(source.tangent.x, source.tangent.y, source.tangent.z, decodedTangent)
+        );
+    }
+
+    return report;
+}
+
+bool fitsIn16Bits(std::span<const uint32_t> indices)
+{
+    return std::ranges::all_of(indices, [](uint32_t index) { return index < 0xFFFFu; });
+}
+
+void narrowIndices(std::span<const uint32_t> indices, std::span<uint16_t> narrowed)
+{
+    std::ranges::transform(indices, narrowed.begin(), [](uint32_t index) { return static_cast<uint16_t>(index); });
+}
+
+} // namespace bisky::scene::VertexQuantizer
\ No newline at end of file
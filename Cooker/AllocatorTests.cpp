@@ -0,0 +1,695 @@
+#include "AllocatorTests.hpp"
+#include "TestResult.hpp"
+
+#include "Core/Logger.hpp"
+#include "Graphics/FrameArena.hpp"
+#include "Graphics/OffsetAllocator.hpp"
+#include "Graphics/StagingRing.hpp"
+#include "Graphics/TlsfAllocator.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <deque>
+#include <iterator>
+#include <map>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace gfx = bisky::gfx;
+
+namespace
+{
+
+/*
+ * Allocates and frees at random with one allocator, keeping about a target number of blocks live.
+ *
+ * @param allocator The allocator, empty.
+ * @param iterations The number of allocations or frees.
+ * @return How long it took.
+ */
+template <typename Allocator, typename Allocation>
+std::chrono::microseconds timeChurn(Allocator &allocator, uint32_t iterations)
+{
+    constexpr size_t targetLive = 4096u;
+
+    std::mt19937                            random(13u);
+    std::uniform_int_distribution<uint64_t> size(4u * 1024u, 256u * 1024u);
+    std::uniform_int_distribution<uint32_t> largeAlignment(0u, 7u);
+
+    std::vector<Allocation> live;
+    live.reserve(targetLive * 2u);
+
+    const auto start = std::chrono::system_clock::now();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        // -------------- allocate below the target, free above it, either one around it --------------
+        const size_t freeChance = live.size() < targetLive / 2u ? 0u : (live.size() > targetLive ? 100u : 50u);
+        if (random() % 100u >= freeChance)
+        {
+            const uint64_t alignment = largeAlignment(random) == 0u ? 64u * 1024u : 4u * 1024u;
+            Allocation     allocation;
+            if (allocator.allocate(size(random), alignment, allocation))
+            {
+                live.push_back(allocation);
+            }
+        }
+        else
+        {
+            const size_t index = random() % live.size();
+            allocator.free(live[index]);
+            live[index] = live.back();
+            live.pop_back();
+        }
+    }
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start);
+}
+
+} // namespace
+
+bool testStagingRing()
+{
+    TestResult result = {.name = "StagingRing"};
+
+    // -------------- a region that doesn't fit before the end skips to the start --------------
+    {
+        gfx::StagingRing   ring(1024u);
+        gfx::StagingRegion a, b, c, d;
+        result.check(ring.allocate(512u, 1u, a) && a.offset == 0u, "the first region starts the ring");
+        result.check(ring.allocate(256u, 1u, b) && b.offset == 512u, "the second region follows the first");
+
+        ring.submit(a.sequence, 1u);
+        ring.submit(b.sequence, 2u);
+        ring.retire(1u);
+        result.check(ring.getRegionCount() == 1u, "the first region retires at its fence value");
+
+        result.check(ring.allocate(512u, 1u, c) && c.offset == 0u, "a region skips the end of the ring");
+        result.check(ring.getUsedBytes() == 1024u, "the skipped space counts as used");
+        result.check(!ring.allocate(1u, 1u, d), "a full ring has no room");
+
+        // -------------- an unsubmitted region holds back retirement until it's cancelled --------------
+        result.check(ring.getOldestFenceValue() == 2u, "the oldest fence value is the second region's");
+        ring.retire(100u);
+        result.check(ring.getRegionCount() == 1u, "retiring stops at the unsubmitted region");
+        result.check(ring.getOldestFenceValue() == 0u, "an unsubmitted region has no fence value");
+
+        ring.cancel(c.sequence);
+        ring.retire(0u);
+        result.check(ring.getRegionCount() == 0u, "a cancelled region retires without the fence");
+        result.check(ring.getUsedBytes() == 0u, "an empty ring starts over");
+    }
+
+    // -------------- at random, with a counter as the fence --------------
+    {
+        constexpr uint64_t capacity   = 1ull << 20;
+        constexpr uint32_t iterations = 200000u;
+
+        struct Region
+        {
+            uint64_t offset;
+            uint64_t size;
+            uint64_t fenceValue;
+            bool     submitted;
+        };
+
+        std::mt19937                            random(7u);
+        std::uniform_int_distribution<uint32_t> operation(0u, 9u);
+        std::uniform_int_distribution<uint64_t> size(1u, 64u * 1024u);
+        std::uniform_int_distribution<uint32_t> alignmentShift(0u, 9u);
+
+        gfx::StagingRing      ring(capacity);
+        std::deque<Region>    live; // the model, in allocation order like the ring
+        std::vector<uint64_t> unsubmitted;
+        uint64_t              firstSequence = 0u;
+        uint64_t              signaled      = 0u;
+        uint64_t              completed     = 0u;
+
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            const uint32_t op = operation(random);
+            if (op < 6u)
+            {
+                // -------------- allocate, the region must be aligned and overlap nothing live --------------
+                const uint64_t     regionSize = size(random);
+                const uint64_t     alignment  = 1ull << alignmentShift(random);
+                gfx::StagingRegion region;
+                if (!ring.allocate(regionSize, alignment, region))
+                {
+                    result.check(!live.empty(), "an empty ring fits anything smaller than it");
+                    continue;
+                }
+
+                result.check(region.sequence == firstSequence + live.size(), "sequences count up");
+                result.check(region.offset % alignment == 0u, "the offset is aligned");
+                result.check(region.offset + regionSize <= capacity, "the region ends inside of the ring");
+
+                bool overlaps = false;
+                for (const Region &other : live)
+                {
+                    overlaps |= region.offset < other.offset + other.size && other.offset < region.offset + regionSize;
+                }
+                result.check(!overlaps, "a new region doesn't overlap a live one");
+
+                live.push_back({.offset = region.offset, .size = regionSize, .fenceValue = 0u, .submitted = false});
+                unsubmitted.push_back(region.sequence);
+            }
+            else if (op < 8u)
+            {
+                // -------------- submit everything recorded so far, cancelling a tenth of it --------------
+                signaled++;
+                for (uint64_t sequence : unsubmitted)
+                {
+                    Region &region   = live[sequence - firstSequence];
+                    region.submitted = true;
+                    if (random() % 10u == 0u)
+                    {
+                        ring.cancel(sequence);
+                        region.fenceValue = 0u;
+                    }
+                    else
+                    {
+                        ring.submit(sequence, signaled);
+                        region.fenceValue = signaled;
+                    }
+                }
+                unsubmitted.clear();
+            }
+            else
+            {
+                // -------------- the fence moves forward some of the way and the ring catches up --------------
+                completed = std::uniform_int_distribution<uint64_t>(completed, signaled)(random);
+                ring.retire(completed);
+
+                while (!live.empty() && live.front().submitted && live.front().fenceValue <= completed)
+                {
+                    live.pop_front();
+                    firstSequence++;
+                }
+
+                result.check(ring.getRegionCount() == live.size(), "the ring retires what the model does");
+                const uint64_t oldest = !live.empty() && live.front().submitted ? live.front().fenceValue : 0u;
+                result.check(ring.getOldestFenceValue() == oldest, "the oldest fence value is the model's");
+            }
+
+            result.check(ring.getUsedBytes() <= capacity, "the used bytes fit in the ring");
+        }
+    }
+
+    return result.report();
+}
+
+bool testFrameArena()
+{
+    TestResult result = {.name = "FrameArena"};
+
+    constexpr uint64_t KB = 1024u;
+
+    // -------------- the padding for alignment is wasted, not used --------------
+    {
+        gfx::FrameArena  arena(64u * KB);
+        gfx::ArenaRegion a = arena.allocate(3u, 1u);
+        gfx::ArenaRegion b = arena.allocate(256u, 256u);
+        result.check(a.page == 0u && a.offset == 0u, "the first region starts the base page");
+        result.check(b.page == 0u && b.offset == 256u, "the offset is aligned");
+
+        const gfx::ArenaFrameStats &stats = arena.getFrameStats();
+        result.check(stats.usedBytes == 259u, "the used bytes are what was asked for");
+        result.check(stats.wastedBytes == 253u, "the space skipped to align is wasted");
+        result.check(stats.pageCount == 1u, "the frame touched one page");
+    }
+
+    // -------------- overflow pages chain on, each twice the last or as big as the region --------------
+    {
+        gfx::FrameArena arena(64u * KB);
+        arena.allocate(48u * KB, 16u);
+        gfx::ArenaRegion a = arena.allocate(32u * KB, 16u);
+        result.check(a.page == 1u && a.offset == 0u, "a region that doesn't fit starts an overflow page");
+        result.check(arena.getPageSize(1u) == 128u * KB, "the first overflow page is twice the base page");
+        result.check(arena.getFrameStats().wastedBytes == 16u * KB, "the end of the base page is wasted");
+
+        gfx::ArenaRegion b = arena.allocate(200u * KB, 16u);
+        result.check(b.page == 2u && arena.getPageSize(2u) == 256u * KB, "the next overflow page doubles again");
+
+        gfx::ArenaRegion c = arena.allocate(600u * KB, 16u);
+        result.check(c.page == 3u, "a region bigger than the next page gets a page of its own");
+        result.check(arena.getPageSize(3u) == 640u * KB, "the page is the region rounded up to the page granularity");
+        result.check(arena.getPageCount() == 4u && arena.getFrameStats().pageCount == 4u, "the frame touched 4 pages");
+
+        // -------------- the next frame starts on a base page that fits the busy one --------------
+        const uint64_t went = arena.getFrameStats().usedBytes + arena.getFrameStats().wastedBytes;
+        arena.reset();
+        result.check(arena.getHighWater() == went, "the high water is what the busy frame went through");
+        result.check(arena.getPageCount() == 1u, "the overflow pages are dropped");
+        const uint64_t grown = (went + went / 4u + 64u * KB - 1u) / (64u * KB) * (64u * KB);
+        result.check(arena.getBaseSize() == grown, "the base grows to the busy frame with a quarter to spare");
+        result.check(arena.getLastFrameStats().pageCount == 4u, "the last frame's stats are kept");
+
+        gfx::ArenaRegion d = arena.allocate(went, 16u);
+        result.check(d.page == 0u && d.offset == 0u, "the busy frame fits in the base page now");
+    }
+
+    // -------------- shrinks only after a full history of quiet frames --------------
+    {
+        gfx::FrameArena arena(1024u * KB, 128u * KB);
+        for (uint32_t frame = 0; frame < gfx::FrameArena::HistoryLength - 1u; frame++)
+        {
+            arena.allocate(16u * KB, 16u);
+            arena.reset();
+        }
+        result.check(arena.getBaseSize() == 1024u * KB, "the base doesn't shrink before the history is full");
+
+        arena.allocate(16u * KB, 16u);
+        arena.reset();
+        result.check(arena.getBaseSize() == 128u * KB, "the base shrinks, but not below the minimum");
+
+        gfx::FrameArena busy(1024u * KB);
+        busy.allocate(256u * KB, 16u);
+        busy.reset();
+        for (uint32_t frame = 0; frame < gfx::FrameArena::HistoryLength - 1u; frame++)
+        {
+            busy.allocate(16u * KB, 16u);
+            busy.reset();
+        }
+        result.check(busy.getBaseSize() == 1024u * KB, "one frame using a quarter of the base keeps it");
+
+        busy.allocate(16u * KB, 16u);
+        busy.reset();
+        result.check(busy.getBaseSize() == 64u * KB, "the base shrinks to twice the busiest quiet frame");
+    }
+
+    // -------------- random frames --------------
+    {
+        constexpr uint32_t frames = 2000u;
+
+        std::mt19937                            random(19u);
+        std::uniform_int_distribution<uint32_t> regionCount(0u, 400u);
+        std::uniform_int_distribution<uint64_t> size(1u, 16u * KB);
+        std::uniform_int_distribution<uint32_t> alignmentShift(0u, 16u);
+
+        gfx::FrameArena arena(128u * KB);
+        for (uint32_t frame = 0; frame < frames; frame++)
+        {
+            // every few hundred frames gets much busier or much quieter
+            const uint32_t count = regionCount(random) >> ((frame / 300u) % 4u * 2u);
+
+            uint32_t page      = 0u;
+            uint64_t end       = 0u;
+            uint64_t usedBytes = 0u;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const uint64_t   regionSize = size(random);
+                const uint64_t   alignment  = 1ull << alignmentShift(random);
+                gfx::ArenaRegion region     = arena.allocate(regionSize, alignment);
+                usedBytes += regionSize;
+
+                result.check(region.offset % alignment == 0u, "the offset is aligned");
+                result.check(region.page < arena.getPageCount(), "the region is in a page");
+                result.check(region.offset + regionSize <= arena.getPageSize(region.page), "the region fits its page");
+                result.check(
+                    region.page > page || (region.page == page && region.offset >= end),
+                    "a region follows the one before it"
+                );
+
+                page = region.page;
+                end  = region.offset + regionSize;
+            }
+
+            const gfx::ArenaFrameStats stats = arena.getFrameStats();
+            result.check(stats.usedBytes == usedBytes, "the used bytes are what was asked for");
+
+            arena.reset();
+            result.check(arena.getPageCount() == 1u, "a reset leaves only the base page");
+            result.check(arena.getBaseSize() >= stats.usedBytes + stats.wastedBytes, "the base fits the last frame");
+            result.check(arena.getBaseSize() % gfx::FrameArena::PageGranularity == 0u, "pages are whole granules");
+        }
+    }
+
+    return result.report();
+}
+
+bool testOffsetAllocator()
+{
+    TestResult result = {.name = "OffsetAllocator"};
+
+    // -------------- any stride, the skipped space stays free --------------
+    {
+        gfx::OffsetAllocator  allocator(1000u);
+        gfx::OffsetAllocation a, b;
+        result.check(allocator.allocate(10u, 1u, a) && a.offset == 0u, "the first range starts the space");
+        result.check(allocator.allocate(48u, 48u, b) && b.offset == 48u, "the offset is a multiple of the stride");
+        const gfx::OffsetAllocatorStats stats = allocator.getStats();
+        result.check(stats.freeBytes == 1000u - 10u - 48u, "the space skipped to align is still free");
+        result.check(stats.freeRangeCount == 2u, "the skipped space is a free range of its own");
+        result.check(!allocator.allocate(1001u, 1u, a), "nothing bigger than the space fits");
+    }
+
+    // -------------- best fit and merging on free --------------
+    {
+        constexpr std::array<uint64_t, 5> sizes = {100u, 200u, 100u, 100u, 200u};
+
+        gfx::OffsetAllocator                 allocator(1000u);
+        std::array<gfx::OffsetAllocation, 5> ranges;
+        for (size_t i = 0; i < ranges.size(); i++)
+        {
+            allocator.allocate(sizes[i], 1u, ranges[i]);
+        }
+
+        allocator.free(ranges[1]);
+        allocator.free(ranges[3]);
+        result.check(allocator.getStats().freeRangeCount == 3u, "ranges apart from each other don't merge");
+
+        gfx::OffsetAllocation small;
+        result.check(
+            allocator.allocate(60u, 1u, small) && small.offset == ranges[3].offset,
+            "the smallest range that fits is used, not the first one"
+        );
+        allocator.free(small);
+
+        allocator.free(ranges[2]);
+        gfx::OffsetAllocatorStats stats = allocator.getStats();
+        result.check(stats.freeRangeCount == 2u, "a range merges with free ranges on both sides");
+        result.check(stats.largestFreeRange == 400u, "the merged range spans all three");
+
+        allocator.free(ranges[0]);
+        allocator.free(ranges[4]);
+        stats = allocator.getStats();
+        result.check(stats.freeRangeCount == 1u && stats.freeBytes == 1000u, "freeing everything leaves one range");
+        result.check(
+            stats.allocationCount == 0u && stats.getFragmentation() == 0.0f, "an empty space isn't fragmented"
+        );
+    }
+
+    // -------------- at random, with the live ranges as the model --------------
+    {
+        constexpr uint64_t                capacity   = 16ull << 20;
+        constexpr uint32_t                iterations = 200000u;
+        constexpr std::array<uint64_t, 6> strides    = {4u, 12u, 16u, 32u, 48u, 256u};
+
+        std::mt19937                            random(11u);
+        std::uniform_int_distribution<uint32_t> operation(0u, 99u);
+        std::uniform_int_distribution<uint64_t> size(256u, 256u * 1024u);
+        std::uniform_int_distribution<size_t>   stride(0u, strides.size() - 1u);
+
+        gfx::OffsetAllocator         allocator(capacity);
+        std::map<uint64_t, uint64_t> live; // offset -> size
+        uint64_t                     liveBytes = 0u;
+
+        // the gaps between the live ranges, which is what the free ranges are once they're all merged
+        auto forEachGap = [&](auto &&visit) {
+            uint64_t end = 0u;
+            for (const auto &[offset, rangeSize] : live)
+            {
+                if (offset > end)
+                {
+                    visit(end, offset - end);
+                }
+                end = offset + rangeSize;
+            }
+            if (capacity > end)
+            {
+                visit(end, capacity - end);
+            }
+        };
+
+        double   fragmentationSum  = 0.0;
+        float    fragmentationPeak = 0.0f;
+        uint64_t freeRangeSum      = 0u;
+        uint32_t freeRangePeak     = 0u;
+        uint32_t samples           = 0u;
+        uint32_t failedAllocations = 0u;
+
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            if (operation(random) < 55u || live.empty())
+            {
+                // -------------- allocate, the range must be aligned and overlap nothing live --------------
+                const uint64_t        rangeSize = size(random);
+                const uint64_t        alignment = strides[stride(random)];
+                gfx::OffsetAllocation allocation;
+                if (!allocator.allocate(rangeSize, alignment, allocation))
+                {
+                    bool fits = false;
+                    forEachGap([&](uint64_t offset, uint64_t gapSize) {
+                        fits |= (offset + alignment - 1u) / alignment * alignment + rangeSize <= offset + gapSize;
+                    });
+                    result.check(!fits, "an allocation only fails if no gap fits it");
+                    failedAllocations++;
+                    continue;
+                }
+
+                result.check(allocation.size == rangeSize, "the range is as big as asked for");
+                result.check(allocation.offset % alignment == 0u, "the offset is aligned");
+                result.check(allocation.offset + rangeSize <= capacity, "the range ends inside of the space");
+
+                auto next     = live.lower_bound(allocation.offset);
+                bool overlaps = next != live.end() && next->first < allocation.offset + rangeSize;
+                if (next != live.begin())
+                {
+                    auto previous = std::prev(next);
+                    overlaps |= previous->first + previous->second > allocation.offset;
+                }
+                result.check(!overlaps, "a new range doesn't overlap a live one");
+
+                live.emplace(allocation.offset, rangeSize);
+                liveBytes += rangeSize;
+            }
+            else
+            {
+                // -------------- free a live range --------------
+                auto it = std::next(live.begin(), std::uniform_int_distribution<size_t>(0u, live.size() - 1u)(random));
+                allocator.free({.offset = it->first, .size = it->second});
+                liveBytes -= it->second;
+                live.erase(it);
+            }
+
+            // -------------- the free ranges are exactly the gaps, and how split up they are --------------
+            if (i % 1000u == 0u)
+            {
+                uint64_t gapCount   = 0u;
+                uint64_t largestGap = 0u;
+                forEachGap([&](uint64_t, uint64_t gapSize) {
+                    gapCount++;
+                    largestGap = std::max(largestGap, gapSize);
+                });
+
+                const gfx::OffsetAllocatorStats stats = allocator.getStats();
+                result.check(stats.freeBytes == capacity - liveBytes, "the free bytes are what isn't live");
+                result.check(stats.allocationCount == live.size(), "the allocation count is the model's");
+                result.check(stats.freeRangeCount == gapCount, "every free range is merged with its neighbours");
+                result.check(stats.largestFreeRange == largestGap, "the largest free range is the largest gap");
+
+                fragmentationSum  += stats.getFragmentation();
+                fragmentationPeak  = std::max(fragmentationPeak, stats.getFragmentation());
+                freeRangeSum      += stats.freeRangeCount;
+                freeRangePeak      = std::max(freeRangePeak, stats.freeRangeCount);
+                samples++;
+            }
+        }
+
+        LOG_INFO(fmt::format(
+            "OffsetAllocator: fragmentation {:.1f}% on average and {:.1f}% at most, {} free ranges on average and {} "
+            "at most, {} of {} allocations didn't fit",
+            fragmentationSum / samples * 100.0, fragmentationPeak * 100.0f, freeRangeSum / samples, freeRangePeak,
+            failedAllocations, iterations
+        ));
+
+        // -------------- everything merges back into one range --------------
+        for (const auto &[offset, rangeSize] : live)
+        {
+            allocator.free({.offset = offset, .size = rangeSize});
+        }
+        const gfx::OffsetAllocatorStats stats = allocator.getStats();
+        result.check(stats.freeRangeCount == 1u && stats.freeBytes == capacity, "freeing everything leaves one range");
+        result.check(stats.largestFreeRange == capacity, "the one range is the whole space");
+    }
+
+    return result.report();
+}
+
+bool testTlsfAllocator()
+{
+    TestResult result = {.name = "TlsfAllocator"};
+
+    // -------------- sizes round up to the granularity and offsets to the alignment --------------
+    {
+        gfx::TlsfAllocator  allocator(64u * 1024u, 256u);
+        gfx::TlsfAllocation a, b;
+        result.check(allocator.allocate(1u, 1u, a) && a.offset == 0u, "the first block starts the space");
+        result.check(a.size == 256u, "a block is at least the granularity");
+        result.check(allocator.allocate(300u, 4096u, b) && b.offset == 4096u, "the offset is aligned");
+        result.check(b.size == 512u, "the size rounds up to the granularity");
+
+        gfx::TlsfStats stats = allocator.getStats();
+        result.check(stats.usedBytes == 768u, "the space skipped to align isn't used");
+        result.check(stats.freeBlockCount == 2u, "the skipped space is a free block of its own");
+
+        allocator.free(a);
+        allocator.free(b);
+        stats = allocator.getStats();
+        result.check(allocator.isEmpty() && stats.freeBlockCount == 1u, "freeing everything leaves one block");
+        result.check(stats.largestFreeBlock == 64u * 1024u, "the one block is the whole space");
+    }
+
+    // -------------- a block merges with free blocks on both sides --------------
+    {
+        gfx::TlsfAllocator                  allocator(4096u, 256u);
+        std::array<gfx::TlsfAllocation, 4> blocks;
+        for (gfx::TlsfAllocation &block : blocks)
+        {
+            allocator.allocate(1024u, 1u, block);
+        }
+
+        gfx::TlsfAllocation extra;
+        result.check(!allocator.allocate(1u, 1u, extra), "a full space has no room");
+
+        allocator.free(blocks[0]);
+        allocator.free(blocks[2]);
+        result.check(allocator.getStats().freeBlockCount == 2u, "blocks apart from each other don't merge");
+
+        allocator.free(blocks[1]);
+        const gfx::TlsfStats stats = allocator.getStats();
+        result.check(stats.freeBlockCount == 1u && stats.largestFreeBlock == 3072u, "the freed block merges both");
+
+        gfx::TlsfAllocation big;
+        result.check(allocator.allocate(3072u, 1u, big) && big.offset == 0u, "the merged block can be used whole");
+    }
+
+    // -------------- at random, with the live blocks as the model --------------
+    {
+        constexpr uint64_t capacity    = 64ull << 20;
+        constexpr uint64_t granularity = 4096u;
+        constexpr uint32_t iterations  = 200000u;
+
+        std::mt19937                            random(17u);
+        std::uniform_int_distribution<uint32_t> operation(0u, 99u);
+        std::uniform_int_distribution<uint64_t> size(1u, 1024u * 1024u);
+        std::uniform_int_distribution<uint32_t> alignmentShift(0u, 10u);
+
+        gfx::TlsfAllocator                      allocator(capacity, granularity);
+        std::map<uint64_t, gfx::TlsfAllocation> live; // offset -> block
+        uint64_t                                liveBytes = 0u;
+
+        // the gaps between the live blocks, which is what the free blocks are once they're all merged
+        auto forEachGap = [&](auto &&visit) {
+            uint64_t end = 0u;
+            for (const auto &[offset, block] : live)
+            {
+                if (offset > end)
+                {
+                    visit(offset - end);
+                }
+                end = offset + block.size;
+            }
+            if (capacity > end)
+            {
+                visit(capacity - end);
+            }
+        };
+
+        for (uint32_t i = 0; i < iterations; i++)
+        {
+            if (operation(random) < 55u || live.empty())
+            {
+                // -------------- allocate, the block must be aligned and overlap nothing live --------------
+                const uint64_t      blockSize = size(random);
+                const uint64_t      alignment = granularity << alignmentShift(random);
+                gfx::TlsfAllocation allocation;
+                if (!allocator.allocate(blockSize, alignment, allocation))
+                {
+                    const uint64_t rounded = (blockSize + granularity - 1u) / granularity * granularity;
+                    bool           fits    = false;
+                    forEachGap([&](uint64_t gapSize) { fits |= gapSize >= rounded + alignment - granularity; });
+                    result.check(!fits, "an allocation only fails if no free block fits it wherever it starts");
+                    continue;
+                }
+
+                result.check(allocation.size >= blockSize, "the block is at least as big as asked for");
+                result.check(allocation.size % granularity == 0u, "the block is a multiple of the granularity");
+                result.check(allocation.offset % alignment == 0u, "the offset is aligned");
+                result.check(allocation.offset + allocation.size <= capacity, "the block ends inside of the space");
+
+                auto next     = live.lower_bound(allocation.offset);
+                bool overlaps = next != live.end() && next->first < allocation.offset + allocation.size;
+                if (next != live.begin())
+                {
+                    auto previous = std::prev(next);
+                    overlaps |= previous->first + previous->second.size > allocation.offset;
+                }
+                result.check(!overlaps, "a new block doesn't overlap a live one");
+
+                live.emplace(allocation.offset, allocation);
+                liveBytes += allocation.size;
+            }
+            else
+            {
+                // -------------- free a live block --------------
+                auto it = std::next(live.begin(), std::uniform_int_distribution<size_t>(0u, live.size() - 1u)(random));
+                allocator.free(it->second);
+                liveBytes -= it->second.size;
+                live.erase(it);
+            }
+
+            // -------------- the free blocks are exactly the gaps --------------
+            if (i % 1000u == 0u)
+            {
+                uint32_t gapCount   = 0u;
+                uint64_t largestGap = 0u;
+                forEachGap([&](uint64_t gapSize) {
+                    gapCount++;
+                    largestGap = std::max(largestGap, gapSize);
+                });
+
+                const gfx::TlsfStats stats = allocator.getStats();
+                result.check(stats.usedBytes == liveBytes, "the used bytes are what's live");
+                result.check(stats.allocationCount == live.size(), "the allocation count is the model's");
+                result.check(stats.freeBlockCount == gapCount, "every free block is merged with its neighbours");
+                result.check(stats.largestFreeBlock == largestGap, "the largest free block is the largest gap");
+            }
+        }
+
+        // -------------- everything merges back into one block --------------
+        for (const auto &[offset, block] : live)
+        {
+            allocator.free(block);
+        }
+        const gfx::TlsfStats stats = allocator.getStats();
+        result.check(allocator.isEmpty() && stats.freeBlockCount == 1u, "freeing everything leaves one block");
+        result.check(stats.largestFreeBlock == capacity, "the one block is the whole space");
+    }
+
+    return result.report();
+}
+
+void benchmarkAllocators()
+{
+    constexpr uint64_t capacity   = 1ull << 30;
+    constexpr uint32_t iterations = 1000000u;
+
+    gfx::TlsfAllocator              tlsf(capacity, 4096u);
+    const std::chrono::microseconds tlsfElapsed = timeChurn<gfx::TlsfAllocator, gfx::TlsfAllocation>(tlsf, iterations);
+
+    gfx::OffsetAllocator            offset(capacity);
+    const std::chrono::microseconds offsetElapsed =
+        timeChurn<gfx::OffsetAllocator, gfx::OffsetAllocation>(offset, iterations);
+
+    LOG_INFO(fmt::format(
+        "{} allocations and frees: TlsfAllocator {:.1f} ns each, OffsetAllocator {:.1f} ns each", iterations,
+        tlsfElapsed.count() * 1000.0 / iterations, offsetElapsed.count() * 1000.0 / iterations
+    ));
+}
+
+bool testAllocators()
+{
+    bool passed = true;
+    passed &= testStagingRing();
+    passed &= testFrameArena();
+    passed &= testOffsetAllocator();
+    passed &= testTlsfAllocator();
+
+    benchmarkAllocators();
+    return passed;
+}
\ No newline at end of file
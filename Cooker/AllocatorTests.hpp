@@ -0,0 +1,58 @@
+#pragma once
+
+/*
+ * Headless tests of the allocators that only do bookkeeping.
+ *
+ * Nothing here needs a device, and the tests include only the standard library, fmt, the logger and
+ * the allocator headers, so they build and run anywhere the allocator sources do.
+ */
+
+/*
+ * Drives a StagingRing with a plain counter standing in for the fence.
+ * Checks wrapping around the end, regions held back by unsubmitted ones and cancelling by hand,
+ * then allocates, submits, cancels and retires at random against a model of the live regions.
+ *
+ * @return True if every check passed.
+ */
+bool testStagingRing();
+
+/*
+ * Drives a FrameArena frame by frame without any memory behind the pages.
+ * Checks alignment, chaining onto overflow pages twice the size of the last, growing the base page after a busy
+ * frame and shrinking it after a full history of quiet ones, then allocates random frames and checks every region
+ * fits in its page and follows the one before it.
+ *
+ * @return True if every check passed.
+ */
+bool testFrameArena();
+
+/*
+ * Checks that OffsetAllocator aligns to any stride, picks the smallest range that fits and merges freed ranges
+ * with their neighbours, then allocates and frees at random against a model of the live ranges.
+ * The free ranges must always be the gaps between live ranges, and the fragmentation they leave is logged.
+ *
+ * @return True if every check passed.
+ */
+bool testOffsetAllocator();
+
+/*
+ * Checks that TlsfAllocator rounds to its granularity, aligns blocks and merges freed blocks with their
+ * neighbours, then allocates and frees at random against a model of the live blocks.
+ * An allocation may only fail if no free block is big enough for it wherever its start lands.
+ *
+ * @return True if every check passed.
+ */
+bool testTlsfAllocator();
+
+/*
+ * Times TlsfAllocator and OffsetAllocator on the same random allocations and frees of heap sized blocks,
+ * with a few thousand blocks live, and logs the time per allocation and free.
+ */
+void benchmarkAllocators();
+
+/*
+ * Runs every allocator test, then the benchmark.
+ *
+ * @return True if every test passed.
+ */
+bool testAllocators();
\ No newline at end of file
@@ -0,0 +1,75 @@
+#include "Headless.hpp"
+#include "AllocatorTests.hpp"
+#include "JobTests.hpp"
+#include "MeshTests.hpp"
+#include "ModelTests.hpp"
+#include "SceneTests.hpp"
+#include "TextureTests.hpp"
+
+#include <filesystem>
+#include <string_view>
+
+int runHeadless(int argc, char **argv)
+{
+    if (argc > 1 && std::string_view(argv[1]) == "--allocators")
+    {
+        return testAllocators() ? 0 : 1;
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--jobs")
+    {
+        return testJobs() ? 0 : 1;
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--cooked")
+    {
+        return testCookedModel() ? 0 : 1;
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--optimizer")
+    {
+        bool passed = testMeshOptimizer();
+        passed &= benchmarkMeshOptimizer();
+        return passed ? 0 : 1;
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--meshlets")
+    {
+        const bool passed = testMeshlets();
+
+        benchmarkMeshlets();
+        return passed ? 0 : 1;
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--textures")
+    {
+        bool passed = testTextures();
+        passed &= benchmarkTextures();
+        return passed ? 0 : 1;
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--decode")
+    {
+        const std::filesystem::path path =
+            argc > 2 ? std::filesystem::path(argv[2])
+                     : std::filesystem::absolute(__FILE__).parent_path().parent_path() / "Sandbox" / "Assets" /
+                           "Models" / "DamagedHelmet.glb";
+        return benchmarkImageDecode(path) ? 0 : 1;
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--entities")
+    {
+        bool passed = testEntities();
+        passed &= benchmarkEntities();
+        return passed ? 0 : 1;
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--culling")
+    {
+        bool passed = testCulling();
+        passed &= benchmarkCulling();
+        return passed ? 0 : 1;
+    }
+
+    return -1;
+}
\ No newline at end of file
@@ -0,0 +1,19 @@
+#pragma once
+
+/*
+ * Runs the tests and benchmarks that need no device, window or Windows headers.
+ *
+ * --allocators runs the allocator tests and times TlsfAllocator against OffsetAllocator, --jobs tests the job
+ * system and times how plain loops scale with its number of workers, --cooked writes, maps and reads back
+ * a cooked model, --optimizer tests the mesh optimization passes and times them one at a time, --meshlets
+ * tests the meshlet builder and culler and reports the meshlets and cull rates of generated meshes, --textures
+ * tests the block compressors and the mip chains and reports the throughput, size and error of processing
+ * generated images, --decode times decoding the images of a model, DamagedHelmet unless another is given,
+ * on one thread and on the job system, --entities tests the entity registry and times walking the components
+ * of 1M entities and --culling tests the frustum culler and times culling 1M spheres with every kernel.
+ *
+ * @param argc The number of command line arguments.
+ * @param argv The command line arguments, the first after the program picks the mode.
+ * @return The exit code, or -1 if the mode isn't a headless one.
+ */
+int runHeadless(int argc, char **argv);
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "JobTests.hpp"
+#include "TestResult.hpp"
+
+#include "Core/JobSystem.hpp"
+#include "Core/Logger.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <thread>
+#include <vector>
+
+namespace core = bisky::core;
+
+namespace
+{
+
+struct Rotation
+{
+    float pitch;
+    float yaw;
+    float roll;
+};
+
+struct Sphere
+{
+    float x;
+    float y;
+    float z;
+    float radius;
+};
+
+struct Plane
+{
+    float x;
+    float y;
+    float z;
+    float d;
+};
+
+using Matrix = std::array<float, 16>;
+
+/*
+ * Composes a row-major scale, rotation and translation matrix the long way, with scalar trigonometry.
+ *
+ * @param rotation The rotation in radians.
+ * @param position The translation.
+ * @param scale The uniform scale.
+ * @return The matrix.
+ */
+Matrix compose(const Rotation &rotation, const Sphere &position, float scale)
+{
+    const float sp = std::sin(rotation.pitch), cp = std::cos(rotation.pitch);
+    const float sy = std::sin(rotation.yaw), cy = std::cos(rotation.yaw);
+    const float sr = std::sin(rotation.roll), cr = std::cos(rotation.roll);
+
+    return {
+        scale * (cr * cy + sr * sp * sy), scale * (sr * cp), scale * (cr * -sy + sr * sp * cy), 0.0f,
+        scale * (-sr * cy + cr * sp * sy), scale * (cr * cp), scale * (sr * sy + cr * sp * cy), 0.0f,
+        scale * (cp * sy), scale * -sp, scale * (cp * cy), 0.0f,
+        position.x, position.y, position.z, 1.0f,
+    };
+}
+
+/*
+ * Tests a sphere against every plane of a frustum, the planes point inwards.
+ *
+ * @param planes The frustum planes.
+ * @param sphere The sphere.
+ * @return 1 if the sphere is at least partly inside, 0 otherwise.
+ */
+uint8_t isVisible(const std::array<Plane, 6> &planes, const Sphere &sphere)
+{
+    for (const Plane &plane : planes)
+    {
+        if (plane.x * sphere.x + plane.y * sphere.y + plane.z * sphere.z + plane.d < -sphere.radius)
+        {
+            return 0u;
+        }
+    }
+
+    return 1u;
+}
+
+} // namespace
+
+bool testJobSystem()
+{
+    TestResult result = {.name = "JobSystem"};
+
+    constexpr std::array<uint32_t, 5> counts     = {0u, 1u, 7u, 1000u, 100000u};
+    constexpr std::array<uint32_t, 5> grainSizes = {0u, 1u, 3u, 64u, 100000u};
+
+    for (uint32_t workers : {0u, 1u, 4u})
+    {
+        core::JobSystem jobSystem(workers);
+
+        // -------------- every index of every split is visited once --------------
+        for (uint32_t count : counts)
+        {
+            for (uint32_t grainSize : grainSizes)
+            {
+                auto                  visits  = std::make_unique<std::atomic<uint32_t>[]>(std::max(count, 1u));
+                std::atomic<uint32_t> batches = 0u;
+                std::atomic<bool>     inRange = true;
+
+                jobSystem.parallelFor(count, grainSize, [&](uint32_t begin, uint32_t end) {
+                    batches.fetch_add(1u);
+                    if (begin >= end || end > count || end - begin > std::max(grainSize, 1u))
+                    {
+                        inRange = false;
+                        return;
+                    }
+
+                    for (uint32_t i = begin; i < end; i++)
+                    {
+                        visits[i].fetch_add(1u);
+                    }
+                });
+
+                const uint32_t expectedBatches = (count + std::max(grainSize, 1u) - 1u) / std::max(grainSize, 1u);
+                bool           once            = true;
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    once &= visits[i].load() == 1u;
+                }
+
+                const auto what = fmt::format("{} workers, {} items in batches of {}", workers, count, grainSize);
+                result.check(inRange, what + ": every batch is a non-empty range within the items");
+                result.check(batches.load() == expectedBatches, what + ": one batch per grain");
+                result.check(once, what + ": every item is visited exactly once");
+            }
+        }
+
+        // -------------- jobs submitting more jobs to the same counter --------------
+        constexpr uint32_t parents  = 64u;
+        constexpr uint32_t children = 16u;
+
+        core::JobCounter      counter;
+        std::atomic<uint32_t> ran = 0u;
+        for (uint32_t parent = 0; parent < parents; parent++)
+        {
+            jobSystem.submit(
+                [&]() {
+                    for (uint32_t child = 0; child < children; child++)
+                    {
+                        jobSystem.submit([&]() { ran.fetch_add(1u); }, &counter);
+                    }
+                    ran.fetch_add(1u);
+                },
+                &counter
+            );
+        }
+        jobSystem.wait(&counter);
+
+        result.check(counter.value.load() == 0u, fmt::format("{} workers: the counter is zero after waiting", workers));
+        result.check(
+            ran.load() == parents * (children + 1u),
+            fmt::format("{} workers: waiting runs the jobs submitted by other jobs", workers)
+        );
+    }
+
+    return result.report();
+}
+
+void benchmarkJobs()
+{
+    constexpr uint32_t objectCount    = 1000000u;
+    constexpr uint32_t runs           = 10u;
+    constexpr uint32_t transformGrain = 16384u;
+    constexpr uint32_t cullGrain      = 65536u;
+
+    std::mt19937                          random(7u);
+    std::uniform_real_distribution<float> angle(-3.14159265f, 3.14159265f);
+    std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> radius(0.5f, 4.0f);
+
+    std::vector<Rotation> rotations(objectCount);
+    std::vector<Sphere>   spheres(objectCount);
+    for (uint32_t i = 0; i < objectCount; i++)
+    {
+        rotations[i] = {angle(random), angle(random), angle(random)};
+        spheres[i]   = {position(random), position(random), position(random), radius(random)};
+    }
+
+    // -------------- a 90 degree frustum looking down +z from the origin --------------
+    const float                halfSqrt2 = std::sqrt(0.5f);
+    const std::array<Plane, 6> planes    = {{
+        {halfSqrt2, 0.0f, halfSqrt2, 0.0f},
+        {-halfSqrt2, 0.0f, halfSqrt2, 0.0f},
+        {0.0f, halfSqrt2, halfSqrt2, 0.0f},
+        {0.0f, -halfSqrt2, halfSqrt2, 0.0f},
+        {0.0f, 0.0f, 1.0f, -0.1f},
+        {0.0f, 0.0f, -1.0f, 1000.0f},
+    }};
+
+    std::vector<Matrix>  matrices(objectCount);
+    std::vector<uint8_t> visible(objectCount);
+
+    auto transformRange = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            matrices[i] = compose(rotations[i], spheres[i], spheres[i].radius);
+        }
+    };
+
+    auto cullRange = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            visible[i] = isVisible(planes, spheres[i]);
+        }
+    };
+
+    auto time = [&](auto work) {
+        auto start = std::chrono::system_clock::now();
+        for (uint32_t run = 0; run < runs; run++)
+        {
+            work();
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start);
+        return elapsed.count() / 1000.0f / runs;
+    };
+
+    // -------------- the calling thread alone, the baseline every split is compared to --------------
+    const float serialTransforms = time([&]() { transformRange(0u, objectCount); });
+    const float serialCull       = time([&]() { cullRange(0u, objectCount); });
+    LOG_INFO(fmt::format("Serial: transforms {:.3f} ms, cull {:.3f} ms", serialTransforms, serialCull));
+
+    const std::vector<Matrix>  expectedMatrices = matrices;
+    const std::vector<uint8_t> expectedVisible  = visible;
+
+    // -------------- then split with parallelFor, the calling thread helps while it waits --------------
+    const uint32_t maxWorkers = std::max(std::thread::hardware_concurrency(), 1u);
+    for (uint32_t workers = 1u; workers <= maxWorkers; workers++)
+    {
+        core::JobSystem jobSystem(workers);
+
+        std::fill(matrices.begin(), matrices.end(), Matrix{});
+        const float transforms = time([&]() { jobSystem.parallelFor(objectCount, transformGrain, transformRange); });
+
+        std::fill(visible.begin(), visible.end(), uint8_t(2u));
+        const float cull = time([&]() { jobSystem.parallelFor(objectCount, cullGrain, cullRange); });
+
+        const bool matches = matrices == expectedMatrices && visible == expectedVisible;
+        LOG_INFO(fmt::format(
+            "{} workers: transforms {:.3f} ms ({:.2f}x), cull {:.3f} ms ({:.2f}x){}", workers, transforms,
+            serialTransforms / transforms, cull, serialCull / cull, matches ? "" : ", DIFFERS FROM SERIAL"
+        ));
+    }
+}
+
+bool testJobs()
+{
+    const bool passed = testJobSystem();
+
+    benchmarkJobs();
+    return passed;
+}
\ No newline at end of file
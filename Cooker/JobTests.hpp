@@ -0,0 +1,31 @@
+#pragma once
+
+/*
+ * Headless tests of the job system.
+ *
+ * Like the allocator tests these include only the standard library, fmt, the logger and the job system,
+ * so they build and run anywhere JobSystem.cpp does.
+ */
+
+/*
+ * Splits ranges of many sizes into batches of many grain sizes, on job systems with no workers, one and several,
+ * and checks that every index is visited exactly once. Then submits jobs that submit more jobs with the same
+ * counter and checks that waiting on it runs all of them.
+ *
+ * @return True if every check passed.
+ */
+bool testJobSystem();
+
+/*
+ * Builds the matrices of 1M transforms and culls 1M spheres against six planes split across a JobSystem with 1 up
+ * to one worker per hardware thread, against running them on the calling thread alone. Both workloads are plain
+ * scalar loops, so only the split is measured, and the split results have to match the serial ones exactly.
+ */
+void benchmarkJobs();
+
+/*
+ * Runs the job system test, then the benchmark.
+ *
+ * @return True if the test passed.
+ */
+bool testJobs();
\ No newline at end of file
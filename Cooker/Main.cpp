@@ -0,0 +1,796 @@
+#include "Bisky.hpp"
+#include "Headless.hpp"
+
+namespace core  = bisky::core;
+namespace gfx   = bisky::gfx;
+namespace scene = bisky::scene;
+
+/*
+ * Packs every mesh of a model with the scalar and the SSE2 encoder and reports the packing error.
+ *
+ * @param model The imported model.
+ */
+void benchmarkPacking(const core::ModelData &model)
+{
+    namespace VertexQuantizer = scene::VertexQuantizer;
+
+    std::chrono::microseconds        scalarElapsed{0};
+    std::chrono::microseconds        simdElapsed{0};
+    std::vector<scene::PackedVertex> scalar;
+    std::vector<scene::PackedVertex> simd;
+    for (auto &mesh : model.meshes)
+    {
+        auto bounds = VertexQuantizer::computeBounds(mesh.vertices);
+        scalar.resize(mesh.vertices.size());
+        simd.resize(mesh.vertices.size());
+
+        auto scalarStart = std::chrono::system_clock::now();
+        VertexQuantizer::encode(mesh.vertices, bounds, scalar);
+        auto simdStart = std::chrono::system_clock::now();
+        VertexQuantizer::encodeSimd(mesh.vertices, bounds, simd);
+        auto simdEnd = std::chrono::system_clock::now();
+
+        scalarElapsed += std::chrono::duration_cast<std::chrono::microseconds>(simdStart - scalarStart);
+        simdElapsed += std::chrono::duration_cast<std::chrono::microseconds>(simdEnd - simdStart);
+
+        auto report = VertexQuantizer::measure(mesh.vertices, simd, bounds);
+        LOG_INFO(fmt::format(
+            "{}: {} -> {} bytes, max error: position {:.5f}, normal {:.3f} deg, tangent {:.3f} deg, uv {:.5f}{}",
+            mesh.name, report.fullBytes, report.packedBytes, report.maxPositionError, report.maxNormalError,
+            report.maxTangentError, report.maxTexCoordError,
+            memcmp(scalar.data(), simd.data(), simd.size() * sizeof(scene::PackedVertex)) == 0
+                ? ""
+                : " (scalar and SSE2 encoders disagree)"
+        ));
+    }
+
+    LOG_INFO(fmt::format(
+        "Packed vertices: scalar {:.3f} ms, SSE2 {:.3f} ms", scalarElapsed.count() / 1000.0f,
+        simdElapsed.count() / 1000.0f
+    ));
+}
+
+/*
+ * Cooks a model and compares importing the source with reading the cooked file.
+ * The cooked read touches every vertex and index so page faults are part of the measurement.
+ *
+ * @param path The source model to cook.
+ * @return True if the model was cooked successfully.
+ */
+bool cook(const std::filesystem::path &path)
+{
+    const std::filesystem::path cookedPath = core::ModelCooker::getCookedPath(path);
+
+    // -------------- import the source model --------------
+    auto            importStart = std::chrono::system_clock::now();
+    core::ModelData source;
+    if (!core::ModelCooker::importGltf(path, source))
+    {
+        return false;
+    }
+    auto importElapsed =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - importStart);
+
+    benchmarkPacking(source);
+
+    // -------------- write the cooked model --------------
+    if (!core::ModelCooker::write(cookedPath, source, core::ModelCooker::getSourceStamp(path, {})))
+    {
+        return false;
+    }
+
+    // -------------- read the cooked model back --------------
+    auto            readStart = std::chrono::system_clock::now();
+    core::ModelData cooked;
+    if (!core::ModelCooker::read(cookedPath, cooked))
+    {
+        LOG_ERROR("Failed to read back " + cookedPath.string());
+        return false;
+    }
+
+    uint64_t checksum = 0u;
+    for (auto &mesh : cooked.meshes)
+    {
+        for (auto &vertex : mesh.vertices)
+            checksum += static_cast<uint64_t>(vertex.position.x);
+        for (auto index : mesh.indices)
+            checksum += index;
+    }
+    auto readElapsed =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - readStart);
+
+    LOG_INFO(fmt::format(
+        "{}: glTF import {:.3f} ms, cooked read {:.3f} ms ({:.1f}x, checksum {})", path.filename().string(),
+        importElapsed.count() / 1000.0f, readElapsed.count() / 1000.0f,
+        importElapsed.count() / std::max(static_cast<float>(readElapsed.count()), 1.0f), checksum
+    ));
+    return true;
+}
+
+/*
+ * Compiles every Sandbox shader stage with an increasing number of threads.
+ * The shader cache is disabled so every run does the full compile.
+ *
+ * @param sandbox The Sandbox project directory.
+ */
+void benchmarkShaders(const std::filesystem::path &sandbox)
+{
+    core::ResourceManager::get().setWorkingDirectory(sandbox);
+    core::ResourceManager::get().setShaderDirectory("Shaders");
+    gfx::ShaderCompiler::setCacheEnabled(false);
+
+    // -------------- every shader outside of Include has a vertex and a pixel stage --------------
+    const std::filesystem::path        shaderDirectory = core::ResourceManager::get().getShaderDirectory();
+    std::vector<gfx::ShaderCompileJob> stages;
+    for (auto &entry : std::filesystem::recursive_directory_iterator(shaderDirectory))
+    {
+        if (entry.path().extension() != ".hlsl")
+            continue;
+
+        auto filename = entry.path().lexically_relative(shaderDirectory);
+        stages.push_back({.shaderType = gfx::ShaderType::Vertex, .filename = filename, .entryPoint = L"VsMain"});
+        stages.push_back({.shaderType = gfx::ShaderType::Pixel, .filename = filename, .entryPoint = L"PsMain"});
+    }
+
+    // -------------- compile them all with 1, 2, 4... threads --------------
+    const uint32_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (uint32_t threads = 1u;; threads = std::min(threads * 2u, maxThreads))
+    {
+        core::JobSystem jobSystem(threads - 1u);
+        auto            jobs  = stages;
+        auto            start = std::chrono::system_clock::now();
+        bool            ok    = gfx::ShaderCompiler::compileBatch(jobs, jobSystem);
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start);
+
+        LOG_INFO(fmt::format(
+            "{} threads: compiled {} shader stages in {:.3f} ms{}", threads, jobs.size(), elapsed.count() / 1000.0f,
+            ok ? "" : " (with errors)"
+        ));
+
+        if (threads == maxThreads)
+            break;
+    }
+}
+
+/*
+ * Fills per-object constants for 100k objects in write-combined memory, the way mapped upload pages
+ * are, comparing writing them in place, reading the inverse back like ForwardRenderer used to,
+ * against building them on the stack and streaming them out.
+ */
+void benchmarkConstants()
+{
+    constexpr uint32_t objectCount = 100000u;
+    constexpr uint32_t runs        = 10u;
+    const size_t       bytes       = objectCount * sizeof(gfx::ObjectBuffer);
+
+    auto *mapped = static_cast<gfx::ObjectBuffer *>(
+        VirtualAlloc(nullptr, bytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE | PAGE_WRITECOMBINE)
+    );
+    if (!mapped)
+    {
+        LOG_ERROR("Failed to allocate write-combined memory");
+        return;
+    }
+
+    std::vector<dx::XMFLOAT4X4> worlds(objectCount);
+    for (uint32_t i = 0; i < objectCount; i++)
+    {
+        XMStoreFloat4x4(&worlds[i], dx::XMMatrixRotationY(i * 0.01f) * dx::XMMatrixTranslation(i * 1.0f, 0.0f, 0.0f));
+    }
+
+    auto measure = [&](std::string_view name, auto fill) {
+        auto start = std::chrono::system_clock::now();
+        for (uint32_t run = 0; run < runs; run++)
+        {
+            for (uint32_t i = 0; i < objectCount; i++)
+            {
+                fill(XMLoadFloat4x4(&worlds[i]), i);
+            }
+            gfx::StreamingStore::fence();
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start);
+        const float seconds = elapsed.count() / 1000000.0f;
+        LOG_INFO(fmt::format(
+            "{}: {:.1f} ns per object, {:.0f} MB/s", name, seconds * 1e9f / (objectCount * runs),
+            bytes * runs / (1024.0f * 1024.0f) / seconds
+        ));
+    };
+
+    // -------------- in place, reading the inverse back out of write-combined memory --------------
+    measure("In place with read back", [&](dx::FXMMATRIX world, uint32_t i) {
+        gfx::ObjectBuffer *object = &mapped[i];
+        XMStoreFloat4x4(&object->world, world);
+        XMStoreFloat4x4(&object->transposeInverseWorld, dx::XMMatrixInverse(nullptr, world));
+        dx::XMMATRIX inverseWorld = XMLoadFloat4x4(&object->transposeInverseWorld);
+        XMStoreFloat4x4(&object->transposeInverseWorld, dx::XMMatrixTranspose(inverseWorld));
+        object->positionMin   = {};
+        object->positionScale = {};
+        object->vertexFormat  = 0u;
+        object->padding       = 0.0f;
+    });
+
+    // -------------- in place, write only --------------
+    measure("In place", [&](dx::FXMMATRIX world, uint32_t i) {
+        gfx::ObjectBuffer *object = &mapped[i];
+        XMStoreFloat4x4(&object->world, world);
+        XMStoreFloat4x4(&object->transposeInverseWorld, dx::XMMatrixTranspose(dx::XMMatrixInverse(nullptr, world)));
+        object->positionMin   = {};
+        object->positionScale = {};
+        object->vertexFormat  = 0u;
+        object->padding       = 0.0f;
+    });
+
+    // -------------- on the stack, then streamed out --------------
+    measure("Streamed", [&](dx::FXMMATRIX world, uint32_t i) {
+        gfx::ObjectBuffer object = {};
+        XMStoreFloat4x4(&object.world, world);
+        XMStoreFloat4x4(&object.transposeInverseWorld, dx::XMMatrixTranspose(dx::XMMatrixInverse(nullptr, world)));
+        gfx::StreamingStore::copy(&mapped[i], &object, sizeof(object));
+    });
+
+    VirtualFree(mapped, 0, MEM_RELEASE);
+}
+
+/*
+ * Uploads the constants of a static scene of 100k objects, rebuilding and inverting every world matrix
+ * each frame against the cached matrices that only upload the objects that moved.
+ */
+void benchmarkTransforms()
+{
+    constexpr uint32_t objectCount = 100000u;
+    constexpr uint32_t frames      = 100u;
+    const size_t       bytes       = objectCount * sizeof(gfx::ObjectBuffer);
+
+    auto *mapped = static_cast<gfx::ObjectBuffer *>(
+        VirtualAlloc(nullptr, bytes, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE | PAGE_WRITECOMBINE)
+    );
+    if (!mapped)
+    {
+        LOG_ERROR("Failed to allocate write-combined memory");
+        return;
+    }
+
+    gfx::TransformStorage           transforms;
+    std::vector<gfx::Transform>     objects;
+    std::vector<scene::RenderFlags> flags(objectCount);
+    objects.reserve(objectCount);
+    for (uint32_t i = 0; i < objectCount; i++)
+    {
+        auto &transform = objects.emplace_back(transforms.create());
+        transform.setTranslation(i * 1.0f, 0.0f, 0.0f);
+        transform.setRotation(0.0f, i * 0.5f, 0.0f);
+    }
+
+    auto measure = [&](std::string_view name, auto frame) {
+        size_t written = 0u;
+        auto   start   = std::chrono::system_clock::now();
+        for (uint32_t i = 0; i < frames; i++)
+        {
+            written += frame();
+            gfx::StreamingStore::fence();
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start);
+        LOG_INFO(fmt::format(
+            "{}: {:.3f} ms per frame, {:.1f} KB written per frame", name, elapsed.count() / 1000.0f / frames,
+            written / 1024.0f / frames
+        ));
+    };
+
+    // -------------- every matrix rebuilt, inverted and uploaded every frame --------------
+    measure("Rebuilt", [&]() {
+        for (uint32_t i = 0; i < objectCount; i++)
+        {
+            auto        &transform = objects[i];
+            dx::XMMATRIX world     = transform.getScaleMatrix() * transform.getRotationMatrix();
+            world                  = world * transform.getTranslationMatrix();
+
+            gfx::ObjectBuffer object = {};
+            XMStoreFloat4x4(&object.world, world);
+            XMStoreFloat4x4(&object.transposeInverseWorld, dx::XMMatrixTranspose(dx::XMMatrixInverse(nullptr, world)));
+            gfx::StreamingStore::copy(&mapped[i], &object, sizeof(object));
+        }
+        return bytes;
+    });
+
+    // -------------- cached matrices, only objects that moved are uploaded --------------
+    auto cached = [&]() {
+        size_t written = 0u;
+        transforms.update();
+        for (uint32_t i = 0; i < objectCount; i++)
+        {
+            if (objects[i].takeChanged())
+            {
+                flags[i].numFramesDirty = gfx::Device::FramesInFlight;
+            }
+
+            if (flags[i].numFramesDirty == 0u)
+            {
+                continue;
+            }
+
+            gfx::ObjectBuffer object = {};
+            XMStoreFloat4x4(&object.world, objects[i].getLocalToWorld());
+            XMStoreFloat4x4(&object.transposeInverseWorld, objects[i].getNormalMatrix());
+            gfx::StreamingStore::copy(&mapped[i], &object, sizeof(object));
+            flags[i].numFramesDirty--;
+            written += sizeof(object);
+        }
+        return written;
+    };
+
+    // -------------- the first frames in flight still upload everything once --------------
+    for (uint32_t i = 0; i < gfx::Device::FramesInFlight; i++)
+    {
+        cached();
+    }
+    measure("Cached", cached);
+
+    // -------------- and with one object in a hundred moving every frame --------------
+    measure("Cached, 1% moving", [&]() {
+        for (uint32_t i = 0; i < objectCount; i += 100u)
+        {
+            objects[i].addTranslation(0.0f, 0.01f, 0.0f);
+        }
+        return cached();
+    });
+
+    VirtualFree(mapped, 0, MEM_RELEASE);
+}
+
+/*
+ * Builds the local to world and world to local matrices of 1M transforms with the TransformStorage
+ * kernels, against transforms that each sit behind two pointers and are built one at a time with
+ * DirectXMath, the way RenderObject used to hold them.
+ */
+void benchmarkMatrices()
+{
+    constexpr uint32_t transformCount = 1000000u;
+    constexpr uint32_t runs           = 10u;
+
+    struct HeapTransform
+    {
+        dx::XMFLOAT3   scale;
+        dx::XMFLOAT3   rotation;
+        dx::XMFLOAT3   translation;
+        dx::XMFLOAT4X4 localToWorld;
+        dx::XMFLOAT4X4 worldToLocal;
+    };
+
+    struct HeapObject
+    {
+        std::string                    name;
+        std::unique_ptr<HeapTransform> transform;
+    };
+
+    std::mt19937                          random(7u);
+    std::uniform_real_distribution<float> angle(-180.0f, 180.0f);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+
+    gfx::TransformStorage                    storage;
+    std::vector<std::shared_ptr<HeapObject>> objects;
+    for (uint32_t i = 0; i < transformCount; i++)
+    {
+        const dx::XMFLOAT3 rotation    = {angle(random), angle(random), angle(random)};
+        const dx::XMFLOAT3 translation = {position(random), position(random), position(random)};
+
+        auto &object                   = objects.emplace_back(std::make_shared<HeapObject>());
+        object->name                   = fmt::format("Object {}", i);
+        object->transform              = std::make_unique<HeapTransform>();
+        object->transform->scale       = {1.0f, 2.0f, 1.0f};
+        object->transform->rotation    = rotation;
+        object->transform->translation = translation;
+
+        gfx::Transform transform = storage.create();
+        transform.setScale(1.0f, 2.0f, 1.0f);
+        transform.setRotation(rotation.x, rotation.y, rotation.z);
+        transform.setTranslation(translation.x, translation.y, translation.z);
+    }
+
+    // -------------- objects come and go over a session, so they end up spread around the heap --------------
+    std::shuffle(objects.begin(), objects.end(), random);
+
+    auto measure = [&](std::string_view name, auto buildAll) {
+        auto start = std::chrono::system_clock::now();
+        for (uint32_t run = 0; run < runs; run++)
+        {
+            buildAll();
+        }
+
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start);
+        const float seconds = elapsed.count() / 1000000.0f;
+        LOG_INFO(fmt::format("{}: {:.1f}M transforms per second", name, transformCount * runs / seconds / 1e6f));
+    };
+
+    // -------------- one at a time, the way Transform built them before --------------
+    measure("Heap, DirectXMath", [&]() {
+        for (auto &object : objects)
+        {
+            HeapTransform      &transform   = *object->transform;
+            const dx::XMFLOAT3 &scale       = transform.scale;
+            const dx::XMFLOAT3 &rotation    = transform.rotation;
+            const dx::XMFLOAT3 &translation = transform.translation;
+
+            dx::XMMATRIX s = dx::XMMatrixScaling(scale.x, scale.y, scale.z);
+            dx::XMVECTOR q = dx::XMQuaternionRotationRollPitchYawFromVector(
+                dx::XMVectorScale(XMLoadFloat3(&rotation), dx::XM_PI / 180.0f)
+            );
+            dx::XMMATRIX r = dx::XMMatrixRotationQuaternion(q);
+            dx::XMMATRIX t = dx::XMMatrixTranslation(translation.x, translation.y, translation.z);
+
+            dx::XMMATRIX world = s * r * t;
+            XMStoreFloat4x4(&transform.localToWorld, world);
+            XMStoreFloat4x4(&transform.worldToLocal, dx::XMMatrixInverse(nullptr, world));
+        }
+    });
+
+    // -------------- whole blocks at a time out of the structure of arrays --------------
+    for (auto kernel : {gfx::TransformKernel::Sse, gfx::TransformKernel::Avx})
+    {
+        if (!gfx::TransformStorage::IsSupported(kernel))
+        {
+            LOG_INFO("AVX is not supported, skipping its kernel");
+            continue;
+        }
+
+        storage.setKernel(kernel);
+        measure(kernel == gfx::TransformKernel::Sse ? "SoA, SSE2" : "SoA, AVX", [&]() {
+            storage.computeLocals(0u, transformCount);
+        });
+    }
+}
+
+/*
+ * Updates deep and wide hierarchies of 100k+ transforms, rebuilding every world matrix against
+ * rebuilding only the subtrees under the transforms that moved.
+ */
+void benchmarkHierarchy()
+{
+    constexpr uint32_t runs = 20u;
+
+    auto measure = [&](std::string_view name, gfx::TransformStorage &storage, auto touch) {
+        std::chrono::microseconds elapsed{0};
+        for (uint32_t run = 0; run < runs; run++)
+        {
+            touch();
+
+            auto start = std::chrono::system_clock::now();
+            storage.update();
+            elapsed += std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start);
+        }
+
+        LOG_INFO(fmt::format("{}: {:.3f} ms per update", name, elapsed.count() / 1000.0f / runs));
+    };
+
+    auto benchmark = [&](std::string_view name, gfx::TransformStorage &storage) {
+        const uint32_t count = storage.getCount();
+        storage.update();
+
+        std::mt19937          random(7u);
+        std::vector<uint32_t> leaves;
+        std::vector<uint32_t> roots;
+        std::vector<uint8_t>  hasChildren(count, 0u);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            const uint32_t parent = storage.getParent(i);
+            if (parent == gfx::TransformStorage::NoParent)
+                roots.push_back(i);
+            else
+                hasChildren[parent] = 1u;
+        }
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            if (!hasChildren[i])
+                leaves.push_back(i);
+        }
+
+        LOG_INFO(fmt::format("{}: {} transforms, {} roots, {} leaves", name, count, roots.size(), leaves.size()));
+
+        measure("  Full", storage, [&]() { storage.invalidate(); });
+        measure("  One root moved", storage, [&]() {
+            storage.addTranslation(roots[random() % roots.size()], 0.0f, 0.01f, 0.0f);
+        });
+        measure("  100 leaves moved", storage, [&]() {
+            for (uint32_t i = 0; i < 100u; i++)
+                storage.addTranslation(leaves[random() % leaves.size()], 0.0f, 0.01f, 0.0f);
+        });
+        measure("  1% moved", storage, [&]() {
+            for (uint32_t i = 0; i < count / 100u; i++)
+                storage.addTranslation(random() % count, 0.0f, 0.01f, 0.0f);
+        });
+        measure("  Nothing moved", storage, []() {});
+    };
+
+    // -------------- deep, 100 chains of 1000 transforms --------------
+    {
+        gfx::TransformStorage storage;
+        for (uint32_t chain = 0; chain < 100u; chain++)
+        {
+            uint32_t parent = gfx::TransformStorage::NoParent;
+            for (uint32_t depth = 0; depth < 1000u; depth++)
+            {
+                gfx::Transform transform = storage.create(parent);
+                transform.setTranslation(0.0f, 0.1f, 0.0f);
+                transform.setRotation(0.0f, 1.0f, 0.0f);
+                parent = transform.getIndex();
+            }
+        }
+
+        benchmark("Deep", storage);
+    }
+
+    // -------------- wide, 1 root with 1000 children of 100 children each --------------
+    {
+        gfx::TransformStorage storage;
+        gfx::Transform        root = storage.create();
+        for (uint32_t i = 0; i < 1000u; i++)
+        {
+            gfx::Transform child = storage.create(root.getIndex());
+            child.setTranslation(i * 1.0f, 0.0f, 0.0f);
+            for (uint32_t j = 0; j < 100u; j++)
+            {
+                storage.create(child.getIndex()).setTranslation(0.0f, j * 1.0f, 0.0f);
+            }
+        }
+
+        benchmark("Wide", storage);
+    }
+}
+
+/*
+ * Writes a glTF scene of 100k cubes placed with EXT_mesh_gpu_instancing and 1000 more placed by their own nodes,
+ * half of those through a copy of the cube mesh, then imports and cooks it. Every cube should end up drawing the
+ * one decoded mesh.
+ */
+void benchmarkInstancing()
+{
+    constexpr uint32_t InstanceCount = 100000u;
+    constexpr uint32_t NodeCount     = 1000u;
+    constexpr uint32_t RowLength     = 316u;
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "BiskyInstancing";
+    const std::filesystem::path path      = directory / "Instancing.gltf";
+    std::filesystem::create_directories(directory);
+
+    // -------------- a cube, then the translation, rotation and scale of every instance --------------
+    const float positions[8][3] = {
+        {-0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f},
+        {-0.5f, -0.5f, 0.5f},  {0.5f, -0.5f, 0.5f},  {0.5f, 0.5f, 0.5f},  {-0.5f, 0.5f, 0.5f},
+    };
+    const uint16_t indices[36] = {0, 2, 1, 0, 3, 2, 4, 5, 6, 4, 6, 7, 0, 1, 5, 0, 5, 4,
+                                  3, 6, 2, 3, 7, 6, 0, 4, 7, 0, 7, 3, 1, 2, 6, 1, 6, 5};
+
+    std::vector<dx::XMFLOAT3> translations(InstanceCount);
+    std::vector<dx::XMFLOAT4> rotations(InstanceCount);
+    std::vector<dx::XMFLOAT3> scales(InstanceCount);
+    for (uint32_t i = 0; i < InstanceCount; i++)
+    {
+        translations[i] = {(i % RowLength) * 2.0f, 0.0f, (i / RowLength) * 2.0f};
+        scales[i]       = {1.0f, 1.0f + (i % 3u) * 0.5f, 1.0f};
+        dx::XMStoreFloat4(&rotations[i], dx::XMQuaternionRotationRollPitchYaw(0.0f, i * 0.01f, 0.0f));
+    }
+
+    std::vector<uint8_t>                   buffer;
+    std::vector<std::pair<size_t, size_t>> views; // offset and size of every buffer view
+    auto                                   append = [&](const void *data, size_t size) {
+        views.push_back({buffer.size(), size});
+        buffer.insert(buffer.end(), static_cast<const uint8_t *>(data), static_cast<const uint8_t *>(data) + size);
+        buffer.resize((buffer.size() + 3u) & ~size_t(3u));
+    };
+    append(positions, sizeof(positions));
+    append(indices, sizeof(indices));
+    append(translations.data(), translations.size() * sizeof(dx::XMFLOAT3));
+    append(rotations.data(), rotations.size() * sizeof(dx::XMFLOAT4));
+    append(scales.data(), scales.size() * sizeof(dx::XMFLOAT3));
+
+    // -------------- the scene, the copy of the mesh has the same primitives --------------
+    std::ostringstream json;
+    json << R"({"asset":{"version":"2.0"},"extensionsUsed":["EXT_mesh_gpu_instancing"],"scene":0,)";
+    json << R"("buffers":[{"uri":"Instancing.bin","byteLength":)" << buffer.size() << "}],";
+    json << R"("bufferViews":[)";
+    for (size_t i = 0; i < views.size(); i++)
+    {
+        json << (i > 0u ? "," : "") << R"({"buffer":0,"byteOffset":)" << views[i].first << R"(,"byteLength":)"
+             << views[i].second << "}";
+    }
+    json << "],";
+    json << R"("accessors":[)"
+         << R"({"bufferView":0,"componentType":5126,"count":8,"type":"VEC3",)"
+         << R"("min":[-0.5,-0.5,-0.5],"max":[0.5,0.5,0.5]},)"
+         << R"({"bufferView":1,"componentType":5123,"count":36,"type":"SCALAR"},)"
+         << R"({"bufferView":2,"componentType":5126,"count":)" << InstanceCount << R"(,"type":"VEC3"},)"
+         << R"({"bufferView":3,"componentType":5126,"count":)" << InstanceCount << R"(,"type":"VEC4"},)"
+         << R"({"bufferView":4,"componentType":5126,"count":)" << InstanceCount << R"(,"type":"VEC3"}],)";
+    json << R"("meshes":[{"name":"Cube","primitives":[{"attributes":{"POSITION":0},"indices":1}]},)"
+         << R"({"name":"CubeCopy","primitives":[{"attributes":{"POSITION":0},"indices":1}]}],)";
+    json << R"("nodes":[{"name":"Instances","mesh":0,"extensions":{"EXT_mesh_gpu_instancing":)"
+         << R"({"attributes":{"TRANSLATION":2,"ROTATION":3,"SCALE":4}}}},)"
+         << R"({"name":"Grid","translation":[0,10,0],"children":[)";
+    for (uint32_t i = 0; i < NodeCount; i++)
+    {
+        json << (i > 0u ? "," : "") << 2u + i;
+    }
+    json << "]}";
+    for (uint32_t i = 0; i < NodeCount; i++)
+    {
+        json << R"(,{"name":"Cube)" << i << R"(","mesh":)" << i % 2u << R"(,"translation":[)" << (i % 32u) * 2.0f
+             << ",0," << (i / 32u) * 2.0f << "]}";
+    }
+    json << R"(],"scenes":[{"nodes":[0,1]}]})";
+
+    {
+        std::ofstream(directory / "Instancing.bin", std::ios::binary)
+            .write(reinterpret_cast<const char *>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+        std::ofstream(path) << json.str();
+    }
+
+    // -------------- import it --------------
+    auto            importStart = std::chrono::system_clock::now();
+    core::ModelData model;
+    if (!core::ModelCooker::importGltf(path, model))
+    {
+        LOG_ERROR("Failed to import " + path.string());
+        return;
+    }
+    auto importElapsed =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - importStart);
+
+    // -------------- compare the geometry uploaded once against once per node --------------
+    auto meshBytes = [&](const core::MeshData &mesh) {
+        return mesh.vertices.size_bytes() + mesh.indices.size_bytes();
+    };
+
+    size_t drawn       = 0u;
+    size_t sharedBytes = 0u;
+    size_t nodeBytes   = 0u;
+    for (auto &mesh : model.meshes)
+    {
+        sharedBytes += meshBytes(mesh);
+    }
+    for (auto &node : model.nodes)
+    {
+        if (node.mesh < 0)
+            continue;
+        drawn++;
+        nodeBytes += meshBytes(model.meshes[node.mesh]);
+    }
+
+    LOG_INFO(fmt::format(
+        "{} nodes draw {} meshes {} times, {:.2f} KB of geometry instead of {:.2f} MB with a mesh per node, "
+        "imported in {:.3f} ms",
+        model.nodes.size(), model.meshes.size(), drawn, sharedBytes / 1024.0f, nodeBytes / (1024.0f * 1024.0f),
+        importElapsed.count() / 1000.0f
+    ));
+
+    // -------------- the nodes have to survive cooking --------------
+    const std::filesystem::path cookedPath = core::ModelCooker::getCookedPath(path);
+    if (!core::ModelCooker::write(cookedPath, model))
+    {
+        return;
+    }
+
+    auto            readStart = std::chrono::system_clock::now();
+    core::ModelData cooked;
+    if (!core::ModelCooker::read(cookedPath, cooked))
+    {
+        LOG_ERROR("Failed to read back " + cookedPath.string());
+        return;
+    }
+    auto readElapsed =
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - readStart);
+
+    auto sameNode = [](const core::NodeData &a, const core::NodeData &b) {
+        return a.name == b.name && a.mesh == b.mesh && a.parent == b.parent &&
+               memcmp(&a.scale, &b.scale, sizeof(dx::XMFLOAT3)) == 0 &&
+               memcmp(&a.rotation, &b.rotation, sizeof(dx::XMFLOAT3)) == 0 &&
+               memcmp(&a.translation, &b.translation, sizeof(dx::XMFLOAT3)) == 0;
+    };
+
+    LOG_INFO(fmt::format(
+        "Cooked read {:.3f} ms, nodes {}", readElapsed.count() / 1000.0f,
+        std::ranges::equal(model.nodes, cooked.nodes, sameNode) ? "match" : "DIFFER"
+    ));
+
+    std::error_code ec;
+    std::filesystem::remove_all(directory, ec);
+}
+
+/*
+ * Gets the models to work on.
+ *
+ * @param sandbox The Sandbox project directory.
+ * @param count The number of models given on the command line.
+ * @param paths The models given on the command line.
+ * @return The given models, or every .gltf and .glb file in the Sandbox model directory if none were given.
+ */
+std::vector<std::filesystem::path> getModels(const std::filesystem::path &sandbox, int count, char **paths)
+{
+    std::vector<std::filesystem::path> models;
+    for (int i = 0; i < count; i++)
+    {
+        models.push_back(paths[i]);
+    }
+
+    if (models.empty())
+    {
+        for (auto &entry : std::filesystem::recursive_directory_iterator(sandbox / "Assets\\Models"))
+        {
+            auto extension = entry.path().extension();
+            if (extension == ".gltf" || extension == ".glb")
+                models.push_back(entry.path());
+        }
+    }
+
+    return models;
+}
+
+/*
+ * Cooks every model given on the command line.
+ * With no arguments every .gltf and .glb file in the Sandbox model directory is cooked.
+ * Passing --shaders benchmarks shader compilation instead, --constants benchmarks filling per-object constants
+ * and --transforms benchmarks uploading the constants of a static scene, --matrices building transform matrices,
+ * --hierarchy updating transform hierarchies and --instancing importing an instanced glTF scene.
+ * The modes that need no device, like --allocators, --jobs, --textures, --decode, --entities and --culling,
+ * are run by runHeadless first.
+ */
+int main(int argc, char **argv)
+{
+    core::setLogLevel(core::Info);
+
+    if (const int headless = runHeadless(argc, argv); headless >= 0)
+    {
+        return headless;
+    }
+
+    const std::filesystem::path sandbox = std::filesystem::absolute(__FILE__).parent_path().parent_path() / "Sandbox";
+    if (argc > 1 && std::string_view(argv[1]) == "--shaders")
+    {
+        benchmarkShaders(sandbox);
+        return 0;
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--constants")
+    {
+        benchmarkConstants();
+        return 0;
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--transforms")
+    {
+        benchmarkTransforms();
+        return 0;
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--matrices")
+    {
+        benchmarkMatrices();
+        return 0;
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--hierarchy")
+    {
+        benchmarkHierarchy();
+        return 0;
+    }
+
+    if (argc > 1 && std::string_view(argv[1]) == "--instancing")
+    {
+        benchmarkInstancing();
+        return 0;
+    }
+
+    int failed = 0;
+    for (auto &model : getModels(sandbox, argc - 1, argv + 1))
+    {
+        if (!cook(model))
+        {
+            LOG_ERROR("Failed to cook " + model.string());
+            failed++;
+        }
+    }
+
+    return failed == 0 ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,679 @@
+#include "MeshTests.hpp"
+#include "TestResult.hpp"
+
+#include "Core/Logger.hpp"
+#include "Scene/MeshOptimizer.hpp"
+#include "Scene/MeshletBuilder.hpp"
+#include "Scene/MeshletCuller.hpp"
+#include "Scene/Vertex.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace scene = bisky::scene;
+
+namespace
+{
+
+struct TestMesh
+{
+    std::vector<scene::Vertex> vertices;
+    std::vector<uint32_t>      indices;
+};
+
+/*
+ * Builds a flat grid of quads, every vertex shared by the quads around it.
+ *
+ * @param size The number of quads along each side.
+ * @return The grid.
+ */
+TestMesh makeGrid(uint32_t size)
+{
+    TestMesh mesh;
+    for (uint32_t z = 0; z <= size; z++)
+    {
+        for (uint32_t x = 0; x <= size; x++)
+        {
+            const float u = x / static_cast<float>(size);
+            const float v = z / static_cast<float>(size);
+            mesh.vertices.push_back({
+                .position = {u * 2.0f - 1.0f, 0.0f, v * 2.0f - 1.0f},
+                .normal   = {0.0f, 1.0f, 0.0f},
+                .texCoord = {u, v},
+                .tangent  = {1.0f, 0.0f, 0.0f, 1.0f},
+            });
+        }
+    }
+
+    for (uint32_t z = 0; z < size; z++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            const uint32_t corner = z * (size + 1u) + x;
+            mesh.indices.insert(mesh.indices.end(), {corner, corner + size + 1u, corner + 1u});
+            mesh.indices.insert(mesh.indices.end(), {corner + 1u, corner + size + 1u, corner + size + 2u});
+        }
+    }
+
+    return mesh;
+}
+
+/*
+ * Builds a unit sphere out of rings, every vertex shared by the quads around it.
+ * The seam and the poles have a vertex per segment, so their texture coordinates differ.
+ * Every triangle is wound so its face normal points out of the sphere.
+ *
+ * @param rings The number of rings from pole to pole.
+ * @param segments The number of segments around each ring.
+ * @return The sphere, without the degenerate triangles at the poles.
+ */
+TestMesh makeSphere(uint32_t rings, uint32_t segments)
+{
+    constexpr float pi = 3.14159265f;
+
+    TestMesh mesh;
+    for (uint32_t r = 0; r <= rings; r++)
+    {
+        for (uint32_t s = 0; s <= segments; s++)
+        {
+            const float theta = pi * r / rings;
+            const float phi   = 2.0f * pi * s / segments;
+            const float x     = std::sin(theta) * std::cos(phi);
+            const float y     = std::cos(theta);
+            const float z     = std::sin(theta) * std::sin(phi);
+            mesh.vertices.push_back({
+                .position = {x, y, z},
+                .normal   = {x, y, z},
+                .texCoord = {s / static_cast<float>(segments), r / static_cast<float>(rings)},
+                .tangent  = {-std::sin(phi), 0.0f, std::cos(phi), 1.0f},
+            });
+        }
+    }
+
+    for (uint32_t r = 0; r < rings; r++)
+    {
+        for (uint32_t s = 0; s < segments; s++)
+        {
+            const uint32_t corner = r * (segments + 1u) + s;
+            if (r > 0u)
+            {
+                mesh.indices.insert(mesh.indices.end(), {corner, corner + 1u, corner + segments + 1u});
+            }
+            if (r + 1u < rings)
+            {
+                mesh.indices.insert(mesh.indices.end(), {corner + 1u, corner + segments + 2u, corner + segments + 1u});
+            }
+        }
+    }
+
+    return mesh;
+}
+
+/*
+ * Gives every corner of every triangle its own vertex, like an importer that doesn't weld.
+ */
+void unweld(TestMesh &mesh)
+{
+    std::vector<scene::Vertex> vertices;
+    vertices.reserve(mesh.indices.size());
+    for (uint32_t &index : mesh.indices)
+    {
+        vertices.push_back(mesh.vertices[index]);
+        index = static_cast<uint32_t>(vertices.size() - 1u);
+    }
+
+    mesh.vertices = std::move(vertices);
+}
+
+/*
+ * Shuffles the order of the triangles, keeping the order of each triangle's corners.
+ */
+void shuffleTriangles(std::span<uint32_t> indices, std::mt19937 &random)
+{
+    const size_t triangleCount = indices.size() / 3u;
+    for (size_t t = triangleCount; t > 1u; t--)
+    {
+        const size_t other = std::uniform_int_distribution<size_t>(0u, t - 1u)(random);
+        std::swap_ranges(indices.begin() + (t - 1u) * 3u, indices.begin() + t * 3u, indices.begin() + other * 3u);
+    }
+}
+
+/*
+ * Shuffles the order of the vertices and remaps the indices to match.
+ */
+void shuffleVertices(TestMesh &mesh, std::mt19937 &random)
+{
+    std::vector<uint32_t> order(mesh.vertices.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::shuffle(order.begin(), order.end(), random);
+
+    std::vector<scene::Vertex> vertices(mesh.vertices.size());
+    std::vector<uint32_t>      remap(mesh.vertices.size());
+    for (uint32_t i = 0; i < order.size(); i++)
+    {
+        vertices[i]     = mesh.vertices[order[i]];
+        remap[order[i]] = i;
+    }
+
+    for (uint32_t &index : mesh.indices)
+    {
+        index = remap[index];
+    }
+
+    mesh.vertices = std::move(vertices);
+}
+
+using Triangle = std::array<scene::Vertex, 3>;
+
+/*
+ * Gets every triangle by the values of its corners, starting from the smallest corner so a rotated triangle
+ * still matches but a flipped one doesn't.
+ *
+ * @param vertices The vertices the indices refer to.
+ * @param indices The triangle list.
+ * @return The triangles, sorted.
+ */
+std::vector<Triangle> getTriangles(std::span<const scene::Vertex> vertices, std::span<const uint32_t> indices)
+{
+    auto less = [](const scene::Vertex &a, const scene::Vertex &b) {
+        return memcmp(&a, &b, sizeof(scene::Vertex)) < 0;
+    };
+
+    std::vector<Triangle> triangles(indices.size() / 3u);
+    for (size_t t = 0; t < triangles.size(); t++)
+    {
+        const scene::Vertex *corners[3] = {
+            &vertices[indices[t * 3u + 0u]],
+            &vertices[indices[t * 3u + 1u]],
+            &vertices[indices[t * 3u + 2u]],
+        };
+
+        uint32_t first = less(*corners[1], *corners[0]) ? 1u : 0u;
+        first          = less(*corners[2], *corners[first]) ? 2u : first;
+        triangles[t]   = {*corners[first], *corners[(first + 1u) % 3u], *corners[(first + 2u) % 3u]};
+    }
+
+    std::ranges::sort(triangles, [](const Triangle &a, const Triangle &b) {
+        return memcmp(a.data(), b.data(), sizeof(Triangle)) < 0;
+    });
+    return triangles;
+}
+
+bool sameTriangles(const TestMesh &mesh, const std::vector<Triangle> &expected)
+{
+    const std::vector<Triangle> triangles = getTriangles(mesh.vertices, mesh.indices);
+    return triangles.size() == expected.size() &&
+           memcmp(triangles.data(), expected.data(), triangles.size() * sizeof(Triangle)) == 0;
+}
+
+bool indicesInRange(const TestMesh &mesh)
+{
+    return std::ranges::all_of(mesh.indices, [&](uint32_t index) { return index < mesh.vertices.size(); });
+}
+
+scene::VertexCacheStats analyze(const TestMesh &mesh)
+{
+    return scene::MeshOptimizer::analyzeVertexCache(mesh.indices, static_cast<uint32_t>(mesh.vertices.size()));
+}
+
+
+/*
+ * Gets the directions to look at a mesh from, 6 along the axes and 8 towards the corners of a cube.
+ */
+std::vector<dx::XMVECTOR> getViewDirections()
+{
+    std::vector<dx::XMVECTOR> directions;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        directions.push_back(dx::XMVectorSetByIndex(dx::XMVectorZero(), 1.0f, axis));
+        directions.push_back(dx::XMVectorSetByIndex(dx::XMVectorZero(), -1.0f, axis));
+    }
+
+    for (int corner = 0; corner < 8; corner++)
+    {
+        directions.push_back(dx::XMVector3Normalize(
+            dx::XMVectorSet(corner & 1 ? 1.0f : -1.0f, corner & 2 ? 1.0f : -1.0f, corner & 4 ? 1.0f : -1.0f, 0.0f)
+        ));
+    }
+
+    return directions;
+}
+
+/*
+ * Gets what the meshlet culler needs to test an untransformed mesh from a camera looking at a point.
+ *
+ * @param position The camera position.
+ * @param target The point to look at.
+ * @return The culling data of the mesh.
+ */
+scene::MeshletCullData getCullData(dx::FXMVECTOR position, dx::FXMVECTOR target)
+{
+    namespace MeshletCuller = scene::MeshletCuller;
+
+    const dx::XMVECTOR forward    = dx::XMVector3Normalize(dx::XMVectorSubtract(target, position));
+    const bool         vertical   = std::abs(dx::XMVectorGetY(forward)) > 0.99f;
+    const dx::XMVECTOR up         = dx::XMVectorSet(0.0f, vertical ? 0.0f : 1.0f, vertical ? 1.0f : 0.0f, 0.0f);
+    const dx::XMMATRIX view       = dx::XMMatrixLookAtLH(position, target, up);
+    const dx::XMMATRIX projection = dx::XMMatrixPerspectiveFovLH(dx::XM_PIDIV2, 16.0f / 9.0f, 0.01f, 1000.0f);
+
+    const scene::Frustum frustum = MeshletCuller::getFrustum(view * projection);
+    return MeshletCuller::prepare(frustum, dx::XMMatrixIdentity(), dx::XMMatrixIdentity(), position);
+}
+
+} // namespace
+
+bool testMeshOptimizer()
+{
+    namespace MeshOptimizer = scene::MeshOptimizer;
+
+    TestResult   result = {.name = "MeshOptimizer"};
+    std::mt19937 random(5u);
+
+    // -------------- the cache analysis against hand counted misses --------------
+    {
+        const std::vector<uint32_t> lone     = {0u, 1u, 2u};
+        const std::vector<uint32_t> pair     = {0u, 1u, 2u, 2u, 1u, 3u};
+        const std::vector<uint32_t> repeated = {0u, 1u, 2u, 0u, 1u, 2u};
+
+        // 16 triangles with their own corners, then the first again once it has left a 16 entry cache
+        std::vector<uint32_t> evicted(48u);
+        std::iota(evicted.begin(), evicted.end(), 0u);
+        evicted.insert(evicted.end(), {0u, 1u, 2u});
+
+        auto loneStats     = MeshOptimizer::analyzeVertexCache(lone, 3u);
+        auto pairStats     = MeshOptimizer::analyzeVertexCache(pair, 4u);
+        auto repeatedStats = MeshOptimizer::analyzeVertexCache(repeated, 3u);
+        auto evictedStats  = MeshOptimizer::analyzeVertexCache(evicted, 48u, 16u);
+        auto keptStats     = MeshOptimizer::analyzeVertexCache(evicted, 48u, 64u);
+        auto emptyStats    = MeshOptimizer::analyzeVertexCache({}, 0u);
+
+        result.check(loneStats.acmr == 3.0f && loneStats.atvr == 1.0f, "a lone triangle misses every corner");
+        result.check(pairStats.acmr == 2.0f && pairStats.atvr == 1.0f, "two triangles sharing an edge miss 4");
+        result.check(repeatedStats.acmr == 1.5f && repeatedStats.atvr == 1.0f, "a repeated triangle hits");
+        result.check(evictedStats.acmr == 3.0f && evictedStats.atvr == 51.0f / 48.0f, "evicted corners miss again");
+        result.check(keptStats.acmr == 48.0f / 17.0f && keptStats.atvr == 1.0f, "a larger cache keeps them");
+        result.check(emptyStats.acmr == 0.0f && emptyStats.atvr == 0.0f, "no triangles have no misses");
+    }
+
+    // -------------- welding leaves one vertex per unique value --------------
+    {
+        TestMesh grid = makeGrid(32u);
+        unweld(grid);
+        shuffleTriangles(grid.indices, random);
+
+        const std::vector<Triangle> expected = getTriangles(grid.vertices, grid.indices);
+        const uint32_t              count    = MeshOptimizer::weldVertices(grid.vertices, grid.indices);
+
+        std::vector<scene::Vertex> sorted = grid.vertices;
+        std::ranges::sort(sorted, [](const scene::Vertex &a, const scene::Vertex &b) {
+            return memcmp(&a, &b, sizeof(scene::Vertex)) < 0;
+        });
+        const auto duplicate = std::ranges::adjacent_find(sorted, [](const scene::Vertex &a, const scene::Vertex &b) {
+            return memcmp(&a, &b, sizeof(scene::Vertex)) == 0;
+        });
+
+        result.check(count == 33u * 33u && grid.vertices.size() == count, "welding a grid leaves its corners");
+        result.check(duplicate == sorted.end(), "no two welded vertices are the same");
+        result.check(indicesInRange(grid), "welded indices refer to the welded vertices");
+        result.check(sameTriangles(grid, expected), "welding keeps every triangle");
+
+        std::vector<scene::Vertex> none;
+        result.check(MeshOptimizer::weldVertices(none, {}) == 0u, "welding nothing leaves nothing");
+    }
+
+    // -------------- vertex cache ordering undoes a shuffle --------------
+    {
+        TestMesh grid = makeGrid(64u);
+        shuffleTriangles(grid.indices, random);
+
+        const std::vector<Triangle>   expected = getTriangles(grid.vertices, grid.indices);
+        const scene::VertexCacheStats before   = analyze(grid);
+        MeshOptimizer::optimizeVertexCache(grid.indices, static_cast<uint32_t>(grid.vertices.size()));
+        const scene::VertexCacheStats after = analyze(grid);
+
+        LOG_INFO(fmt::format("MeshOptimizer: shuffled grid ACMR {:.3f} -> {:.3f}", before.acmr, after.acmr));
+        result.check(after.acmr < 0.8f && after.acmr < before.acmr * 0.5f, "a shuffled grid gets cache friendly");
+        result.check(sameTriangles(grid, expected), "vertex cache ordering keeps every triangle");
+
+        MeshOptimizer::optimizeVertexCache({}, 0u);
+    }
+
+    // -------------- overdraw ordering only costs its threshold --------------
+    for (float threshold : {1.0f, 1.05f, 1.5f})
+    {
+        TestMesh sphere = makeSphere(48u, 96u);
+        shuffleTriangles(sphere.indices, random);
+        MeshOptimizer::optimizeVertexCache(sphere.indices, static_cast<uint32_t>(sphere.vertices.size()));
+
+        const std::vector<Triangle>   expected = getTriangles(sphere.vertices, sphere.indices);
+        const scene::VertexCacheStats before   = analyze(sphere);
+        MeshOptimizer::optimizeOverdraw(sphere.indices, sphere.vertices, threshold);
+        const scene::VertexCacheStats after = analyze(sphere);
+
+        const auto what = fmt::format("overdraw ordering with a threshold of {}", threshold);
+        result.check(after.acmr <= before.acmr * threshold * 1.001f, what + " costs at most that much ACMR");
+        result.check(sameTriangles(sphere, expected), what + " keeps every triangle");
+    }
+
+    // -------------- vertex fetch ordering follows the indices --------------
+    {
+        TestMesh sphere = makeSphere(16u, 32u);
+        for (uint32_t i = 0; i < 100u; i++)
+        {
+            sphere.vertices.push_back({.position = {10.0f + i, 0.0f, 0.0f}});
+        }
+        shuffleVertices(sphere, random);
+        shuffleTriangles(sphere.indices, random);
+
+        std::vector<bool> used(sphere.vertices.size(), false);
+        for (uint32_t index : sphere.indices)
+        {
+            used[index] = true;
+        }
+
+        const std::vector<Triangle> expected   = getTriangles(sphere.vertices, sphere.indices);
+        const size_t                referenced = std::ranges::count(used, true);
+        const uint32_t              count      = MeshOptimizer::optimizeVertexFetch(sphere.vertices, sphere.indices);
+
+        uint32_t next    = 0u;
+        bool     inOrder = true;
+        for (uint32_t index : sphere.indices)
+        {
+            inOrder &= index <= next;
+            next = std::max(next, index + 1u);
+        }
+
+        result.check(count == referenced && sphere.vertices.size() == count, "unused vertices are dropped");
+        result.check(next == count && inOrder, "vertices are stored in the order they are first used");
+        result.check(sameTriangles(sphere, expected), "vertex fetch ordering keeps every triangle");
+    }
+
+    // -------------- every pass at once --------------
+    {
+        TestMesh     sphere = makeSphere(32u, 64u);
+        const size_t unique = sphere.vertices.size() - 2u; // the first vertex of each pole is never used
+        unweld(sphere);
+        shuffleTriangles(sphere.indices, random);
+
+        const std::vector<Triangle>        expected = getTriangles(sphere.vertices, sphere.indices);
+        const scene::MeshOptimizationStats stats    = MeshOptimizer::optimize(sphere.vertices, sphere.indices);
+
+        result.check(stats.verticesBefore == sphere.indices.size(), "optimize counts the vertices it was given");
+        result.check(stats.verticesAfter == unique && sphere.vertices.size() == unique, "optimize welds them");
+        result.check(stats.after.acmr < stats.before.acmr * 0.5f, "optimize makes the sphere cache friendly");
+        result.check(indicesInRange(sphere) && sameTriangles(sphere, expected), "optimize keeps every triangle");
+
+        // a broken triangle list is left alone
+        TestMesh broken = makeGrid(2u);
+        broken.indices.push_back(0u);
+        const std::vector<uint32_t>        indices     = broken.indices;
+        const scene::MeshOptimizationStats brokenStats = MeshOptimizer::optimize(broken.vertices, broken.indices);
+        result.check(
+            broken.indices == indices && brokenStats.verticesAfter == brokenStats.verticesBefore,
+            "optimize leaves a broken triangle list alone"
+        );
+    }
+
+    return result.report();
+}
+
+bool benchmarkMeshOptimizer()
+{
+    namespace MeshOptimizer = scene::MeshOptimizer;
+
+    std::mt19937 random(9u);
+    TestMesh     sphere = makeSphere(256u, 512u);
+    unweld(sphere);
+    shuffleTriangles(sphere.indices, random);
+
+    const std::vector<Triangle> expected      = getTriangles(sphere.vertices, sphere.indices);
+    const uint32_t              triangleCount = static_cast<uint32_t>(sphere.indices.size() / 3u);
+
+    bool ok  = true;
+    auto run = [&](std::string_view pass, auto function) {
+        auto start = std::chrono::system_clock::now();
+        function();
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start);
+
+        const scene::VertexCacheStats cache = analyze(sphere);
+        const bool                    kept  = sameTriangles(sphere, expected);
+        LOG_INFO(fmt::format(
+            "{} triangles, {}: {:.3f} ms, ACMR {:.3f}, ATVR {:.3f}, {} vertices{}", triangleCount, pass,
+            elapsed.count() / 1000.0f, cache.acmr, cache.atvr, sphere.vertices.size(),
+            kept ? "" : ", LOST OR CHANGED TRIANGLES"
+        ));
+        ok = ok && kept;
+    };
+
+    // -------------- the passes in the order optimize runs them --------------
+    run("Imported", []() {});
+    run("Weld", [&]() { MeshOptimizer::weldVertices(sphere.vertices, sphere.indices); });
+    run("Vertex cache", [&]() {
+        MeshOptimizer::optimizeVertexCache(sphere.indices, static_cast<uint32_t>(sphere.vertices.size()));
+    });
+    run("Overdraw", [&]() { MeshOptimizer::optimizeOverdraw(sphere.indices, sphere.vertices); });
+    run("Vertex fetch", [&]() { MeshOptimizer::optimizeVertexFetch(sphere.vertices, sphere.indices); });
+
+    return ok;
+}
+
+bool testMeshlets()
+{
+    namespace MeshletBuilder = scene::MeshletBuilder;
+    namespace MeshletCuller  = scene::MeshletCuller;
+
+    TestResult result = {.name = "Meshlets"};
+
+    TestMesh                    sphere   = makeSphere(128u, 256u);
+    const std::vector<Triangle> expected = getTriangles(sphere.vertices, sphere.indices);
+
+    std::vector<scene::Meshlet> meshlets;
+    const uint32_t              count = MeshletBuilder::build(sphere.vertices, sphere.indices, meshlets);
+    result.check(count == meshlets.size() && count > 0u, "the builder returns how many meshlets it appended");
+    result.check(sameTriangles(sphere, expected), "the builder keeps every triangle");
+
+    // -------------- the meshlets cover the indices one after another and stay within the limits --------------
+    uint32_t next = 0u;
+    for (auto &meshlet : meshlets)
+    {
+        const auto what = fmt::format("meshlet at index {}", meshlet.startIndexLocation);
+        if (meshlet.startIndexLocation != next || meshlet.indexCount % 3u != 0u ||
+            next + meshlet.indexCount > sphere.indices.size())
+        {
+            result.check(false, what + " follows the one before it");
+            break;
+        }
+
+        std::vector<uint32_t> unique(
+            sphere.indices.begin() + meshlet.startIndexLocation,
+            sphere.indices.begin() + meshlet.startIndexLocation + meshlet.indexCount
+        );
+        std::ranges::sort(unique);
+        unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+
+        result.check(unique.size() <= MeshletBuilder::MaxVertices, what + " has at most MaxVertices vertices");
+        result.check(meshlet.indexCount / 3u <= MeshletBuilder::MaxTriangles, what + " has at most MaxTriangles");
+        result.check(meshlet.vertexCount == unique.size(), what + " counts its vertices");
+
+        next += meshlet.indexCount;
+    }
+    result.check(next == sphere.indices.size(), "the meshlets cover every index");
+
+    // -------------- every triangle between 12 vertices, so the triangle limit is reached first --------------
+    {
+        TestMesh dense = makeGrid(2u);
+        dense.vertices.resize(12u, dense.vertices.back());
+        for (uint32_t i = 0; i < dense.vertices.size(); i++)
+        {
+            dense.vertices[i].position.y = static_cast<float>(i);
+        }
+
+        dense.indices.clear();
+        for (uint32_t a = 0; a < 12u; a++)
+        {
+            for (uint32_t b = a + 1u; b < 12u; b++)
+            {
+                for (uint32_t c = b + 1u; c < 12u; c++)
+                {
+                    dense.indices.insert(dense.indices.end(), {a, b, c});
+                }
+            }
+        }
+
+        const std::vector<Triangle> denseExpected = getTriangles(dense.vertices, dense.indices);
+        std::vector<scene::Meshlet> denseMeshlets;
+        MeshletBuilder::build(dense.vertices, dense.indices, denseMeshlets);
+
+        const bool withinLimit = std::ranges::all_of(denseMeshlets, [](const scene::Meshlet &meshlet) {
+            return meshlet.indexCount / 3u <= MeshletBuilder::MaxTriangles;
+        });
+        result.check(denseMeshlets.size() == 2u && withinLimit, "220 triangles on 12 vertices fill two meshlets");
+        result.check(sameTriangles(dense, denseExpected), "the builder keeps every triangle of a dense mesh");
+    }
+
+    // -------------- no culled meshlet has a triangle facing a camera inside its frustum --------------
+    uint32_t tested = 0u;
+    uint32_t culled = 0u;
+    for (auto &direction : getViewDirections())
+    {
+        for (float distance : {1.05f, 1.2f, 2.0f, 8.0f})
+        {
+            const dx::XMVECTOR           position = dx::XMVectorScale(direction, distance);
+            const scene::MeshletCullData data     = getCullData(position, dx::XMVectorZero());
+
+            for (auto &meshlet : meshlets)
+            {
+                tested++;
+                if (MeshletCuller::isVisible(meshlet, data))
+                    continue;
+
+                culled++;
+                bool visible = false;
+                for (uint32_t i = 0; i < meshlet.indexCount && !visible; i += 3u)
+                {
+                    dx::XMVECTOR corners[3];
+                    for (uint32_t corner = 0; corner < 3u; corner++)
+                    {
+                        const uint32_t index = sphere.indices[meshlet.startIndexLocation + i + corner];
+                        corners[corner] = dx::XMVectorSetW(dx::XMLoadFloat3(&sphere.vertices[index].position), 1.0f);
+                    }
+
+                    const dx::XMVECTOR normal = dx::XMVector3Normalize(dx::XMVector3Cross(
+                        dx::XMVectorSubtract(corners[1], corners[0]), dx::XMVectorSubtract(corners[2], corners[0])
+                    ));
+                    const dx::XMVECTOR toCorner = dx::XMVectorSubtract(corners[0], position);
+                    const bool front = dx::XMVectorGetX(dx::XMVector3Dot(toCorner, normal)) < -1e-4f * distance;
+
+                    bool outside = false;
+                    for (auto &plane : data.planes)
+                    {
+                        const dx::XMVECTOR p = dx::XMLoadFloat4(&plane);
+                        outside |= dx::XMVectorGetX(dx::XMVector4Dot(p, corners[0])) < 0.0f &&
+                                   dx::XMVectorGetX(dx::XMVector4Dot(p, corners[1])) < 0.0f &&
+                                   dx::XMVectorGetX(dx::XMVector4Dot(p, corners[2])) < 0.0f;
+                    }
+
+                    visible = front && !outside;
+                }
+
+                result.check(!visible, fmt::format(
+                    "meshlet at index {} is only culled without a visible triangle, {} units away",
+                    meshlet.startIndexLocation, distance
+                ));
+            }
+        }
+    }
+
+    // -------------- from outside, about half of a sphere faces away --------------
+    const float culledShare = culled / static_cast<float>(std::max(tested, 1u));
+    result.check(culledShare > 0.3f, "the culler rejects the meshlets on the far side of the sphere");
+    LOG_INFO(fmt::format(
+        "Meshlets: {} triangles in {} meshlets, {:.1f}% culled over {} views", sphere.indices.size() / 3u,
+        meshlets.size(), 100.0f * culledShare, tested / std::max<size_t>(meshlets.size(), 1u)
+    ));
+
+    return result.report();
+}
+
+void benchmarkMeshlets()
+{
+    namespace MeshletBuilder = scene::MeshletBuilder;
+    namespace MeshletCuller  = scene::MeshletCuller;
+
+    struct Shape
+    {
+        std::string_view name;
+        TestMesh         mesh;
+    };
+
+    std::vector<Shape> shapes;
+    shapes.push_back({"Sphere 4k", makeSphere(32u, 64u)});
+    shapes.push_back({"Sphere 65k", makeSphere(128u, 256u)});
+    shapes.push_back({"Sphere 261k", makeSphere(256u, 512u)});
+    shapes.push_back({"Grid 33k", makeGrid(128u)});
+
+    const std::vector<dx::XMVECTOR> directions = getViewDirections();
+    for (auto &[name, mesh] : shapes)
+    {
+        std::vector<scene::Meshlet> meshlets;
+        auto                        buildStart = std::chrono::system_clock::now();
+        MeshletBuilder::build(mesh.vertices, mesh.indices, meshlets);
+        auto buildElapsed =
+            std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - buildStart);
+
+        // -------------- meshlet sizes --------------
+        uint32_t triangles = 0u;
+        uint32_t vertices  = 0u;
+        for (auto &meshlet : meshlets)
+        {
+            triangles += meshlet.indexCount / 3u;
+            vertices += meshlet.vertexCount;
+        }
+
+        // -------------- cull from every direction, a bounding box diagonal away from the center --------------
+        dx::XMVECTOR minimum = dx::XMLoadFloat3(&mesh.vertices[0].position);
+        dx::XMVECTOR maximum = minimum;
+        for (auto &vertex : mesh.vertices)
+        {
+            minimum = dx::XMVectorMin(minimum, dx::XMLoadFloat3(&vertex.position));
+            maximum = dx::XMVectorMax(maximum, dx::XMLoadFloat3(&vertex.position));
+        }
+
+        const dx::XMVECTOR center   = dx::XMVectorScale(dx::XMVectorAdd(minimum, maximum), 0.5f);
+        const float        distance = dx::XMVectorGetX(dx::XMVector3Length(dx::XMVectorSubtract(maximum, minimum)));
+
+        uint32_t                  culled = 0u;
+        std::chrono::microseconds cullElapsed{0};
+        for (auto &direction : directions)
+        {
+            const dx::XMVECTOR position = dx::XMVectorAdd(center, dx::XMVectorScale(direction, distance));
+
+            auto start = std::chrono::system_clock::now();
+            auto data  = getCullData(position, center);
+            for (auto &meshlet : meshlets)
+            {
+                culled += MeshletCuller::isVisible(meshlet, data) ? 0u : 1u;
+            }
+            cullElapsed +=
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start);
+        }
+
+        const float meshletCount = static_cast<float>(std::max<size_t>(meshlets.size(), 1u));
+        LOG_INFO(fmt::format(
+            "{}: {} meshlets ({:.1f} triangles, {:.1f} vertices each) built in {:.3f} ms, {:.1f}% culled over {} "
+            "views in {:.3f} ms",
+            name, meshlets.size(), triangles / meshletCount, vertices / meshletCount, buildElapsed.count() / 1000.0f,
+            100.0f * culled / (meshletCount * directions.size()), directions.size(), cullElapsed.count() / 1000.0f
+        ));
+    }
+}
\ No newline at end of file
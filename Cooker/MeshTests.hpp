@@ -0,0 +1,45 @@
+#pragma once
+
+/*
+ * Headless tests of the mesh processing passes.
+ *
+ * The meshes are generated here, so nothing is imported and the tests include only the standard library, fmt,
+ * the logger and the mesh headers. They build and run anywhere the mesh sources do.
+ */
+
+/*
+ * Checks the vertex cache analysis against triangle lists with a known miss count, then runs every
+ * MeshOptimizer pass on generated grids and spheres with shuffled triangles. Welding has to leave only unique
+ * vertices, vertex cache ordering has to cut the ACMR of a shuffled grid, overdraw ordering may only cost its
+ * threshold, vertex fetch ordering has to store vertices in the order they are first used and drop the unused
+ * ones, and no pass may lose a triangle or change its winding.
+ *
+ * @return True if every check passed.
+ */
+bool testMeshOptimizer();
+
+/*
+ * Runs the MeshOptimizer passes one at a time on a large generated sphere with every triangle's vertices
+ * duplicated and its triangles shuffled, and logs the time each pass took and the ACMR, ATVR and vertex count
+ * after it.
+ *
+ * @return True if every pass kept every triangle.
+ */
+bool benchmarkMeshOptimizer();
+
+/*
+ * Splits a sphere of 65k triangles into meshlets and checks the builder and the culler against it.
+ * Every triangle has to end up in exactly one meshlet, no meshlet can go over MaxVertices or MaxTriangles,
+ * and no meshlet culled from the cameras around the sphere can hold a front-facing triangle inside the frustum.
+ * A mesh of every triangle between 12 vertices checks the triangle limit, which a sphere never reaches.
+ *
+ * @return True if every check passed.
+ */
+bool testMeshlets();
+
+/*
+ * Splits generated spheres and a flat grid into meshlets and logs how long building took, how many triangles
+ * and vertices the meshlets hold on average, and how many of them the CPU culler rejects from cameras placed
+ * around each mesh, looking at its center.
+ */
+void benchmarkMeshlets();
\ No newline at end of file
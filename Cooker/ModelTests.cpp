@@ -0,0 +1,400 @@
+#include "ModelTests.hpp"
+#include "TestResult.hpp"
+
+#include "Core/Logger.hpp"
+#include "Core/MappedFile.hpp"
+#include "Core/ModelCooker.hpp"
+
+#include <fmt/core.h>
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <span>
+#include <string>
+#include <system_error>
+#include <vector>
+
+namespace core  = bisky::core;
+namespace scene = bisky::scene;
+
+namespace
+{
+
+/*
+ * Builds a model with a mesh that uses every section, an empty mesh, two materials, an image with bytes
+ * and one without, and a chain of three nodes.
+ *
+ * @param random The generator to fill the vertices, indices and meshlets with.
+ * @return The model, its spans point into its own storage.
+ */
+core::ModelData makeModel(std::mt19937 &random)
+{
+    constexpr uint32_t vertexCount   = 3000u;
+    constexpr uint32_t triangleCount = 4000u;
+    constexpr uint32_t meshletCount  = 20u;
+
+    std::uniform_real_distribution<float>   value(-10.0f, 10.0f);
+    std::uniform_int_distribution<uint32_t> vertex(0u, vertexCount - 1u);
+    std::uniform_int_distribution<uint32_t> byte(0u, 255u);
+
+    core::ModelData model;
+
+    // -------------- the geometry, as the importer would leave it --------------
+    std::vector<scene::Vertex> vertices(vertexCount);
+    for (auto &v : vertices)
+    {
+        v = {
+            .position = {value(random), value(random), value(random)},
+            .normal   = {value(random), value(random), value(random)},
+            .texCoord = {value(random), value(random)},
+            .tangent  = {value(random), value(random), value(random), 1.0f},
+        };
+    }
+
+    std::vector<uint32_t> indices(triangleCount * 3u);
+    for (auto &index : indices)
+    {
+        index = vertex(random);
+    }
+
+    std::vector<scene::Meshlet> meshlets(meshletCount);
+    for (uint32_t i = 0; i < meshletCount; i++)
+    {
+        meshlets[i] = {
+            .startIndexLocation = i * 372u,
+            .indexCount         = 372u,
+            .vertexCount        = 64u,
+            .radius             = value(random),
+            .center             = {value(random), value(random), value(random)},
+            .coneCutoff         = value(random),
+            .coneAxis           = {value(random), value(random), value(random)},
+            .padding            = 0.0f,
+        };
+    }
+
+    core::MeshData mesh = {.name = "Helmet"};
+
+    mesh.submeshes = {
+        {.startIndexLocation = 0u, .indexCount = 6000u, .materialIndex = 0, .meshletCount = 12u},
+        {.startIndexLocation = 6000u, .indexCount = 6000u, .materialIndex = 1, .firstMeshlet = 12u, .meshletCount = 8u},
+    };
+    mesh.lods = {
+        {.error = 0.01f, .submeshes = {{.indexCount = 3000u, .materialIndex = 0}, {.indexCount = 3000u}}},
+        {.error = 0.05f, .submeshes = {{.indexCount = 900u, .materialIndex = 0}, {.indexCount = 600u}}},
+    };
+    mesh.bounds = {.center = {1.0f, -2.0f, 0.5f}, .radius = 17.33f};
+
+    model.vertexStorage.push_back(std::move(vertices));
+    model.indexStorage.push_back(std::move(indices));
+    model.meshletStorage.push_back(std::move(meshlets));
+    mesh.vertices = model.vertexStorage.back();
+    mesh.indices  = model.indexStorage.back();
+    mesh.meshlets = model.meshletStorage.back();
+    model.meshes.push_back(std::move(mesh));
+    model.meshes.push_back({.name = "Empty"});
+
+    // -------------- materials, images and nodes --------------
+    model.materials.push_back(
+        {.name = "Metal", .diffuse = {0.5f, 0.25f, 1.0f}, .diffuseImage = 0, .metallicRoughnessImage = 1}
+    );
+    model.materials.push_back({.name = "Plain"});
+
+    std::vector<uint8_t> bytes(5000u);
+    for (auto &b : bytes)
+    {
+        b = static_cast<uint8_t>(byte(random));
+    }
+    model.imageStorage.push_back(std::move(bytes));
+    model.images.push_back({.name = "diffuse.png", .bytes = model.imageStorage.back()});
+    model.images.push_back({.name = "missing.ktx"});
+
+    model.nodes.push_back({.name = "Root"});
+    model.nodes.push_back({.name = "Body", .mesh = 0, .parent = 0, .scale = {2.0f, 2.0f, 2.0f}});
+    model.nodes.push_back(
+        {.name = "Visor", .mesh = 1, .parent = 1, .rotation = {90.0f, 0.0f, 45.0f}, .translation = {0.0f, 1.5f, 0.0f}}
+    );
+
+    return model;
+}
+
+/*
+ * Compares two ranges byte for byte.
+ */
+template <typename T> bool sameBytes(std::span<const T> a, std::span<const T> b)
+{
+    return a.size() == b.size() && (a.empty() || memcmp(a.data(), b.data(), a.size_bytes()) == 0);
+}
+
+/*
+ * Checks whether a range lies inside a mapped file.
+ */
+template <typename T> bool insideFile(std::span<const T> span, const core::MappedFile &file)
+{
+    auto bytes = reinterpret_cast<const uint8_t *>(span.data());
+    return span.empty() || (bytes >= file.data() && bytes + span.size_bytes() <= file.data() + file.size());
+}
+
+/*
+ * Checks everything read promises about a model it accepted, whatever the file held.
+ *
+ * @return True if every span is inside the mapped file and every index into the model is in range.
+ */
+bool isConsistent(const core::ModelData &model)
+{
+    if (!model.mappedFile || !model.mappedFile->isValid())
+    {
+        return false;
+    }
+
+    const core::MappedFile &file = *model.mappedFile;
+    for (auto &mesh : model.meshes)
+    {
+        auto outsideMesh = [&](const core::SubmeshData &submesh) {
+            return submesh.firstMeshlet + static_cast<uint64_t>(submesh.meshletCount) > mesh.meshlets.size();
+        };
+
+        bool consistent = insideFile(mesh.vertices, file) && insideFile(mesh.indices, file) &&
+                          insideFile(mesh.meshlets, file) && mesh.lods.size() < core::ModelCooker::MaxLodCount;
+        for (auto &submesh : mesh.submeshes)
+        {
+            consistent &= !outsideMesh(submesh);
+        }
+
+        for (auto &lod : mesh.lods)
+        {
+            consistent &= lod.submeshes.size() == mesh.submeshes.size();
+            for (auto &submesh : lod.submeshes)
+            {
+                consistent &= !outsideMesh(submesh);
+            }
+        }
+
+        if (!consistent)
+        {
+            return false;
+        }
+    }
+
+    for (auto &image : model.images)
+    {
+        if (!insideFile(image.bytes, file))
+        {
+            return false;
+        }
+    }
+
+    for (size_t i = 0; i < model.nodes.size(); i++)
+    {
+        auto &node = model.nodes[i];
+        if (node.mesh >= static_cast<int64_t>(model.meshes.size()) || node.parent >= static_cast<int64_t>(i))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::vector<char> readBytes(const std::filesystem::path &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+}
+
+void writeBytes(const std::filesystem::path &path, std::span<const char> bytes)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(bytes.data(), static_cast<std::streamsize>(bytes.size()));
+}
+
+} // namespace
+
+bool testCookedModel()
+{
+    TestResult result = {.name = "CookedModel"};
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::filesystem::path path      = directory / "BiskyCookedModelTest.bmesh";
+    const std::filesystem::path corrupt   = directory / "BiskyCookedModelTest.corrupt.bmesh";
+
+    std::mt19937                         random(3u);
+    const core::ModelData                source = makeModel(random);
+    const core::ModelCooker::SourceStamp stamp  = {.optionsHash = 11u, .sourcesHash = 22u};
+    const core::ModelCooker::SourceStamp stale  = {.optionsHash = 11u, .sourcesHash = 23u};
+    std::error_code                      ec;
+
+    // -------------- cook --------------
+    result.check(core::ModelCooker::write(path, source, stamp), "the model is written");
+    result.check(!std::filesystem::exists(path.string() + ".tmp", ec), "the temporary file is renamed");
+
+    const uint64_t fileSize = std::filesystem::file_size(path, ec);
+    result.check(fileSize > 0u && fileSize % core::ModelCooker::Alignment == 0u, "the file ends on a page boundary");
+
+    // -------------- map and read back --------------
+    {
+        core::ModelData model;
+        const bool      read = core::ModelCooker::read(path, model, &stamp);
+        result.check(read && model.mappedFile && model.mappedFile->size() == fileSize, "the file is mapped whole");
+        if (!read)
+        {
+            return result.report();
+        }
+
+        const core::MappedFile &file = *model.mappedFile;
+        result.check(model.meshes.size() == source.meshes.size(), "every mesh is read");
+        for (size_t i = 0; i < std::min(model.meshes.size(), source.meshes.size()); i++)
+        {
+            auto      &mesh     = model.meshes[i];
+            auto      &expected = source.meshes[i];
+            const auto what     = fmt::format("mesh {}", expected.name);
+
+            result.check(mesh.name == expected.name, what + ": the name reads back");
+            result.check(sameBytes(mesh.vertices, expected.vertices), what + ": the vertices read back");
+            result.check(sameBytes(mesh.indices, expected.indices), what + ": the indices read back");
+            result.check(sameBytes(mesh.meshlets, expected.meshlets), what + ": the meshlets read back");
+            result.check(
+                sameBytes<core::SubmeshData>(mesh.submeshes, expected.submeshes), what + ": the submeshes read back"
+            );
+            result.check(
+                memcmp(&mesh.bounds, &expected.bounds, sizeof(scene::MeshBounds)) == 0, what + ": the bounds read back"
+            );
+            result.check(
+                insideFile(mesh.vertices, file) && insideFile(mesh.indices, file) && insideFile(mesh.meshlets, file),
+                what + ": the vertices, indices and meshlets are read in place"
+            );
+
+            result.check(mesh.lods.size() == expected.lods.size(), what + ": every level of detail is read");
+            for (size_t l = 0; l < std::min(mesh.lods.size(), expected.lods.size()); l++)
+            {
+                result.check(
+                    mesh.lods[l].error == expected.lods[l].error &&
+                        sameBytes<core::SubmeshData>(mesh.lods[l].submeshes, expected.lods[l].submeshes),
+                    fmt::format("{}: level {} reads back", what, l + 1u)
+                );
+            }
+        }
+
+        result.check(model.materials.size() == source.materials.size(), "every material is read");
+        for (size_t i = 0; i < std::min(model.materials.size(), source.materials.size()); i++)
+        {
+            auto &material = model.materials[i];
+            auto &expected = source.materials[i];
+            result.check(
+                material.name == expected.name && material.diffuse.x == expected.diffuse.x &&
+                    material.diffuse.y == expected.diffuse.y && material.diffuse.z == expected.diffuse.z &&
+                    material.diffuseImage == expected.diffuseImage &&
+                    material.metallicRoughnessImage == expected.metallicRoughnessImage &&
+                    material.normalImage == expected.normalImage,
+                fmt::format("material {} reads back", expected.name)
+            );
+        }
+
+        result.check(model.images.size() == source.images.size(), "every image is read");
+        for (size_t i = 0; i < std::min(model.images.size(), source.images.size()); i++)
+        {
+            auto &image    = model.images[i];
+            auto &expected = source.images[i];
+            result.check(
+                image.name == expected.name && sameBytes(image.bytes, expected.bytes) && insideFile(image.bytes, file),
+                fmt::format("image {} reads back in place", expected.name)
+            );
+        }
+
+        result.check(model.nodes.size() == source.nodes.size(), "every node is read");
+        for (size_t i = 0; i < std::min(model.nodes.size(), source.nodes.size()); i++)
+        {
+            auto &node     = model.nodes[i];
+            auto &expected = source.nodes[i];
+            result.check(
+                node.name == expected.name && node.mesh == expected.mesh && node.parent == expected.parent &&
+                    memcmp(&node.scale, &expected.scale, sizeof(node.scale)) == 0 &&
+                    memcmp(&node.rotation, &expected.rotation, sizeof(node.rotation)) == 0 &&
+                    memcmp(&node.translation, &expected.translation, sizeof(node.translation)) == 0,
+                fmt::format("node {} reads back", expected.name)
+            );
+        }
+
+        result.check(isConsistent(model), "the model is consistent");
+    }
+
+    // -------------- stale files are refused --------------
+    {
+        core::ModelData model;
+        result.check(!core::ModelCooker::read(path, model, &stale), "a file with another stamp is refused");
+        result.check(core::ModelCooker::read(path, model), "a file is read without a stamp to check");
+    }
+
+    const std::vector<char> bytes = readBytes(path);
+    {
+        // the header starts with the magic and the version
+        std::vector<char> newer   = bytes;
+        uint32_t          version = core::ModelCooker::Version + 1u;
+        memcpy(newer.data() + sizeof(uint32_t), &version, sizeof(version));
+        writeBytes(corrupt, newer);
+
+        core::ModelData model;
+        result.check(!core::ModelCooker::read(corrupt, model), "a file with another version is refused");
+    }
+
+    {
+        writeBytes(corrupt, std::span(bytes).first(bytes.size() - core::ModelCooker::Alignment));
+
+        core::ModelData model;
+        result.check(!core::ModelCooker::read(corrupt, model), "a truncated file is refused");
+    }
+
+    {
+        std::vector<char> longer = bytes;
+        longer.resize(bytes.size() + core::ModelCooker::Alignment);
+        writeBytes(corrupt, longer);
+
+        core::ModelData model;
+        result.check(!core::ModelCooker::read(corrupt, model), "a file longer than the header says is refused");
+    }
+
+    {
+        writeBytes(corrupt, std::span(bytes).first(16u));
+
+        core::ModelData model;
+        result.check(!core::ModelCooker::read(corrupt, model), "a file shorter than the header is refused");
+        result.check(!core::ModelCooker::read(directory / "BiskyMissing.bmesh", model), "a missing file is refused");
+    }
+
+    // -------------- corrupt the header and the tables, whatever is accepted has to stay in the file --------------
+    {
+        // the header and the seven tables each start a page, and none of them fills 256 bytes of it here
+        // half of the flips land in the header, where the counts and offsets of every section are
+        std::discrete_distribution<size_t>    page({7.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0});
+        std::uniform_int_distribution<size_t> offset(0u, 255u);
+        std::uniform_int_distribution<int>    bit(0, 7);
+
+        core::setLogLevel(core::Error);
+        uint32_t accepted = 0u;
+        for (uint32_t run = 0; run < 500u; run++)
+        {
+            std::vector<char> corrupted = bytes;
+            for (uint32_t flip = 0; flip < 2u; flip++)
+            {
+                corrupted[page(random) * core::ModelCooker::Alignment + offset(random)] ^=
+                    static_cast<char>(1 << bit(random));
+            }
+            writeBytes(corrupt, corrupted);
+
+            core::ModelData model;
+            if (core::ModelCooker::read(corrupt, model))
+            {
+                accepted++;
+                result.check(isConsistent(model), fmt::format("corrupted file {} stays inside the file", run));
+            }
+        }
+
+        core::setLogLevel(core::Info);
+        LOG_INFO(fmt::format("CookedModel: {} of 500 corrupted files were accepted", accepted));
+    }
+
+    std::filesystem::remove(path, ec);
+    std::filesystem::remove(corrupt, ec);
+    return result.report();
+}
\ No newline at end of file
@@ -0,0 +1,18 @@
+#pragma once
+
+/*
+ * Headless tests of the cooked model container.
+ *
+ * Writing, mapping and reading a .bmesh only needs the standard library, fmt, the logger and the model headers,
+ * so these build and run anywhere CookedModel.cpp and MappedFile.cpp do.
+ */
+
+/*
+ * Writes a model with every kind of section to a temporary file, maps it back and checks that every mesh,
+ * level of detail, submesh, meshlet, material, image and node reads back as written, with the vertices,
+ * indices and image bytes pointing into the mapped view. Then checks that a stale stamp, a newer version or a
+ * truncated file are refused, and that corrupting the header at random never yields a span outside the file.
+ *
+ * @return True if every check passed.
+ */
+bool testCookedModel();
\ No newline at end of file
@@ -0,0 +1,641 @@
+#include "SceneTests.hpp"
+#include "TestResult.hpp"
+
+#include "Core/Logger.hpp"
+#include "Scene/EntityRegistry.hpp"
+#include "Scene/FrustumCuller.hpp"
+
+#include <fmt/core.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <initializer_list>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace scene = bisky::scene;
+
+namespace
+{
+
+// -------------- the layout of MeshInstance, Bounds and RenderFlags, without the device headers --------------
+struct Instance
+{
+    const void *mesh     = nullptr;
+    uint32_t    topology = 4u; // D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST
+};
+
+struct Sphere
+{
+    float x      = 0.0f;
+    float y      = 0.0f;
+    float z      = 0.0f;
+    float radius = 0.0f;
+};
+
+struct Flags
+{
+    uint32_t numFramesDirty = 3u; // Device::FramesInFlight
+    bool     visible        = true;
+};
+
+struct Hidden
+{
+    uint32_t frame = 0u;
+};
+
+/*
+ * What an entity of testEntities should have, the sphere's x is the entity's number.
+ */
+struct Expected
+{
+    scene::Entity entity;
+    bool          alive    = true;
+    bool          instance = false;
+    bool          flags    = false;
+    bool          hidden   = false;
+    uint32_t      frame    = 0u;
+};
+
+// every kernel, with the name its results are logged with
+constexpr std::pair<scene::CullKernel, std::string_view> Kernels[] = {
+    {scene::CullKernel::Scalar, "Scalar"},
+    {scene::CullKernel::Sse, "SSE2, 4 wide"},
+    {scene::CullKernel::Avx, "AVX, 8 wide"},
+};
+
+float elapsedSince(std::chrono::system_clock::time_point start)
+{
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start);
+    return elapsed.count() / 1000.0f;
+}
+
+bool isClose(const dx::XMFLOAT3 &a, const dx::XMFLOAT3 &b)
+{
+    return std::abs(a.x - b.x) < 1e-4f && std::abs(a.y - b.y) < 1e-4f && std::abs(a.z - b.z) < 1e-4f;
+}
+
+std::vector<scene::Vertex> makeVertices(std::initializer_list<dx::XMFLOAT3> positions)
+{
+    std::vector<scene::Vertex> vertices;
+    for (auto &position : positions)
+    {
+        scene::Vertex &vertex = vertices.emplace_back();
+        vertex.position       = position;
+    }
+    return vertices;
+}
+
+/*
+ * Gets the frustum of a camera at the origin looking down z.
+ *
+ * @param fov The vertical field of view in radians.
+ * @param aspect The width over the height.
+ * @param farZ The distance to the far plane.
+ * @return The world space frustum.
+ */
+scene::Frustum getFrustum(float fov, float aspect, float farZ)
+{
+    const dx::XMVECTOR eye        = dx::XMVectorZero();
+    const dx::XMVECTOR forward    = dx::XMVectorSet(0.0f, 0.0f, 1.0f, 0.0f);
+    const dx::XMVECTOR up         = dx::XMVectorSet(0.0f, 1.0f, 0.0f, 0.0f);
+    const dx::XMMATRIX view       = dx::XMMatrixLookToLH(eye, forward, up);
+    const dx::XMMATRIX projection = dx::XMMatrixPerspectiveFovLH(fov, aspect, 0.1f, farZ);
+    return scene::MeshletCuller::getFrustum(view * projection);
+}
+
+} // namespace
+
+bool testEntities()
+{
+    constexpr uint32_t entityCount = 10000u;
+
+    TestResult            result = {.name = "EntityRegistry"};
+    scene::EntityRegistry registry;
+    std::vector<Expected> expected;
+
+    auto create = [&](uint32_t number) {
+        const Sphere sphere = {.x = static_cast<float>(number), .radius = 1.0f};
+        Expected     entity = {.instance = number % 3u == 2u, .flags = number % 3u != 2u, .hidden = number % 3u == 1u};
+        if (entity.instance)
+        {
+            entity.entity = registry.create(Instance{}, sphere);
+        }
+        else if (entity.hidden)
+        {
+            entity.frame  = number;
+            entity.entity = registry.create(sphere, Flags{.numFramesDirty = number}, Hidden{.frame = number});
+        }
+        else
+        {
+            entity.entity = registry.create(sphere, Flags{.numFramesDirty = number});
+        }
+        expected.push_back(entity);
+    };
+
+    // -------------- every entity has to be found through its handle, with the components it was given --------------
+    auto checkEntities = [&](std::string_view when) {
+        uint32_t alive = 0u, flags = 0u, hidden = 0u;
+        for (uint32_t number = 0; number < expected.size(); number++)
+        {
+            const Expected &entity = expected[number];
+            if (!entity.alive)
+            {
+                result.check(!registry.isAlive(entity.entity), fmt::format("{}: destroyed {} is alive", when, number));
+                result.check(
+                    registry.get<Sphere>(entity.entity) == nullptr,
+                    fmt::format("{}: destroyed {} has a sphere", when, number)
+                );
+                continue;
+            }
+
+            alive++;
+            flags += entity.flags ? 1u : 0u;
+            hidden += entity.hidden ? 1u : 0u;
+
+            const Sphere *sphere = registry.get<Sphere>(entity.entity);
+            const Flags  *flag   = registry.get<Flags>(entity.entity);
+            const Hidden *hide   = registry.get<Hidden>(entity.entity);
+            result.check(registry.isAlive(entity.entity), fmt::format("{}: {} isn't alive", when, number));
+            result.check(
+                sphere && sphere->x == static_cast<float>(number) && sphere->radius == 1.0f,
+                fmt::format("{}: {} lost its sphere", when, number)
+            );
+            result.check(
+                (registry.get<Instance>(entity.entity) != nullptr) == entity.instance,
+                fmt::format("{}: {} has the wrong instance", when, number)
+            );
+            result.check(
+                (flag != nullptr) == entity.flags && (!flag || (flag->numFramesDirty == number && flag->visible)),
+                fmt::format("{}: {} has the wrong flags", when, number)
+            );
+            result.check(
+                (hide != nullptr) == entity.hidden && (!hide || hide->frame == entity.frame),
+                fmt::format("{}: {} has the wrong hidden", when, number)
+            );
+        }
+
+        result.check(registry.getCount() == alive, fmt::format("{}: {} entities", when, registry.getCount()));
+        result.check(registry.count<Sphere>() == alive, fmt::format("{}: wrong sphere count", when));
+        result.check(registry.count<const Sphere, Flags>() == flags, fmt::format("{}: wrong flags count", when));
+        result.check(registry.count<Hidden, Sphere>() == hidden, fmt::format("{}: wrong hidden count", when));
+
+        // -------------- a query visits every entity with its components once, on one thread or many --------------
+        std::vector<uint32_t> visits(expected.size());
+        bool                  handles = true;
+        registry.forEach<const Sphere>([&](const scene::Entity *entities, uint32_t count, const Sphere *spheres) {
+            for (uint32_t row = 0; row < count; row++)
+            {
+                const uint32_t number = static_cast<uint32_t>(spheres[row].x);
+                visits[number]++;
+                handles &= entities[row] == expected[number].entity;
+            }
+        });
+        result.check(handles, fmt::format("{}: forEach gave an entity the wrong handle", when));
+
+        std::vector<std::atomic<uint32_t>> parallelVisits(expected.size());
+        registry.parallelForEach<const Sphere, Flags>(
+            [&](const scene::Entity *, uint32_t count, const Sphere *spheres, Flags *flags) {
+                for (uint32_t row = 0; row < count; row++)
+                {
+                    const uint32_t number = static_cast<uint32_t>(spheres[row].x);
+                    parallelVisits[number].fetch_add(flags[row].numFramesDirty == number ? 1u : 2u);
+                }
+            }
+        );
+
+        for (uint32_t number = 0; number < expected.size(); number++)
+        {
+            const Expected &entity = expected[number];
+            result.check(
+                visits[number] == (entity.alive ? 1u : 0u),
+                fmt::format("{}: forEach visited {} {} times", when, number, visits[number])
+            );
+            result.check(
+                parallelVisits[number].load() == (entity.alive && entity.flags ? 1u : 0u),
+                fmt::format("{}: parallelForEach visited {} wrongly", when, number)
+            );
+        }
+    };
+
+    uint64_t version = registry.getVersion();
+    for (uint32_t number = 0; number < entityCount; number++)
+    {
+        create(number);
+    }
+    result.check(registry.getVersion() != version, "creating didn't change the version");
+    result.check(registry.getArchetypeCount() == 3u, fmt::format("{} archetypes", registry.getArchetypeCount()));
+    result.check(registry.getChunkCount() > 3u, "the entities fit in one chunk per archetype");
+    checkEntities("created");
+
+    // -------------- reading doesn't change the version, nor does destroying an entity that is gone --------------
+    version = registry.getVersion();
+    registry.get<Sphere>(expected[0].entity);
+    registry.forEach<Sphere>([](const scene::Entity *, uint32_t, Sphere *) {});
+    result.check(registry.getVersion() == version, "reading changed the version");
+
+    for (uint32_t number = 0; number < entityCount; number += 5u)
+    {
+        registry.destroy(expected[number].entity);
+        expected[number].alive = false;
+    }
+    result.check(registry.getVersion() != version, "destroying didn't change the version");
+    checkEntities("destroyed");
+
+    version = registry.getVersion();
+    registry.destroy(expected[0].entity);
+    registry.remove<Hidden>(expected[2].entity);
+    result.check(registry.getVersion() == version, "doing nothing changed the version");
+
+    // -------------- moving between archetypes keeps the components both have --------------
+    for (uint32_t number = 1; number < entityCount; number += 7u)
+    {
+        if (!expected[number].alive || !expected[number].flags)
+        {
+            continue;
+        }
+
+        Expected &entity = expected[number];
+        entity.frame     = number + 1u;
+        if (entity.hidden && number % 2u == 0u)
+        {
+            registry.remove<Hidden>(entity.entity);
+            entity.hidden = false;
+            continue;
+        }
+
+        registry.add(entity.entity, Hidden{.frame = entity.frame});
+        entity.hidden = true;
+    }
+    result.check(registry.getVersion() != version, "moving didn't change the version");
+    checkEntities("moved");
+
+    // -------------- the freed slots are reused, but the old handles must not find the new entities --------------
+    for (uint32_t number = entityCount; number < entityCount + entityCount / 5u; number++)
+    {
+        create(number);
+    }
+    for (uint32_t number = 0; number < entityCount; number += 5u)
+    {
+        const scene::Entity stale = expected[number].entity;
+        result.check(
+            std::ranges::any_of(expected, [&](const Expected &entity) {
+                return entity.alive && entity.entity.index == stale.index;
+            }),
+            fmt::format("the slot of {} wasn't reused", number)
+        );
+    }
+    checkEntities("recreated");
+
+    return result.report();
+}
+
+bool benchmarkEntities()
+{
+    constexpr uint32_t entityCount = 1000000u;
+    constexpr uint32_t runs        = 20u;
+
+    struct HeapObject
+    {
+        std::string name;
+        Instance    instance;
+        Sphere      bounds;
+        Flags       flags;
+    };
+
+    std::mt19937                          random(7u);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::vector<Sphere>                   bounds(entityCount);
+    for (auto &sphere : bounds)
+    {
+        sphere = {.x = position(random), .y = position(random), .z = position(random), .radius = 1.0f};
+    }
+
+    // -------------- one heap object per entity, spread around the heap like a session leaves them --------------
+    std::vector<std::shared_ptr<HeapObject>> objects;
+    for (uint32_t i = 0; i < entityCount; i++)
+    {
+        auto &object   = objects.emplace_back(std::make_shared<HeapObject>());
+        object->name   = fmt::format("Entity {}", i);
+        object->bounds = bounds[i];
+    }
+    std::shuffle(objects.begin(), objects.end(), random);
+
+    // -------------- the same entities in a registry, a quarter of them hidden behind an extra component --------------
+    scene::EntityRegistry      registry;
+    std::vector<scene::Entity> entities(entityCount);
+    auto                       start = std::chrono::system_clock::now();
+    for (uint32_t i = 0; i < entityCount; i++)
+    {
+        entities[i] = i % 4u == 0u ? registry.create(Instance{}, bounds[i], Flags{}, Hidden{})
+                                   : registry.create(Instance{}, bounds[i], Flags{});
+    }
+    LOG_INFO(fmt::format(
+        "Created {} entities in {:.1f} ms, {} archetypes, {} chunks", registry.getCount(), elapsedSince(start),
+        registry.getArchetypeCount(), registry.getChunkCount()
+    ));
+
+    // -------------- the work a frame does per entity: age its constants and test it against a plane --------------
+    auto visit = [](const Sphere &sphere, Flags &flags) {
+        flags.numFramesDirty = flags.numFramesDirty > 0u ? flags.numFramesDirty - 1u : 0u;
+        return flags.visible && sphere.x + sphere.radius > 0.0f ? 1u : 0u;
+    };
+
+    auto measure = [&](std::string_view name, auto walk) {
+        uint32_t drawn = 0u;
+        auto     begin = std::chrono::system_clock::now();
+        for (uint32_t run = 0; run < runs; run++)
+        {
+            drawn = walk();
+        }
+
+        const float milliseconds = elapsedSince(begin) / runs;
+        LOG_INFO(fmt::format(
+            "{}: {:.3f} ms per walk, {:.1f}M entities per second, {} drawn", name, milliseconds,
+            entityCount / milliseconds / 1000.0f, drawn
+        ));
+        return drawn;
+    };
+
+    const uint32_t heapDrawn = measure("shared_ptr per object", [&]() {
+        uint32_t drawn = 0u;
+        for (auto &object : objects)
+        {
+            drawn += visit(object->bounds, object->flags);
+        }
+        return drawn;
+    });
+
+    auto walkChunk = [&](uint32_t count, const Sphere *spheres, Flags *flags) {
+        uint32_t drawn = 0u;
+        for (uint32_t row = 0; row < count; row++)
+        {
+            drawn += visit(spheres[row], flags[row]);
+        }
+        return drawn;
+    };
+
+    const uint32_t chunkDrawn = measure("Chunks", [&]() {
+        uint32_t drawn = 0u;
+        registry.forEach<const Sphere, Flags>(
+            [&](const scene::Entity *, uint32_t count, const Sphere *spheres, Flags *flags) {
+                drawn += walkChunk(count, spheres, flags);
+            }
+        );
+        return drawn;
+    });
+
+    const uint32_t parallelDrawn = measure("Chunks, job system", [&]() {
+        std::atomic<uint32_t> drawn = 0u;
+        registry.parallelForEach<const Sphere, Flags>(
+            [&](const scene::Entity *, uint32_t count, const Sphere *spheres, Flags *flags) {
+                drawn.fetch_add(walkChunk(count, spheres, flags), std::memory_order_relaxed);
+            }
+        );
+        return drawn.load();
+    });
+
+    // -------------- churn, every other entity destroyed then created again in a free slot --------------
+    const std::vector<scene::Entity> destroyed = entities;
+    start                                      = std::chrono::system_clock::now();
+    for (uint32_t i = 0; i < entityCount; i += 2u)
+    {
+        registry.destroy(entities[i]);
+    }
+    for (uint32_t i = 0; i < entityCount; i += 2u)
+    {
+        entities[i] = registry.create(Instance{}, bounds[i], Flags{});
+    }
+    const float churnTime = elapsedSince(start);
+
+    // -------------- the slots were reused, but the old handles must not find the new entities --------------
+    uint32_t stale = 0u;
+    for (uint32_t i = 0; i < entityCount; i += 2u)
+    {
+        stale += registry.isAlive(destroyed[i]) ? 1u : 0u;
+    }
+    LOG_INFO(fmt::format(
+        "Destroyed and recreated {} entities in {:.1f} ms, {} destroyed handles still valid, {} chunks",
+        entityCount / 2u, churnTime, stale, registry.getChunkCount()
+    ));
+
+    bool passed = true;
+    if (chunkDrawn != heapDrawn || parallelDrawn != heapDrawn)
+    {
+        LOG_ERROR(fmt::format("The walks drew {}, {} and {} entities", heapDrawn, chunkDrawn, parallelDrawn));
+        passed = false;
+    }
+
+    if (stale != 0u || registry.getCount() != entityCount)
+    {
+        LOG_ERROR(fmt::format("{} stale handles found an entity, {} entities left", stale, registry.getCount()));
+        passed = false;
+    }
+
+    return passed;
+}
+
+bool testCulling()
+{
+    TestResult result = {.name = "FrustumCuller"};
+
+    // -------------- the sphere is centered on the box, its radius reaches the farthest vertex --------------
+    const scene::MeshBounds none = scene::FrustumCuller::computeBounds({});
+    result.check(isClose(none.center, {0.0f, 0.0f, 0.0f}) && none.radius == 0.0f, "the bounds of no vertices");
+
+    const scene::MeshBounds box = scene::FrustumCuller::computeBounds(makeVertices({
+        {4.0f, -5.0f, -1.0f},
+        {6.0f, -1.0f, 5.0f},
+        {5.0f, -3.0f, 2.0f},
+        {6.0f, -5.0f, 5.0f},
+        {4.0f, -1.0f, -1.0f},
+    }));
+    result.check(isClose(box.center, {5.0f, -3.0f, 2.0f}), "the center of a box");
+    result.check(std::abs(box.radius - std::sqrt(14.0f)) < 1e-4f, fmt::format("the radius of a box: {}", box.radius));
+
+    // -------------- not the centroid, most of these vertices are on one side --------------
+    const scene::MeshBounds lopsided = scene::FrustumCuller::computeBounds(makeVertices({
+        {0.0f, 0.0f, 0.0f},
+        {0.0f, 2.0f, 0.0f},
+        {1.0f, 1.0f, 0.0f},
+        {0.5f, 0.5f, 0.0f},
+        {10.0f, 0.0f, 0.0f},
+    }));
+    result.check(isClose(lopsided.center, {5.0f, 1.0f, 0.0f}), "the center of a lopsided mesh");
+    result.check(std::abs(lopsided.radius - std::sqrt(26.0f)) < 1e-4f, "the radius of a lopsided mesh");
+
+    // -------------- around every plane of a 90 degree frustum, its sides are |x| = z and |y| = z --------------
+    const scene::Frustum frustum = getFrustum(dx::XM_PIDIV2, 1.0f, 100.0f);
+
+    const std::pair<scene::Bounds, bool> known[] = {
+        {{.center = {0.0f, 0.0f, 10.0f}, .radius = 1.0f}, true},     // in front
+        {{.center = {0.0f, 0.0f, -10.0f}, .radius = 1.0f}, false},   // behind the camera
+        {{.center = {0.0f, 0.0f, 0.0f}, .radius = 0.5f}, true},      // around the camera, reaching past the near plane
+        {{.center = {0.0f, 0.0f, -0.5f}, .radius = 0.5f}, false},    // behind the near plane
+        {{.center = {0.0f, 0.0f, 100.5f}, .radius = 1.0f}, true},    // past the far plane, reaching back into it
+        {{.center = {0.0f, 0.0f, 102.0f}, .radius = 1.0f}, false},   // past the far plane
+        {{.center = {-10.5f, 0.0f, 10.0f}, .radius = 1.0f}, true},   // left, reaching into the frustum
+        {{.center = {-12.0f, 0.0f, 10.0f}, .radius = 1.0f}, false},  // left
+        {{.center = {12.0f, 0.0f, 10.0f}, .radius = 1.0f}, false},   // right
+        {{.center = {10.5f, 0.0f, 10.0f}, .radius = 1.0f}, true},    // right, reaching into the frustum
+        {{.center = {0.0f, -12.0f, 10.0f}, .radius = 1.0f}, false},  // below
+        {{.center = {0.0f, 10.5f, 10.0f}, .radius = 1.0f}, true},    // above, reaching into the frustum
+        {{.center = {0.0f, 12.0f, 10.0f}, .radius = 1.0f}, false},   // above
+        {{.center = {-50.0f, 50.0f, 40.0f}, .radius = 20.0f}, true}, // a large one over a corner
+    };
+    constexpr uint32_t knownCount = static_cast<uint32_t>(std::size(known));
+
+    // -------------- every count up to a few AVX widths, so every kernel runs its tail and stops there --------------
+    constexpr uint8_t untouched = 0xCDu;
+    for (auto [kernel, name] : Kernels)
+    {
+        if (!scene::FrustumCuller::isSupported(kernel))
+        {
+            result.check(kernel == scene::CullKernel::Avx, fmt::format("{} isn't supported", name));
+            continue;
+        }
+
+        for (uint32_t count = 0; count <= 3u * 8u + 3u; count++)
+        {
+            std::vector<scene::Bounds> spheres(count);
+            uint32_t                   expectedCount = 0u;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                spheres[i]     = known[i % knownCount].first;
+                expectedCount += known[i % knownCount].second ? 1u : 0u;
+            }
+
+            std::vector<uint8_t> visible(count + 8u, untouched);
+            const uint32_t       visibleCount =
+                scene::FrustumCuller::cull(frustum, spheres.data(), count, visible.data(), kernel);
+            result.check(
+                visibleCount == expectedCount,
+                fmt::format("{}: {} of {} visible, expected {}", name, visibleCount, count, expectedCount)
+            );
+
+            for (uint32_t i = 0; i < count + 8u; i++)
+            {
+                const uint8_t expected = i >= count ? untouched : known[i % knownCount].second ? 1u : 0u;
+                result.check(visible[i] == expected, fmt::format("{}: sphere {} of {}", name, i, count));
+            }
+        }
+    }
+
+    // -------------- random spheres, every kernel has to agree with the scalar one --------------
+    constexpr uint32_t randomCount = 10007u;
+
+    std::mt19937                          random(11u);
+    std::uniform_real_distribution<float> position(-150.0f, 150.0f);
+    std::uniform_real_distribution<float> radius(0.0f, 10.0f);
+    std::vector<scene::Bounds>            spheres(randomCount);
+    for (auto &sphere : spheres)
+    {
+        sphere = {.center = {position(random), position(random), position(random)}, .radius = radius(random)};
+    }
+
+    const scene::Frustum wide = getFrustum(dx::XM_PIDIV4, 16.0f / 9.0f, 120.0f);
+    std::vector<uint8_t> expected(randomCount);
+    const uint32_t       expectedCount =
+        scene::FrustumCuller::cull(wide, spheres.data(), randomCount, expected.data(), scene::CullKernel::Scalar);
+    result.check(expectedCount > 0u && expectedCount < randomCount, "the random spheres are all in or all out");
+
+    for (auto [kernel, name] : Kernels)
+    {
+        if (kernel == scene::CullKernel::Scalar || !scene::FrustumCuller::isSupported(kernel))
+        {
+            continue;
+        }
+
+        std::vector<uint8_t> visible(randomCount, untouched);
+        const uint32_t       visibleCount =
+            scene::FrustumCuller::cull(wide, spheres.data(), randomCount, visible.data(), kernel);
+        result.check(
+            visibleCount == expectedCount && visible == expected,
+            fmt::format("{} differs from the scalar kernel on random spheres", name)
+        );
+    }
+
+    return result.report();
+}
+
+bool benchmarkCulling()
+{
+    constexpr uint32_t objectCount = 1000000u;
+    constexpr uint32_t runs        = 20u;
+
+    std::mt19937                          random(7u);
+    std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> radius(0.5f, 4.0f);
+
+    scene::EntityRegistry      registry;
+    std::vector<scene::Bounds> spheres(objectCount);
+    for (auto &sphere : spheres)
+    {
+        sphere = {.center = {position(random), position(random), position(random)}, .radius = radius(random)};
+        registry.create(sphere);
+    }
+
+    // -------------- a camera in the middle of them looking down z, most of them are behind or beside it --------------
+    const scene::Frustum frustum = getFrustum(dx::XM_PIDIV4, 16.0f / 9.0f, 1000.0f);
+
+    std::vector<uint8_t> expected(objectCount);
+    std::vector<uint8_t> visible(objectCount);
+
+    const uint32_t expectedCount =
+        scene::FrustumCuller::cull(frustum, spheres.data(), objectCount, expected.data(), scene::CullKernel::Scalar);
+
+    bool passed  = true;
+    auto measure = [&](std::string_view name, auto cullAll) {
+        std::ranges::fill(visible, uint8_t(2u));
+
+        uint32_t visibleCount = 0u;
+        auto     start        = std::chrono::system_clock::now();
+        for (uint32_t run = 0; run < runs; run++)
+        {
+            visibleCount = cullAll();
+        }
+
+        const float milliseconds = elapsedSince(start) / runs;
+        const bool  agrees       = visibleCount == expectedCount && visible == expected;
+        LOG_INFO(fmt::format(
+            "{}: {:.3f} ms, {:.1f}M spheres per second, {} visible, {} culled{}", name, milliseconds,
+            objectCount / milliseconds / 1000.0f, visibleCount, objectCount - visibleCount,
+            agrees ? "" : ", DIFFERS FROM SCALAR"
+        ));
+        passed &= agrees;
+    };
+
+    for (auto [kernel, name] : Kernels)
+    {
+        if (!scene::FrustumCuller::isSupported(kernel))
+        {
+            LOG_INFO(fmt::format("{} is not supported, skipping it", name));
+            continue;
+        }
+
+        measure(name, [&]() {
+            return scene::FrustumCuller::cull(frustum, spheres.data(), objectCount, visible.data(), kernel);
+        });
+
+        // -------------- the registry keeps the entities in creation order, so the results line up --------------
+        measure(fmt::format("{}, registry chunks", name), [&]() {
+            uint32_t visibleCount = 0u;
+            uint32_t first        = 0u;
+            registry.forEach<const scene::Bounds>(
+                [&](const scene::Entity *, uint32_t count, const scene::Bounds *bounds) {
+                    visibleCount += scene::FrustumCuller::cull(frustum, bounds, count, visible.data() + first, kernel);
+                    first += count;
+                }
+            );
+            return visibleCount;
+        });
+    }
+
+    return passed;
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+
+/*
+ * Headless tests of the entity registry and the frustum culler.
+ *
+ * MeshInstance and RenderFlags pull in the device headers, so the entity tests use plain structs with the same
+ * layout instead. The tests include only the standard library, fmt, DirectXMath, the logger and the scene headers
+ * they test.
+ */
+
+/*
+ * Creates entities with several sets of components, enough to fill many chunks, then destroys some, adds and
+ * removes components and reuses their slots. Every live entity has to keep its components, handles to
+ * destroyed entities have to stop finding anything, the counts have to match, a query has to visit every
+ * matching entity exactly once, on one thread and on the job system, and the version may only change when
+ * entities are created, destroyed or moved.
+ *
+ * @return True if every check passed.
+ */
+bool testEntities();
+
+/*
+ * Walks the render components of 1M entities, kept the way Scene kept its objects, one shared_ptr each,
+ * against walking the packed chunks of an EntityRegistry, on one thread and on the job system.
+ * Also times creating them and destroying and recreating half of them.
+ *
+ * @return True if every walk drew the same entities and no destroyed handle found a recreated entity.
+ */
+bool benchmarkEntities();
+
+/*
+ * Checks computeBounds against point sets with a known sphere, then culls spheres with a known result against
+ * a 90 degree frustum: inside it, behind each plane, and just inside and just outside of them. Every kernel has
+ * to agree with the expected result for every count up to a few of its widths, so the tails are covered, must not
+ * write past the last sphere and has to agree with the scalar kernel on many random spheres.
+ *
+ * @return True if every check passed.
+ */
+bool testCulling();
+
+/*
+ * Culls 1M spheres scattered around a camera with every supported kernel, once as one array and once
+ * chunk by chunk out of an EntityRegistry the way ForwardRenderer does.
+ *
+ * @return True if every kernel agreed with the scalar one on every sphere.
+ */
+bool benchmarkCulling();
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Core/Logger.hpp"
+
+#include <fmt/core.h>
+
+#include <cstdint>
+#include <string_view>
+
+/*
+ * The checks of one test.
+ */
+struct TestResult
+{
+    std::string_view name;
+    uint32_t         checks   = 0u;
+    uint32_t         failures = 0u;
+
+    /*
+     * Records a check, the first few that fail are logged.
+     *
+     * @param passed Whether the check passed.
+     * @param what What was checked.
+     */
+    void check(bool passed, std::string_view what)
+    {
+        checks++;
+        if (!passed && failures++ < 10u)
+        {
+            LOG_ERROR(fmt::format("{}: {}", name, what));
+        }
+    }
+
+    /*
+     * Logs how many checks passed.
+     *
+     * @return True if every check passed.
+     */
+    bool report() const
+    {
+        LOG_INFO(fmt::format("{}: {} checks, {} failed", name, checks, failures));
+        return failures == 0u;
+    }
+};
\ No newline at end of file
@@ -0,0 +1,882 @@
+#include "TextureTests.hpp"
+#include "TestResult.hpp"
+
+#include "Core/JobSystem.hpp"
+#include "Core/Logger.hpp"
+#include "Graphics/BlockCompressor.hpp"
+#include "Graphics/TextureProcessor.hpp"
+
+#include <fastgltf/core.hpp>
+#include <fmt/core.h>
+#include <stb_image.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <random>
+#include <string_view>
+#include <vector>
+
+namespace core = bisky::core;
+namespace gfx  = bisky::gfx;
+
+namespace
+{
+
+constexpr float Pi = 3.14159265f;
+
+struct TestImage
+{
+    std::string_view     name;
+    uint32_t             width;
+    uint32_t             height;
+    gfx::TextureRole     role;
+    std::vector<uint8_t> pixels;
+};
+
+uint8_t toByte(float value)
+{
+    return static_cast<uint8_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+/*
+ * Generates a diffuse image of smooth color waves with fine grain on top, like a photographed surface.
+ *
+ * @param size The width and height.
+ * @param cutout Give the image circles of opaque texels on a transparent background, with soft edges.
+ * @return The image.
+ */
+TestImage makeDiffuse(uint32_t size, bool cutout)
+{
+    std::mt19937                          random(size);
+    std::uniform_real_distribution<float> grain(-0.025f, 0.025f);
+
+    TestImage image = {cutout ? "Cutout" : "Diffuse", size, size, gfx::TextureRole::Diffuse};
+    image.pixels.resize(static_cast<size_t>(size) * size * 4u);
+    for (uint32_t y = 0; y < size; y++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            const float u     = x / static_cast<float>(size);
+            const float v     = y / static_cast<float>(size);
+            const float noise = grain(random);
+
+            uint8_t *pixel = image.pixels.data() + (static_cast<size_t>(y) * size + x) * 4u;
+            pixel[0]       = toByte(0.5f + 0.3f * std::sin(2.0f * Pi * (3.0f * u + v)) + noise);
+            pixel[1]       = toByte(0.4f + 0.2f * std::sin(2.0f * Pi * 5.0f * v) + 0.1f * u + noise);
+            pixel[2]       = toByte(0.3f + 0.2f * std::cos(2.0f * Pi * (2.0f * u - 4.0f * v)) + noise);
+            pixel[3]       = 255u;
+            if (cutout)
+            {
+                // circles of a quarter of a cell, fading out over two texels
+                const float cellU    = u * 8.0f - std::floor(u * 8.0f) - 0.5f;
+                const float cellV    = v * 8.0f - std::floor(v * 8.0f) - 0.5f;
+                const float distance = (0.25f - std::sqrt(cellU * cellU + cellV * cellV)) * size / 8.0f;
+                pixel[3]             = toByte(distance * 0.5f + 0.5f);
+            }
+        }
+    }
+
+    return image;
+}
+
+/*
+ * Generates a tangent space normal map of a field of bumps.
+ *
+ * @param size The width and height.
+ * @return The image.
+ */
+TestImage makeNormalMap(uint32_t size)
+{
+    TestImage image = {"Normal", size, size, gfx::TextureRole::Normal};
+    image.pixels.resize(static_cast<size_t>(size) * size * 4u);
+    for (uint32_t y = 0; y < size; y++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            // -------------- the slopes of h = sin(6 pi u) * sin(4 pi v) + 0.3 * sin(20 pi (u + v)) --------------
+            const float u  = x / static_cast<float>(size);
+            const float v  = y / static_cast<float>(size);
+            const float du = 6.0f * Pi * std::cos(6.0f * Pi * u) * std::sin(4.0f * Pi * v) +
+                             6.0f * Pi * std::cos(20.0f * Pi * (u + v));
+            const float dv = 4.0f * Pi * std::sin(6.0f * Pi * u) * std::cos(4.0f * Pi * v) +
+                             6.0f * Pi * std::cos(20.0f * Pi * (u + v));
+
+            const float strength = 0.05f;
+            const float length   = std::sqrt(strength * strength * (du * du + dv * dv) + 1.0f);
+
+            uint8_t *pixel = image.pixels.data() + (static_cast<size_t>(y) * size + x) * 4u;
+            pixel[0]       = toByte(-strength * du / length * 0.5f + 0.5f);
+            pixel[1]       = toByte(-strength * dv / length * 0.5f + 0.5f);
+            pixel[2]       = toByte(1.0f / length * 0.5f + 0.5f);
+            pixel[3]       = 255u;
+        }
+    }
+
+    return image;
+}
+
+/*
+ * Generates a glTF metallic-roughness image, roughness in green and metal in blue.
+ * Panels of bare metal sit on a painted surface whose roughness changes slowly.
+ *
+ * @param size The width and height.
+ * @return The image.
+ */
+TestImage makeMetallicRoughness(uint32_t size)
+{
+    std::mt19937                          random(size + 1u);
+    std::uniform_real_distribution<float> grain(-0.02f, 0.02f);
+
+    TestImage image = {"MetallicRoughness", size, size, gfx::TextureRole::MetallicRoughness};
+    image.pixels.resize(static_cast<size_t>(size) * size * 4u);
+    for (uint32_t y = 0; y < size; y++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            const float u     = x / static_cast<float>(size);
+            const float v     = y / static_cast<float>(size);
+            const bool  metal = (static_cast<uint32_t>(u * 6.0f) + static_cast<uint32_t>(v * 4.0f)) % 3u == 0u;
+
+            uint8_t *pixel = image.pixels.data() + (static_cast<size_t>(y) * size + x) * 4u;
+            pixel[0]       = 255u;
+            pixel[1]       = toByte((metal ? 0.2f : 0.6f + 0.3f * std::sin(2.0f * Pi * u)) + grain(random));
+            pixel[2]       = metal ? 255u : 0u;
+            pixel[3]       = 255u;
+        }
+    }
+
+    return image;
+}
+
+// -------------- block decoders, written from the format specifications --------------
+
+void decodeBc1(const uint8_t *block, uint8_t *pixels)
+{
+    uint16_t color0, color1;
+    uint32_t indices;
+    memcpy(&color0, block, sizeof(uint16_t));
+    memcpy(&color1, block + 2u, sizeof(uint16_t));
+    memcpy(&indices, block + 4u, sizeof(uint32_t));
+
+    int palette[4][4];
+    for (uint32_t e = 0; e < 2u; e++)
+    {
+        const uint16_t color = e == 0u ? color0 : color1;
+        const int      r     = (color >> 11u) & 31;
+        const int      g     = (color >> 5u) & 63;
+        const int      b     = color & 31;
+        palette[e][0]        = (r << 3) | (r >> 2);
+        palette[e][1]        = (g << 2) | (g >> 4);
+        palette[e][2]        = (b << 3) | (b >> 2);
+        palette[e][3]        = 255;
+    }
+
+    for (uint32_t c = 0; c < 3u; c++)
+    {
+        if (color0 > color1)
+        {
+            palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+            palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+        }
+        else
+        {
+            palette[2][c] = (palette[0][c] + palette[1][c]) / 2;
+            palette[3][c] = 0;
+        }
+    }
+
+    palette[2][3] = 255;
+    palette[3][3] = color0 > color1 ? 255 : 0;
+    for (uint32_t i = 0; i < 16u; i++)
+    {
+        for (uint32_t c = 0; c < 4u; c++)
+        {
+            pixels[i * 4u + c] = static_cast<uint8_t>(palette[(indices >> (i * 2u)) & 3u][c]);
+        }
+    }
+}
+
+void decodeBc4(const uint8_t *block, uint32_t channel, uint8_t *pixels)
+{
+    const int value0 = block[0];
+    const int value1 = block[1];
+
+    int palette[8] = {value0, value1};
+    for (int p = 2; p < 8; p++)
+    {
+        if (value0 > value1)
+            palette[p] = ((8 - p) * value0 + (p - 1) * value1) / 7;
+        else if (p < 6)
+            palette[p] = ((6 - p) * value0 + (p - 1) * value1) / 5;
+        else
+            palette[p] = p == 6 ? 0 : 255;
+    }
+
+    uint64_t indices = 0u;
+    for (uint32_t i = 0; i < 6u; i++)
+    {
+        indices |= static_cast<uint64_t>(block[2u + i]) << (i * 8u);
+    }
+
+    for (uint32_t i = 0; i < 16u; i++)
+    {
+        pixels[i * 4u + channel] = static_cast<uint8_t>(palette[(indices >> (i * 3u)) & 7u]);
+    }
+}
+
+/*
+ * Decodes a BC7 block, only mode 6 is supported since it's the only one the encoder writes.
+ *
+ * @return False if the block uses another mode.
+ */
+bool decodeBc7(const uint8_t *block, uint8_t *pixels)
+{
+    uint32_t position = 0u;
+    auto     read     = [&](uint32_t bits) {
+        uint32_t value = 0u;
+        for (uint32_t b = 0; b < bits; b++, position++)
+        {
+            value |= ((block[position >> 3u] >> (position & 7u)) & 1u) << b;
+        }
+        return value;
+    };
+
+    if (read(7u) != 1u << 6u)
+        return false;
+
+    int endpoints[2][4];
+    for (uint32_t c = 0; c < 4u; c++)
+    {
+        endpoints[0][c] = static_cast<int>(read(7u)) << 1;
+        endpoints[1][c] = static_cast<int>(read(7u)) << 1;
+    }
+
+    const int pBit0 = static_cast<int>(read(1u));
+    const int pBit1 = static_cast<int>(read(1u));
+    for (uint32_t c = 0; c < 4u; c++)
+    {
+        endpoints[0][c] |= pBit0;
+        endpoints[1][c] |= pBit1;
+    }
+
+    constexpr int Weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+    for (uint32_t i = 0; i < 16u; i++)
+    {
+        const int weight = Weights[read(i == 0u ? 3u : 4u)];
+        for (uint32_t c = 0; c < 4u; c++)
+        {
+            pixels[i * 4u + c] =
+                static_cast<uint8_t>(((64 - weight) * endpoints[0][c] + weight * endpoints[1][c] + 32) >> 6);
+        }
+    }
+
+    return true;
+}
+
+/*
+ * Decodes one block of a processed texture to 16 RGBA8 pixels.
+ * BC5 has no blue or alpha, so they're set to 0 and 255.
+ */
+void decodeBlock(DXGI_FORMAT format, const uint8_t *block, uint8_t *pixels)
+{
+    switch (format)
+    {
+    case DXGI_FORMAT_BC1_UNORM:
+        decodeBc1(block, pixels);
+        break;
+    case DXGI_FORMAT_BC3_UNORM:
+        decodeBc1(block + gfx::BlockCompressor::Bc4BlockSize, pixels);
+        decodeBc4(block, 3u, pixels);
+        break;
+    case DXGI_FORMAT_BC5_UNORM:
+        for (uint32_t i = 0; i < 16u; i++)
+        {
+            pixels[i * 4u + 2u] = 0u;
+            pixels[i * 4u + 3u] = 255u;
+        }
+        decodeBc4(block, 0u, pixels);
+        decodeBc4(block + gfx::BlockCompressor::Bc4BlockSize, 1u, pixels);
+        break;
+    case DXGI_FORMAT_BC7_UNORM:
+        if (!decodeBc7(block, pixels))
+            memset(pixels, 0, 64u);
+        break;
+    default:
+        memset(pixels, 0, 64u);
+        break;
+    }
+}
+
+/*
+ * Decodes the largest level of a processed texture back to RGBA8.
+ */
+std::vector<uint8_t> decodeLevel(const gfx::ProcessedTexture &texture)
+{
+    const size_t pixelCount = static_cast<size_t>(texture.width) * texture.height;
+    if (texture.format == DXGI_FORMAT_R8G8B8A8_UNORM)
+    {
+        return std::vector<uint8_t>(texture.data.begin(), texture.data.begin() + pixelCount * 4u);
+    }
+
+    const gfx::SurfaceInfo surface    = gfx::TextureProcessor::getSurfaceInfo(texture.format, texture.width, 4u);
+    const uint32_t         blocksWide = texture.width / 4u;
+    const uint32_t         blockSize  = surface.rowBytes / blocksWide;
+
+    std::vector<uint8_t> pixels(pixelCount * 4u);
+    uint8_t              block[64];
+    for (uint32_t by = 0; by < texture.height / 4u; by++)
+    {
+        for (uint32_t bx = 0; bx < blocksWide; bx++)
+        {
+            decodeBlock(texture.format, texture.data.data() + by * surface.rowBytes + bx * blockSize, block);
+            for (uint32_t y = 0; y < 4u; y++)
+            {
+                memcpy(
+                    pixels.data() + ((static_cast<size_t>(by) * 4u + y) * texture.width + bx * 4u) * 4u,
+                    block + y * 16u, 16u
+                );
+            }
+        }
+    }
+
+    return pixels;
+}
+
+/*
+ * Gets how many channels of a format hold data, starting from red.
+ * BC1 has no alpha to speak of here and BC5 only stores red and green.
+ */
+uint32_t getChannelCount(DXGI_FORMAT format)
+{
+    switch (format)
+    {
+    case DXGI_FORMAT_BC1_UNORM:
+        return 3u;
+    case DXGI_FORMAT_BC5_UNORM:
+        return 2u;
+    default:
+        return 4u;
+    }
+}
+
+/*
+ * Gets the root mean square error between two RGBA8 images, over the first channels of every pixel.
+ */
+float getRmse(const uint8_t *source, const uint8_t *decoded, size_t pixelCount, uint32_t channels)
+{
+    double sum = 0.0;
+    for (size_t i = 0; i < pixelCount; i++)
+    {
+        for (uint32_t c = 0; c < channels; c++)
+        {
+            const double difference = static_cast<double>(source[i * 4u + c]) - decoded[i * 4u + c];
+            sum += difference * difference;
+        }
+    }
+
+    return static_cast<float>(std::sqrt(sum / (pixelCount * channels)));
+}
+
+float getPsnr(float rmse)
+{
+    return rmse > 0.0f ? 20.0f * std::log10(255.0f / rmse) : 99.0f;
+}
+
+/*
+ * Gets the largest difference of one channel between two blocks of 16 RGBA8 pixels.
+ */
+int getMaxError(const uint8_t *source, const uint8_t *decoded, uint32_t channel)
+{
+    int largest = 0;
+    for (uint32_t i = 0; i < 16u; i++)
+    {
+        largest = std::max(largest, std::abs(source[i * 4u + channel] - decoded[i * 4u + channel]));
+    }
+
+    return largest;
+}
+
+/*
+ * Copies the encoded bytes of every image of a glTF model, the same way ModelCooker::importGltf does.
+ * Images embedded in a buffer only copy their buffer view, external images are read from disk.
+ *
+ * @param path The .gltf or .glb file.
+ * @param images Filled with the bytes of every image, empty for images that couldn't be read.
+ * @return False if the file couldn't be parsed.
+ */
+bool readImages(const std::filesystem::path &path, std::vector<std::vector<uint8_t>> &images)
+{
+    auto data = fastgltf::GltfDataBuffer::FromPath(path);
+    if (data.error() != fastgltf::Error::None)
+    {
+        LOG_ERROR("Failed to find " + path.string());
+        return false;
+    }
+
+    const fastgltf::Options options =
+        path.extension() == ".glb" ? fastgltf::Options::None : fastgltf::Options::LoadExternalBuffers;
+
+    fastgltf::Parser parser(fastgltf::Extensions::EXT_mesh_gpu_instancing);
+    auto             asset = parser.loadGltf(data.get(), path.parent_path(), options);
+    if (asset.error() != fastgltf::Error::None)
+    {
+        LOG_ERROR("Failed to parse " + path.string());
+        return false;
+    }
+
+    // the visitors have to see const sources, or the catch-all overload is a better match than the others
+    const fastgltf::Asset &gltf = asset.get();
+    for (auto &image : gltf.images)
+    {
+        std::vector<uint8_t> &bytes = images.emplace_back();
+        auto                  copy  = [&](const std::byte *source, size_t size) {
+            bytes.resize(size);
+            memcpy(bytes.data(), source, size);
+        };
+        auto readFile = [&](const std::filesystem::path &file, size_t offset) {
+            std::ifstream stream(path.parent_path() / file, std::ios::binary | std::ios::ate);
+            if (!stream)
+                return;
+
+            bytes.resize(static_cast<size_t>(stream.tellg()) - offset);
+            stream.seekg(offset);
+            stream.read(reinterpret_cast<char *>(bytes.data()), bytes.size());
+        };
+
+        std::visit(
+            fastgltf::visitor(
+                [&](auto &) {},
+                [&](const fastgltf::sources::Array &array) { copy(array.bytes.data(), array.bytes.size()); },
+                [&](const fastgltf::sources::URI &uri) { readFile(uri.uri.fspath(), uri.fileByteOffset); },
+                [&](const fastgltf::sources::BufferView &view) {
+                    auto &bufferView = gltf.bufferViews[view.bufferViewIndex];
+                    auto &buffer     = gltf.buffers[bufferView.bufferIndex];
+                    std::visit(
+                        fastgltf::visitor(
+                            [&](auto &) {},
+                            [&](const fastgltf::sources::Array &array) {
+                                copy(array.bytes.data() + bufferView.byteOffset, bufferView.byteLength);
+                            }
+                        ),
+                        buffer.data
+                    );
+                }
+            ),
+            image.data
+        );
+    }
+
+    return true;
+}
+
+/*
+ * The pixels stb_image decoded an image to, freed with it.
+ */
+struct DecodedImage
+{
+    stbi_uc *pixels = nullptr;
+    int      width  = 0;
+    int      height = 0;
+
+    DecodedImage()                                = default;
+    DecodedImage(const DecodedImage &)            = delete;
+    DecodedImage &operator=(const DecodedImage &) = delete;
+
+    ~DecodedImage()
+    {
+        stbi_image_free(pixels);
+    }
+};
+
+} // namespace
+
+bool testTextures()
+{
+    namespace BlockCompressor  = gfx::BlockCompressor;
+    namespace TextureProcessor = gfx::TextureProcessor;
+
+    TestResult   result = {"Textures"};
+    std::mt19937 random(11u);
+
+    // -------------- solid blocks only lose what the endpoints can't store --------------
+    std::uniform_int_distribution<int> byte(0, 255);
+    for (uint32_t run = 0; run < 200u; run++)
+    {
+        uint8_t color[4] = {
+            static_cast<uint8_t>(byte(random)), static_cast<uint8_t>(byte(random)),
+            static_cast<uint8_t>(byte(random)), static_cast<uint8_t>(byte(random))
+        };
+
+        uint8_t pixels[64];
+        for (uint32_t i = 0; i < 16u; i++)
+        {
+            memcpy(pixels + i * 4u, color, 4u);
+        }
+
+        uint8_t block[16];
+        uint8_t decoded[64];
+        BlockCompressor::encodeBc1(pixels, block);
+        decodeBlock(DXGI_FORMAT_BC1_UNORM, block, decoded);
+        result.check(
+            getMaxError(pixels, decoded, 0u) <= 5 && getMaxError(pixels, decoded, 1u) <= 3 &&
+                getMaxError(pixels, decoded, 2u) <= 5,
+            fmt::format("a solid BC1 block of {} {} {} is within half a 565 step", color[0], color[1], color[2])
+        );
+
+        BlockCompressor::encodeBc3(pixels, block);
+        decodeBlock(DXGI_FORMAT_BC3_UNORM, block, decoded);
+        result.check(
+            getMaxError(pixels, decoded, 3u) == 0 && getMaxError(pixels, decoded, 1u) <= 3,
+            fmt::format("a solid BC3 block keeps alpha {} exactly", color[3])
+        );
+
+        BlockCompressor::encodeBc5(pixels, block);
+        decodeBlock(DXGI_FORMAT_BC5_UNORM, block, decoded);
+        result.check(
+            getMaxError(pixels, decoded, 0u) == 0 && getMaxError(pixels, decoded, 1u) == 0,
+            fmt::format("a solid BC5 block keeps {} {} exactly", color[0], color[1])
+        );
+
+        // the same p-bit on both endpoints is off by 1 in every channel of the other parity, at most
+        BlockCompressor::encodeBc7(pixels, block);
+        decodeBlock(DXGI_FORMAT_BC7_UNORM, block, decoded);
+        int error = 0;
+        int odd   = 0;
+        for (uint32_t c = 0; c < 4u; c++)
+        {
+            error += getMaxError(pixels, decoded, c) * getMaxError(pixels, decoded, c);
+            odd += color[c] & 1;
+        }
+        result.check(
+            error <= std::min(odd, 4 - odd),
+            fmt::format("a solid BC7 block of {} {} {} {} is off by a p-bit", color[0], color[1], color[2], color[3])
+        );
+    }
+
+    // -------------- ramps between two colors are what the formats store best --------------
+    for (uint32_t run = 0; run < 200u; run++)
+    {
+        int from[4], to[4];
+        for (uint32_t c = 0; c < 4u; c++)
+        {
+            from[c] = byte(random);
+            to[c]   = byte(random);
+        }
+
+        uint8_t pixels[64];
+        for (uint32_t i = 0; i < 16u; i++)
+        {
+            for (uint32_t c = 0; c < 4u; c++)
+            {
+                pixels[i * 4u + c] = static_cast<uint8_t>((from[c] * (15 - static_cast<int>(i)) + to[c] * i) / 15);
+            }
+        }
+
+        // the palettes have 4, 8 and 16 entries, so no pixel can be further than half a gap from one, plus the
+        // rounding of the endpoints
+        uint8_t block[16];
+        uint8_t decoded[64];
+        bool    bc1 = true;
+        bool    bc4 = true;
+        bool    bc7 = true;
+        BlockCompressor::encodeBc1(pixels, block);
+        decodeBlock(DXGI_FORMAT_BC1_UNORM, block, decoded);
+        for (uint32_t c = 0; c < 3u; c++)
+        {
+            bc1 &= getMaxError(pixels, decoded, c) <= std::abs(to[c] - from[c]) / 6 + 5;
+        }
+
+        BlockCompressor::encodeBc4(pixels, 2u, block);
+        memcpy(decoded, pixels, sizeof(decoded));
+        decodeBc4(block, 2u, decoded);
+        bc4 &= getMaxError(pixels, decoded, 2u) <= std::abs(to[2] - from[2]) / 14 + 1;
+
+        BlockCompressor::encodeBc7(pixels, block);
+        decodeBlock(DXGI_FORMAT_BC7_UNORM, block, decoded);
+        for (uint32_t c = 0; c < 4u; c++)
+        {
+            bc7 &= getMaxError(pixels, decoded, c) <= std::abs(to[c] - from[c]) * 5 / 128 + 1;
+        }
+
+        result.check(bc1, fmt::format("a BC1 ramp from {} {} {} is within half a gap", from[0], from[1], from[2]));
+        result.check(bc4, fmt::format("a BC4 ramp from {} to {} is within half a gap", from[2], to[2]));
+        result.check(bc7, fmt::format("a BC7 ramp from {} {} {} is within half a gap", from[0], from[1], from[2]));
+    }
+
+    // -------------- mip chain sizes --------------
+    result.check(TextureProcessor::getMipCount(1u, 1u) == 1u, "a 1x1 texture has 1 mip");
+    result.check(TextureProcessor::getMipCount(256u, 256u) == 9u, "a 256x256 texture has 9 mips");
+    result.check(TextureProcessor::getMipCount(256u, 64u) == 9u, "a 256x64 texture has 9 mips");
+    result.check(TextureProcessor::getMipCount(300u, 17u) == 9u, "a 300x17 texture has 9 mips");
+    result.check(
+        TextureProcessor::getTextureSize(DXGI_FORMAT_BC1_UNORM, 64u, 64u, 7u) == 8u * (256u + 64u + 16u + 4u + 3u),
+        "a 64x64 BC1 chain is 343 blocks, the last three levels a block each"
+    );
+
+    // -------------- formats and sizes of processed textures --------------
+    struct FormatCase
+    {
+        TestImage           image;
+        gfx::TextureQuality quality;
+        DXGI_FORMAT         format;
+    };
+
+    std::vector<FormatCase> cases;
+    cases.push_back({makeDiffuse(64u, false), gfx::TextureQuality::Fast, DXGI_FORMAT_BC1_UNORM});
+    cases.push_back({makeDiffuse(64u, true), gfx::TextureQuality::Fast, DXGI_FORMAT_BC3_UNORM});
+    cases.push_back({makeDiffuse(64u, true), gfx::TextureQuality::High, DXGI_FORMAT_BC7_UNORM});
+    cases.push_back({makeNormalMap(64u), gfx::TextureQuality::High, DXGI_FORMAT_BC5_UNORM});
+    cases.push_back({makeMetallicRoughness(64u), gfx::TextureQuality::High, DXGI_FORMAT_BC1_UNORM});
+    cases.push_back({makeDiffuse(30u, false), gfx::TextureQuality::Fast, DXGI_FORMAT_R8G8B8A8_UNORM});
+    for (auto &[image, quality, format] : cases)
+    {
+        gfx::ProcessedTexture texture;
+        TextureProcessor::process(image.pixels.data(), image.width, image.height, image.role, quality, texture);
+
+        const uint32_t mipLevels = TextureProcessor::getMipCount(image.width, image.height);
+        result.check(
+            texture.format == format,
+            fmt::format(
+                "{} {}x{} is {}", image.name, image.width, image.height, TextureProcessor::getFormatName(format)
+            )
+        );
+        result.check(
+            texture.mipLevels == mipLevels &&
+                texture.data.size() ==
+                    TextureProcessor::getTextureSize(texture.format, image.width, image.height, mipLevels),
+            fmt::format("{} {}x{} holds a full mip chain", image.name, image.width, image.height)
+        );
+    }
+
+    // -------------- a solid image keeps its color in every level, whatever the byte values --------------
+    for (auto role : {gfx::TextureRole::Diffuse, gfx::TextureRole::MetallicRoughness})
+    {
+        bool solid = true;
+        for (uint32_t value = 0; value < 256u && solid; value++)
+        {
+            const uint8_t color[4] = {
+                static_cast<uint8_t>(value), static_cast<uint8_t>(255u - value), static_cast<uint8_t>(value * 7u),
+                static_cast<uint8_t>(value * 3u)
+            };
+
+            std::vector<uint8_t> pixels(12u * 5u * 4u);
+            for (size_t i = 0; i < pixels.size(); i++)
+            {
+                pixels[i] = color[i % 4u];
+            }
+
+            std::vector<uint8_t> mips;
+            TextureProcessor::generateMips(pixels.data(), 12u, 5u, role, mips);
+
+            solid = mips.size() == TextureProcessor::getTextureSize(DXGI_FORMAT_R8G8B8A8_UNORM, 12u, 5u, 4u);
+            for (size_t i = 0; i < mips.size() && solid; i++)
+            {
+                solid = mips[i] == color[i % 4u];
+            }
+        }
+        result.check(solid, fmt::format("a solid image keeps its color in every mip, role {}", static_cast<int>(role)));
+    }
+
+    // -------------- diffuse texels are averaged in linear space and rounded to the closest sRGB byte --------------
+    {
+        auto toLinear = [](float value) {
+            return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+        };
+        auto toSrgb = [](float value) {
+            return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+        };
+
+        uint32_t wrong = 0u;
+        for (uint32_t run = 0; run < 1000u; run++)
+        {
+            const uint8_t left  = static_cast<uint8_t>(byte(random));
+            const uint8_t right = static_cast<uint8_t>(byte(random));
+
+            const uint8_t pixels[16] = {
+                left, left, left, 255u, right, right, right, 255u, left, left, left, 255u, right, right, right, 255u
+            };
+
+            std::vector<uint8_t> mips;
+            TextureProcessor::generateMips(pixels, 2u, 2u, gfx::TextureRole::Diffuse, mips);
+
+            const float average  = (toLinear(left / 255.0f) + toLinear(right / 255.0f)) * 0.5f;
+            const int   expected = static_cast<int>(toSrgb(average) * 255.0f + 0.5f);
+            wrong += mips.size() == 20u && mips[16] == expected && mips[19] == 255u ? 0u : 1u;
+        }
+        result.check(wrong == 0u, fmt::format("{} of 1000 averages of two sRGB texels are off", wrong));
+    }
+
+    // -------------- normal maps stay unit length down to 1x1 --------------
+    {
+        const TestImage      image = makeNormalMap(64u);
+        std::vector<uint8_t> mips;
+        TextureProcessor::generateMips(image.pixels.data(), image.width, image.height, image.role, mips);
+
+        float largest = 0.0f;
+        for (size_t i = static_cast<size_t>(image.width) * image.height * 4u; i < mips.size(); i += 4u)
+        {
+            float length = 0.0f;
+            for (uint32_t c = 0; c < 3u; c++)
+            {
+                const float component = mips[i + c] / 255.0f * 2.0f - 1.0f;
+                length += component * component;
+            }
+
+            largest = std::max(largest, std::abs(std::sqrt(length) - 1.0f));
+        }
+        result.check(largest < 0.02f, fmt::format("normal map mips are unit length, {:.4f} off at most", largest));
+    }
+
+    // -------------- the job system changes nothing but the time --------------
+    {
+        const TestImage       image = makeDiffuse(256u, true);
+        gfx::ProcessedTexture parallel;
+        gfx::ProcessedTexture serial;
+        TextureProcessor::process(
+            image.pixels.data(), image.width, image.height, image.role, gfx::TextureQuality::High, parallel, true
+        );
+        TextureProcessor::process(
+            image.pixels.data(), image.width, image.height, image.role, gfx::TextureQuality::High, serial, false
+        );
+        result.check(parallel.data == serial.data, "compressing on the job system writes the same blocks");
+    }
+
+    return result.report();
+}
+
+bool benchmarkTextures()
+{
+    namespace TextureProcessor = gfx::TextureProcessor;
+
+    std::vector<TestImage> images;
+    images.push_back(makeDiffuse(1024u, false));
+    images.push_back(makeDiffuse(1024u, true));
+    images.push_back(makeNormalMap(1024u));
+    images.push_back(makeMetallicRoughness(1024u));
+
+    // -------------- the PSNR below which a format has gone wrong, not just lost detail --------------
+    auto getMinimumPsnr = [](DXGI_FORMAT format) {
+        switch (format)
+        {
+        case DXGI_FORMAT_BC7_UNORM:
+        case DXGI_FORMAT_BC5_UNORM:
+            return 38.0f;
+        default:
+            return 30.0f;
+        }
+    };
+
+    bool passed = true;
+    for (auto &image : images)
+    {
+        for (auto quality : {gfx::TextureQuality::Fast, gfx::TextureQuality::High})
+        {
+            gfx::ProcessedTexture texture;
+            auto                  start = std::chrono::system_clock::now();
+            TextureProcessor::process(image.pixels.data(), image.width, image.height, image.role, quality, texture);
+            auto elapsed =
+                std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::system_clock::now() - start);
+
+            // -------------- error of the largest level --------------
+            const std::vector<uint8_t> decoded    = decodeLevel(texture);
+            const size_t               pixelCount = static_cast<size_t>(image.width) * image.height;
+            const float                rmse =
+                getRmse(image.pixels.data(), decoded.data(), pixelCount, getChannelCount(texture.format));
+            const float psnr = getPsnr(rmse);
+
+            const float sourceSize = pixelCount * 4.0f / (1024.0f * 1024.0f);
+            LOG_INFO(fmt::format(
+                "{}: {}x{} {} with {} mips in {:.3f} ms ({:.1f} MB/s), {:.2f} MB -> {:.2f} MB, RMSE {:.2f} "
+                "({:.1f} dB)",
+                image.name, image.width, image.height, TextureProcessor::getFormatName(texture.format),
+                texture.mipLevels, elapsed.count() / 1000.0f,
+                sourceSize / std::max(elapsed.count() / 1000000.0f, 1e-6f), sourceSize,
+                texture.data.size() / (1024.0f * 1024.0f), rmse, psnr
+            ));
+
+            if (psnr < getMinimumPsnr(texture.format))
+            {
+                LOG_ERROR(fmt::format(
+                    "{}: {} is below {:.1f} dB", image.name, TextureProcessor::getFormatName(texture.format),
+                    getMinimumPsnr(texture.format)
+                ));
+                passed = false;
+            }
+        }
+    }
+
+    return passed;
+}
+
+bool benchmarkImageDecode(const std::filesystem::path &path)
+{
+    std::vector<std::vector<uint8_t>> images;
+    if (!readImages(path, images) || images.empty())
+    {
+        LOG_ERROR("No images to decode in " + path.string());
+        return false;
+    }
+
+    const uint32_t imageCount = static_cast<uint32_t>(images.size());
+    auto           decode     = [&](std::vector<DecodedImage> &decoded, uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; i++)
+        {
+            int channelCount;
+            decoded[i].pixels = stbi_load_from_memory(
+                images[i].data(), static_cast<int>(images[i].size()), &decoded[i].width, &decoded[i].height,
+                &channelCount, 4
+            );
+        }
+    };
+
+    // -------------- both runs keep their pixels, so freeing them isn't timed and they can be compared --------------
+    std::vector<DecodedImage> serial(imageCount);
+    std::vector<DecodedImage> parallel(imageCount);
+
+    auto serialStart = std::chrono::system_clock::now();
+    decode(serial, 0u, imageCount);
+    auto parallelStart = std::chrono::system_clock::now();
+    core::JobSystem::get().parallelFor(imageCount, 1u, [&](uint32_t begin, uint32_t end) {
+        decode(parallel, begin, end);
+    });
+    auto parallelEnd = std::chrono::system_clock::now();
+
+    // -------------- every image has to decode, and to the same pixels on a worker --------------
+    bool     passed = true;
+    uint64_t texels = 0u;
+    for (uint32_t i = 0; i < imageCount; i++)
+    {
+        const DecodedImage &a = serial[i];
+        const DecodedImage &b = parallel[i];
+        if (!a.pixels || !b.pixels)
+        {
+            LOG_ERROR(fmt::format("Image {} of {} didn't decode", i, path.filename().string()));
+            passed = false;
+            continue;
+        }
+
+        const size_t size = static_cast<size_t>(a.width) * a.height * 4u;
+        if (a.width != b.width || a.height != b.height || memcmp(a.pixels, b.pixels, size) != 0)
+        {
+            LOG_ERROR(fmt::format("Image {} of {} decoded differently on a worker", i, path.filename().string()));
+            passed = false;
+        }
+
+        texels += static_cast<uint64_t>(a.width) * a.height;
+    }
+
+    auto serialElapsed   = std::chrono::duration_cast<std::chrono::microseconds>(parallelStart - serialStart);
+    auto parallelElapsed = std::chrono::duration_cast<std::chrono::microseconds>(parallelEnd - parallelStart);
+    LOG_INFO(fmt::format(
+        "{}: decoded {} images ({:.1f} MTexels): serial {:.3f} ms, parallel {:.3f} ms ({:.1f}x, {} workers)",
+        path.filename().string(), imageCount, texels / 1000000.0f, serialElapsed.count() / 1000.0f,
+        parallelElapsed.count() / 1000.0f,
+        serialElapsed.count() / std::max(static_cast<float>(parallelElapsed.count()), 1.0f),
+        core::JobSystem::get().getWorkerCount()
+    ));
+
+    return passed;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+/*
+ * Headless tests of the texture processing pipeline.
+ *
+ * The images are generated here and the blocks are decoded here to measure them, so the tests include only the
+ * standard library, fmt, the logger and the texture headers. Only the decode benchmark reads a model from disk,
+ * with fastgltf and stb_image.
+ */
+
+#include <filesystem>
+
+/*
+ * Encodes solid and two color blocks with every BlockCompressor encoder and checks that they decode close to
+ * their pixels, then runs TextureProcessor on generated images. The mip chain has to be as long and as large
+ * as getMipCount and getTextureSize say, solid images have to keep their color in every level, diffuse texels
+ * have to be averaged in linear space, normal maps have to stay unit length, images that aren't made of whole
+ * blocks have to stay RGBA8 and compressing on the job system has to produce the same blocks as compressing on
+ * one thread.
+ *
+ * @return True if every check passed.
+ */
+bool testTextures();
+
+/*
+ * Processes generated diffuse, alpha tested, normal and metallic-roughness images with both qualities and logs
+ * the time it took, the throughput, how much smaller the mip chain is than a single RGBA8 level and the RMSE
+ * and PSNR of the largest level against its source.
+ *
+ * @return True if every image came out within the error the format should reach.
+ */
+bool benchmarkTextures();
+
+/*
+ * Reads the encoded images of a glTF model and decodes them to RGBA8 one after another, then all at once on the
+ * job system, and logs both times and the speedup. Only the images are read, the model isn't imported.
+ *
+ * @param path The .gltf or .glb file.
+ * @return True if every image decoded and both runs decoded the same pixels.
+ */
+bool benchmarkImageDecode(const std::filesystem::path &path);
\ No newline at end of file
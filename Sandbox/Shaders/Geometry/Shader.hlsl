@@ -18,6 +18,20 @@ struct Vertex
     float4 tangent : TANGENT;
 };
 
+// matches scene::VertexFormat
+#define VERTEX_FORMAT_FULL 0
+#define VERTEX_FORMAT_PACKED 1
+
+// matches scene::PackedVertex, every uint holds two 16-bit values
+struct PackedVertex
+{
+    uint positionXY;
+    uint positionZTangentSign;
+    uint normal;
+    uint tangent;
+    uint texCoord;
+};
+
 struct RenderResource
 {
     int vertexBufferIndex;
@@ -25,17 +39,53 @@ struct RenderResource
     int diffuseTextureIndex;
     int metallicRoughnessTextureIndex;
     int normalTextureIndex;
+    uint objectIndex;
 };
 
 ConstantBuffer<SceneBuffer> sceneBuffer : register(b0);
 ConstantBuffer<LightBuffer> lightBuffer : register(b1);
-ConstantBuffer<ObjectBuffer> objectBuffer : register(b2);
+StructuredBuffer<ObjectBuffer> objectBuffers : register(t0);
 ConstantBuffer<RenderResource> renderResource : register(b3);
 
+float2 UnpackSnorm16x2(uint packed)
+{
+    int2 value = int2(int(packed << 16) >> 16, int(packed) >> 16);
+    return max(float2(value) / 32767.0, -1.0);
+}
+
+float3 DecodeOctahedral(float2 encoded)
+{
+    float3 direction = float3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float t = saturate(-direction.z);
+    direction.xy += t * (1.0 - 2.0 * step(0.0, direction.xy));
+    return normalize(direction);
+}
+
+Vertex LoadVertex(uint vertexId, ObjectBuffer objectBuffer)
+{
+    if (objectBuffer.vertexFormat == VERTEX_FORMAT_FULL)
+    {
+        StructuredBuffer<Vertex> vertexBuffer = ResourceDescriptorHeap[renderResource.vertexBufferIndex];
+        return vertexBuffer[vertexId];
+    }
+
+    StructuredBuffer<PackedVertex> vertexBuffer = ResourceDescriptorHeap[renderResource.vertexBufferIndex];
+    PackedVertex packed = vertexBuffer[vertexId];
+
+    uint3 position = uint3(packed.positionXY & 0xFFFF, packed.positionXY >> 16, packed.positionZTangentSign & 0xFFFF);
+
+    Vertex vertex;
+    vertex.position = objectBuffer.positionMin + float3(position) * objectBuffer.positionScale;
+    vertex.normal = DecodeOctahedral(UnpackSnorm16x2(packed.normal));
+    vertex.texCoord = f16tof32(uint2(packed.texCoord, packed.texCoord >> 16));
+    vertex.tangent = float4(DecodeOctahedral(UnpackSnorm16x2(packed.tangent)), (packed.positionZTangentSign >> 16) != 0 ? -1.0 : 1.0);
+    return vertex;
+}
+
 VOutput VsMain(uint vertexId : SV_VertexID)
 {
-    StructuredBuffer<Vertex> vertexBuffer = ResourceDescriptorHeap[renderResource.vertexBufferIndex];
-    Vertex vertex = vertexBuffer[vertexId];
+    ObjectBuffer objectBuffer = objectBuffers[renderResource.objectIndex];
+    Vertex vertex = LoadVertex(vertexId, objectBuffer);
     
     VOutput output = (VOutput) 0;
     
@@ -3,8 +3,11 @@
 struct ObjectBuffer
 {
     float4x4 world;
-    float4x4 inverseWorld;
     float4x4 transposeInverseWorld;
+    float3 positionMin;
+    uint vertexFormat;
+    float3 positionScale;
+    float padding;
 };
 
 struct SceneBuffer